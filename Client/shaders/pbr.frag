@@ -1,4 +1,4 @@
-#version 330 core
+#version 430 core
 
 out vec4 FragColor;
 in vec2 TexCoords;
@@ -9,8 +9,8 @@ in mat4 Model;
 
 struct PointLight 
 {
-    vec3 position;
-    vec3 diffuse;
+    vec4 position;
+    vec4 diffuse;
 };
 
 uniform sampler2D albedoMap;
@@ -40,8 +40,20 @@ uniform sampler2D brdfLUT;
 uniform vec3 lightPositions[4];
 uniform vec3 lightColors[4];
 
-uniform vec3 camPos;
-uniform PointLight point_lights[4];
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec4 cameraPosition;
+};
+
+// every light of the frame, lightIndices picks the ones reaching the mesh (-1 when unused)
+layout (std430) readonly buffer PointLights
+{
+    PointLight point_lights[];
+};
+
+uniform ivec4 lightIndices;
 
 const float PI = 3.14159265359;
 
@@ -143,7 +155,7 @@ void main()
 	}
 
     // Input lighting data
-    vec3 V = normalize(camPos - WorldPos);
+    vec3 V = normalize(cameraPosition.xyz - WorldPos);
     vec3 R = reflect(-V, N); 
 
     // Reflectance at normal incidence
@@ -157,12 +169,17 @@ void main()
     
 	for(int i = 0; i < 4; ++i) 
     {
+        if (lightIndices[i] < 0)
+            break;
+
+        PointLight light = point_lights[lightIndices[i]];
+
         // calculate per-light radiance
-        vec3 L = normalize(point_lights[i].position - WorldPos);
+        vec3 L = normalize(light.position.xyz - WorldPos);
         vec3 H = normalize(V + L);
-        float distance = length(point_lights[i].position - WorldPos);
+        float distance = length(light.position.xyz - WorldPos);
         float attenuation = 1.0 / (distance * distance);
-        vec3 radiance = point_lights[i].diffuse * attenuation;
+        vec3 radiance = light.diffuse.rgb * attenuation;
 
         // Cook-Torrance BRDF
         float NDF = DistributionGGX(N, H, roughness);   
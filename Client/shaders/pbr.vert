@@ -1,4 +1,4 @@
-#version 330 core
+#version 430 core
 
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 uvs;
@@ -11,8 +11,13 @@ out vec3 Normal;
 out vec3 Tangent;
 out mat4 Model;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec4 cameraPosition;
+};
+
 uniform mat4 model;
 
 void main()
@@ -180,6 +180,8 @@ namespace Razor
 
 	AssetsManager::~AssetsManager()
 	{
+		delete texturesManager;
+		texturesManager = nullptr;
 	}
 
 
@@ -4,7 +4,7 @@
 #include "Editor/EditorComponent.h"
 #include "Razor/Filesystem/DirectoryWatcher.h"
 #include "Razor/Filesystem/FileWatcher.h"
-#include "Razor/Core/TasksManager.h"
+#include "Razor/Core/JobSystem.h"
 #include "FileBrowser.h"
 #
 namespace Razor {
@@ -135,7 +135,7 @@ namespace Razor
 		ImGui::Dummy(ImVec2(size.x, size.y - 21.0f));
 		auto rect_pos = ImGui::GetItemRectMin();
 		auto rect_max = ImGui::GetItemRectMax();
-		auto rect_size = ImVec2(rect_pos.x + 150.0f, rect_pos.y + (35.0f + 90.0f));
+		auto rect_size = ImVec2(rect_pos.x + 150.0f, rect_pos.y + (35.0f + 110.0f));
 
 		Camera* cam = editor->getEngine()->getScenesManager()->getActiveScene()->getActiveCamera();
 
@@ -235,6 +235,11 @@ namespace Razor
 			ImGui::SetCursorPos(ImVec2(x + 60, y + 80.0f));
 			ImGui::TextColored(ImColor(255, 255, 255, 128), "%.3f", editor->getEngine()->getSleepTiming());
 
+			ImGui::SetCursorPos(ImVec2(x, y + 100.0f));
+			ImGui::TextColored(ImColor(255, 255, 255, 128), "Jitter");
+			ImGui::SetCursorPos(ImVec2(x + 60, y + 100.0f));
+			ImGui::TextColored(ImColor(255, 255, 255, 128), "%.3f", editor->getEngine()->getJitterTiming());
+
 			ImGui::PopStyleColor();
 		}
 
@@ -5,7 +5,7 @@
 #include "AssetsManager.h"
 #include "Razor/Materials/TexturesManager.h"
 #include "Razor/Materials/Texture.h"
-#include "Razor/Core/TasksManager.h"
+#include "Razor/Core/JobSystem.h"
 #include "Razor/Geometry/StaticMesh.h"
 #include "Editor/Editor.h"
 #include "Razor/Types/Color.h"
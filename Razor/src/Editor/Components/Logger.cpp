@@ -25,14 +25,20 @@ namespace Razor
 
 	void Logger::addLog(const std::string& str)
 	{
+		std::unique_lock<std::mutex> lock(mutex);
+
 		logs.push_back(str);
 
+		if (logs.size() > MAX_LOGS)
+			logs.pop_front();
+
 		if (autoScroll)
 			scrollToBottom = true;
 	}
 
 	void Logger::clear()
 	{
+		std::unique_lock<std::mutex> lock(mutex);
 		logs.clear();
 	}
 
@@ -64,8 +70,12 @@ namespace Razor
 		ImGui::NextColumn();
 		ImGui::Indent(5.0f);
 
-		for (auto log : logs)
-			ImGui::Text(log.c_str());
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			for (auto& log : logs)
+				ImGui::TextUnformatted(log.c_str());
+		}
 
 		ImGui::Indent(-5.0f);
 		ImGui::PopStyleVar();
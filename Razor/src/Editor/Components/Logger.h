@@ -5,6 +5,8 @@
 #include "Razor/Filesystem/FileWatcher.h"
 #include "Editor/EditorComponent.h"
 
+#define MAX_LOGS 2000
+
 namespace Razor {
 
 	class RAZOR_API Logger : public EditorComponent
@@ -23,7 +25,9 @@ namespace Razor {
 		bool autoScroll;
 		bool scrollToBottom;
 
-		std::vector<std::string> logs;
+		// Filled from the log thread
+		std::deque<std::string> logs;
+		std::mutex mutex;
 	};
 
 }
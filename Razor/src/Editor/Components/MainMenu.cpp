@@ -6,6 +6,9 @@
 #include "Editor/Editor.h"
 #include "Razor/Core/System.h"
 #include "Razor/Core/Engine.h"
+#include "Razor/Scene/ScenesManager.h"
+#include "Razor/Filesystem/Serializer.h"
+#include "Razor/Scene/WorldPartition.h"
 
 #include "Editor/Components/AssetsManager.h"
 
@@ -14,7 +17,8 @@ namespace Razor {
 	MainMenu::MainMenu(Editor* editor) : 
 		EditorComponent(editor),
 		show_create_project(false),
-		show_preferences(false)
+		show_preferences(false),
+		scene_path("")
 	{
 	}
 
@@ -47,12 +51,32 @@ namespace Razor {
 
 					ImGui::EndMenu();
 				}
+
+				ImGui::MenuItem("Load Scene...");
+
+				// Adds the nodes and lights of a .rza to the active scene. The file isn't
+				// made the Save target, saving the merged scene over it would lose it.
+				if (ImGui::IsItemClicked())
+				{
+					std::string path = Utils::fileDialog();
+					Serializer serializer;
+
+					if (!path.empty())
+						serializer.importScene(editor->getEngine()->getScenesManager()->getActiveScene().get(), path, AssetsManager::texturesManager);
+				}
 			
 				ImGui::Separator();
 
 				ImGui::MenuItem("Save", "Ctrl + S");
+
+				if (ImGui::IsItemClicked())
+					saveScene(scene_path.empty() ? Utils::saveFileDialog("rza") : scene_path);
+
 				ImGui::MenuItem("Save As...", "Ctrl + Shift + S");
 
+				if (ImGui::IsItemClicked())
+					saveScene(Utils::saveFileDialog("rza"));
+
 				ImGui::Separator();
 
 				ImGui::MenuItem("Preferences");
@@ -68,6 +92,38 @@ namespace Razor {
 
 				ImGui::Separator();
 
+				ImGui::MenuItem("Open World...");
+
+				// Any file of a cooked world directory, its index is world.rzw
+				if (ImGui::IsItemClicked())
+				{
+					std::string path = Utils::fileDialog();
+
+					if (!path.empty())
+					{
+						Engine* engine = editor->getEngine();
+						WorldPartition* partition = new WorldPartition();
+
+						if (partition->open(std::filesystem::path(path).parent_path().string()))
+							engine->getScenesManager()->getActiveScene()->setWorldPartition(partition, engine->getPhysicsWorld());
+						else
+							delete partition;
+					}
+				}
+
+				ImGui::MenuItem("Cook World...");
+
+				// The cells are written next to the chosen file
+				if (ImGui::IsItemClicked())
+				{
+					std::string path = Utils::folderDialog();
+
+					if (!path.empty())
+						WorldPartition::cook(editor->getEngine()->getScenesManager()->getActiveScene().get(), std::filesystem::path(path).parent_path().string());
+				}
+
+				ImGui::Separator();
+
 				ImGui::MenuItem("Quit", "Ctrl + Q");
 
 				if (ImGui::IsItemClicked())
@@ -133,5 +189,15 @@ namespace Razor {
 		
 	}
 
+	void MainMenu::saveScene(const std::string& path)
+	{
+		if (path.empty())
+			return;
+
+		Serializer serializer;
+
+		if (serializer.exportScene(editor->getEngine()->getScenesManager()->getActiveScene().get(), path))
+			scene_path = path;
+	}
 
 }
@@ -17,6 +17,10 @@ namespace Razor {
 		bool show_preferences;
 
 	private:
+		void saveScene(const std::string& path);
+
+		// Last .rza loaded or saved, Save writes back to it
+		std::string scene_path;
 	};
 
 }
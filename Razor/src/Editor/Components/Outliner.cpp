@@ -23,7 +23,7 @@ namespace Razor
 	{
 	}
 
-	void Outliner::drawNode(std::shared_ptr<Node> node, unsigned int index, unsigned int depth)
+	void Outliner::drawNode(const std::shared_ptr<Node>& node, unsigned int index, unsigned int depth)
 	{
 		if (node != nullptr && selection != nullptr)
 		{
@@ -136,7 +136,7 @@ namespace Razor
 		ImGui::Begin("Outliner");
 		
 		std::shared_ptr<Scene> scene = editor->getEngine()->getScenesManager()->getActiveScene();
-		std::vector<std::shared_ptr<Node>> nodes = scene->getSceneGraph()->getNodes();
+		SceneGraph::NodeList& nodes = scene->getSceneGraph()->getNodes();
 		std::vector<std::shared_ptr<Node>>::iterator it;
 		unsigned int i = 0;
 
@@ -15,7 +15,7 @@ namespace Razor {
 		Outliner(Editor* editor);
 		~Outliner();
 
-		void drawNode(std::shared_ptr<Node> node, unsigned int index, unsigned int depth);
+		void drawNode(const std::shared_ptr<Node>& node, unsigned int index, unsigned int depth);
 		void render(float delta) override;
 		void onEvent(Event& event) override;
 
@@ -73,7 +73,8 @@ namespace Razor
 				//ImGui::DragFloat2("Coords", &ForwardRenderer::geo_coords[0]);
 				//ImGui::DragFloat2("Offset", &ForwardRenderer::geo_offset[0]);
 
-				ImGui::InputText("##name", &selected->name[0u], selected->name.size() + 128);
+				if (ImGui::InputText("##name", &selected->name[0u], selected->name.size() + 128))
+					editor->getEngine()->getScenesManager()->getActiveScene()->getSceneGraph()->renameNode(selected.get(), selected->name);
 				ImGui::PopItemWidth();
 
 				ImGui::Dummy(ImVec2(0.0f, 5.0f));
@@ -158,8 +159,11 @@ namespace Razor
 						ImGui::TextColored(ImColor(255, 255, 255, 128), "Position");
 						ImGui::NextColumn();
 
+						glm::vec3 position = selected->transform.getPosition();
+
 						ImGui::PushItemWidth(-1.0f);
-						ImGui::DragFloat3("##position", &selected->transform.getPosition()[0], 0.01f);
+						if (ImGui::DragFloat3("##position", &position[0], 0.01f))
+							selected->transform.setPosition(position);
 						ImGui::PopItemWidth();
 
 						if (ImGui::IsItemActive() && selected->meshes.size() > 0)
@@ -170,8 +174,11 @@ namespace Razor
 						ImGui::TextColored(ImColor(255, 255, 255, 128), "Rotation");
 						ImGui::NextColumn();
 
+						glm::vec3 rotation = selected->transform.getRotation();
+
 						ImGui::PushItemWidth(-1.0f);
-						ImGui::DragFloat3("##rotation", &selected->transform.getRotation()[0], 0.01f);
+						if (ImGui::DragFloat3("##rotation", &rotation[0], 0.01f))
+							selected->transform.setRotation(rotation);
 						ImGui::PopItemWidth();
 
 						if (ImGui::IsItemActive() && selected->meshes.size() > 0)
@@ -182,8 +189,11 @@ namespace Razor
 						ImGui::TextColored(ImColor(255, 255, 255, 128), "Scale");
 						ImGui::NextColumn();
 
+						glm::vec3 scale = selected->transform.getScale();
+
 						ImGui::PushItemWidth(-1.0f);
-						ImGui::DragFloat3("##scale", &selected->transform.getScale()[0], 0.01f, 0.001f, 99999999999999.0f);
+						if (ImGui::DragFloat3("##scale", &scale[0], 0.01f, 0.001f, 99999999999999.0f))
+							selected->transform.setScale(scale);
 						ImGui::PopItemWidth();
 
 						if (ImGui::IsItemActive() && selected->meshes.size() > 0)
@@ -618,8 +628,8 @@ namespace Razor
 										if (ImGui::IsItemClicked())
 										{
 											selected->meshes[0]->getMaterial()->removeTextureMap(Material::TextureType::Diffuse);
-											selected->meshes[0]->getMaterial()->setDiffusePath("Not set");
 											AssetsManager::texturesManager->removeTexture(selected->meshes[0]->getMaterial()->getDiffusePath());
+											selected->meshes[0]->getMaterial()->setDiffusePath("Not set");
 										}
 
 										ImGui::NextColumn();
@@ -696,8 +706,8 @@ namespace Razor
 										if (ImGui::IsItemClicked())
 										{
 											selected->meshes[0]->getMaterial()->removeTextureMap(Material::TextureType::Specular);
-											selected->meshes[0]->getMaterial()->setSpecularPath("Not set");
 											AssetsManager::texturesManager->removeTexture(selected->meshes[0]->getMaterial()->getSpecularPath());
+											selected->meshes[0]->getMaterial()->setSpecularPath("Not set");
 										}
 
 										ImGui::NextColumn();
@@ -807,8 +817,8 @@ namespace Razor
 										if (ImGui::IsItemClicked())
 										{
 											selected->meshes[0]->getMaterial()->removeTextureMap(Material::TextureType::Normal);
-											selected->meshes[0]->getMaterial()->setNormalPath("Not set");
 											AssetsManager::texturesManager->removeTexture(selected->meshes[0]->getMaterial()->getNormalPath());
+											selected->meshes[0]->getMaterial()->setNormalPath("Not set");
 										}
 
 										ImGui::NextColumn();
@@ -278,7 +278,7 @@ namespace Razor
 
 				if (ImGui::IsItemClicked())
 				{
-					std::shared_ptr<Node> node = std::make_shared<Node>();
+					std::shared_ptr<Node> node = Node::create();
 					node->name = "Cube_x";
 					std::shared_ptr<Cube> cube = std::make_shared<Cube>(cube_parameters.radius);
 					std::shared_ptr<PhongMaterial> mat = std::make_shared<PhongMaterial>();
@@ -362,7 +362,7 @@ namespace Razor
 
 				if (ImGui::IsItemClicked())
 				{
-					std::shared_ptr<Node> node = std::make_shared<Node>();
+					std::shared_ptr<Node> node = Node::create();
 					node->name = "Cube_x";
 					std::shared_ptr<Cube> cube = std::make_shared<Cube>(cube_parameters.radius);
 					std::shared_ptr<PbrMaterial> mat = std::make_shared<PbrMaterial>();
@@ -460,7 +460,7 @@ namespace Razor
 
 				if (ImGui::IsItemClicked())
 				{
-					std::shared_ptr<Node> node = std::make_shared<Node>();
+					std::shared_ptr<Node> node = Node::create();
 					node->name = "UVSphere";
 					std::shared_ptr<UVSphere> uvsphere = std::make_shared<UVSphere>(UVsphere_parameters.radius, UVsphere_parameters.segments);
 
@@ -550,7 +550,7 @@ namespace Razor
 
 				if (ImGui::IsItemClicked())
 				{
-					std::shared_ptr<Node> node = std::make_shared<Node>();
+					std::shared_ptr<Node> node = Node::create();
 					node->name = "Plane";
 					std::shared_ptr<Plane> plane = std::make_shared<Plane>(plane_parameters.radius);
 
@@ -625,7 +625,7 @@ namespace Razor
 
 				if (ImGui::IsItemClicked())
 				{
-					std::shared_ptr<Node> node = std::make_shared<Node>();
+					std::shared_ptr<Node> node = Node::create();
 					node->name = "Directional light";
 					std::shared_ptr<Directional> directional = std::make_shared<Directional>(editor->getEngine()->getScenesManager()->getActiveScene()->getActiveCamera());
 
@@ -687,7 +687,7 @@ namespace Razor
 
 				if (ImGui::IsItemClicked())
 				{
-					std::shared_ptr<Node> node = std::make_shared<Node>();
+					std::shared_ptr<Node> node = Node::create();
 					node->name = "Point light";
 					std::shared_ptr<Point> point = std::make_shared<Point>(editor->getEngine()->getScenesManager()->getActiveScene()->getActiveCamera());
 
@@ -755,7 +755,7 @@ namespace Razor
 
 				if (ImGui::IsItemClicked())
 				{
-					std::shared_ptr<Node> node = std::make_shared<Node>();
+					std::shared_ptr<Node> node = Node::create();
 					node->name = "Spot light";
 					std::shared_ptr<Spot> spot = std::make_shared<Spot>(editor->getEngine()->getScenesManager()->getActiveScene()->getActiveCamera());
 
@@ -166,35 +166,42 @@ namespace Razor
 				float offset = tools->isPanelVisible() ? tools->getSize().x : 0.0f;
 				glm::vec2 vp_size = glm::vec2(vp->getSize().x - 3.0f, vp->getSize().y);
 
+				glm::vec2 mouse = glm::vec2(mouse_pos.x - offset - 3.0f, mouse_pos.y - 53.0f);
+				Camera* camera = scene->getActiveCamera();
+
 				World::RaycastResult result = World::RaycastResult();
-				m_Engine->getPhysicsWorld()->raycast(&result, scene->getActiveCamera(), glm::vec2(mouse_pos.x - offset - 3.0f, mouse_pos.y - 53.0f), vp_size, 1000);
+				m_Engine->getPhysicsWorld()->raycast(&result, camera, mouse, vp_size, 1000);
+
+				std::shared_ptr<Node> node = nullptr;
 
 				if (result.hit)
+					node = scene->getSceneGraph()->getNodeById(result.node->id);
+				else
 				{
-					std::shared_ptr<Node> node = scene->getSceneGraph()->getNodeById(result.node->id);
+					// Nodes without a physics body, picked by their bounds
+					glm::vec3 direction = World::getRayDirection(camera, mouse, vp_size);
+					node = scene->getSceneGraph()->raycast(camera->getPosition(), direction, 1000.0f);
+				}
 
-					if (node != nullptr)
+				if (node != nullptr)
+				{
+					if (Input::IsKeyPressed(RZ_KEY_LEFT_SHIFT))
 					{
-						if (Input::IsKeyPressed(RZ_KEY_LEFT_SHIFT))
-						{
-							if (selection->isSelected(node))
-								selection->removeNode(node->id);
-							else
-								selection->addNode(node);
-						}
+						if (selection->isSelected(node))
+							selection->removeNode(node->id);
+						else
+							selection->addNode(node);
+					}
+					else
+					{
+						if (selection->isSelected(node))
+							selection->removeNode(node->id);
 						else
 						{
-							if (selection->isSelected(node))
-								selection->removeNode(node->id);
-							else
-							{
-								selection->clear();
-								selection->addNode(node);
-							}
+							selection->clear();
+							selection->addNode(node);
 						}
 					}
-					else
-						Log::trace("%s not found", node->name.c_str());
 				}
 			}
 		}
@@ -206,13 +213,13 @@ namespace Razor
 
 			if (e.GetKeyCode() == RZ_KEY_SPACE && vp->isHovered())
 			{
-				std::shared_ptr<Node> node = std::make_shared<Node>();
+				std::shared_ptr<Node> node = Node::create();
 		/*		AssetsManager::import(node, &Editor::importFinished, Variant("./data/Jeep.fbx"));
 */
 			
-		/*		tasksManager->add({ &mesh1, &AssetsManager::import, &AssetsManager::finished, Variant("data/Lia.fbx"), "Import task 2", 200 });
-				tasksManager->add({ &mesh2, &AssetsManager::import, &AssetsManager::finished, Variant("house_wood_3.fbx"), "Import task 3", 23 });
-				tasksManager->add({ &mesh3, &AssetsManager::import, &AssetsManager::finished, Variant("house_wood_4.fbx"), "Import task 4", 74 });*/
+		/*		jobSystem->add({ &mesh1, &AssetsManager::import, &AssetsManager::finished, Variant("data/Lia.fbx"), "Import task 2", 200 });
+				jobSystem->add({ &mesh2, &AssetsManager::import, &AssetsManager::finished, Variant("house_wood_3.fbx"), "Import task 3", 23 });
+				jobSystem->add({ &mesh3, &AssetsManager::import, &AssetsManager::finished, Variant("house_wood_4.fbx"), "Import task 4", 74 });*/
 			}
 
 			if (e.GetKeyCode() == RZ_KEY_Q && vp->isHovered() && Input::IsKeyPressed(RZ_KEY_LEFT_SHIFT))
@@ -311,7 +318,7 @@ namespace Razor
 					{
 						if (*it != nullptr)
 						{
-							for (auto light : (*it)->lights)
+							for (auto& light : (*it)->lights)
 							{
 								/*ForwardRenderer::billboard_manager->removeBillboard((*it)->id);
 						
@@ -323,7 +330,7 @@ namespace Razor
 							selection->removeNode((*it)->id);
 							m_Engine->getPhysicsWorld()->removeNode((*it));
 
-							for (auto m : (*it)->meshes) 
+							for (auto& m : (*it)->meshes) 
 							{
 								m->getBoundingMesh().reset();
 
@@ -73,7 +73,7 @@ namespace Razor
 
 		if (scene->mRootNode != NULL)
 		{
-			rootNode = std::make_shared<Node>();
+			rootNode = Node::create();
 			auto parts = Utils::splitString(filename, ".");
 			auto pathname = parts[0];
 			auto str = pathname.substr(pathname.find_last_of("/") + 1);
@@ -103,7 +103,7 @@ namespace Razor
 		newNode->name = name;
 		newNode->transform = Transform();
 		newNode->transform.setMatrix(mat);
-		newNode->parent = parentNode;
+		newNode->parent = parentNode.get();
 		newNode->meshes.resize(node->mNumMeshes);
 
 		for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
@@ -114,9 +114,9 @@ namespace Razor
 
 		for (unsigned int i = 0; i < node->mNumChildren; ++i)
 		{ 
-			std::shared_ptr<Node> n = std::make_shared<Node>();
+			std::shared_ptr<Node> n = Node::create();
 			n->name = std::string(node->mName.C_Str());
-			newNode->nodes.push_back(n);
+			newNode->addChild(n);
 			this->processNode(node->mChildren[i], parentNode, newNode->nodes[i]);
 		}
 
@@ -130,7 +130,7 @@ namespace Razor
 	std::shared_ptr<StaticMesh> AssimpImporter::processMesh(aiMesh* object)
 	{
 		std::string name = object->mName.length != 0 ? std::string(object->mName.C_Str()) : "child_node";
-		std::shared_ptr<StaticMesh> mesh = std::make_shared<StaticMesh>();
+		std::shared_ptr<StaticMesh> mesh = StaticMesh::create();
 		mesh->setName(name);
 		mesh->setVertexCount(object->mNumVertices);
 		AABB box;
@@ -156,9 +156,10 @@ namespace Razor
 						AssetsManager::texturesManager->addTexture(diffuse_filename, diffuseTexture);
 					}
 					else
-						diffuseTexture = AssetsManager::texturesManager->getTexture(diffuse_filename);
+						diffuseTexture = AssetsManager::texturesManager->acquireTexture(diffuse_filename);
 
 					material->setTextureMap(Material::TextureType::Diffuse, diffuseTexture->getId());
+					material->setDiffusePath(diffuse_filename);
 				}
 			}
 			
@@ -176,9 +177,10 @@ namespace Razor
 						AssetsManager::texturesManager->addTexture(specular_filename, specularTexture);
 					}
 					else
-						specularTexture = AssetsManager::texturesManager->getTexture(specular_filename);
+						specularTexture = AssetsManager::texturesManager->acquireTexture(specular_filename);
 
 					material->setTextureMap(Material::TextureType::Specular, specularTexture->getId());
+					material->setSpecularPath(specular_filename);
 				}
 			}
 
@@ -196,9 +198,10 @@ namespace Razor
 						AssetsManager::texturesManager->addTexture(normal_filename, normalTexture);
 					}
 					else
-						normalTexture = AssetsManager::texturesManager->getTexture(normal_filename);
+						normalTexture = AssetsManager::texturesManager->acquireTexture(normal_filename);
 
 					material->setTextureMap(Material::TextureType::Normal, normalTexture->getId());
+					material->setNormalPath(normal_filename);
 				}
 			}
 
@@ -14,8 +14,8 @@ namespace Razor
 		grid_size(10),
 		axis_size(10)
 	{
-		grid_node = std::make_shared<Node>();
-		axis_node = std::make_shared<Node>();
+		grid_node = Node::create();
+		axis_node = Node::create();
 
 		axis = new Axis(axis_size);
 		grid = std::make_shared<Grid>(grid_size);
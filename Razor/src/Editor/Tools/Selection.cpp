@@ -23,7 +23,7 @@ namespace Razor
 		return false;
 	}
 
-	bool Selection::isSelected(std::shared_ptr<Node> node)
+	bool Selection::isSelected(const std::shared_ptr<Node>& node)
 	{
 		auto it = std::find(nodes.begin(), nodes.end(), node);
 		return it != nodes.end();
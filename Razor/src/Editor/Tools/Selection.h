@@ -15,7 +15,7 @@ namespace Razor
 		inline void addNode(std::shared_ptr<Node> node) { nodes.push_back(node); }
 		inline std::vector<std::shared_ptr<Node>>& getNodes() { return nodes; }
 		bool removeNode(unsigned int id);
-		bool isSelected(std::shared_ptr<Node> node);
+		bool isSelected(const std::shared_ptr<Node>& node);
 
 		inline void clear() {
 			nodes.clear();
@@ -8,8 +8,8 @@
 #include "Razor/Scene/Node.h"
 #include "Razor/Imgui/ImGuiLayer.h"
 #include "Razor/Input/Input.h"
-#include "Razor/Core/TasksManager.h"
-#include "Razor/Core/ThreadPool.h"
+#include "Razor/Core/JobSystem.h"
+#include "Razor/Core/TraceProfiler.h"
 #include "Razor/Types/Variant.h"
 #include "Razor/Types/Array.h"
 #include "Razor/Scene/ScenesManager.h"
@@ -12,8 +12,8 @@ namespace Razor
 		mesh(mesh),
 		current_animation(nullptr),
 		delta(0.0f),
-		time(0.0f)
-
+		time(0.0f),
+		current_pose()
 	{
 	}
 
@@ -30,8 +30,7 @@ namespace Razor
 
 		tick();
 
-		std::map<std::string, glm::mat4> current_pose = calcCurrentAnimationPose();
-		applyPoseToBone(current_pose, mesh->getRootBone(), glm::mat4(1.0f));
+		applyPoseToBone(calcCurrentAnimationPose(), mesh->getRootBone(), glm::mat4(1.0f));
 	}
 
 	void AnimationManager::tick()
@@ -46,51 +45,52 @@ namespace Razor
 	{
 		time = 0.0f;
 		current_animation = animation;
+		current_pose.clear();
 	}
 
-	std::map<std::string, glm::mat4> AnimationManager::calcCurrentAnimationPose()
+	const std::map<std::string, glm::mat4>& AnimationManager::calcCurrentAnimationPose()
 	{
-		std::vector<Keyframe> frames = getPreviousAndNextFrames();
-		float progress = calculateProgress(frames[0], frames[1]);
+		std::pair<Keyframe*, Keyframe*> frames = getPreviousAndNextFrames();
+		float progress = calculateProgress(*frames.first, *frames.second);
+
+		interpolatePoses(*frames.first, *frames.second, progress);
 
-		return interpolatePoses(frames[0], frames[1], progress);
+		return current_pose;
 	}
 
-	void AnimationManager::applyPoseToBone(const std::map<std::string, glm::mat4>& current_pose, std::shared_ptr<Bone> bone, glm::mat4 parent_transform)
+	void AnimationManager::applyPoseToBone(const std::map<std::string, glm::mat4>& current_pose, const std::shared_ptr<Bone>& bone, const glm::mat4& parent_transform)
 	{
-		glm::mat4 current_local_transform = current_pose.at(bone->getName());
+		const glm::mat4& current_local_transform = current_pose.at(bone->getName());
 		glm::mat4 current_transform = parent_transform * current_local_transform;
 
-		for (auto child : bone->getChildren())
+		for (const auto& child : bone->getChildren())
 			applyPoseToBone(current_pose, child, current_transform);
 
 		current_transform *= bone->getInverseTransform();
 		bone->setAnimatedTransform(current_transform);
 	}
 
-	std::vector<Keyframe> AnimationManager::getPreviousAndNextFrames()
+	std::pair<Keyframe*, Keyframe*> AnimationManager::getPreviousAndNextFrames()
 	{
-		std::vector<Keyframe> frames = current_animation->getKeyframes();
+		std::vector<Keyframe>& frames = current_animation->getKeyframes();
 
-		Keyframe previous = frames[0];
-		Keyframe next = frames[0];
+		Keyframe* previous = &frames[0];
+		Keyframe* next = &frames[0];
 
-		for (int i = 1; i < frames.size(); i++)
+		for (size_t i = 1; i < frames.size(); i++)
 		{
-			next = frames[i];
+			next = &frames[i];
 
-			if (next.getTimestamp() > time)
+			if (next->getTimestamp() > time)
 				break;
 
-			previous = frames[i];
+			previous = &frames[i];
 		}
 
-		std::vector<Keyframe> f = { previous, next };
-
-		return f;
+		return { previous, next };
 	}
 
-	float AnimationManager::calculateProgress(Keyframe previous, Keyframe next)
+	float AnimationManager::calculateProgress(const Keyframe& previous, const Keyframe& next)
 	{
 		float total = next.getTimestamp() - previous.getTimestamp();
 		float current = time - previous.getTimestamp();
@@ -98,22 +98,18 @@ namespace Razor
 		return current / total;
 	}
 
-	std::map<std::string, glm::mat4> AnimationManager::interpolatePoses(Keyframe previous, Keyframe next, float progress)
+	void AnimationManager::interpolatePoses(const Keyframe& previous, const Keyframe& next, float progress)
 	{
-		std::map<std::string, glm::mat4> currentPose;
-		std::map<std::string, BoneTransform*>::iterator it;
-		std::map<std::string, BoneTransform*> keyframes = previous.getPose();
+		const std::map<std::string, BoneTransform*>& keyframes = previous.getPose();
+		const std::map<std::string, BoneTransform*>& next_keyframes = next.getPose();
 
-		for (it = keyframes.begin(); it != keyframes.end(); it++)
+		for (auto it = keyframes.begin(); it != keyframes.end(); it++)
 		{
-			BoneTransform* previousTransform = keyframes.at(it->first);
-			BoneTransform* nextTransform = next.getPose().at(it->first);
-			BoneTransform* currentTransform = BoneTransform::interpolate(previousTransform, nextTransform, progress);
+			BoneTransform current_transform = BoneTransform::interpolate(*it->second, *next_keyframes.at(it->first), progress);
 
-			currentPose[it->first] = currentTransform->getLocaltransform();
+			// Only the first update of an animation inserts, afterwards the nodes are reused
+			current_pose[it->first] = current_transform.getLocaltransform();
 		}
-
-		return currentPose;
 	}
 
 }
\ No newline at end of file
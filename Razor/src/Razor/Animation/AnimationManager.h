@@ -16,17 +16,20 @@ namespace Razor
 		void update(float dt);
 		void tick();
 		void playAnimation(Animation* animation);
-		std::map<std::string, glm::mat4> calcCurrentAnimationPose();
-		void applyPoseToBone(const std::map<std::string, glm::mat4>& current_pose, std::shared_ptr<Bone> bone, glm::mat4 parent_transform);
-		std::vector<Keyframe> getPreviousAndNextFrames();
-		float calculateProgress(Keyframe previous, Keyframe next);
-		std::map<std::string, glm::mat4> interpolatePoses(Keyframe previous, Keyframe next, float progress);
+		const std::map<std::string, glm::mat4>& calcCurrentAnimationPose();
+		void applyPoseToBone(const std::map<std::string, glm::mat4>& current_pose, const std::shared_ptr<Bone>& bone, const glm::mat4& parent_transform);
+		std::pair<Keyframe*, Keyframe*> getPreviousAndNextFrames();
+		float calculateProgress(const Keyframe& previous, const Keyframe& next);
+		void interpolatePoses(const Keyframe& previous, const Keyframe& next, float progress);
 
 	private:
 		SkeletalMesh* mesh;
 		Animation* current_animation;
 		float delta;
 		float time;
+
+		// Reused every update, the bone set of an animation does not change
+		std::map<std::string, glm::mat4> current_pose;
 	};
 
 }
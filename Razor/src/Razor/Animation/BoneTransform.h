@@ -20,12 +20,12 @@ namespace Razor
 			return matrix * glm::toMat4(rotation);
 		}
 
-		inline static BoneTransform* BoneTransform::interpolate(BoneTransform* a, BoneTransform* b, float time)
+		inline static BoneTransform interpolate(const BoneTransform& a, const BoneTransform& b, float time)
 		{
-			glm::vec3 pos = Utils::lerp(a->position, b->position, time);
-			glm::quat rot = glm::slerp(a->rotation, b->rotation, time);
+			glm::vec3 pos = Utils::lerp(a.position, b.position, time);
+			glm::quat rot = glm::slerp(a.rotation, b.rotation, time);
 
-			return new BoneTransform(pos, rot);
+			return BoneTransform(pos, rot);
 		}
 
 	private:
@@ -10,8 +10,8 @@ namespace Razor
 		Keyframe(float timestamp, std::map<std::string, BoneTransform*> keyframes);
 		~Keyframe();
 
-		inline float& getTimestamp() { return timestamp; }
-		inline std::map<std::string, BoneTransform*> getPose() { return pose; }
+		inline float getTimestamp() const { return timestamp; }
+		inline const std::map<std::string, BoneTransform*>& getPose() const { return pose; }
 
 		inline void setTimestamp(float value) { timestamp = value; }
 		inline void setPose(std::map<std::string, BoneTransform*> keyframes) { this->pose = keyframes; }
@@ -2,15 +2,22 @@
 
 #ifdef RZ_PLATFORM_WINDOWS
 
+#include "Razor/Memory/MemoryHooks.h"
+
 extern Razor::Application* Razor::createApplication();
 
 int main(int argc, char** argv)
 {
 	Razor::Log::init();
+	Razor::TraceProfiler::parseCommandLine(argc, argv);
 
 	auto app = Razor::createApplication();
 	app->run();
 	delete app;
+
+	Razor::TraceProfiler::shutdown();
+	Razor::MemoryTracker::reportLeaks();
+	Razor::Log::shutdown();
 }
 
 #endif
\ No newline at end of file
@@ -13,12 +13,14 @@ namespace Razor
 		state(State::INITIAL),
 		looping(false),
 		gain(1.0f),
+		occlusion(1.0f),
 		gain_min(1.0f),
 		gain_max(1.0f),
 		pitch(1.0f),
 		inner_angle(360.0f),
 		outer_angle(1.0f),
 		position(glm::vec3(0.0f)),
+		positional(false),
 		direction(glm::vec3(0.0f)),
 		velocity(glm::vec3(0.0f)),
 		is_audio_stream(false)
@@ -97,7 +99,16 @@ namespace Razor
 	void Sound::setGain(float value)
 	{
 		gain = value;
-		alSourcef(audio_data->source_id, AL_GAIN, gain);
+		alSourcef(audio_data->source_id, AL_GAIN, gain * occlusion);
+	}
+
+	void Sound::setOcclusion(float value)
+	{
+		if (value == occlusion)
+			return;
+
+		occlusion = value;
+		alSourcef(audio_data->source_id, AL_GAIN, gain * occlusion);
 	}
 
 	void Sound::setGainMin(float value)
@@ -133,6 +144,7 @@ namespace Razor
 	void Sound::setPosition(const glm::vec3& position)
 	{
 		this->position = position;
+		positional = true;
 		alSource3f(audio_data->source_id, AL_POSITION, position.x, position.y, position.z);
 	}
 
@@ -40,12 +40,15 @@ namespace Razor
 		inline bool isLooping() { return looping; }
 		bool isPlaying();
 		inline float& getGain() { return gain; }
+		inline float getOcclusion() const { return occlusion; }
 		inline float& getGainMin() { return gain_min; }
 		inline float& getGainMax() { return gain_max; }
 		inline float& getPitch() { return pitch; }
 		inline float& getInnerAngle() { return inner_angle; }
 		inline float& getOuterAngle() { return outer_angle; }
 		inline glm::vec3& getPosition() { return position; }
+		// Placed in the world with setPosition(), music and UI sounds are not
+		inline bool isPositional() const { return positional; }
 		inline glm::vec3& getDirection() { return direction; }
 		inline glm::vec3& getVelocity() { return velocity; }
 
@@ -53,6 +56,9 @@ namespace Razor
 		inline void setState(State state) { this->state = state; }
 		void setIsLooping(bool value);
 		void setGain(float value);
+		// Attenuation from the geometry between the sound and the listener,
+		// applied on top of the gain
+		void setOcclusion(float value);
 		void setGainMin(float value);
 		void setGainMax(float value);
 		void setPitch(float value);
@@ -72,12 +78,14 @@ namespace Razor
 		State state;
 		bool looping;
 		float gain;
+		float occlusion;
 		float gain_min;
 		float gain_max;
 		float pitch;
 		float inner_angle;
 		float outer_angle;
 		glm::vec3 position;
+		bool positional;
 		glm::vec3 direction;
 		glm::vec3 velocity;
 	};
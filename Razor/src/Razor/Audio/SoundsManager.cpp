@@ -1,9 +1,13 @@
 #include "rzpch.h"
 #include "SoundsManager.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Core/JobSystem.h"
+#include "Razor/Memory/MemoryTracker.h"
 
 #include "Razor/Audio/Sound.h"
 #include "Razor/Audio/Loaders/WAVLoader.h"
 #include "Razor/Audio/Loaders/OGGLoader.h"
+#include "Razor/Scene/SceneGraph.h"
 
 namespace Razor
 {
@@ -15,6 +19,7 @@ namespace Razor
 		ogg_loader(nullptr),
 		distance_model(DistanceModel::LINEAR),
 		sounds({}),
+		occluders({}),
 		device_infos(DeviceInfo())
 	{
 		wav_loader = new WAVLoader();
@@ -53,6 +58,8 @@ namespace Razor
 
 	void SoundsManager::loadSound(const std::string& filename, const std::string& short_name)
 	{
+		MemoryTagScope memory(MemoryTag::Audio);
+		static Counter& s_loaded = Metrics::counter("audio.sounds_loaded", "Sounds decoded");
 		auto item = sounds.find(short_name);
 
 		if (item == sounds.end())
@@ -67,6 +74,7 @@ namespace Razor
 
 				Sound* sound = new Sound(short_name, wav_data);
 				sounds[short_name] = sound;
+				s_loaded.add();
 			}
 			else if (ext == "ogg")
 			{
@@ -75,16 +83,73 @@ namespace Razor
 
 				Sound* sound = new Sound(short_name, ogg_data);
 				sounds[short_name] = sound;
+				s_loaded.add();
 			}
 		}
 	}
 
 	void SoundsManager::playSound(const std::string& short_name)
 	{
+		static Counter& s_played = Metrics::counter("audio.sounds_played", "Sounds started");
 		auto it = sounds.find(short_name);
 
 		if (it != sounds.end())
+		{
 			it->second->play();
+			s_played.add();
+		}
+	}
+
+	void SoundsManager::updateOcclusion(SceneGraph* graph, const glm::vec3& listener)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		occlusions.clear();
+
+		for (auto& it : sounds)
+		{
+			Sound* sound = it.second;
+
+			// Whether it plays is asked to OpenAL, the stopped ones are updated too
+			if (!sound->isPositional())
+				continue;
+
+			const glm::vec3& position = sound->getPosition();
+			glm::vec3 offset = position - listener;
+			float distance = glm::length(offset);
+			int blockers = 0;
+
+			if (distance > 0.0f)
+			{
+				occluders.clear();
+				graph->queryRay(listener, offset / distance, distance, occluders);
+
+				// Bounds around either end are the emitter itself or what the listener stands in
+				for (NodeHandle handle : occluders)
+				{
+					std::shared_ptr<Node> node = graph->getNode(handle);
+
+					if (node == nullptr)
+						continue;
+
+					AABB box = SceneGraph::getWorldBounds(node.get());
+
+					if (!box.contains(listener) && !box.contains(position) && ++blockers == SOUND_OCCLUSION_MAX_OCCLUDERS)
+						break;
+				}
+			}
+
+			occlusions.push_back({ sound, powf(SOUND_OCCLUSION_GAIN, (float)blockers) });
+		}
+
+		if (occlusions.empty())
+			return;
+
+		JobSystem::get().runOnMainThread([occlusions = occlusions]()
+		{
+			for (auto& occlusion : occlusions)
+				occlusion.first->setOcclusion(occlusion.second);
+		});
 	}
 
 }
@@ -3,12 +3,19 @@
 #include <AL/al.h>
 #include <AL/alc.h>
 
+#include "Razor/Scene/Node.h"
+
+// Gain kept per occluder between a positional sound and the listener
+#define SOUND_OCCLUSION_GAIN 0.5f
+#define SOUND_OCCLUSION_MAX_OCCLUDERS 4
+
 namespace Razor
 {
 
 	class Sound;
 	class WAVLoader;
 	class OGGLoader;
+	class SceneGraph;
 
 	class SoundsManager
 	{
@@ -37,6 +44,10 @@ namespace Razor
 		void playSound(const std::string& short_name);
 		void setSound(const std::string& short_name, Sound* sound) { sounds[short_name] = sound; }
 		bool hasSound(const std::string& short_name) { return sounds.find(short_name) != sounds.end(); }
+		// Muffles the positional sounds by the scene bounds crossed on the way
+		// to the listener. Queries the graph on the calling thread, the gains
+		// are set by the main thread.
+		void updateOcclusion(SceneGraph* graph, const glm::vec3& listener);
 
 		inline DeviceInfo& getDeviceInfos() { return device_infos; }
 
@@ -61,6 +72,8 @@ namespace Razor
 		WAVLoader* wav_loader;
 		OGGLoader* ogg_loader;
 		std::map<std::string, Sound*> sounds;
+		std::vector<NodeHandle> occluders;
+		std::vector<std::pair<Sound*, float>> occlusions;
 
 		DeviceInfo device_infos;
 	};
@@ -2,6 +2,7 @@
 #include "Razor/Core/Engine.h"
 #include "FrameBuffer.h"
 #include "RenderBuffer.h"
+#include "Razor/Rendering/RenderState.h"
 #include <glad/glad.h>
 
 namespace Razor {
@@ -14,6 +15,7 @@ namespace Razor {
 	FrameBuffer::~FrameBuffer()
 	{
 		glDeleteFramebuffers(1, &id);
+		RenderState::releaseFramebuffer(id);
 
 		for (auto texture : texturesAttachments)
 			delete texture;
@@ -31,12 +33,12 @@ namespace Razor {
 
 	void FrameBuffer::bind(BindMode mode, int buffer_id) const
 	{
-		glBindFramebuffer(mode, buffer_id);
+		RenderState::bindFramebuffer(mode, buffer_id);
 	}
 
 	void FrameBuffer::unbind() const
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 	TextureAttachment* FrameBuffer::addTextureAttachment(const glm::vec2& size, bool depth, bool transparent, int slot)
@@ -4,6 +4,7 @@
 #include "FrameBuffer.h"
 #include "RenderBuffer.h"
 #include "TextureAttachment.h"
+#include "Razor/Rendering/RenderState.h"
 
 namespace Razor
 {
@@ -20,11 +21,11 @@ namespace Razor
 	{
 		// Main frame buffer
 		glGenFramebuffers(1, &buffer);
-		glBindFramebuffer(GL_FRAMEBUFFER, buffer);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, buffer);
 
 		// position color buffer
 		glGenTextures(1, &position);
-		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, position);
+		RenderState::editTexture(GL_TEXTURE_2D_MULTISAMPLE, position);
 		glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, 0, GL_RGB16F, size.x, size.y, GL_TRUE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -32,7 +33,7 @@ namespace Razor
 
 		// normal color buffer
 		glGenTextures(1, &normal);
-		glBindTexture(GL_TEXTURE_2D, normal);
+		RenderState::editTexture(GL_TEXTURE_2D, normal);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, size.x, size.y, 0, GL_RGB, GL_FLOAT, NULL);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -40,7 +41,7 @@ namespace Razor
 
 		// color + specular color buffer
 		glGenTextures(1, &color);
-		glBindTexture(GL_TEXTURE_2D, color);
+		RenderState::editTexture(GL_TEXTURE_2D, color);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -54,21 +55,21 @@ namespace Razor
 		glDrawBuffers(3, attachments);
 
 		glGenRenderbuffers(1, &depth);
-		glBindRenderbuffer(GL_RENDERBUFFER, depth);
+		RenderState::bindRenderbuffer(depth);
 		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32, size.x, size.y);
 		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
 
 		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
 			std::cout << "Framebuffer not complete!" << std::endl;
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		// Combined frame buffer
 		glGenFramebuffers(1, &frame);
-		glBindFramebuffer(GL_FRAMEBUFFER, frame);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, frame);
 
 		glGenRenderbuffers(1, &frame_depth);
-		glBindRenderbuffer(GL_RENDERBUFFER, frame_depth);
+		RenderState::bindRenderbuffer(frame_depth);
 		glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_DEPTH_COMPONENT32, size.x, size.y);
 		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, frame_depth);
 
@@ -77,13 +78,13 @@ namespace Razor
 
 		// combined passes
 		glGenTextures(1, &combined);
-		glBindTexture(GL_TEXTURE_2D, combined);
+		RenderState::editTexture(GL_TEXTURE_2D, combined);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, size.x, size.y, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, combined, 0);
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 	GBuffer::~GBuffer()
@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "IndexBuffer.h"
+#include "Razor/Rendering/RenderState.h"
 #include "glad/glad.h"
 
 namespace Razor {
@@ -7,23 +8,24 @@ namespace Razor {
 	IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count) : count(count)
 	{
 		glGenBuffers(1, &id);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+		RenderState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW);
 	}
 
 	IndexBuffer::~IndexBuffer()
 	{
 		glDeleteBuffers(1, &id);
+		RenderState::releaseBuffer(id);
 	}
 
 	void IndexBuffer::bind() const
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+		RenderState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
 	}
 
 	void IndexBuffer::unbind() const
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		RenderState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
 
 }
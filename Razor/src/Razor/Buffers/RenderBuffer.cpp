@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "RenderBuffer.h"
+#include "Razor/Rendering/RenderState.h"
 #include <glad/glad.h>
 
 namespace Razor {
@@ -18,12 +19,12 @@ namespace Razor {
 
 	void RenderBuffer::bind() const 
 	{
-		glBindRenderbuffer(GL_RENDERBUFFER, id);
+		RenderState::bindRenderbuffer(id);
 	}
 
 	void RenderBuffer::unbind() const
 	{
-		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		RenderState::bindRenderbuffer(0);
 	};
 }
 
@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "TextureAttachment.h"
+#include "Razor/Rendering/RenderState.h"
 #include <glad/glad.h>
 
 namespace Razor {
@@ -45,17 +46,17 @@ namespace Razor {
 	TextureAttachment::~TextureAttachment()
 	{
 		glDeleteTextures(1, &id);
+		RenderState::releaseTexture(id);
 	}
 
 	void TextureAttachment::bind(int slot) const
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_2D, id);
+		RenderState::bindTexture(slot, GL_TEXTURE_2D, id);
 	}
 
 	void TextureAttachment::unbind() const
 	{
-		glBindTexture(GL_TEXTURE_2D, 0);
+		RenderState::editTexture(GL_TEXTURE_2D, 0);
 	}
 
 	void TextureAttachment::resize(const glm::vec2& new_size)
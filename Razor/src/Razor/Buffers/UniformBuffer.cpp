@@ -1,45 +1,66 @@
 #include "rzpch.h"
 #include "UniformBuffer.h"
+#include "Razor/Rendering/RenderState.h"
 #include <glad/glad.h>
-#include <glm/glm.hpp>
 
 namespace Razor {
 
-	struct ShaderData {
-		std::vector<glm::vec3> cameras_positions;
-		std::vector<glm::vec3> lights_positions;
-	};
-
-	UniformBuffer::UniformBuffer(const void* data)
+	UniformBuffer::UniformBuffer(Type type, uint32 binding, size_t capacity) :
+		type(type),
+		binding(binding),
+		capacity(std::max<size_t>(capacity, 16))
 	{
 		glGenBuffers(1, &id);
-		bind();
-		glBufferData(GL_UNIFORM_BUFFER, sizeof(data), &data, GL_DYNAMIC_COPY);
+		RenderState::bindBuffer((GLenum)type, id);
+		glBufferData((GLenum)type, this->capacity, nullptr, GL_DYNAMIC_DRAW);
 	}
 
 	UniformBuffer::~UniformBuffer()
 	{
 		glDeleteBuffers(1, &id);
+		RenderState::releaseBuffer(id);
 	}
 
-	void UniformBuffer::link(unsigned int program)
+	void UniformBuffer::update(const void* data, size_t size)
 	{
-		unsigned int block_index = glGetUniformBlockIndex(program, "shader_data");
-	}
+		if (size == 0)
+			return;
 
-	void UniformBuffer::update(const void* data)
-	{
-		bind();
+		RenderState::bindBuffer((GLenum)type, id);
+
+		if (size > capacity)
+		{
+			capacity = std::max(size, capacity * 2);
+			glBufferData((GLenum)type, capacity, nullptr, GL_DYNAMIC_DRAW);
+		}
+
+		glBufferSubData((GLenum)type, 0, size, data);
 	}
 
 	void UniformBuffer::bind() const
 	{
-		glBindBuffer(GL_UNIFORM_BUFFER, id);
+		RenderState::bindBufferBase((GLenum)type, binding, id);
 	}
 
 	void UniformBuffer::unbind() const
 	{
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		RenderState::bindBufferBase((GLenum)type, binding, 0);
+	}
+
+	int32 UniformBuffer::findBinding(const char* block)
+	{
+		static const std::pair<const char*, int32> s_bindings[] = {
+			{ "Camera", UNIFORM_BINDING_CAMERA },
+			{ "PointLights", STORAGE_BINDING_POINT_LIGHTS }
+		};
+
+		for (auto& binding : s_bindings)
+		{
+			if (strcmp(binding.first, block) == 0)
+				return binding.second;
+		}
+
+		return -1;
 	}
 
 }
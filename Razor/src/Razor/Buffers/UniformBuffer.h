@@ -1,20 +1,44 @@
 #pragma once
 
+#include "Razor/Core/Core.h"
+
+// Binding points of the blocks shared by the engine shaders, matched by block name
+#define UNIFORM_BINDING_CAMERA 0
+#define STORAGE_BINDING_POINT_LIGHTS 0
+
 namespace Razor {
 
+	// Data of a uniform (UBO) or shader storage (SSBO) block, uploaded whole
+	// once per frame and bound to a fixed binding point every program shares
 	class UniformBuffer
 	{
 	public:
-		UniformBuffer(const void* data);
+		enum class Type
+		{
+			UNIFORM = 0x8A11,
+			STORAGE = 0x90D2
+		};
+
+		UniformBuffer(Type type, uint32 binding, size_t capacity);
 		~UniformBuffer();
 
-		void link(unsigned int program);
-		void update(const void* data);
+		// A single glBufferSubData, the storage is only reallocated to grow
+		void update(const void* data, size_t size);
 		void bind() const;
 		void unbind() const;
 
+		inline uint32 getId() const { return id; }
+		inline uint32 getBinding() const { return binding; }
+		inline size_t getCapacity() const { return capacity; }
+
+		// Binding point of a block name known to the engine, -1 otherwise
+		static int32 findBinding(const char* block);
+
 	private:
 		unsigned int id;
+		Type type;
+		uint32 binding;
+		size_t capacity;
 	};
 
 }
@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "VertexArray.h"
+#include "Razor/Rendering/RenderState.h"
 #include <glad/glad.h>
 
 namespace Razor {
@@ -12,6 +13,7 @@ namespace Razor {
 	VertexArray::~VertexArray()
 	{
 		glDeleteVertexArrays(1, &id);
+		RenderState::releaseVertexArray(id);
 	}
 
 	void VertexArray::addBuffer(
@@ -32,12 +34,12 @@ namespace Razor {
 
 	void VertexArray::bind() const
 	{
-		glBindVertexArray(id);
+		RenderState::bindVertexArray(id);
 	}
 
 	void VertexArray::unbind() const
 	{
-		glBindVertexArray(0);
+		RenderState::bindVertexArray(0);
 	}
 
 }
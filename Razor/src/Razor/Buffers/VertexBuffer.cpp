@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "VertexBuffer.h"
+#include "Razor/Rendering/RenderState.h"
 #include "glad/glad.h"
 
 namespace Razor {
@@ -15,16 +16,17 @@ namespace Razor {
 	VertexBuffer::~VertexBuffer()
 	{
 		glDeleteBuffers(1, &id);
+		RenderState::releaseBuffer(id);
 	}
 
 	void VertexBuffer::bind() const
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, id);
+		RenderState::bindBuffer(GL_ARRAY_BUFFER, id);
 	}
 
 	void VertexBuffer::unbind() const
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		RenderState::bindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
 	void VertexBuffer::update(unsigned int size, const void* data)
@@ -13,6 +13,9 @@ namespace Razor
 	class Viewport;
 	class Application;
 
+	// Input is polled and the window events handled on the main thread,
+	// update() moves the camera on the update thread. Both sides hold
+	// input_mutex, only update() writes the matrices and the position.
 	class Camera
 	{
 	public:
@@ -74,6 +77,7 @@ namespace Razor
 		inline float& getClipFar() { return clip_far; }
 		inline float& getAspectRatio() { return aspect_ratio; }
 
+		// Main thread, polls the keys held down for the next updates
 		virtual void onEvent(Window* window) {}
 		virtual void onKeyPressed(Direction direction) {}
 		virtual void onKeyDown(int keyCode) {}
@@ -119,6 +123,8 @@ namespace Razor
 		float speed_factor;
 		float min_speed;
 		float max_speed;
+
+		std::mutex input_mutex;
 	};
 
 }
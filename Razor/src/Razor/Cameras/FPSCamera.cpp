@@ -17,7 +17,8 @@ namespace Razor
 		move_friction(10.0f),
 		mouse(glm::vec2()),
 		mouse_offset(glm::vec2()),
-		constrain_pitch(true)
+		constrain_pitch(true),
+		moving()
 	{
 		projection = glm::perspective(glm::radians(fov), window->GetWidth() / window->GetHeight(), clip_near, clip_far);
 		updateVectors();
@@ -42,12 +43,38 @@ namespace Razor
 
 	void FPSCamera::update(double dt)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		delta = (float)dt;
+
+		updateVectors();
+
+		for (size_t i = 0; i < moving.size(); i++)
+			if (moving[i])
+				onKeyPressed((Direction)i);
+
+		switch (mode) {
+			case Mode::ORTHOGRAPHIC:
+				projection = glm::ortho(1.5f * aspect_ratio, -1.5f * aspect_ratio, 1.5f, -1.5f, -100.0f, 100.0f);
+				break;
+
+			case Mode::PERSPECTIVE:
+				projection = glm::perspective(glm::radians(fov), aspect_ratio, clip_near, clip_far);
+				break;
+		}
+
+		velocity *= 1.0f / (1.0f + delta * move_friction);
+		position += velocity * delta;
+		
+		view = glm::lookAt(position, position + direction, up);
 	}
 
 	void FPSCamera::onEvent(Window * window)
 	{
 		GLFWwindow* native = (GLFWwindow*)window->GetNativeWindow();
+		std::lock_guard<std::mutex> lock(input_mutex);
+
+		moving.fill(false);
 
 		if (viewport != nullptr) {
 			auto w = window->GetWidth();
@@ -59,9 +86,6 @@ namespace Razor
 				return;
 		}
 
-	
-		updateVectors(); 
-
 		if (glfwGetKey(native, GLFW_KEY_KP_5) == GLFW_PRESS && viewport->isHovered())
 			mode = mode == Camera::Mode::ORTHOGRAPHIC 
 			? Camera::Mode::PERSPECTIVE 
@@ -70,35 +94,20 @@ namespace Razor
 		if (capture)
 		{
 			if (glfwGetKey(native, GLFW_KEY_W) == GLFW_PRESS)
-				onKeyPressed(Direction::FORWARD);
+				moving[(size_t)Direction::FORWARD] = true;
 			else if (glfwGetKey(native, GLFW_KEY_S) == GLFW_PRESS)
-				onKeyPressed(Direction::BACKWARD);
+				moving[(size_t)Direction::BACKWARD] = true;
 			
 			if (glfwGetKey(native, GLFW_KEY_A) == GLFW_PRESS)
-				onKeyPressed(Direction::LEFT);
+				moving[(size_t)Direction::LEFT] = true;
 			else if (glfwGetKey(native, GLFW_KEY_D) == GLFW_PRESS)
-				onKeyPressed(Direction::RIGHT);
+				moving[(size_t)Direction::RIGHT] = true;
 			
 			if (glfwGetKey(native, GLFW_KEY_Q) == GLFW_PRESS)
-				onKeyPressed(Direction::UP);
+				moving[(size_t)Direction::UP] = true;
 			else if (glfwGetKey(native, GLFW_KEY_E) == GLFW_PRESS)
-				onKeyPressed(Direction::DOWN);
+				moving[(size_t)Direction::DOWN] = true;
 		}
-		
-		switch (mode) {
-			case Mode::ORTHOGRAPHIC:
-				projection = glm::ortho(1.5f * aspect_ratio, -1.5f * aspect_ratio, 1.5f, -1.5f, -100.0f, 100.0f);
-				break;
-
-			case Mode::PERSPECTIVE:
-				projection = glm::perspective(glm::radians(fov), aspect_ratio, clip_near, clip_far);
-				break;
-		}
-
-		velocity *= 1.0f / (1.0f + delta * move_friction);
-		position += velocity * delta;
-		
-		view = glm::lookAt(position, position + direction, up);
 	}
 
 	void FPSCamera::onKeyPressed(Direction dir)
@@ -121,6 +130,8 @@ namespace Razor
 
 	void FPSCamera::onMouseMoved(glm::vec2& pos, bool constrain)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (first)
 		{
 			last_pos = pos;
@@ -140,14 +151,13 @@ namespace Razor
 				if (pitch > 89.0f)  pitch = 89.0f;
 				if (pitch < -89.0f) pitch = -89.0f;
 			}
-
-			
-			updateVectors();
 		}
 	}
 
 	void FPSCamera::onMouseScrolled(glm::vec2& offset)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (capture)
 		{
 			speed += offset.y / 10.0f * speed_factor;
@@ -162,6 +172,8 @@ namespace Razor
 
 	void FPSCamera::onMouseDown(int button)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (button == 1 && viewport->isHovered())
 		{
 			capture = true;
@@ -171,6 +183,8 @@ namespace Razor
 
 	void FPSCamera::onMouseUp(int button)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (button == 1)
 		{
 			capture = false;
@@ -180,6 +194,8 @@ namespace Razor
 
 	void FPSCamera::onWindowResized(const glm::vec2& size)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (viewport != nullptr) {
 			aspect_ratio = (float)viewport->getSize().x / (float)viewport->getSize().y;
 		}
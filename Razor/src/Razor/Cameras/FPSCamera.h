@@ -31,6 +31,8 @@ namespace Razor
 		glm::vec2 mouse_offset;
 		glm::vec2 mouse;
 		bool constrain_pitch;
+		// Directions held down at the last poll, indexed by Direction
+		std::array<bool, 6> moving;
 	};
 
 }
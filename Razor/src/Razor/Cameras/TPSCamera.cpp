@@ -68,6 +68,8 @@ namespace Razor
 
 	void TPSCamera::update(double dt)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		//alpha += 0.5f * dt;
 		//y_offset = sin(alpha - dt) - 20.0f;
 		//roll += 0.5f * dt;
@@ -124,6 +126,8 @@ namespace Razor
 
 	void TPSCamera::onMouseMoved(glm::vec2& pos, bool constrain)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (first)
 		{
 			last_pos = pos;
@@ -175,6 +179,8 @@ namespace Razor
 
 	void TPSCamera::onMouseScrolled(glm::vec2& offset)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (viewport->isHovered())
 		{
 			distance -= (offset.y / 10.0f) * zoom_factor;
@@ -206,6 +212,8 @@ namespace Razor
 
 	void TPSCamera::onKeyDown(int keyCode)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (keyCode == GLFW_KEY_KP_5 && viewport->isHovered()) 
 		{
 			mode = mode == Camera::Mode::ORTHOGRAPHIC ? Camera::Mode::PERSPECTIVE : Camera::Mode::ORTHOGRAPHIC;
@@ -219,6 +227,8 @@ namespace Razor
 
 	void TPSCamera::onWindowResized(const glm::vec2& size)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		if (viewport != nullptr) {
 			aspect_ratio = (float)viewport->getSize().x / (float)viewport->getSize().y;
 		}
@@ -226,6 +236,8 @@ namespace Razor
 
 	void TPSCamera::setTarget(Transform* transform)
 	{
+		std::lock_guard<std::mutex> lock(input_mutex);
+
 		target->setPosition(glm::vec3(transform->getPosition()));
 	}
 
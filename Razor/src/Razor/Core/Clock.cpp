@@ -11,7 +11,7 @@ namespace Razor {
 
 	double Clock::getTime()
 	{
-		return time = glfwGetTime();
+		return glfwGetTime();
 	}
 
 	Clock::~Clock()
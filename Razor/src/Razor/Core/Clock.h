@@ -9,9 +9,6 @@ namespace Razor {
 		~Clock();
 
 		 double getTime();
-
-	private:
-		double time;
 	};
 
 }
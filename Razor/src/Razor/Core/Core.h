@@ -36,6 +36,9 @@
 #define TAU 2.0f * PI
 #define EPSILON 0.001f
 
+typedef __int8 int8;
+typedef unsigned __int8 uint8;
+
 typedef __int16 int16;
 typedef unsigned __int16 uint16;
 
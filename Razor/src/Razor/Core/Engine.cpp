@@ -2,7 +2,7 @@
 #include "Engine.h"
 #include "Razor/Rendering/Renderer.h"
 #include "Razor/Materials/ShadersManager.h"
-#include "Razor/Core/TasksManager.h"
+#include "Razor/Core/JobSystem.h"
 #include "Razor/Scene/ScenesManager.h"
 #include "Razor/Cameras/FPSCamera.h"
 #include "Razor/Application/Application.h"
@@ -14,8 +14,12 @@
 #include "Razor/Physics/World.h"
 #include "Razor/Audio/SoundsManager.h"
 #include "Razor/Audio/Sound.h"
-#include "Razor/Core/ThreadPool.h"
 #include "Razor/Core/System.h"
+#include "Razor/Network/MetricsServer.h"
+#include "Razor/Memory/MemoryTracker.h"
+#include "Razor/Scene/FrameSnapshot.h"
+#include "Razor/Scene/SceneSnapshot.h"
+#include "Razor/Scene/WorldPartition.h"
 #include "Editor/Editor.h"
 
 namespace Razor
@@ -26,10 +30,16 @@ namespace Razor
 		application(application)
 	{
 		system = new System();
-		//thread_pool = new ThreadPool(8);
+		metrics_server = new MetricsServer();
+		job_system = new JobSystem();
+		snapshots = new FrameSnapshot[FRAME_SNAPSHOTS];
+		snapshot_publisher = new SnapshotPublisher();
 
 		gameLoop = new GameLoop(this);
-		gameLoop->setUpdateCallback(&Engine::update);
+		// GLFW is polled by input(), the GL and OpenAL calls of the update are
+		// queued to the main thread and the snapshots own the meshes they draw
+		gameLoop->setInputCallback(&Engine::input);
+		gameLoop->setUpdateCallback(&Engine::update, true);
 		gameLoop->setRenderCallback(&Engine::render);
 
 		physics_world = new World();
@@ -37,7 +47,6 @@ namespace Razor
 		scenes_manager  = new ScenesManager();
 		sounds_manager  = new SoundsManager();
 		shaders_manager = new ShadersManager();
-		//tasks_manager   = new TasksManager();
 
 		renderer = new Renderer(&application->GetWindow(), this, scenes_manager, shaders_manager);
 
@@ -48,12 +57,16 @@ namespace Razor
 
 	Engine::~Engine()
 	{
+		delete metrics_server;
 		delete system;
 		delete gameLoop;
 		delete renderer;
 		delete sounds_manager;
 		delete scenes_manager;
 		delete shaders_manager;
+		delete job_system;
+		delete[] snapshots;
+		delete snapshot_publisher;
 	}
 
 	void Engine::start()
@@ -116,6 +129,9 @@ namespace Razor
 					sounds_manager->playSound("trailer_music");
 				}
 
+				if (e.GetKeyCode() == RZ_KEY_F11)
+					TraceProfiler::toggleCapture();
+
 				if (e.GetKeyCode() == RZ_KEY_P)
 				{
 					Sound* trailer = sounds_manager->getSounds()["trailer_music"];
@@ -132,20 +148,77 @@ namespace Razor
 		}
 	}
 
+	FrameSnapshot* Engine::getUpdateSnapshot()
+	{
+		return &snapshots[gameLoop->getUpdateFrame() % FRAME_SNAPSHOTS];
+	}
+
+	FrameSnapshot* Engine::getRenderSnapshot()
+	{
+		if (!gameLoop->hasRenderFrame())
+			return nullptr;
+
+		FrameSnapshot* snapshot = &snapshots[gameLoop->getRenderFrame() % FRAME_SNAPSHOTS];
+
+		return snapshot->isValid() ? snapshot : nullptr;
+	}
+
+	std::shared_ptr<const SceneSnapshot> Engine::getSceneSnapshot()
+	{
+		return snapshot_publisher->get();
+	}
+
+	void Engine::input(GameLoop* loop, Engine* self)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		Camera* camera = self->scenes_manager->getActiveScene()->getActiveCamera();
+
+		if (camera != nullptr)
+			camera->onEvent(&self->application->GetWindow());
+	}
+
 	void Engine::update(GameLoop* loop, Engine* self)
 	{
-		double delta = loop->getPassedTime();
+		RZ_PROFILE_FUNCTION();
+
+		double delta = loop->getUpdateDelta();
 		Window& window = self->application->GetWindow();
-		Camera* camera = self->scenes_manager->getActiveScene()->getActiveCamera();
+		Scene* scene = self->scenes_manager->getActiveScene();
+		Camera* camera = scene->getActiveCamera();
 
-		camera->update(delta);
-		camera->onEvent(&self->application->GetWindow());
+		{
+			RZ_PROFILE_SCOPE("Camera");
+			camera->update(delta);
+		}
 
-		self->getPhysicsWorld()->tick((float)loop->getPassedTime());
+		self->getPhysicsWorld()->tick((float)delta);
 		self->getPhysicsWorld()->updateNodes();
 
 		for (Layer* layer : self->application->getLayerStack())
+		{
+			RZ_PROFILE_SCOPE("Layer::OnUpdate");
 			layer->OnUpdate((float)delta);
+		}
+
+		uint64 frame = loop->getUpdateFrame();
+
+		if (scene->getWorldPartition() != nullptr)
+			scene->getWorldPartition()->update(camera, scene->getSceneGraph(), self->getPhysicsWorld(), frame);
+
+		FrameSnapshot* snapshot = self->getUpdateSnapshot();
+		FrameSnapshot* previous = &self->snapshots[(frame - 1) % FRAME_SNAPSHOTS];
+
+		// Catch-up steps of a frame interpolate from the step before
+		if (snapshot->isValid() && snapshot->getFrame() == frame)
+			previous = snapshot;
+		else if (previous->getFrame() != frame - 1)
+			previous = nullptr;
+
+		snapshot->capture(scene, frame, delta, previous);
+		self->snapshot_publisher->publish(scene->getSceneGraph(), *snapshot);
+		snapshot->setSceneSnapshot(self->getSceneSnapshot());
+		self->sounds_manager->updateOcclusion(scene->getSceneGraph(), camera->getPosition());
 
 		//self->forward_renderer->setViewport(0, 0, window.GetWidth(), window.GetHeight());
 		//self->forward_renderer->update((float)loop->getPassedTime());
@@ -153,16 +226,36 @@ namespace Razor
 
 	void Engine::render(GameLoop* loop, Engine* self)
 	{
-		self->renderer->render();
-			
-		self->application->getImGuiLayer()->Begin();
+		RZ_PROFILE_FUNCTION();
 
-		for (Layer* layer : self->application->getLayerStack())
-			layer->OnImGuiRender();
+		{
+			RZ_PROFILE_SCOPE("MainThreadJobs");
+			self->job_system->processMainThreadJobs();
+		}
 
-		self->application->getImGuiLayer()->End();
+		Scene* scene = self->scenes_manager->getActiveScene();
 
-		self->application->GetWindow().OnUpdate();
+		if (scene->getWorldPartition() != nullptr)
+			scene->getWorldPartition()->upload(loop->getRenderFrame());
+
+		self->renderer->render(self->getRenderSnapshot(), loop->getAlpha());
+
+		{
+			RZ_PROFILE_SCOPE("ImGui");
+			MemoryTagScope memory(MemoryTag::Editor);
+
+			self->application->getImGuiLayer()->Begin();
+
+			for (Layer* layer : self->application->getLayerStack())
+				layer->OnImGuiRender();
+
+			self->application->getImGuiLayer()->End();
+		}
+
+		{
+			RZ_PROFILE_SCOPE("SwapBuffers");
+			self->application->GetWindow().OnUpdate();
+		}
 
 		glfwPollEvents();
 	}
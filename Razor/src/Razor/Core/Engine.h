@@ -10,13 +10,16 @@ namespace Razor
 	class ScenesManager;
 	class SoundsManager;
 	class ShadersManager;
-	class TasksManager;
 	class Window;
 	class Application;
 	class Event;
 	class World;
-	class ThreadPool;
+	class JobSystem;
 	class System;
+	class MetricsServer;
+	class FrameSnapshot;
+	class SceneSnapshot;
+	class SnapshotPublisher;
 
 	class Engine
 	{
@@ -27,15 +30,16 @@ namespace Razor
 		void start();
 		void stop();
 		void OnEvent(Event& event);
+		static void input(GameLoop* loop, Engine* self);
 		static void update(GameLoop* loop, Engine* self);
 		static void render(GameLoop* loop, Engine* self);
 
 		inline ScenesManager* getScenesManager() { return scenes_manager; }
 		inline SoundsManager* getSoundsManager() { return sounds_manager; }
 		inline ShadersManager* getShadersManager() { return shaders_manager; }
-		inline TasksManager* getTasksManager() { return tasks_manager; }
-		inline ThreadPool* getThreadPool() { return thread_pool; }
+		inline JobSystem* getJobSystem() { return job_system; }
 		inline System* getSystem() { return system; }
+		inline MetricsServer* getMetricsServer() { return metrics_server; }
 
 		inline Renderer* getRenderer() { return renderer; }
 
@@ -45,10 +49,17 @@ namespace Razor
 		inline float getUpdateTiming() { return (float)gameLoop->getProfiler()->getReport("update");  }
 		inline float getRenderTiming() { return (float)gameLoop->getProfiler()->getReport("render");  }
 		inline float getSleepTiming()  { return (float)gameLoop->getProfiler()->getReport("sleep");  }
+		inline float getOverlapTiming() { return (float)gameLoop->getProfiler()->getReport("overlap"); }
+		inline float getJitterTiming() { return (float)gameLoop->getFrameStats().jitter; }
+
+		FrameSnapshot* getUpdateSnapshot();
+		FrameSnapshot* getRenderSnapshot();
+		// Last scene state published by the update, readable from any thread
+		std::shared_ptr<const SceneSnapshot> getSceneSnapshot();
 		
 		inline GameLoop* getGameLoop() { return gameLoop; }
 		inline float getFPS() { return gameLoop->getFps(); }
-		inline std::map<int, float>& getFpsArray() { return gameLoop->getFpsList(); }
+		inline const std::array<float, MAX_SAMPLES>& getFpsArray() { return gameLoop->getFpsList(); }
 
 		inline unsigned int activeUnitToDecimal() 
 		{
@@ -128,18 +139,21 @@ namespace Razor
 	private:
 		Application* application;
 		GameLoop* gameLoop;
-		ThreadPool* thread_pool;
+		JobSystem* job_system;
 
 		Renderer* renderer;
 
 		ScenesManager* scenes_manager;
 		SoundsManager* sounds_manager;
 		ShadersManager* shaders_manager;
-		TasksManager* tasks_manager;
 
 		World* physics_world;
 
 		System* system;
+		MetricsServer* metrics_server;
+
+		FrameSnapshot* snapshots;
+		SnapshotPublisher* snapshot_publisher;
 	
 	};
 
@@ -2,13 +2,14 @@
 #include "GameLoop.h"
 #include "Engine.h"
 #include "clock.h"
+#include "Razor/Memory/MemoryStats.h"
+#include "Razor/Memory/MemoryTracker.h"
 
 namespace Razor {
 
 	GameLoop::GameLoop(Engine* engine) :
 		m_running(false),
 		m_render(false),
-		m_sleepTime(0),
 		m_fps(0.0f),
 		m_lastTime(0.0),
 		m_startTime(0.0),
@@ -17,20 +18,50 @@ namespace Razor {
 		m_unprocessedTime(0),
 		m_frames(0),
 		m_passedTime(0.0),
+		m_alpha(0.0f),
+		m_updateSteps(0),
+		m_targetFrameTime(0.0),
+		m_nextFrameTime(0.0),
+		m_sleepEstimate(FRAME_PACING_SPIN),
+		m_frameSampleIndex(0),
+		m_frameSampleCount(0),
+		m_frameSamples(),
+		m_frameStats(),
 		m_fpsIndex(0),
-		m_fpsSum(0.0f)
+		m_fpsSum(0.0f),
+		m_fpsList(),
+		m_pipelineDepth(0),
+		m_updateFrame(0),
+		m_renderFrame(0),
+		m_updateDelta(0.0),
+		m_submittedFrame(0),
+		m_iterations(0),
+		m_lastUpdate(),
+		m_pipeline({}),
+		m_pipelineFrames(),
+		m_updateArenas(),
+		m_renderArenas()
 	{
 		m_engine = engine;
 		m_clock = new Clock();
 		m_profiler = new Profiler(m_clock);
 
-		m_profiler->addTimer("frame");
-		m_profiler->addTimer("update");
-		m_profiler->addTimer("render");
-		m_profiler->addTimer("sleep");
+		m_frameTimer = m_profiler->addTimer("frame");
+		m_updateTimer = m_profiler->addTimer("update");
+		m_renderTimer = m_profiler->addTimer("render");
+		m_sleepTimer = m_profiler->addTimer("sleep");
+		m_overlapTimer = m_profiler->addTimer("overlap");
 
 		m_updateCallback = nullptr;
 		m_renderCallback = nullptr;
+		m_inputCallback = nullptr;
+		m_updateThreadSafe = false;
+
+		for (auto& arena : m_updateArenas)
+			arena = new LinearArena("Update");
+
+		for (auto& arena : m_renderArenas)
+			arena = new LinearArena("Render");
 	}
 
 	void GameLoop::start()
@@ -40,12 +71,31 @@ namespace Razor {
 
 		m_running = true;
 		m_lastTime = m_clock->getTime();
+		m_nextFrameTime = m_lastTime;
 		m_frameCounter = 0;
 		m_unprocessedTime = 0;
 		m_frames = 0;
 
+#ifdef RZ_PLATFORM_WINDOWS
+		// 1 ms scheduler granularity, the default ~15 ms makes coarse sleeps useless
+		timeBeginPeriod(1);
+#endif
+
+		static Counter& s_frames = Metrics::counter("frames", "Frames rendered");
+		static Histogram& s_frameTime = Metrics::histogram("frame.time", "us", "Time between two frames");
+		static Gauge& s_fps = Metrics::gauge("frame.fps", "Average frames per second");
+
 		while (m_running)
 		{
+			RZ_PROFILE_SCOPE("Frame");
+
+			MemoryStats::endFrame();
+			MemoryTracker::update();
+
+			LinearArena* render_arena = m_renderArenas[m_iterations++ % m_renderArenas.size()];
+			render_arena->reset();
+			LinearArena::setFrameArena(render_arena);
+
 			m_render = false;
 			m_startTime = m_clock->getTime();
 
@@ -55,43 +105,302 @@ namespace Razor {
 			m_unprocessedTime += m_passedTime;
 			m_frameCounter += m_passedTime;
 
+			computeFrameStats();
+
+			s_frames.add();
+			s_frameTime.record((uint64)(m_passedTime * 1e6));
+
 			if (m_frameCounter >= 0.05f)
 			{
 				m_fps = computeAverageFps(1.0f / (float)m_passedTime);
+				s_fps.set(m_fps);
 				m_frames = 0;
 				m_frameCounter = 0;
 			}
 
-			m_profiler->startTimer("frame");
+			m_frameTimer->start();
+
+			if (!isPipelined())
+				runSerial();
+			else
+				runPipelined();
+
+			m_frames++;
 
-			if (m_unprocessedTime > m_frameTime)
 			{
-				m_profiler->startTimer("update");
+				RZ_PROFILE_SCOPE("Sleep");
+				m_sleepTimer->start();
+					waitForNextFrame();
+				m_sleepTimer->stop();
+			}
 
-				if (m_updateCallback != nullptr)
-					m_updateCallback(this, m_engine);
+			m_frameTimer->stop();
+		}
 
-				m_profiler->stopTimer("update");
+		LinearArena::setFrameArena(nullptr);
 
-				m_render = true;
-				m_unprocessedTime -= m_passedTime;
-			}
-			 
-			m_profiler->startTimer("render");
+		while (!m_pipeline.empty())
+		{
+			completeFrame(m_pipelineFrames[m_pipeline.front() % FRAME_SNAPSHOTS]);
+			m_pipeline.pop_front();
+		}
+
+#ifdef RZ_PLATFORM_WINDOWS
+		timeEndPeriod(1);
+#endif
+	}
+
+	void GameLoop::runSerial()
+	{
+		// Flush frames left in flight when switching back from the pipelined mode
+		while (!m_pipeline.empty())
+		{
+			completeFrame(m_pipelineFrames[m_pipeline.front() % FRAME_SNAPSHOTS]);
+			m_pipeline.pop_front();
+		}
 
-			if (m_renderCallback != nullptr)
-				m_renderCallback(this, m_engine);
+		runInput();
 
-			m_profiler->stopTimer("render");
+		int steps = consumeUpdateSteps();
 
-			m_frames++;
+		if (steps > 0)
+		{
+			m_updateTimer->start();
+
+			runUpdates(++m_submittedFrame, steps);
+			m_renderFrame = m_submittedFrame;
+
+			m_updateTimer->stop();
+
+			m_render = true;
+		}
+
+		m_renderTimer->start();
+		runRender();
+		m_renderTimer->stop();
+	}
+
+	void GameLoop::runPipelined()
+	{
+		runInput();
+
+		int steps = consumeUpdateSteps();
+		PipelineFrame* slot = nullptr;
+
+		if (steps > 0)
+		{
+			uint64 frame = ++m_submittedFrame;
+
+			slot = &m_pipelineFrames[frame % FRAME_SNAPSHOTS];
+			slot->frame = frame;
+			slot->updateStart = slot->updateEnd = 0.0;
+			slot->renderStart = slot->renderEnd = 0.0;
+
+			// Updates stay ordered, each one waits for the previous frame to be simulated
+			slot->job = JobSystem::get().schedule([this, frame, steps]
+			{
+				PipelineFrame& pipeline_frame = m_pipelineFrames[frame % FRAME_SNAPSHOTS];
+
+				pipeline_frame.updateStart = m_clock->getTime();
+				runUpdates(frame, steps);
+				pipeline_frame.updateEnd = m_clock->getTime();
+			}, { m_lastUpdate });
+
+			m_lastUpdate = slot->job;
+			m_pipeline.push_back(frame);
+		}
+
+		// Pick up frames that are already simulated without blocking on the others
+		while (!m_pipeline.empty())
+		{
+			PipelineFrame& frame = m_pipelineFrames[m_pipeline.front() % FRAME_SNAPSHOTS];
+
+			if ((int)m_pipeline.size() <= m_pipelineDepth && !JobSystem::get().isFinished(frame.job))
+				break;
+
+			completeFrame(frame);
+			m_pipeline.pop_front();
+		}
+
+		m_render = hasRenderFrame();
+
+		double render_start = m_clock->getTime();
+		m_renderTimer->start();
+		runRender();
+		m_renderTimer->stop();
+
+		if (slot != nullptr)
+		{
+			slot->renderStart = render_start;
+			slot->renderEnd = m_clock->getTime();
+		}
+	}
+
+	void GameLoop::setPipelineDepth(int depth)
+	{
+		m_pipelineDepth = std::min(std::max(depth, 0), MAX_PIPELINE_DEPTH);
+
+		if (m_pipelineDepth > 0 && !m_updateThreadSafe)
+			Log::warn("GameLoop: The update callback isn't thread safe, frames stay serial");
+	}
+
+	int GameLoop::consumeUpdateSteps()
+	{
+		int steps = 0;
+
+		while (m_unprocessedTime >= m_frameTime && steps < MAX_UPDATES_PER_FRAME)
+		{
+			m_unprocessedTime -= m_frameTime;
+			steps++;
+		}
 
-			m_profiler->startTimer("sleep");
-				Sleep(m_sleepTime);
-			m_profiler->stopTimer("sleep");
+		// Drop what can't be caught up (breakpoints, loading hitches) instead of
+		// falling further behind every frame
+		if (m_unprocessedTime >= m_frameTime)
+			m_unprocessedTime = std::fmod(m_unprocessedTime, m_frameTime);
 
-			m_profiler->stopTimer("frame");
+		m_updateSteps = steps;
+		m_alpha = (float)(m_unprocessedTime / m_frameTime);
+
+		return steps;
+	}
+
+	void GameLoop::runUpdates(uint64 frame, int steps)
+	{
+		static Histogram& s_updateTime = Metrics::histogram("update.time", "us", "Time spent in the update steps of a frame");
+		double start = m_clock->getTime();
+
+		// The snapshot slot of this frame is free again, so is its arena
+		LinearArena* arena = m_updateArenas[frame % FRAME_SNAPSHOTS];
+		arena->reset();
+
+		FrameArenaScope scope(arena);
+
+		for (int i = 0; i < steps; i++)
+			runUpdate(frame, m_frameTime);
+
+		s_updateTime.record((uint64)((m_clock->getTime() - start) * 1e6));
+	}
+
+	void GameLoop::runUpdate(uint64 frame, double delta)
+	{
+		m_updateFrame = frame;
+		m_updateDelta = delta;
+
+		if (m_updateCallback != nullptr)
+			m_updateCallback(this, m_engine);
+	}
+
+	void GameLoop::runInput()
+	{
+		if (m_inputCallback != nullptr)
+			m_inputCallback(this, m_engine);
+	}
+
+	void GameLoop::runRender()
+	{
+		static Histogram& s_renderTime = Metrics::histogram("render.time", "us", "Time spent in the render callback");
+		double start = m_clock->getTime();
+
+		if (m_renderCallback != nullptr)
+			m_renderCallback(this, m_engine);
+
+		s_renderTime.record((uint64)((m_clock->getTime() - start) * 1e6));
+	}
+
+	void GameLoop::completeFrame(PipelineFrame& frame)
+	{
+		{
+			RZ_PROFILE_SCOPE("WaitUpdate");
+			JobSystem::get().wait(frame.job);
+		}
+
+		m_renderFrame = frame.frame;
+
+		// Time spent rendering previous snapshots while this frame was being simulated
+		double overlap = 0.0;
+		int depth = std::max(m_pipelineDepth, 1);
+
+		for (int i = 0; i < depth; i++)
+		{
+			PipelineFrame& render = m_pipelineFrames[(frame.frame + i) % FRAME_SNAPSHOTS];
+
+			if (render.frame != frame.frame + i)
+				continue;
+
+			double start = std::max(frame.updateStart, render.renderStart);
+			double end = std::min(frame.updateEnd, render.renderEnd);
+
+			if (end > start)
+				overlap += end - start;
 		}
+
+		m_updateTimer->addTime(frame.updateEnd - frame.updateStart);
+		m_overlapTimer->addTime(overlap);
+	}
+
+	void GameLoop::waitForNextFrame()
+	{
+		if (m_targetFrameTime <= 0.0)
+		{
+			std::this_thread::yield();
+			return;
+		}
+
+		m_nextFrameTime += m_targetFrameTime;
+
+		double now = m_clock->getTime();
+
+		// Too late already, restart the schedule rather than rushing the next frames
+		if (now > m_nextFrameTime)
+		{
+			m_nextFrameTime = now;
+			return;
+		}
+
+		// Coarse sleeps until the scheduler could overshoot the deadline,
+		// the estimate follows the worst recent sleep and slowly decays
+		while (m_nextFrameTime - now > m_sleepEstimate + FRAME_PACING_SPIN)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			double time = m_clock->getTime();
+			m_sleepEstimate = std::max(time - now, m_sleepEstimate * 0.99);
+			now = time;
+		}
+
+		while (m_clock->getTime() < m_nextFrameTime);
+	}
+
+	void GameLoop::computeFrameStats()
+	{
+		m_frameSamples[m_frameSampleIndex] = m_passedTime * 1000.0;
+		m_frameSampleIndex = (m_frameSampleIndex + 1) % MAX_SAMPLES;
+		m_frameSampleCount = std::min(m_frameSampleCount + 1, MAX_SAMPLES);
+
+		double sum = 0.0;
+		double minimum = m_frameSamples[0];
+		double maximum = m_frameSamples[0];
+
+		for (int i = 0; i < m_frameSampleCount; i++)
+		{
+			sum += m_frameSamples[i];
+			minimum = std::min(minimum, m_frameSamples[i]);
+			maximum = std::max(maximum, m_frameSamples[i]);
+		}
+
+		double average = sum / m_frameSampleCount;
+		double target = m_targetFrameTime > 0.0 ? m_targetFrameTime * 1000.0 : average;
+		double variance = 0.0;
+
+		for (int i = 0; i < m_frameSampleCount; i++)
+			variance += (m_frameSamples[i] - average) * (m_frameSamples[i] - average);
+
+		m_frameStats.average = average;
+		m_frameStats.deviation = std::sqrt(variance / m_frameSampleCount);
+		m_frameStats.minimum = minimum;
+		m_frameStats.maximum = maximum;
+		m_frameStats.jitter = std::max(maximum - target, target - minimum);
 	}
 
 	float GameLoop::computeAverageFps(float fps)
@@ -116,6 +425,12 @@ namespace Razor {
 	{
 		delete m_clock;
 		delete m_profiler;
+
+		for (auto arena : m_updateArenas)
+			delete arena;
+
+		for (auto arena : m_renderArenas)
+			delete arena;
 	}
 
 }
@@ -2,8 +2,15 @@
 
 #include "profiler.h"
 #include "clock.h"
+#include "JobSystem.h"
+#include "Metrics.h"
+#include "Razor/Memory/LinearArena.h"
 
 #define MAX_SAMPLES 60
+#define MAX_UPDATES_PER_FRAME 5
+#define FRAME_PACING_SPIN 0.001
+#define MAX_PIPELINE_DEPTH 2
+#define FRAME_SNAPSHOTS (MAX_PIPELINE_DEPTH + 1)
 
 namespace Razor {
 
@@ -23,29 +30,96 @@ namespace Razor {
 		inline Profiler* getProfiler() { return m_profiler; }
 		inline Clock* getClock() { return m_clock; }
 
-		inline void setUpdateCallback(GameLoopCallback callback) { m_updateCallback = callback; }
+		// A thread safe update makes no GL, GLFW or audio calls and leaves alone what
+		// render reads in place, only such an update can be pipelined
+		inline void setUpdateCallback(GameLoopCallback callback, bool threadSafe = false) { m_updateCallback = callback; m_updateThreadSafe = threadSafe; }
 		inline void setRenderCallback(GameLoopCallback callback) { m_renderCallback = callback; }
-
+		// Main thread, once per frame before its updates are scheduled, polls what they read
+		inline void setInputCallback(GameLoopCallback callback) { m_inputCallback = callback; }
+
+		struct FrameStats
+		{
+			FrameStats() :
+				average(0.0),
+				deviation(0.0),
+				minimum(0.0),
+				maximum(0.0),
+				jitter(0.0)
+			{}
+
+			// Milliseconds over the last MAX_SAMPLES frames, jitter is the worst
+			// distance to the target frame time (or to the average when uncapped)
+			double average;
+			double deviation;
+			double minimum;
+			double maximum;
+			double jitter;
+		};
+
+		// Updates always run with the fixed frame time, rendering interpolates
+		// between the last two updates with getAlpha()
 		inline double getFrameTime() { return m_frameTime; }
+		inline void setUpdateRate(double rate) { m_frameTime = 1.0 / rate; }
 		inline double getPassedTime() { return m_passedTime; }
+		inline float getAlpha() { return m_alpha; }
+		inline int getUpdateSteps() { return m_updateSteps; }
+
+		// 0 leaves the frame pacing to vsync
+		inline double getTargetFrameTime() { return m_targetFrameTime; }
+		inline void setTargetFrameRate(double fps) { m_targetFrameTime = fps > 0.0 ? 1.0 / fps : 0.0; }
+		inline const FrameStats& getFrameStats() { return m_frameStats; }
+
+		// 0 runs update and render serially, 1 or 2 lets the update of the next
+		// frames run on a worker while the main thread renders the last snapshot.
+		// Updates not declared thread safe always run serially.
+		inline int getPipelineDepth() { return m_pipelineDepth; }
+		void setPipelineDepth(int depth);
+		inline bool isPipelined() { return m_pipelineDepth > 0 && m_updateThreadSafe; }
+
+		inline uint64 getUpdateFrame() { return m_updateFrame; }
+		inline double getUpdateDelta() { return m_updateDelta; }
+		inline bool hasRenderFrame() { return m_renderFrame > 0; }
+		inline uint64 getRenderFrame() { return m_renderFrame; }
 		inline float getFps() { return m_fps; }
 		inline double getFrameCounter() { return m_frameCounter; }
 
 		float computeAverageFps(float fps);
-		inline std::map<int, float>& getFpsList() { return m_fpsList; }
+		inline const std::array<float, MAX_SAMPLES>& getFpsList() { return m_fpsList; }
 
 		~GameLoop();
 		Clock* m_clock;
 		Profiler* m_profiler;
 
 	private:
+		struct PipelineFrame
+		{
+			JobHandle job;
+			uint64 frame;
+			double updateStart;
+			double updateEnd;
+			double renderStart;
+			double renderEnd;
+		};
+
+		void runSerial();
+		void runPipelined();
+		void runInput();
+		int consumeUpdateSteps();
+		void runUpdates(uint64 frame, int steps);
+		void runUpdate(uint64 frame, double delta);
+		void runRender();
+		void completeFrame(PipelineFrame& frame);
+		void waitForNextFrame();
+		void computeFrameStats();
+
 		Engine* m_engine;
 		GameLoopCallback m_updateCallback;
 		GameLoopCallback m_renderCallback;
+		GameLoopCallback m_inputCallback;
+		bool m_updateThreadSafe;
 
 		bool m_running;
 		bool m_render;
-		int m_sleepTime;
 		float m_fps;
 		double m_lastTime;
 		double m_startTime;
@@ -54,10 +128,40 @@ namespace Razor {
 		double m_unprocessedTime = 0;
 		int m_frames = 0;
 		double m_passedTime;
+		float m_alpha;
+		int m_updateSteps;
+
+		double m_targetFrameTime;
+		double m_nextFrameTime;
+		double m_sleepEstimate;
+		int m_frameSampleIndex;
+		int m_frameSampleCount;
+		std::array<double, MAX_SAMPLES> m_frameSamples;
+		FrameStats m_frameStats;
 
 		int m_fpsIndex;
 		float m_fpsSum;
-		std::map<int, float> m_fpsList;
+		std::array<float, MAX_SAMPLES> m_fpsList;
+
+		Timer* m_frameTimer;
+		Timer* m_updateTimer;
+		Timer* m_renderTimer;
+		Timer* m_sleepTimer;
+		Timer* m_overlapTimer;
+
+		int m_pipelineDepth;
+		uint64 m_updateFrame;
+		uint64 m_renderFrame;
+		double m_updateDelta;
+		uint64 m_submittedFrame;
+		uint64 m_iterations;
+		JobHandle m_lastUpdate;
+		std::deque<uint64> m_pipeline;
+		std::array<PipelineFrame, FRAME_SNAPSHOTS> m_pipelineFrames;
+
+		// Update data lives as long as its snapshot, render data for two frames
+		std::array<LinearArena*, FRAME_SNAPSHOTS> m_updateArenas;
+		std::array<LinearArena*, 2> m_renderArenas;
 	};
 
 }
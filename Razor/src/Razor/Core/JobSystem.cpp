@@ -0,0 +1,433 @@
+#include "rzpch.h"
+#include "JobSystem.h"
+
+namespace Razor
+{
+
+	JobSystem* JobSystem::s_instance = nullptr;
+
+	static thread_local int t_threadIndex = -1;
+	static thread_local uint32 t_stealSeed = 0;
+
+	WorkStealingQueue::WorkStealingQueue() :
+		top(0),
+		bottom(0)
+	{
+		for (auto& job : jobs)
+			job.store(nullptr, std::memory_order_relaxed);
+	}
+
+	bool WorkStealingQueue::push(Job* job)
+	{
+		int64 b = bottom.load(std::memory_order_relaxed);
+		int64 t = top.load(std::memory_order_acquire);
+
+		if (b - t >= MAX_QUEUED_JOBS)
+			return false;
+
+		jobs[b & (MAX_QUEUED_JOBS - 1)].store(job, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	Job* WorkStealingQueue::pop()
+	{
+		int64 b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64 t = top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job* job = jobs[b & (MAX_QUEUED_JOBS - 1)].load(std::memory_order_relaxed);
+
+		if (t != b)
+			return job;
+
+		// Last job in the queue, race against the thieves
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+
+		bottom.store(b + 1, std::memory_order_relaxed);
+
+		return job;
+	}
+
+	Job* WorkStealingQueue::steal()
+	{
+		int64 t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64 b = bottom.load(std::memory_order_acquire);
+
+		if (t >= b)
+			return nullptr;
+
+		Job* job = jobs[t & (MAX_QUEUED_JOBS - 1)].load(std::memory_order_relaxed);
+
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+
+		return job;
+	}
+
+	JobSystem::JobSystem(unsigned int threads_count) :
+		next_job(0),
+		queued(0),
+		running(true)
+	{
+		RZ_ASSERT(!s_instance, "JobSystem already exists!");
+		s_instance = this;
+
+		if (threads_count == 0)
+			threads_count = std::max(2u, std::thread::hardware_concurrency());
+
+		// Queue 0 belongs to the thread creating the job system (the main/GL thread)
+		t_threadIndex = 0;
+		TraceProfiler::setThreadName("Main");
+
+		for (unsigned int i = 0; i < threads_count; i++)
+			queues.push_back(std::make_unique<WorkStealingQueue>());
+
+		for (unsigned int i = 1; i < threads_count; i++)
+			threads.emplace_back(&JobSystem::work, this, i);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		running = false;
+		condition.notify_all();
+
+		for (auto& thread : threads)
+			thread.join();
+
+		s_instance = nullptr;
+	}
+
+	int JobSystem::getThreadIndex()
+	{
+		return t_threadIndex;
+	}
+
+	JobHandle JobSystem::create(const JobFunction& function, JobHandle parent)
+	{
+		Job* job = nullptr;
+
+		while (job == nullptr)
+		{
+			Job* candidate = &jobs[next_job.fetch_add(1, std::memory_order_relaxed) & (MAX_JOBS - 1)];
+			bool expected = false;
+
+			if (candidate->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+				job = candidate;
+			else if (!runOne())
+				std::this_thread::yield();
+		}
+
+		uint32 generation = job->generation.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		job->function = function;
+		job->parent = nullptr;
+		job->finished = false;
+		job->main_thread = false;
+		job->memory_tag = MemoryTracker::getTag();
+		job->continuations.clear();
+		job->dependencies.store(1, std::memory_order_relaxed);
+		job->unfinished.store(1, std::memory_order_release);
+
+		if (parent.isValid())
+		{
+			RZ_ASSERT(!isFinished(parent), "Cannot attach a child to a finished job");
+			parent.job->unfinished.fetch_add(1, std::memory_order_relaxed);
+			job->parent = parent.job;
+		}
+
+		return JobHandle(job, generation);
+	}
+
+	void JobSystem::addDependency(JobHandle job, JobHandle dependency)
+	{
+		if (!dependency.isValid())
+			return;
+
+		Job* target = dependency.job;
+		bool registered = false;
+
+		job.job->dependencies.fetch_add(1, std::memory_order_relaxed);
+
+		while (target->continuations_lock.test_and_set(std::memory_order_acquire));
+
+		if (!target->finished && target->generation.load(std::memory_order_relaxed) == dependency.generation)
+		{
+			target->continuations.push_back(job.job);
+			registered = true;
+		}
+
+		target->continuations_lock.clear(std::memory_order_release);
+
+		if (!registered)
+			job.job->dependencies.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void JobSystem::submit(JobHandle job, Affinity affinity)
+	{
+		job.job->main_thread = affinity == Affinity::MainThread;
+		releaseDependency(job.job);
+	}
+
+	JobHandle JobSystem::schedule(const JobFunction& function, Affinity affinity)
+	{
+		JobHandle job = create(function);
+		submit(job, affinity);
+
+		return job;
+	}
+
+	JobHandle JobSystem::schedule(const JobFunction& function, const std::vector<JobHandle>& dependencies, Affinity affinity)
+	{
+		JobHandle job = create(function);
+
+		for (auto& dependency : dependencies)
+			addDependency(job, dependency);
+
+		submit(job, affinity);
+
+		return job;
+	}
+
+	JobHandle JobSystem::then(JobHandle job, const JobFunction& function, Affinity affinity)
+	{
+		return schedule(function, { job }, affinity);
+	}
+
+	bool JobSystem::isFinished(JobHandle job) const
+	{
+		if (!job.isValid())
+			return true;
+
+		return job.job->generation.load(std::memory_order_acquire) != job.generation
+			|| job.job->unfinished.load(std::memory_order_acquire) == 0;
+	}
+
+	void JobSystem::wait(JobHandle job)
+	{
+		while (!isFinished(job))
+		{
+			if (runOne())
+				continue;
+
+			if (isMainThread() && runMainThreadJob())
+				continue;
+
+			std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::processMainThreadJobs()
+	{
+		RZ_ASSERT(isMainThread(), "Main thread jobs must be processed on the main thread");
+
+		size_t count = 0;
+
+		{
+			std::unique_lock<std::mutex> lock(main_thread_mutex);
+			count = main_thread_jobs.size();
+		}
+
+		// Only drain what was queued so far, jobs spawned meanwhile wait for the next frame
+		for (size_t i = 0; i < count; i++)
+			if (!runMainThreadJob())
+				break;
+	}
+
+	void JobSystem::add(const TaskData& data)
+	{
+		TaskData task_data = data;
+		TaskFinished finished = data.tf;
+
+		// Completion callbacks usually touch the scene or GL resources
+		task_data.tf = [this, finished](Node* result)
+		{
+			if (finished)
+				runOnMainThread([finished, result] { finished(result); });
+		};
+
+		{
+			std::unique_lock<std::mutex> lock(tasks_mutex);
+			tasks.push(Task(task_data));
+		}
+
+		// Each job executes whichever pending task has the highest priority
+		schedule([this]
+		{
+			std::unique_lock<std::mutex> lock(tasks_mutex);
+			Task task = tasks.top();
+			tasks.pop();
+			lock.unlock();
+
+			task.execute();
+		});
+	}
+
+	void JobSystem::work(unsigned int index)
+	{
+		t_threadIndex = (int)index;
+		t_stealSeed = index * 2654435761u;
+		TraceProfiler::setThreadName("Worker " + std::to_string(index));
+
+		while (running)
+		{
+			if (runOne())
+				continue;
+
+			std::unique_lock<std::mutex> lock(condition_mutex);
+			condition.wait_for(lock, std::chrono::milliseconds(1), [this]
+			{
+				return queued.load(std::memory_order_relaxed) > 0 || !running;
+			});
+		}
+	}
+
+	bool JobSystem::runOne()
+	{
+		Job* job = take();
+
+		if (job == nullptr)
+			return false;
+
+		execute(job);
+
+		return true;
+	}
+
+	bool JobSystem::runMainThreadJob()
+	{
+		Job* job = nullptr;
+
+		{
+			std::unique_lock<std::mutex> lock(main_thread_mutex);
+
+			if (main_thread_jobs.empty())
+				return false;
+
+			job = main_thread_jobs.front();
+			main_thread_jobs.pop_front();
+		}
+
+		execute(job);
+
+		return true;
+	}
+
+	Job* JobSystem::take()
+	{
+		int index = getThreadIndex();
+		Job* job = nullptr;
+
+		if (index >= 0)
+			job = queues[index]->pop();
+
+		if (job == nullptr)
+		{
+			std::unique_lock<std::mutex> lock(injected_mutex);
+
+			if (!injected_jobs.empty())
+			{
+				job = injected_jobs.front();
+				injected_jobs.pop_front();
+			}
+		}
+
+		if (job == nullptr)
+		{
+			size_t count = queues.size();
+
+			t_stealSeed ^= t_stealSeed << 13;
+			t_stealSeed ^= t_stealSeed >> 17;
+			t_stealSeed ^= t_stealSeed << 5;
+
+			size_t offset = t_stealSeed % count;
+
+			for (size_t i = 0; i < count && job == nullptr; i++)
+			{
+				size_t victim = (offset + i) % count;
+
+				if ((int)victim != index)
+					job = queues[victim]->steal();
+			}
+		}
+
+		if (job != nullptr)
+			queued.fetch_sub(1, std::memory_order_relaxed);
+
+		return job;
+	}
+
+	void JobSystem::execute(Job* job)
+	{
+		if (job->function)
+		{
+			RZ_PROFILE_SCOPE("Job");
+			MemoryTagScope tag(job->memory_tag);
+			job->function();
+		}
+
+		finish(job);
+	}
+
+	void JobSystem::finish(Job* job)
+	{
+		if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		Job* parent = job->parent;
+
+		while (job->continuations_lock.test_and_set(std::memory_order_acquire));
+
+		job->finished = true;
+
+		for (Job* continuation : job->continuations)
+			releaseDependency(continuation);
+
+		job->continuations.clear();
+		job->continuations_lock.clear(std::memory_order_release);
+
+		job->function = nullptr;
+		job->in_use.store(false, std::memory_order_release);
+
+		if (parent != nullptr)
+			finish(parent);
+	}
+
+	void JobSystem::enqueue(Job* job)
+	{
+		if (job->main_thread)
+		{
+			std::unique_lock<std::mutex> lock(main_thread_mutex);
+			main_thread_jobs.push_back(job);
+			return;
+		}
+
+		int index = getThreadIndex();
+
+		if (index < 0 || !queues[index]->push(job))
+		{
+			std::unique_lock<std::mutex> lock(injected_mutex);
+			injected_jobs.push_back(job);
+		}
+
+		queued.fetch_add(1, std::memory_order_relaxed);
+		condition.notify_one();
+	}
+
+	void JobSystem::releaseDependency(Job* job)
+	{
+		if (job->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			enqueue(job);
+	}
+
+}
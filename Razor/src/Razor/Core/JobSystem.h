@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Core.h"
+#include "Task.h"
+#include "Razor/Memory/MemoryTracker.h"
+
+#define MAX_JOBS 8192
+#define MAX_QUEUED_JOBS 4096
+
+namespace Razor
+{
+
+	typedef std::function<void()> JobFunction;
+
+	struct Job
+	{
+		Job() :
+			function(),
+			parent(nullptr),
+			unfinished(0),
+			dependencies(0),
+			generation(0),
+			in_use(false),
+			finished(false),
+			main_thread(false),
+			memory_tag(MemoryTag::General)
+		{
+			continuations_lock.clear();
+		}
+
+		JobFunction function;
+		Job* parent;
+		std::atomic<int> unfinished;
+		std::atomic<int> dependencies;
+		std::atomic<uint32> generation;
+		std::atomic<bool> in_use;
+		bool finished;
+		bool main_thread;
+		// Allocations of the job are accounted to the subsystem that created it
+		MemoryTag memory_tag;
+
+		std::atomic_flag continuations_lock;
+		std::vector<Job*> continuations;
+	};
+
+	struct JobHandle
+	{
+		JobHandle() : job(nullptr), generation(0) {}
+		JobHandle(Job* job, uint32 generation) : job(job), generation(generation) {}
+
+		inline bool isValid() const { return job != nullptr; }
+
+		Job* job;
+		uint32 generation;
+	};
+
+	class WorkStealingQueue
+	{
+	public:
+		WorkStealingQueue();
+
+		bool push(Job* job);
+		Job* pop();
+		Job* steal();
+
+		inline bool empty() const { return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<int64> top;
+		std::atomic<int64> bottom;
+		std::array<std::atomic<Job*>, MAX_QUEUED_JOBS> jobs;
+	};
+
+	class JobSystem
+	{
+	public:
+		enum class Affinity { Any, MainThread };
+
+		JobSystem(unsigned int threads_count = 0);
+		~JobSystem();
+
+		inline static JobSystem& get() { return *s_instance; }
+		inline static bool exists() { return s_instance != nullptr; }
+
+		JobHandle create(const JobFunction& function, JobHandle parent = JobHandle());
+		void addDependency(JobHandle job, JobHandle dependency);
+		void submit(JobHandle job, Affinity affinity = Affinity::Any);
+
+		JobHandle schedule(const JobFunction& function, Affinity affinity = Affinity::Any);
+		JobHandle schedule(const JobFunction& function, const std::vector<JobHandle>& dependencies, Affinity affinity = Affinity::Any);
+		JobHandle then(JobHandle job, const JobFunction& function, Affinity affinity = Affinity::Any);
+		inline JobHandle runOnMainThread(const JobFunction& function) { return schedule(function, Affinity::MainThread); }
+
+		bool isFinished(JobHandle job) const;
+		void wait(JobHandle job);
+		void processMainThreadJobs();
+
+		void add(const TaskData& data);
+
+		template<class T>
+		auto addTask(T task) -> std::future<decltype(task())>
+		{
+			auto wrapper = std::make_shared<std::packaged_task<decltype(task()) ()>>(std::move(task));
+			schedule([=] { (*wrapper)(); });
+
+			return wrapper->get_future();
+		}
+
+		inline unsigned int getThreadsCount() { return (unsigned int)queues.size(); }
+		static int getThreadIndex();
+		inline bool isMainThread() { return getThreadIndex() == 0; }
+
+	private:
+		void work(unsigned int index);
+		bool runOne();
+		bool runMainThreadJob();
+		Job* take();
+		void execute(Job* job);
+		void finish(Job* job);
+		void enqueue(Job* job);
+		void releaseDependency(Job* job);
+
+		static JobSystem* s_instance;
+
+		std::array<Job, MAX_JOBS> jobs;
+		std::atomic<uint32> next_job;
+
+		std::vector<std::unique_ptr<WorkStealingQueue>> queues;
+		std::vector<std::thread> threads;
+
+		std::deque<Job*> injected_jobs;
+		std::mutex injected_mutex;
+
+		std::deque<Job*> main_thread_jobs;
+		std::mutex main_thread_mutex;
+
+		std::priority_queue<Task> tasks;
+		std::mutex tasks_mutex;
+
+		std::atomic<int> queued;
+		std::condition_variable condition;
+		std::mutex condition_mutex;
+		std::atomic<bool> running;
+	};
+
+}
@@ -12,6 +12,7 @@ namespace Razor {
 	std::shared_ptr<spdlog::logger> Log::s_clientLogger;
 	std::shared_ptr<spdlog::logger> Log::s_fileLogger;
 	Logger* Log::s_editorLogger;
+	LogCategory Log::s_core(nullptr);
 
 	Log::Log()
 	{
@@ -34,48 +35,36 @@ namespace Razor {
 		s_clientLogger->set_level(spdlog::level::trace);
 
 		spdlog::set_default_logger(s_fileLogger);
-	}
-
-	void Log::trace(const char* format, ...)
-	{
-		va_list args;
-		char buf[1024];
-		va_start(args, format);
-		vsnprintf(buf, IM_ARRAYSIZE(buf), format, args);
-		s_coreLogger->trace(buf);
-
-		if(s_editorLogger != nullptr)
-			s_editorLogger->addLog(std::string(buf));
 
-		va_end(args);
+		LogBackend::addSink([](Level level, const std::string& message)
+		{
+			switch (level)
+			{
+				case Level::Trace: s_coreLogger->trace(message); break;
+				case Level::Info:  s_coreLogger->info(message); break;
+				case Level::Warn:  s_coreLogger->warn(message); break;
+				case Level::Error: s_coreLogger->error(message); break;
+				case Level::Fatal: s_coreLogger->critical(message); break;
+			}
+		});
+
+		LogBackend::addSink([](Level level, const std::string& message)
+		{
+			if (s_editorLogger != nullptr)
+				s_editorLogger->addLog(message);
+		});
+
+		LogBackend::start();
 	}
 
-	void Log::info(const char* format, ...)
+	void Log::shutdown()
 	{
-		va_list args;
-		char buf[1024];
-		va_start(args, format);
-		vsnprintf(buf, IM_ARRAYSIZE(buf), format, args);
-		s_coreLogger->info(buf);
-
-		if (s_editorLogger != nullptr)
-			s_editorLogger->addLog(std::string(buf));
-
-		va_end(args);
+		LogBackend::stop();
 	}
 
-	void Log::warn(const char * format, ...)
+	void Log::output(Level level, const char* message)
 	{
-		va_list args;
-		char buf[1024];
-		va_start(args, format);
-		vsnprintf(buf, IM_ARRAYSIZE(buf), format, args);
-		s_coreLogger->warn(buf);
-
-		if (s_editorLogger != nullptr)
-			s_editorLogger->addLog(std::string(buf));
-
-		va_end(args);
+		LogBackend::dispatch(level, message);
 	}
 
 	void Log::error(const char * format, ...)
@@ -84,12 +73,10 @@ namespace Razor {
 		char buf[1024];
 		va_start(args, format);
 		vsnprintf(buf, IM_ARRAYSIZE(buf), format, args);
-		s_coreLogger->error(buf);
-
-		if (s_editorLogger != nullptr)
-			s_editorLogger->addLog(std::string(buf));
-
 		va_end(args);
+
+		LogBackend::flush();
+		output(Level::Error, buf);
 	}
 
 	void Log::fatal(const char * format, ...)
@@ -98,12 +85,10 @@ namespace Razor {
 		char buf[1024];
 		va_start(args, format);
 		vsnprintf(buf, IM_ARRAYSIZE(buf), format, args);
-		s_coreLogger->critical(buf);
-
-		if (s_editorLogger != nullptr)
-			s_editorLogger->addLog(std::string(buf));
-
 		va_end(args);
+
+		LogBackend::flush();
+		output(Level::Fatal, buf);
 	}
 
 }
@@ -1,37 +1,113 @@
 #pragma once
 
 #include "Core.h"
+#include "LogBackend.h"
 #include "spdlog/spdlog.h"
 #include "spdlog/fmt/ostr.h"
 
-namespace Razor 
+namespace Razor
 {
 
 	class Logger;
 
+	// Anything usable as a format that isn't a string literal (a const char array)
+	template<typename T>
+	using RuntimeFormat = std::enable_if_t<
+		std::is_convertible<T, const char*>::value &&
+		!std::is_same<std::remove_extent_t<std::remove_reference_t<T>>, const char>::value
+	>;
+
 	class Log
 	{
 	public:
+		typedef LogBackend::Level Level;
+
 		Log();
 		static void init();
-		
+		static void shutdown();
+
 		std::function<void(const std::string&)> callback;
 
 		static std::shared_ptr<spdlog::logger> s_coreLogger;
 		static std::shared_ptr<spdlog::logger> s_clientLogger;
 		static std::shared_ptr<spdlog::logger> s_fileLogger;
 		static Logger* s_editorLogger;
+		static LogCategory s_core;
 
 		inline static std::shared_ptr<spdlog::logger>& getCoreLogger() { return s_coreLogger; }
 		inline static std::shared_ptr<spdlog::logger>& getClientLogger() { return s_clientLogger; }
 		inline static std::shared_ptr<spdlog::logger>& getFileLogger() { return s_fileLogger; }
 		inline static Logger* getEditorLogger() { return s_editorLogger; }
 
-		static void trace(const char* format, ...);
-		static void info(const char* format, ...);
-		static void warn(const char* format, ...);
+		// String literal formats are deferred: only the format pointer and the raw
+		// arguments are queued, the log thread formats and writes them.
+		// Runtime format strings are formatted on the spot.
+		template<size_t N, typename... Args>
+		inline static void trace(const char (&format)[N], const Args&... args) { write<RZ_LOG_LEVEL_TRACE>(Level::Trace, s_core, format, args...); }
+		template<size_t N, typename... Args>
+		inline static void trace(LogCategory& category, const char (&format)[N], const Args&... args) { write<RZ_LOG_LEVEL_TRACE>(Level::Trace, category, format, args...); }
+		template<typename T, typename... Args, typename = RuntimeFormat<T>>
+		inline static void trace(T&& format, const Args&... args) { writeRuntime<RZ_LOG_LEVEL_TRACE>(Level::Trace, format, args...); }
+
+		template<size_t N, typename... Args>
+		inline static void info(const char (&format)[N], const Args&... args) { write<RZ_LOG_LEVEL_INFO>(Level::Info, s_core, format, args...); }
+		template<size_t N, typename... Args>
+		inline static void info(LogCategory& category, const char (&format)[N], const Args&... args) { write<RZ_LOG_LEVEL_INFO>(Level::Info, category, format, args...); }
+		template<typename T, typename... Args, typename = RuntimeFormat<T>>
+		inline static void info(T&& format, const Args&... args) { writeRuntime<RZ_LOG_LEVEL_INFO>(Level::Info, format, args...); }
+
+		template<size_t N, typename... Args>
+		inline static void warn(const char (&format)[N], const Args&... args) { write<RZ_LOG_LEVEL_WARN>(Level::Warn, s_core, format, args...); }
+		template<size_t N, typename... Args>
+		inline static void warn(LogCategory& category, const char (&format)[N], const Args&... args) { write<RZ_LOG_LEVEL_WARN>(Level::Warn, category, format, args...); }
+		template<typename T, typename... Args, typename = RuntimeFormat<T>>
+		inline static void warn(T&& format, const Args&... args) { writeRuntime<RZ_LOG_LEVEL_WARN>(Level::Warn, format, args...); }
+
+		// Errors are always synchronous, after everything queued before them
 		static void error(const char* format, ...);
 		static void fatal(const char* format, ...);
+
+		static void output(Level level, const char* message);
+
+	private:
+		template<typename T>
+		inline static const T& argument(const T& value) { return value; }
+		inline static const char* argument(const std::string& value) { return value.c_str(); }
+
+		template<int L, typename... Args>
+		static void write(Level level, LogCategory& category, const char* format, const Args&... args)
+		{
+			if constexpr (L >= RZ_LOG_LEVEL)
+			{
+				if (!category.acquire())
+					return;
+
+				if (LogBackend::isDeferred())
+					LogBackend::record(level, category, format, args...);
+				else
+					writeRuntime<L>(level, format, args...);
+			}
+		}
+
+		template<int L, typename... Args>
+		static void writeRuntime(Level level, const char* format, const Args&... args)
+		{
+			if constexpr (L >= RZ_LOG_LEVEL)
+			{
+				char buf[1024];
+
+				if constexpr (sizeof...(Args) == 0)
+					snprintf(buf, sizeof(buf), "%s", format);
+				else
+					snprintf(buf, sizeof(buf), format, argument(args)...);
+
+				// Still goes through the queue to keep the ordering with deferred messages
+				if (LogBackend::isDeferred())
+					LogBackend::record(level, s_core, "%s", buf);
+				else
+					output(level, buf);
+			}
+		}
 	};
 
 }
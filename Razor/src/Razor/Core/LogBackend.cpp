@@ -0,0 +1,364 @@
+#include "rzpch.h"
+#include "LogBackend.h"
+
+namespace Razor
+{
+
+	std::atomic<bool> LogBackend::s_running(false);
+	bool LogBackend::s_deferred = true;
+	std::thread LogBackend::s_thread;
+	std::mutex LogBackend::s_mutex;
+	std::condition_variable LogBackend::s_condition;
+	std::atomic<uint64> LogBackend::s_flushRequest(0);
+	std::atomic<uint64> LogBackend::s_flushDone(0);
+	std::vector<std::unique_ptr<LogBackend::Ring>> LogBackend::s_rings;
+	std::shared_ptr<const std::vector<LogBackend::Sink>> LogBackend::s_sinks = std::make_shared<std::vector<LogBackend::Sink>>();
+	std::recursive_mutex LogBackend::s_outputMutex;
+
+	static thread_local LogBackend::Ring* t_ring = nullptr;
+
+	bool LogCategory::acquire()
+	{
+		if (max_per_second == 0)
+			return true;
+
+		uint64 second = LogBackend::now() / 1000000000ull;
+		uint64 current = window.load(std::memory_order_relaxed);
+
+		if (second != current && window.compare_exchange_strong(current, second, std::memory_order_relaxed))
+		{
+			uint32 dropped = suppressed.exchange(0, std::memory_order_relaxed);
+			count.store(0, std::memory_order_relaxed);
+
+			if (dropped > 0)
+				LogBackend::record(LogBackend::Level::Warn, *this, "%u messages suppressed", dropped);
+		}
+
+		if (count.fetch_add(1, std::memory_order_relaxed) < max_per_second)
+			return true;
+
+		suppressed.fetch_add(1, std::memory_order_relaxed);
+
+		return false;
+	}
+
+	LogBackend::Ring::Ring() :
+		head(0),
+		tail(0),
+		dropped(0),
+		reserved(0),
+		reserved_size(0),
+		data(new char[LOG_RING_SIZE])
+	{
+	}
+
+	char* LogBackend::Ring::reserve(uint32 size)
+	{
+		uint64 h = head.load(std::memory_order_relaxed);
+		uint64 t = tail.load(std::memory_order_acquire);
+
+		uint32 offset = (uint32)(h & (LOG_RING_SIZE - 1));
+		uint32 contiguous = LOG_RING_SIZE - offset;
+		uint64 needed = contiguous < size ? size + contiguous : size;
+
+		// Never block the caller, a full ring drops the message
+		if (size > LOG_RING_SIZE / 2 || h + needed - t > LOG_RING_SIZE)
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		if (contiguous < size)
+		{
+			((RecordHeader*)&data[offset])->size = 0;
+			h += contiguous;
+		}
+
+		reserved = h;
+		reserved_size = size;
+
+		return &data[h & (LOG_RING_SIZE - 1)];
+	}
+
+	void LogBackend::Ring::commit()
+	{
+		head.store(reserved + reserved_size, std::memory_order_release);
+	}
+
+	char* LogBackend::writeString(char* out, const char* str, uint32 length)
+	{
+		*out++ = STRING;
+		memcpy(out, &length, sizeof(length));
+		out += sizeof(length);
+
+		if (length > 0)
+			memcpy(out, str, length);
+
+		return out + length;
+	}
+
+	uint64 LogBackend::now()
+	{
+		return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+	}
+
+	LogBackend::Ring* LogBackend::getRing()
+	{
+		if (t_ring == nullptr)
+		{
+			std::unique_lock<std::mutex> lock(s_mutex);
+
+			s_rings.push_back(std::make_unique<Ring>());
+			t_ring = s_rings.back().get();
+		}
+
+		return t_ring;
+	}
+
+	void LogBackend::start()
+	{
+		if (isRunning())
+			return;
+
+		s_running = true;
+		s_thread = std::thread(&LogBackend::work);
+	}
+
+	void LogBackend::stop()
+	{
+		if (!isRunning())
+			return;
+
+		s_running = false;
+		s_condition.notify_all();
+		s_thread.join();
+
+		drain();
+	}
+
+	void LogBackend::flush()
+	{
+		if (!isRunning())
+			return;
+
+		uint64 request = s_flushRequest.fetch_add(1) + 1;
+		s_condition.notify_all();
+
+		while (s_flushDone.load(std::memory_order_acquire) < request && isRunning())
+			std::this_thread::yield();
+	}
+
+	void LogBackend::addSink(const Sink& sink)
+	{
+		std::unique_lock<std::mutex> lock(s_mutex);
+
+		std::shared_ptr<std::vector<Sink>> sinks = std::make_shared<std::vector<Sink>>(*s_sinks);
+		sinks->push_back(sink);
+		s_sinks = sinks;
+	}
+
+	std::shared_ptr<const std::vector<LogBackend::Sink>> LogBackend::getSinks()
+	{
+		std::unique_lock<std::mutex> lock(s_mutex);
+
+		return s_sinks;
+	}
+
+	void LogBackend::dispatch(Level level, const std::string& message)
+	{
+		std::shared_ptr<const std::vector<Sink>> sinks = getSinks();
+		std::lock_guard<std::recursive_mutex> lock(s_outputMutex);
+
+		for (auto& sink : *sinks)
+			sink(level, message);
+	}
+
+	void LogBackend::work()
+	{
+		while (s_running)
+		{
+			uint64 request = s_flushRequest.load(std::memory_order_acquire);
+
+			if (drain() == 0 && request == s_flushDone.load(std::memory_order_relaxed))
+			{
+				std::unique_lock<std::mutex> lock(s_mutex);
+				s_condition.wait_for(lock, std::chrono::milliseconds(5));
+			}
+
+			s_flushDone.store(request, std::memory_order_release);
+		}
+	}
+
+	size_t LogBackend::drain()
+	{
+		struct Message
+		{
+			uint64 time;
+			Level level;
+			std::string text;
+		};
+
+		std::vector<Message> messages;
+
+		{
+			std::unique_lock<std::mutex> lock(s_mutex);
+
+			for (auto& ring : s_rings)
+			{
+				ring->consume([&](const RecordHeader& header, const char* args, const char* end)
+				{
+					std::string text = format(header.format, args, end);
+
+					if (header.category != nullptr && header.category->name != nullptr)
+						text = "[" + std::string(header.category->name) + "] " + text;
+
+					messages.push_back({ header.time, (Level)header.level, std::move(text) });
+				});
+
+				uint64 dropped = ring->takeDropped();
+
+				if (dropped > 0)
+					messages.push_back({ now(), Level::Warn, std::to_string(dropped) + " messages dropped, log queue full" });
+			}
+		}
+
+		// Rings are per thread, merge them back in time order
+		std::stable_sort(messages.begin(), messages.end(), [](const Message& a, const Message& b)
+		{
+			return a.time < b.time;
+		});
+
+		if (!messages.empty())
+		{
+			std::shared_ptr<const std::vector<Sink>> sinks = getSinks();
+			std::lock_guard<std::recursive_mutex> lock(s_outputMutex);
+
+			for (auto& message : messages)
+				for (auto& sink : *sinks)
+					sink(message.level, message.text);
+		}
+
+		return messages.size();
+	}
+
+	std::string LogBackend::format(const char* format, const char* args, const char* end)
+	{
+		std::string result;
+		char spec[32];
+		char buffer[512];
+
+		result.reserve(strlen(format) + 32);
+
+		for (const char* c = format; *c != '\0'; c++)
+		{
+			if (*c != '%')
+			{
+				result += *c;
+				continue;
+			}
+
+			if (c[1] == '%')
+			{
+				result += '%';
+				c++;
+				continue;
+			}
+
+			// Copy flags, width and precision, skip the length modifiers
+			size_t length = 0;
+			spec[length++] = *c++;
+
+			while (*c != '\0' && strchr("-+ #0123456789.", *c) && length < sizeof(spec) - 4)
+				spec[length++] = *c++;
+
+			while (*c != '\0' && strchr("hljztL", *c))
+				c++;
+
+			if (*c == '\0')
+				break;
+
+			char conversion = *c;
+
+			if (args >= end || (unsigned char)*args > POINTER)
+			{
+				result += "<?>";
+				continue;
+			}
+
+			ArgType type = (ArgType)*args++;
+
+			if (type == STRING)
+			{
+				uint32 size = 0;
+				memcpy(&size, args, sizeof(size));
+				args += sizeof(size);
+
+				std::string str(args, size);
+				args += size;
+
+				if (length == 1)
+				{
+					result += str;
+					continue;
+				}
+
+				spec[length++] = 's';
+				spec[length] = '\0';
+				snprintf(buffer, sizeof(buffer), spec, str.c_str());
+				result += buffer;
+				continue;
+			}
+
+			uint64 bits = 0;
+			memcpy(&bits, args, sizeof(bits));
+			args += sizeof(bits);
+
+			if (type == DOUBLE)
+			{
+				double value = 0.0;
+				memcpy(&value, &bits, sizeof(value));
+
+				spec[length++] = strchr("fFeEgGaA", conversion) ? conversion : 'f';
+				spec[length] = '\0';
+				snprintf(buffer, sizeof(buffer), spec, value);
+			}
+			else if (type == POINTER || conversion == 'p')
+			{
+				spec[length++] = 'p';
+				spec[length] = '\0';
+				snprintf(buffer, sizeof(buffer), spec, (void*)(uintptr_t)bits);
+			}
+			else if (conversion == 'c')
+			{
+				spec[length++] = 'c';
+				spec[length] = '\0';
+				snprintf(buffer, sizeof(buffer), spec, (int)bits);
+			}
+			else if (strchr("fFeEgGaA", conversion))
+			{
+				spec[length++] = conversion;
+				spec[length] = '\0';
+				snprintf(buffer, sizeof(buffer), spec, type == INT ? (double)(int64)bits : (double)bits);
+			}
+			else
+			{
+				spec[length++] = 'l';
+				spec[length++] = 'l';
+				spec[length++] = strchr("uxXo", conversion) ? conversion : (type == INT ? 'd' : 'u');
+				spec[length] = '\0';
+
+				if (spec[length - 1] == 'd')
+					snprintf(buffer, sizeof(buffer), spec, (long long)bits);
+				else
+					snprintf(buffer, sizeof(buffer), spec, (unsigned long long)bits);
+			}
+
+			result += buffer;
+		}
+
+		return result;
+	}
+
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "Core.h"
+
+#define LOG_RING_SIZE (1 << 16)
+#define LOG_RECORD_ALIGN 8
+
+#define RZ_LOG_LEVEL_TRACE 0
+#define RZ_LOG_LEVEL_INFO 1
+#define RZ_LOG_LEVEL_WARN 2
+#define RZ_LOG_LEVEL_ERROR 3
+
+#ifndef RZ_LOG_LEVEL
+	#ifdef RZ_DIST
+		#define RZ_LOG_LEVEL RZ_LOG_LEVEL_WARN
+	#else
+		#define RZ_LOG_LEVEL RZ_LOG_LEVEL_TRACE
+	#endif
+#endif
+
+namespace Razor
+{
+
+	// Messages of a category beyond max_per_second are dropped, the count of
+	// dropped messages is reported once the next second starts
+	struct LogCategory
+	{
+		LogCategory(const char* name, uint32 max_per_second = 0) :
+			name(name),
+			max_per_second(max_per_second),
+			window(0),
+			count(0),
+			suppressed(0)
+		{}
+
+		bool acquire();
+
+		const char* name;
+		uint32 max_per_second;
+		std::atomic<uint64> window;
+		std::atomic<uint32> count;
+		std::atomic<uint32> suppressed;
+	};
+
+	class LogBackend
+	{
+	public:
+		enum class Level { Trace, Info, Warn, Error, Fatal };
+
+		enum ArgType : unsigned char { INT, UINT, DOUBLE, STRING, POINTER };
+
+		struct RecordHeader
+		{
+			uint32 size;
+			uint32 level;
+			LogCategory* category;
+			const char* format;
+			uint64 time;
+		};
+
+		// Single producer (the owning thread), single consumer (the log thread)
+		class Ring
+		{
+		public:
+			Ring();
+
+			char* reserve(uint32 size);
+			void commit();
+
+			template<typename F>
+			void consume(F callback);
+
+			inline uint64 takeDropped() { return dropped.exchange(0, std::memory_order_relaxed); }
+
+		private:
+			std::atomic<uint64> head;
+			std::atomic<uint64> tail;
+			std::atomic<uint64> dropped;
+			uint64 reserved;
+			uint32 reserved_size;
+			std::unique_ptr<char[]> data;
+		};
+
+		typedef std::function<void(Level level, const std::string& message)> Sink;
+
+		static void start();
+		static void stop();
+		static void flush();
+
+		inline static bool isRunning() { return s_running.load(std::memory_order_relaxed); }
+		inline static void setDeferred(bool deferred) { s_deferred = deferred; }
+		inline static bool isDeferred() { return s_deferred && isRunning(); }
+
+		// Sinks can be added from any thread. Calls into them are serialized
+		// between the log thread and synchronous error/fatal callers, a sink may
+		// log again on the same thread.
+		static void addSink(const Sink& sink);
+		static void dispatch(Level level, const std::string& message);
+
+		template<typename... Args>
+		static void record(Level level, LogCategory& category, const char* format, const Args&... args);
+
+		static std::string format(const char* format, const char* args, const char* end);
+		static uint64 now();
+
+	private:
+		static Ring* getRing();
+		static std::shared_ptr<const std::vector<Sink>> getSinks();
+		static void work();
+		static size_t drain();
+
+		// Argument encoding, integers are widened to 64 bits and strings copied
+		template<typename T>
+		inline static uint32 argumentSize(const T&) { return 1 + 8; }
+		inline static uint32 argumentSize(const char* str) { return 1 + 4 + (uint32)(str ? strlen(str) : 0); }
+		inline static uint32 argumentSize(char* str) { return argumentSize((const char*)str); }
+		inline static uint32 argumentSize(const std::string& str) { return 1 + 4 + (uint32)str.size(); }
+
+		template<typename T>
+		static char* writeArgument(char* out, const T& value);
+		static char* writeString(char* out, const char* str, uint32 length);
+		inline static char* writeArgument(char* out, const char* str) { return writeString(out, str, str ? (uint32)strlen(str) : 0); }
+		inline static char* writeArgument(char* out, char* str) { return writeArgument(out, (const char*)str); }
+		inline static char* writeArgument(char* out, const std::string& str) { return writeString(out, str.c_str(), (uint32)str.size()); }
+
+		static std::atomic<bool> s_running;
+		static bool s_deferred;
+		static std::thread s_thread;
+		static std::mutex s_mutex;
+		static std::condition_variable s_condition;
+		static std::atomic<uint64> s_flushRequest;
+		static std::atomic<uint64> s_flushDone;
+		static std::vector<std::unique_ptr<Ring>> s_rings;
+		// Replaced as a whole by addSink(), dispatch keeps the list it started with
+		static std::shared_ptr<const std::vector<Sink>> s_sinks;
+		static std::recursive_mutex s_outputMutex;
+	};
+
+	template<typename F>
+	void LogBackend::Ring::consume(F callback)
+	{
+		uint64 t = tail.load(std::memory_order_relaxed);
+		uint64 h = head.load(std::memory_order_acquire);
+
+		while (t < h)
+		{
+			uint32 offset = (uint32)(t & (LOG_RING_SIZE - 1));
+			const RecordHeader* header = (const RecordHeader*)&data[offset];
+
+			// Zero sized record pads the end of the buffer
+			if (header->size == 0)
+			{
+				t += LOG_RING_SIZE - offset;
+				continue;
+			}
+
+			callback(*header, (const char*)(header + 1), (const char*)header + header->size);
+			t += header->size;
+		}
+
+		tail.store(t, std::memory_order_release);
+	}
+
+	template<typename T>
+	char* LogBackend::writeArgument(char* out, const T& value)
+	{
+		static_assert(std::is_arithmetic<T>::value || std::is_pointer<T>::value || std::is_enum<T>::value, "Unsupported log argument type");
+
+		uint64 bits = 0;
+
+		if constexpr (std::is_floating_point<T>::value)
+		{
+			double v = (double)value;
+			*out++ = DOUBLE;
+			memcpy(&bits, &v, sizeof(v));
+		}
+		else if constexpr (std::is_pointer<T>::value)
+		{
+			*out++ = POINTER;
+			bits = (uint64)(uintptr_t)value;
+		}
+		else if constexpr (std::is_enum<T>::value || std::is_signed<T>::value)
+		{
+			*out++ = INT;
+			int64 v = (int64)value;
+			memcpy(&bits, &v, sizeof(v));
+		}
+		else
+		{
+			*out++ = UINT;
+			bits = (uint64)value;
+		}
+
+		memcpy(out, &bits, sizeof(bits));
+
+		return out + sizeof(bits);
+	}
+
+	template<typename... Args>
+	void LogBackend::record(Level level, LogCategory& category, const char* format, const Args&... args)
+	{
+		uint32 size = (uint32)sizeof(RecordHeader);
+		((size += argumentSize(args)), ...);
+		size = (size + LOG_RECORD_ALIGN - 1) & ~(LOG_RECORD_ALIGN - 1);
+
+		Ring* ring = getRing();
+		char* out = ring->reserve(size);
+
+		if (out == nullptr)
+			return;
+
+		RecordHeader* header = (RecordHeader*)out;
+		header->size = size;
+		header->level = (uint32)level;
+		header->category = &category;
+		header->format = format;
+		header->time = now();
+
+		out = (char*)(header + 1);
+		((out = writeArgument(out, args)), ...);
+
+		ring->commit();
+	}
+
+}
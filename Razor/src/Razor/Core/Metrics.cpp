@@ -0,0 +1,339 @@
+#include "rzpch.h"
+#include "Metrics.h"
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+namespace Razor
+{
+
+	std::array<Metrics::Entry, MAX_METRICS> Metrics::s_entries;
+	std::atomic<uint32> Metrics::s_count(0);
+	std::mutex Metrics::s_mutex;
+
+	static std::atomic<uint32> s_nextShard(0);
+
+	static inline uint32 highestBit(uint64 value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return (uint32)index;
+#else
+		return 63 - (uint32)__builtin_clzll(value);
+#endif
+	}
+
+	Counter::Counter() :
+		shards()
+	{
+		reset();
+	}
+
+	void Counter::reset()
+	{
+		for (auto& shard : shards)
+			shard.value.store(0, std::memory_order_relaxed);
+	}
+
+	uint64 Counter::get() const
+	{
+		uint64 total = 0;
+
+		for (auto& shard : shards)
+			total += shard.value.load(std::memory_order_relaxed);
+
+		return total;
+	}
+
+	uint32 Counter::getShard()
+	{
+		static thread_local uint32 shard = s_nextShard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+
+		return shard;
+	}
+
+	void Gauge::add(double delta)
+	{
+		double current = value.load(std::memory_order_relaxed);
+
+		while (!value.compare_exchange_weak(current, current + delta, std::memory_order_relaxed));
+	}
+
+	Histogram::Histogram() :
+		buckets(),
+		count(),
+		sum(),
+		max(0)
+	{
+		reset();
+	}
+
+	uint32 Histogram::getBucket(uint64 value)
+	{
+		if (value < SubBuckets)
+			return (uint32)value;
+
+		uint32 shift = highestBit(value) - HISTOGRAM_SUB_BUCKET_BITS;
+
+		if (shift >= HISTOGRAM_MAGNITUDES)
+			return BucketCount - 1;
+
+		return (shift + 1) * SubBuckets + (uint32)(value >> shift) - SubBuckets;
+	}
+
+	uint64 Histogram::getBucketLimit(uint32 bucket)
+	{
+		if (bucket < SubBuckets)
+			return bucket;
+
+		uint32 shift = bucket / SubBuckets - 1;
+		uint64 base = (uint64)(bucket % SubBuckets + SubBuckets) << shift;
+
+		return base + ((uint64)1 << shift) - 1;
+	}
+
+	void Histogram::record(uint64 value)
+	{
+		buckets[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+		count.add();
+		sum.add(value);
+
+		uint64 current = max.load(std::memory_order_relaxed);
+
+		while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+	}
+
+	void Histogram::reset()
+	{
+		// Records racing with a reset may survive it, good enough for windows
+		for (auto& bucket : buckets)
+			bucket.store(0, std::memory_order_relaxed);
+
+		count.reset();
+		sum.reset();
+		max.store(0, std::memory_order_relaxed);
+	}
+
+	uint64 Histogram::getCount() const
+	{
+		return count.get();
+	}
+
+	uint64 Histogram::getSum() const
+	{
+		return sum.get();
+	}
+
+	uint64 Histogram::getPercentile(double q) const
+	{
+		uint64 total = 0;
+
+		for (auto& bucket : buckets)
+			total += bucket.load(std::memory_order_relaxed);
+
+		if (total == 0)
+			return 0;
+
+		uint64 rank = (uint64)std::ceil(std::min(std::max(q, 0.0), 1.0) * total);
+		uint64 seen = 0;
+
+		for (uint32 i = 0; i < BucketCount; i++)
+		{
+			seen += buckets[i].load(std::memory_order_relaxed);
+
+			if (seen >= rank && seen > 0)
+				return std::min(getBucketLimit(i), getMax());
+		}
+
+		return getMax();
+	}
+
+	Metrics::Entry* Metrics::find(const char* name, Type type)
+	{
+		uint32 count = s_count.load(std::memory_order_acquire);
+
+		for (uint32 i = 0; i < count; i++)
+		{
+			if (strcmp(s_entries[i].name, name) == 0)
+			{
+				if (s_entries[i].type != type)
+					Log::error("Metric %s registered twice with different types", name);
+
+				return s_entries[i].type == type ? &s_entries[i] : nullptr;
+			}
+		}
+
+		return nullptr;
+	}
+
+	Metrics::Entry& Metrics::add(const char* name, const char* help, const char* unit, Type type, void* metric)
+	{
+		uint32 index = s_count.load(std::memory_order_relaxed);
+
+		Entry& entry = s_entries[index];
+		entry.name = name;
+		entry.help = help;
+		entry.unit = unit;
+		entry.type = type;
+		entry.metric = metric;
+
+		// Readers only look at entries below the count
+		s_count.store(index + 1, std::memory_order_release);
+
+		return entry;
+	}
+
+	Counter& Metrics::counter(const char* name, const char* help)
+	{
+		static Counter s_overflow;
+		std::unique_lock<std::mutex> lock(s_mutex);
+
+		if (Entry* entry = find(name, Type::COUNTER))
+			return *(Counter*)entry->metric;
+
+		if (s_count.load(std::memory_order_relaxed) >= MAX_METRICS)
+		{
+			Log::error("Too many metrics, %s is not registered", name);
+			return s_overflow;
+		}
+
+		return *(Counter*)add(name, help, "", Type::COUNTER, new Counter()).metric;
+	}
+
+	Gauge& Metrics::gauge(const char* name, const char* help)
+	{
+		static Gauge s_overflow;
+		std::unique_lock<std::mutex> lock(s_mutex);
+
+		if (Entry* entry = find(name, Type::GAUGE))
+			return *(Gauge*)entry->metric;
+
+		if (s_count.load(std::memory_order_relaxed) >= MAX_METRICS)
+		{
+			Log::error("Too many metrics, %s is not registered", name);
+			return s_overflow;
+		}
+
+		return *(Gauge*)add(name, help, "", Type::GAUGE, new Gauge()).metric;
+	}
+
+	Histogram& Metrics::histogram(const char* name, const char* unit, const char* help)
+	{
+		static Histogram s_overflow;
+		std::unique_lock<std::mutex> lock(s_mutex);
+
+		if (Entry* entry = find(name, Type::HISTOGRAM))
+			return *(Histogram*)entry->metric;
+
+		if (s_count.load(std::memory_order_relaxed) >= MAX_METRICS)
+		{
+			Log::error("Too many metrics, %s is not registered", name);
+			return s_overflow;
+		}
+
+		return *(Histogram*)add(name, help, unit, Type::HISTOGRAM, new Histogram()).metric;
+	}
+
+	// Prometheus names only allow [a-zA-Z0-9_:]
+	static std::string exposedName(const char* name, const char* unit)
+	{
+		std::string result = "razor_";
+		result += name;
+
+		if (unit != nullptr && unit[0] != '\0')
+			result += std::string("_") + unit;
+
+		for (auto& c : result)
+			if (!isalnum((unsigned char)c) && c != '_' && c != ':')
+				c = '_';
+
+		return result;
+	}
+
+	std::string Metrics::dump(Format format)
+	{
+		static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+		static const char* quantile_names[] = { "p50", "p90", "p99", "p999" };
+
+		uint32 count = s_count.load(std::memory_order_acquire);
+		std::ostringstream stream;
+		stream << std::fixed << std::setprecision(3);
+
+		if (format == Format::JSON)
+			stream << "{";
+
+		for (uint32 i = 0; i < count; i++)
+		{
+			const Entry& entry = s_entries[i];
+
+			if (format == Format::JSON)
+			{
+				stream << (i > 0 ? "," : "") << "\n\"" << entry.name << "\": {";
+
+				switch (entry.type)
+				{
+					case Type::COUNTER:
+						stream << "\"type\": \"counter\", \"value\": " << ((Counter*)entry.metric)->get();
+						break;
+					case Type::GAUGE:
+						stream << "\"type\": \"gauge\", \"value\": " << ((Gauge*)entry.metric)->get();
+						break;
+					case Type::HISTOGRAM:
+					{
+						Histogram* histogram = (Histogram*)entry.metric;
+
+						stream << "\"type\": \"histogram\", \"unit\": \"" << entry.unit << "\""
+							<< ", \"count\": " << histogram->getCount()
+							<< ", \"sum\": " << histogram->getSum()
+							<< ", \"mean\": " << histogram->getMean()
+							<< ", \"max\": " << histogram->getMax();
+
+						for (int q = 0; q < 4; q++)
+							stream << ", \"" << quantile_names[q] << "\": " << histogram->getPercentile(quantiles[q]);
+
+						break;
+					}
+				}
+
+				stream << "}";
+				continue;
+			}
+
+			std::string name = exposedName(entry.name, entry.type == Type::HISTOGRAM ? entry.unit : nullptr);
+
+			if (entry.help[0] != '\0')
+				stream << "# HELP " << name << " " << entry.help << "\n";
+
+			switch (entry.type)
+			{
+				case Type::COUNTER:
+					stream << "# TYPE " << name << " counter\n" << name << " " << ((Counter*)entry.metric)->get() << "\n";
+					break;
+				case Type::GAUGE:
+					stream << "# TYPE " << name << " gauge\n" << name << " " << ((Gauge*)entry.metric)->get() << "\n";
+					break;
+				case Type::HISTOGRAM:
+				{
+					Histogram* histogram = (Histogram*)entry.metric;
+
+					stream << "# TYPE " << name << " summary\n";
+
+					for (int q = 0; q < 4; q++)
+						stream << name << "{quantile=\"" << quantiles[q] << "\"} " << histogram->getPercentile(quantiles[q]) << "\n";
+
+					stream << name << "_sum " << histogram->getSum() << "\n";
+					stream << name << "_count " << histogram->getCount() << "\n";
+					break;
+				}
+			}
+		}
+
+		if (format == Format::JSON)
+			stream << "\n}\n";
+
+		return stream.str();
+	}
+
+}
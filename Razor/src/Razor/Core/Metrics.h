@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Core.h"
+
+#define MAX_METRICS 256
+#define METRIC_SHARDS 16
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_MAGNITUDES 40
+
+namespace Razor
+{
+
+	// Monotonic count, every thread adds to its own cache line
+	class Counter
+	{
+	public:
+		Counter();
+
+		inline void add(uint64 value = 1) { shards[getShard()].value.fetch_add(value, std::memory_order_relaxed); }
+		uint64 get() const;
+		void reset();
+
+		static uint32 getShard();
+
+	private:
+		struct alignas(64) Shard
+		{
+			std::atomic<uint64> value;
+		};
+
+		std::array<Shard, METRIC_SHARDS> shards;
+	};
+
+	// Last written value
+	class Gauge
+	{
+	public:
+		Gauge() : value(0.0) {}
+
+		inline void set(double value) { this->value.store(value, std::memory_order_relaxed); }
+		void add(double delta);
+		inline double get() const { return value.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<double> value;
+	};
+
+	// Log-linear buckets in the spirit of HdrHistogram: each power of two is
+	// split in 2^HISTOGRAM_SUB_BUCKET_BITS buckets, so percentiles stay within
+	// ~6% of the recorded value from 1 up to 2^HISTOGRAM_MAGNITUDES
+	class Histogram
+	{
+	public:
+		Histogram();
+
+		void record(uint64 value);
+		void reset();
+
+		uint64 getCount() const;
+		uint64 getSum() const;
+		inline uint64 getMax() const { return max.load(std::memory_order_relaxed); }
+		inline double getMean() const { uint64 count = getCount(); return count > 0 ? (double)getSum() / count : 0.0; }
+
+		// q in [0, 1], returns the upper bound of the bucket holding it
+		uint64 getPercentile(double q) const;
+
+	private:
+		static const uint32 SubBuckets = 1 << HISTOGRAM_SUB_BUCKET_BITS;
+		static const uint32 BucketCount = (HISTOGRAM_MAGNITUDES + 1) * SubBuckets;
+
+		static uint32 getBucket(uint64 value);
+		static uint64 getBucketLimit(uint32 bucket);
+
+		std::array<std::atomic<uint64>, BucketCount> buckets;
+		Counter count;
+		Counter sum;
+		std::atomic<uint64> max;
+	};
+
+	// Process wide registry. Metrics are registered once, usually into a
+	// static, and never removed; updating them is lock free.
+	//
+	//   static Counter& s_drawCalls = Metrics::counter("renderer.draw_calls", "Draw calls issued");
+	//   s_drawCalls.add();
+	class Metrics
+	{
+	public:
+		enum class Type
+		{
+			COUNTER,
+			GAUGE,
+			HISTOGRAM
+		};
+
+		enum class Format
+		{
+			TEXT,
+			JSON
+		};
+
+		static Counter& counter(const char* name, const char* help = "");
+		static Gauge& gauge(const char* name, const char* help = "");
+		// unit only documents the recorded values (e.g. "us")
+		static Histogram& histogram(const char* name, const char* unit = "us", const char* help = "");
+
+		static std::string dump(Format format = Format::TEXT);
+
+	private:
+		struct Entry
+		{
+			const char* name;
+			const char* help;
+			const char* unit;
+			Type type;
+			void* metric;
+		};
+
+		static Entry* find(const char* name, Type type);
+		static Entry& add(const char* name, const char* help, const char* unit, Type type, void* metric);
+
+		static std::array<Entry, MAX_METRICS> s_entries;
+		static std::atomic<uint32> s_count;
+		static std::mutex s_mutex;
+	};
+
+}
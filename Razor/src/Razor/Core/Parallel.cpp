@@ -0,0 +1,53 @@
+#include "rzpch.h"
+#include "Parallel.h"
+#include "JobSystem.h"
+
+namespace Razor
+{
+
+	std::atomic<bool> Parallel::s_deterministic(false);
+
+	uint32 Parallel::getChunkCount(size_t count, size_t grain)
+	{
+		if (count == 0)
+			return 1;
+
+		size_t chunks = (count + std::max(grain, (size_t)1) - 1) / std::max(grain, (size_t)1);
+
+		return (uint32)std::min(std::max(chunks, (size_t)1), (size_t)PARALLEL_MAX_CHUNKS);
+	}
+
+	size_t Parallel::getChunkBegin(size_t count, uint32 chunks, uint32 chunk)
+	{
+		// Spreads the remainder so chunk sizes differ by one at most
+		return count / chunks * chunk + std::min((size_t)chunk, count % chunks);
+	}
+
+	void Parallel::run(uint32 chunks, const std::function<void(uint32)>& function)
+	{
+		JobSystem* jobs = JobSystem::exists() ? &JobSystem::get() : nullptr;
+
+		if (chunks <= 1 || isDeterministic() || jobs == nullptr || jobs->getThreadsCount() < 2)
+		{
+			for (uint32 i = 0; i < chunks; i++)
+				function(i);
+
+			return;
+		}
+
+		RZ_PROFILE_FUNCTION();
+
+		// The parent only completes once every chunk has, and it isn't
+		// submitted before all of them are attached
+		JobHandle parent = jobs->create(JobFunction());
+
+		for (uint32 i = 1; i < chunks; i++)
+			jobs->submit(jobs->create([&function, i] { function(i); }, parent));
+
+		function(0);
+
+		jobs->submit(parent);
+		jobs->wait(parent);
+	}
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Core.h"
+
+#define PARALLEL_MAX_CHUNKS 256
+
+namespace Razor
+{
+
+	// Splits [begin, end) in chunks of at least grain items and runs them on
+	// the JobSystem, the calling thread helps until every chunk is done.
+	// Chunking only depends on the range and the grain, never on the thread
+	// count, so reductions give the same result on every machine.
+	class Parallel
+	{
+	public:
+		// Runs every chunk in order on the calling thread, for tests and repro
+		inline static void setDeterministic(bool deterministic) { s_deterministic = deterministic; }
+		inline static bool isDeterministic() { return s_deterministic; }
+
+		static uint32 getChunkCount(size_t count, size_t grain);
+		static size_t getChunkBegin(size_t count, uint32 chunks, uint32 chunk);
+
+		// Calls function(chunk) for chunk in [0, chunks)
+		static void run(uint32 chunks, const std::function<void(uint32)>& function);
+
+	private:
+		static std::atomic<bool> s_deterministic;
+	};
+
+	// function(first, last) processes the items [first, last)
+	template<typename Function>
+	void parallel_for(size_t begin, size_t end, size_t grain, const Function& function)
+	{
+		if (end <= begin)
+			return;
+
+		size_t count = end - begin;
+		uint32 chunks = Parallel::getChunkCount(count, grain);
+
+		if (chunks == 1)
+		{
+			function(begin, end);
+			return;
+		}
+
+		Parallel::run(chunks, [&](uint32 chunk)
+		{
+			function(
+				begin + Parallel::getChunkBegin(count, chunks, chunk),
+				begin + Parallel::getChunkBegin(count, chunks, chunk + 1)
+			);
+		});
+	}
+
+	// reduce(first, last, value) folds the items [first, last) into value,
+	// combine(a, b) merges two partial results. Partials are combined in range order.
+	template<typename T, typename Reduce, typename Combine>
+	T parallel_reduce(size_t begin, size_t end, size_t grain, const T& identity, const Reduce& reduce, const Combine& combine)
+	{
+		if (end <= begin)
+			return identity;
+
+		size_t count = end - begin;
+		uint32 chunks = Parallel::getChunkCount(count, grain);
+
+		if (chunks == 1)
+			return reduce(begin, end, identity);
+
+		// Wrapped so T = bool doesn't end up in a packed std::vector<bool>
+		struct Partial { T value; };
+		std::vector<Partial> partials(chunks, Partial{ identity });
+
+		Parallel::run(chunks, [&](uint32 chunk)
+		{
+			partials[chunk].value = reduce(
+				begin + Parallel::getChunkBegin(count, chunks, chunk),
+				begin + Parallel::getChunkBegin(count, chunks, chunk + 1),
+				identity
+			);
+		});
+
+		T result = partials[0].value;
+
+		for (uint32 i = 1; i < chunks; i++)
+			result = combine(result, partials[i].value);
+
+		return result;
+	}
+
+	// Sorts chunks in parallel then merges them pairwise, not stable
+	template<typename Iterator, typename Compare>
+	void parallel_sort(Iterator first, Iterator last, size_t grain, const Compare& compare)
+	{
+		size_t count = (size_t)std::distance(first, last);
+		uint32 chunks = Parallel::getChunkCount(count, std::max(grain, (size_t)2));
+
+		if (chunks == 1)
+		{
+			std::sort(first, last, compare);
+			return;
+		}
+
+		auto at = [&](uint32 chunk) { return first + Parallel::getChunkBegin(count, chunks, std::min(chunk, chunks)); };
+
+		Parallel::run(chunks, [&](uint32 chunk)
+		{
+			std::sort(at(chunk), at(chunk + 1), compare);
+		});
+
+		for (uint32 width = 1; width < chunks; width *= 2)
+		{
+			uint32 merges = (chunks + 2 * width - 1) / (2 * width);
+
+			Parallel::run(merges, [&](uint32 merge)
+			{
+				uint32 left = merge * 2 * width;
+
+				if (left + width < chunks)
+					std::inplace_merge(at(left), at(left + width), at(left + 2 * width), compare);
+			});
+		}
+	}
+
+	template<typename Iterator>
+	void parallel_sort(Iterator first, Iterator last, size_t grain)
+	{
+		parallel_sort(first, last, grain, std::less<typename std::iterator_traits<Iterator>::value_type>());
+	}
+
+}
@@ -17,9 +17,12 @@ namespace Razor {
 		return nullptr;
 	}
 
-	void Profiler::addTimer(const std::string& name)
+	Timer* Profiler::addTimer(const std::string& name)
 	{
-		m_timers[name] = new Timer(m_clock);
+		Timer* timer = new Timer(m_clock);
+		m_timers[name] = timer;
+
+		return timer;
 	}
 
 	void Profiler::startTimer(const std::string& name)
@@ -32,6 +35,11 @@ namespace Razor {
 		m_timers[name]->stop();
 	}
 
+	void Profiler::addTime(const std::string& name, double time)
+	{
+		m_timers[name]->addTime(time);
+	}
+
 	double Profiler::getReport(const std::string& name)
 	{
 		return m_timers[name]->report(0);
@@ -11,9 +11,10 @@ namespace Razor {
 		~Profiler();
 
 		Timer* getTimer(const std::string& name);
-		void addTimer(const std::string& name);
+		Timer* addTimer(const std::string& name);
 		void stopTimer(const std::string& name);
 		void startTimer(const std::string& name);
+		void addTime(const std::string& name, double time);
 		double getReport(const std::string& name);
 
 	private:
@@ -1,10 +1,14 @@
 #include "rzpch.h"
 #include "System.h"
+#include "Metrics.h"
 
 namespace Razor
 {
 
-	System::System()
+	System::System() :
+		virtual_memory(),
+		physical_memory(),
+		cpu()
 	{
 
 	}
@@ -33,5 +37,15 @@ namespace Razor
 		physical_memory.process_usage = pmc.WorkingSetSize;
 
 		// CPU -> TODO
+
+		static Gauge& s_virtualUsage = Metrics::gauge("system.virtual_memory.process", "Virtual memory used by the process in bytes");
+		static Gauge& s_physicalUsage = Metrics::gauge("system.physical_memory.process", "Physical memory used by the process in bytes");
+		static Gauge& s_physicalSystem = Metrics::gauge("system.physical_memory.system", "Physical memory used by the system in bytes");
+		static Gauge& s_physicalTotal = Metrics::gauge("system.physical_memory.total", "Installed physical memory in bytes");
+
+		s_virtualUsage.set((double)virtual_memory.process_usage);
+		s_physicalUsage.set((double)physical_memory.process_usage);
+		s_physicalSystem.set((double)physical_memory.system_usage);
+		s_physicalTotal.set((double)physical_memory.total);
 	}
 }
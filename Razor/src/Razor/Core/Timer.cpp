@@ -3,7 +3,10 @@
 
 namespace Razor {
 
-	Timer::Timer(Clock* clock)
+	Timer::Timer(Clock* clock) :
+		m_calls(0),
+		m_startTime(0.0),
+		m_totalTime(0.0)
 	{
 		m_clock = clock;
 	}
@@ -20,6 +23,12 @@ namespace Razor {
 		m_startTime = 0;
 	}
 
+	void Timer::addTime(double time)
+	{
+		m_calls++;
+		m_totalTime += time;
+	}
+
 	double Timer::report(double divisor)
 	{
 		divisor = (divisor == 0) ? m_calls : divisor;
@@ -12,6 +12,7 @@ namespace Razor {
 
 		void start();
 		void stop();
+		void addTime(double time);
 		double report(double divisor);
 
 	private:
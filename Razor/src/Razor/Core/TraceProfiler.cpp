@@ -0,0 +1,306 @@
+#include "rzpch.h"
+#include "TraceProfiler.h"
+
+namespace Razor
+{
+
+	std::atomic<bool> TraceProfiler::s_capturing(false);
+	uint64 TraceProfiler::s_captureStart = 0;
+	std::string TraceProfiler::s_outputPath = "./razor_trace";
+	std::mutex TraceProfiler::s_mutex;
+	std::vector<std::unique_ptr<TraceProfiler::ThreadBuffer>> TraceProfiler::s_buffers;
+	std::vector<TraceProfiler::Track> TraceProfiler::s_capture;
+
+	static thread_local std::string t_threadName;
+	static thread_local TraceProfiler::ThreadBuffer* t_buffer = nullptr;
+
+	TraceProfiler::ThreadBuffer::ThreadBuffer(uint32 thread) :
+		thread(thread),
+		name(),
+		head(0),
+		capture_begin(0),
+		next_id(0),
+		depth(0),
+		events(new Event[TRACE_EVENTS_PER_THREAD])
+	{
+	}
+
+	TraceProfiler::ThreadBuffer& TraceProfiler::getThreadBuffer()
+	{
+		if (t_buffer == nullptr)
+		{
+			std::unique_lock<std::mutex> lock(s_mutex);
+
+			s_buffers.push_back(std::make_unique<ThreadBuffer>((uint32)s_buffers.size()));
+			t_buffer = s_buffers.back().get();
+			t_buffer->name = t_threadName.empty() ? "Thread " + std::to_string(t_buffer->thread) : t_threadName;
+		}
+
+		return *t_buffer;
+	}
+
+	void TraceProfiler::beginZone(ProfileScope& scope)
+	{
+		ThreadBuffer& buffer = getThreadBuffer();
+
+		scope.id = ++buffer.next_id;
+		scope.depth = buffer.depth;
+		scope.parent = buffer.depth > 0 && buffer.depth <= MAX_TRACE_DEPTH ? buffer.stack[buffer.depth - 1] : 0;
+
+		if (buffer.depth < MAX_TRACE_DEPTH)
+			buffer.stack[buffer.depth] = scope.id;
+
+		buffer.depth++;
+		scope.start = now();
+	}
+
+	void TraceProfiler::endZone(ProfileScope& scope)
+	{
+		uint64 end = now();
+		ThreadBuffer& buffer = getThreadBuffer();
+
+		buffer.depth--;
+
+		if (!isCapturing())
+			return;
+
+		uint64 head = buffer.head.load(std::memory_order_relaxed);
+		buffer.events[head & (TRACE_EVENTS_PER_THREAD - 1)] = { scope.name, scope.start, end, scope.id, scope.parent, scope.depth };
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	void TraceProfiler::setThreadName(const std::string& name)
+	{
+		t_threadName = name;
+
+		if (t_buffer != nullptr)
+		{
+			std::unique_lock<std::mutex> lock(s_mutex);
+			t_buffer->name = name;
+		}
+	}
+
+	void TraceProfiler::beginCapture()
+	{
+		if (isCapturing())
+			return;
+
+		{
+			std::unique_lock<std::mutex> lock(s_mutex);
+
+			for (auto& buffer : s_buffers)
+				buffer->capture_begin = buffer->head.load(std::memory_order_acquire);
+
+			s_capture.clear();
+			s_captureStart = now();
+		}
+
+		s_capturing.store(true, std::memory_order_release);
+		Log::info("Profiler capture started");
+	}
+
+	void TraceProfiler::endCapture()
+	{
+		if (!isCapturing())
+			return;
+
+		s_capturing.store(false, std::memory_order_release);
+
+		std::unique_lock<std::mutex> lock(s_mutex);
+
+		s_capture.clear();
+
+		for (auto& buffer : s_buffers)
+		{
+			uint64 head = buffer->head.load(std::memory_order_acquire);
+			uint64 begin = buffer->capture_begin;
+
+			// Keep a margin in case a zone was closing while the capture stopped
+			if (head - begin > TRACE_EVENTS_PER_THREAD - 64)
+				begin = head - (TRACE_EVENTS_PER_THREAD - 64);
+
+			Track track;
+			track.thread = buffer->thread;
+			track.name = buffer->name;
+			track.events.reserve((size_t)(head - begin));
+
+			for (uint64 i = begin; i < head; i++)
+			{
+				Event event = buffer->events[i & (TRACE_EVENTS_PER_THREAD - 1)];
+
+				if (event.start < s_captureStart)
+					continue;
+
+				event.start -= s_captureStart;
+				event.end -= s_captureStart;
+				track.events.push_back(event);
+			}
+
+			if (!track.events.empty())
+				s_capture.push_back(std::move(track));
+		}
+
+		lock.unlock();
+
+		writeChromeTrace(s_outputPath + ".json");
+		writeBinaryTrace(s_outputPath + ".rztrace");
+	}
+
+	void TraceProfiler::toggleCapture()
+	{
+		if (isCapturing())
+			endCapture();
+		else
+			beginCapture();
+	}
+
+	static void writeJsonString(std::ofstream& stream, const char* str)
+	{
+		stream << '"';
+
+		for (const char* c = str; *c != '\0'; c++)
+		{
+			if (*c == '"' || *c == '\\')
+				stream << '\\';
+
+			stream << *c;
+		}
+
+		stream << '"';
+	}
+
+	bool TraceProfiler::writeChromeTrace(const std::string& path)
+	{
+		std::ofstream stream(path, std::ios::out | std::ios::trunc);
+
+		if (!stream.is_open())
+		{
+			Log::error("Unable to write profiler trace: %s", path.c_str());
+			return false;
+		}
+
+		size_t count = 0;
+		bool first = true;
+
+		stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		stream << std::fixed << std::setprecision(3);
+
+		for (auto& track : s_capture)
+		{
+			stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << track.thread << ",\"args\":{\"name\":";
+			writeJsonString(stream, track.name.c_str());
+			stream << "}}";
+			first = false;
+
+			for (auto& event : track.events)
+			{
+				stream << ",\n{\"name\":";
+				writeJsonString(stream, event.name);
+				stream << ",\"cat\":\"razor\",\"ph\":\"X\",\"pid\":0,\"tid\":" << track.thread
+					<< ",\"ts\":" << (double)event.start / 1000.0
+					<< ",\"dur\":" << (double)(event.end - event.start) / 1000.0
+					<< ",\"args\":{\"id\":" << event.id << ",\"parent\":" << event.parent << ",\"depth\":" << event.depth << "}}";
+				count++;
+			}
+		}
+
+		stream << "\n]}\n";
+		stream.close();
+
+		Log::info("Profiler trace written: %s (%d zones)", path.c_str(), (int)count);
+
+		return true;
+	}
+
+	bool TraceProfiler::writeBinaryTrace(const std::string& path)
+	{
+		std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!stream.is_open())
+		{
+			Log::error("Unable to write profiler trace: %s", path.c_str());
+			return false;
+		}
+
+		// Zone names are interned by pointer, they are static strings
+		std::vector<const char*> names;
+		std::unordered_map<const char*, uint32> indices;
+
+		auto intern = [&](const char* name) -> uint32
+		{
+			auto it = indices.find(name);
+
+			if (it != indices.end())
+				return it->second;
+
+			uint32 index = (uint32)names.size();
+			indices[name] = index;
+			names.push_back(name);
+
+			return index;
+		};
+
+		for (auto& track : s_capture)
+			for (auto& event : track.events)
+				intern(event.name);
+
+		auto write = [&](const auto& value) { stream.write((const char*)&value, sizeof(value)); };
+
+		const char magic[4] = { 'R', 'Z', 'T', 'R' };
+		stream.write(magic, sizeof(magic));
+		write((uint32)1);
+		write((uint32)names.size());
+		write((uint32)s_capture.size());
+
+		for (auto name : names)
+		{
+			uint32 length = (uint32)strlen(name);
+			write(length);
+			stream.write(name, length);
+		}
+
+		for (auto& track : s_capture)
+		{
+			write(track.thread);
+			write((uint32)track.name.size());
+			stream.write(track.name.c_str(), track.name.size());
+			write((uint32)track.events.size());
+
+			for (auto& event : track.events)
+			{
+				write(indices[event.name]);
+				write(event.id);
+				write(event.parent);
+				write(event.depth);
+				write(event.start);
+				write(event.end);
+			}
+		}
+
+		stream.close();
+
+		return true;
+	}
+
+	void TraceProfiler::parseCommandLine(int argc, char** argv)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string arg = argv[i];
+
+			if (arg == "--trace" || arg.rfind("--trace=", 0) == 0)
+			{
+				if (arg.size() > 8)
+					s_outputPath = arg.substr(8);
+
+				beginCapture();
+			}
+		}
+	}
+
+	void TraceProfiler::shutdown()
+	{
+		endCapture();
+	}
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Core.h"
+
+#define TRACE_EVENTS_PER_THREAD (1 << 16)
+#define MAX_TRACE_DEPTH 128
+
+#ifndef RZ_DIST
+	#define RZ_ENABLE_PROFILING
+#endif
+
+#ifdef RZ_ENABLE_PROFILING
+	#define RZ_PROFILE_CONCAT_IMPL(a, b) a##b
+	#define RZ_PROFILE_CONCAT(a, b) RZ_PROFILE_CONCAT_IMPL(a, b)
+	#define RZ_PROFILE_SCOPE(name) ::Razor::ProfileScope RZ_PROFILE_CONCAT(rz_profile_scope_, __LINE__)(name)
+	#define RZ_PROFILE_FUNCTION() RZ_PROFILE_SCOPE(__FUNCTION__)
+#else
+	#define RZ_PROFILE_SCOPE(name)
+	#define RZ_PROFILE_FUNCTION()
+#endif
+
+namespace Razor
+{
+
+	class ProfileScope;
+
+	class TraceProfiler
+	{
+	public:
+		// Zone names must be string literals (or otherwise outlive the capture),
+		// only their pointer is recorded.
+		struct Event
+		{
+			const char* name;
+			uint64 start;
+			uint64 end;
+			uint32 id;
+			uint32 parent;
+			uint32 depth;
+		};
+
+		struct Track
+		{
+			uint32 thread;
+			std::string name;
+			std::vector<Event> events;
+		};
+
+		static inline uint64 now()
+		{
+			return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()
+			).count();
+		}
+
+		static inline bool isCapturing() { return s_capturing.load(std::memory_order_relaxed); }
+
+		static void beginZone(ProfileScope& scope);
+		static void endZone(ProfileScope& scope);
+
+		static void setThreadName(const std::string& name);
+
+		static void beginCapture();
+		static void endCapture();
+		static void toggleCapture();
+
+		static bool writeChromeTrace(const std::string& path);
+		static bool writeBinaryTrace(const std::string& path);
+
+		static void parseCommandLine(int argc, char** argv);
+		static void shutdown();
+
+		inline static const std::vector<Track>& getCapture() { return s_capture; }
+		inline static void setOutputPath(const std::string& path) { s_outputPath = path; }
+		inline static const std::string& getOutputPath() { return s_outputPath; }
+
+		struct ThreadBuffer
+		{
+			ThreadBuffer(uint32 thread);
+
+			uint32 thread;
+			std::string name;
+			std::atomic<uint64> head;
+			uint64 capture_begin;
+			uint32 next_id;
+			uint32 depth;
+			uint32 stack[MAX_TRACE_DEPTH];
+			std::unique_ptr<Event[]> events;
+		};
+
+	private:
+		static ThreadBuffer& getThreadBuffer();
+
+		static std::atomic<bool> s_capturing;
+		static uint64 s_captureStart;
+		static std::string s_outputPath;
+		static std::mutex s_mutex;
+		static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+		static std::vector<Track> s_capture;
+	};
+
+	class ProfileScope
+	{
+	public:
+		inline ProfileScope(const char* name) :
+			name(name),
+			start(0),
+			id(0),
+			parent(0),
+			depth(0),
+			active(TraceProfiler::isCapturing())
+		{
+			if (active)
+				TraceProfiler::beginZone(*this);
+		}
+
+		inline ~ProfileScope()
+		{
+			if (active)
+				TraceProfiler::endZone(*this);
+		}
+
+		const char* name;
+		uint64 start;
+		uint32 id;
+		uint32 parent;
+		uint32 depth;
+		bool active;
+	};
+
+}
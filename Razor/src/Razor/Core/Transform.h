@@ -12,7 +12,17 @@ namespace Razor
 		glm::vec3 m_rotation = glm::vec3(0.0f);
 		glm::vec3 m_scale = glm::vec3(1.0f);
 		glm::mat4 m_matrix = glm::mat4(1.0f);
+		// Set by the setters, the vectors are only writable through them
 		bool m_dirty;
+		// Bumped every time the local matrix changes
+		unsigned int m_version = 0;
+
+		void rebuild()
+		{
+			m_matrix = getPositionMatrix() * getRotationMatrix() * getScaleMatrix();
+			m_dirty = false;
+			m_version++;
+		}
 
 	public:
 		Transform(
@@ -25,22 +35,46 @@ namespace Razor
 			m_scale(scale),
 			m_dirty(true) {}
 
+		Transform(const Transform& other) = default;
+
+		// Keeps the version of the destination going so nodes caching a
+		// world matrix notice a transform replaced as a whole
+		Transform& operator=(const Transform& other)
+		{
+			m_position = other.m_position;
+			m_rotation = other.m_rotation;
+			m_scale = other.m_scale;
+			m_matrix = other.m_matrix;
+			m_dirty = true;
+
+			return *this;
+		}
+
 		virtual ~Transform() {};
 
+		// Local matrix, only rebuilt when the position, rotation or scale changed
 		inline glm::mat4& getMatrix()
 		{
-			glm::mat4 positionMatrix = glm::translate(m_position);
-			glm::mat4 rotationXMatrix = glm::rotate(m_rotation.x, glm::vec3(1, 0, 0));
-			glm::mat4 rotationYMatrix = glm::rotate(m_rotation.y, glm::vec3(0, 1, 0));
-			glm::mat4 rotationZMatrix = glm::rotate(m_rotation.z, glm::vec3(0, 0, 1));
-			glm::mat4 scaleMatrix = glm::scale(m_scale);
-
-			glm::mat4 rotationMatrix = rotationZMatrix * rotationYMatrix * rotationXMatrix;
-			m_matrix = positionMatrix * rotationMatrix * scaleMatrix;
+			if (m_dirty)
+				rebuild();
 
 			return m_matrix;
 		}
 
+		inline bool isDirty() const
+		{
+			return m_dirty;
+		}
+
+		// Brings the local matrix up to date and returns its version
+		inline unsigned int getVersion()
+		{
+			if (m_dirty)
+				rebuild();
+
+			return m_version;
+		}
+
 		inline glm::mat4 getPositionMatrix() { return glm::translate(m_position); }
 		inline glm::mat4 getScaleMatrix() { return glm::scale(m_scale); }
 		inline glm::mat4 getRotationMatrix() {
@@ -51,12 +85,12 @@ namespace Razor
 			return rotationZMatrix * rotationYMatrix * rotationXMatrix;
 		}
 
-		inline glm::vec3& getPosition() { return m_position; };
-		inline float& getPositionX() { return m_position.x; };
-		inline float& getPositionY() { return m_position.y; };
-		inline float& getPositionZ() { return m_position.z; };
-		inline glm::vec3& getRotation() { return m_rotation; };
-		inline glm::vec3& getScale() { return m_scale; };
+		inline const glm::vec3& getPosition() const { return m_position; };
+		inline float getPositionX() const { return m_position.x; };
+		inline float getPositionY() const { return m_position.y; };
+		inline float getPositionZ() const { return m_position.z; };
+		inline const glm::vec3& getRotation() const { return m_rotation; };
+		inline const glm::vec3& getScale() const { return m_scale; };
 
 		inline void setPosition(const glm::vec3& position) { m_dirty = true; m_position = position; }
 		inline void setPositionX(float position) { m_dirty = true; m_position.x = position; }
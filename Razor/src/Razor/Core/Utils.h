@@ -293,6 +293,23 @@ namespace Razor
 			return fileDialog(OFN_PATHMUSTEXIST);
 		}
 
+		static std::string saveFileDialog(const char* extension = nullptr) {
+			OPENFILENAMEA ofn;
+			ZeroMemory(&ofn, sizeof(ofn));
+			char buffer[MAX_PATH] = "";
+
+			ofn.lStructSize = sizeof(ofn);
+			ofn.hwndOwner = NULL;
+			ofn.lpstrFilter = "All\0*.*\0";
+			ofn.lpstrFile = buffer;
+			ofn.nFilterIndex = 1;
+			ofn.nMaxFile = MAX_PATH;
+			ofn.lpstrDefExt = extension;
+			ofn.Flags = OFN_DONTADDTORECENT | OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST;
+
+			return GetSaveFileNameA(&ofn) ? std::string(ofn.lpstrFile) : "";
+		}
+
 		template<class T>
 		static std::string numberFormatLocale(T value, char sep = ' ') {
 			struct Numpunct : public std::numpunct<char> 
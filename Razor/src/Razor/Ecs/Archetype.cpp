@@ -0,0 +1,119 @@
+#include "rzpch.h"
+#include "Archetype.h"
+#include "Manager.h"
+
+namespace Razor {
+	namespace ECS {
+
+		static size_t alignUp(size_t value, size_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		Archetype::Archetype(const ComponentBitset& signature) :
+			signature(signature),
+			types({}),
+			offsets({}),
+			sizes({}),
+			capacity(0),
+			count(0),
+			chunks({})
+		{
+			add_edges.fill(nullptr);
+			remove_edges.fill(nullptr);
+
+			size_t row_size = sizeof(EntityId);
+
+			for (size_t type = 0; type < MAX_COMPONENTS; type++)
+			{
+				if (!signature[type])
+					continue;
+
+				const ComponentInfo& info = Manager::getComponentInfo(type);
+				RZ_ASSERT(info.alignment <= ARCHETYPE_MAX_ALIGNMENT, "Component alignment is too large for the chunk storage");
+
+				types.push_back(type);
+				sizes[type] = (uint32)info.size;
+				row_size += info.size;
+			}
+
+			// Start from the unpadded estimate and shrink until the arrays fit
+			capacity = (uint32)(ARCHETYPE_CHUNK_SIZE / row_size);
+			RZ_ASSERT(capacity > 0, "Components don't fit in a single chunk");
+
+			while (capacity > 0)
+			{
+				size_t offset = alignUp(sizeof(EntityId) * capacity, ARCHETYPE_MAX_ALIGNMENT);
+
+				for (size_t type : types)
+				{
+					offset = alignUp(offset, Manager::getComponentInfo(type).alignment);
+					offsets[type] = (uint32)offset;
+					offset += (size_t)sizes[type] * capacity;
+				}
+
+				if (offset <= ARCHETYPE_CHUNK_SIZE)
+					break;
+
+				capacity--;
+			}
+		}
+
+		Archetype::~Archetype()
+		{
+			for (uint32 chunk = 0; chunk < chunks.size(); chunk++)
+			{
+				for (size_t type : types)
+				{
+					const ComponentInfo& info = Manager::getComponentInfo(type);
+
+					for (uint32 row = 0; row < chunks[chunk].count; row++)
+						info.destroy(getComponent(chunk, row, type));
+				}
+
+				::operator delete(chunks[chunk].data);
+			}
+		}
+
+		void Archetype::push(EntityId entity, uint32& chunk, uint32& row)
+		{
+			chunk = count / capacity;
+			row = count % capacity;
+
+			if (chunk == chunks.size())
+				chunks.push_back({ (char*)::operator new(ARCHETYPE_CHUNK_SIZE), 0 });
+
+			getEntities(chunk)[row] = entity;
+			chunks[chunk].count++;
+			count++;
+		}
+
+		EntityId Archetype::remove(uint32 chunk, uint32 row, bool destroy)
+		{
+			if (destroy)
+			{
+				for (size_t type : types)
+					Manager::getComponentInfo(type).destroy(getComponent(chunk, row, type));
+			}
+
+			uint32 last_chunk = (count - 1) / capacity;
+			uint32 last_row = (count - 1) % capacity;
+			EntityId moved = INVALID_ENTITY;
+
+			if (last_chunk != chunk || last_row != row)
+			{
+				for (size_t type : types)
+					Manager::getComponentInfo(type).move(getComponent(chunk, row, type), getComponent(last_chunk, last_row, type));
+
+				moved = getEntities(last_chunk)[last_row];
+				getEntities(chunk)[row] = moved;
+			}
+
+			chunks[last_chunk].count--;
+			count--;
+
+			return moved;
+		}
+
+	}
+}
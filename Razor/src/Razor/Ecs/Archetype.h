@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Entity.h"
+
+#define ARCHETYPE_CHUNK_SIZE (16 * 1024)
+#define ARCHETYPE_MAX_ALIGNMENT 16
+
+namespace Razor {
+	namespace ECS {
+
+		// Type erased operations on a component type, filled on the first
+		// use of Manager::getComponentTypeId<T>()
+		struct ComponentInfo
+		{
+			size_t size;
+			size_t alignment;
+			const char* name;
+			// Move constructs into uninitialized memory and destroys the source
+			void (*move)(void* destination, void* source);
+			void (*destroy)(void* pointer);
+
+			template<typename T>
+			static ComponentInfo create()
+			{
+				ComponentInfo info;
+				info.size = sizeof(T);
+				info.alignment = alignof(T);
+				info.name = typeid(T).name();
+				info.move = [](void* destination, void* source)
+				{
+					new (destination) T(std::move(*(T*)source));
+					((T*)source)->~T();
+				};
+				info.destroy = [](void* pointer)
+				{
+					((T*)pointer)->~T();
+				};
+
+				return info;
+			}
+		};
+
+		struct ArchetypeChunk
+		{
+			char* data;
+			uint32 count;
+		};
+
+		// Storage of every entity sharing the same component signature.
+		// Entities are packed in ARCHETYPE_CHUNK_SIZE chunks, each chunk holds
+		// one array per component type (SoA) plus the ids of its entities.
+		// Rows are kept dense: removing an entity moves the last one of the
+		// archetype into the hole.
+		class Archetype
+		{
+		public:
+			Archetype(const ComponentBitset& signature);
+			~Archetype();
+
+			Archetype(const Archetype&) = delete;
+			Archetype& operator=(const Archetype&) = delete;
+
+			// Appends a row, the components of the entity are left uninitialized
+			void push(EntityId entity, uint32& chunk, uint32& row);
+			// Fills the row with the last entity of the archetype and returns
+			// that entity, INVALID_ENTITY when the row was the last one.
+			// Components are destroyed first unless they have been moved out.
+			EntityId remove(uint32 chunk, uint32 row, bool destroy);
+
+			inline void* getComponent(uint32 chunk, uint32 row, size_t type) const
+			{
+				return chunks[chunk].data + offsets[type] + (size_t)row * sizes[type];
+			}
+
+			inline void* getArray(uint32 chunk, size_t type) const { return chunks[chunk].data + offsets[type]; }
+			inline EntityId* getEntities(uint32 chunk) const { return (EntityId*)chunks[chunk].data; }
+
+			inline bool has(size_t type) const { return signature[type]; }
+			inline const ComponentBitset& getSignature() const { return signature; }
+			inline const std::vector<size_t>& getTypes() const { return types; }
+
+			inline uint32 getChunkCount() const { return (uint32)chunks.size(); }
+			inline uint32 getChunkSize(uint32 chunk) const { return chunks[chunk].count; }
+			inline uint32 getChunkCapacity() const { return capacity; }
+			inline uint32 getEntityCount() const { return count; }
+
+			// Cached transitions when adding or removing a single component
+			std::array<Archetype*, MAX_COMPONENTS> add_edges;
+			std::array<Archetype*, MAX_COMPONENTS> remove_edges;
+
+		private:
+			ComponentBitset signature;
+			std::vector<size_t> types;
+			std::array<uint32, MAX_COMPONENTS> offsets;
+			std::array<uint32, MAX_COMPONENTS> sizes;
+			uint32 capacity;
+			uint32 count;
+			// Chunks are kept once allocated, an archetype never shrinks below its peak
+			std::vector<ArchetypeChunk> chunks;
+		};
+
+	}
+}
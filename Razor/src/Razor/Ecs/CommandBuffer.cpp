@@ -0,0 +1,125 @@
+#include "rzpch.h"
+#include "CommandBuffer.h"
+
+namespace Razor {
+	namespace ECS {
+
+		CommandBuffer::CommandBuffer(Manager& manager) :
+			manager(manager),
+			arena("ECS Commands", COMMAND_BUFFER_ARENA_SIZE),
+			commands({})
+		{
+		}
+
+		CommandBuffer::~CommandBuffer()
+		{
+			for (auto& command : commands)
+				if (command.type == Command::Type::Add)
+					Manager::getComponentInfo(command.component).destroy(command.payload);
+		}
+
+		EntityId CommandBuffer::spawn()
+		{
+			EntityId entity = manager.reserve();
+			push({ Command::Type::Spawn, entity, 0, nullptr });
+
+			return entity;
+		}
+
+		void CommandBuffer::despawn(EntityId entity)
+		{
+			push({ Command::Type::Despawn, entity, 0, nullptr });
+		}
+
+		void CommandBuffer::push(const Command& command)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			commands.push_back(command);
+		}
+
+		void CommandBuffer::flush()
+		{
+			RZ_PROFILE_FUNCTION();
+			RZ_ASSERT(!manager.isIterating(), "Command buffers can't be flushed during a query");
+
+			size_t count = commands.size();
+			size_t i = 0;
+
+			while (i < count)
+			{
+				Command& command = commands[i];
+
+				switch (command.type)
+				{
+					case Command::Type::Spawn:
+						manager.place(command.entity, manager.getArchetype(ComponentBitset()));
+						i++;
+						break;
+
+					case Command::Type::Despawn:
+						manager.despawn(command.entity);
+						i++;
+						break;
+
+					case Command::Type::Remove:
+						if (manager.isAlive(command.entity))
+						{
+							Archetype* archetype = manager.records[command.entity.index].archetype;
+
+							if (archetype->has(command.component))
+								manager.move(command.entity, manager.getRemoveTarget(archetype, command.component));
+						}
+
+						i++;
+						break;
+
+					case Command::Type::Add:
+					{
+						// Consecutive adds on the same entity (spawn with components)
+						// move it once, straight to its final archetype
+						size_t last = i + 1;
+
+						while (last < count && commands[last].type == Command::Type::Add && commands[last].entity == command.entity)
+							last++;
+
+						if (!manager.isAlive(command.entity))
+						{
+							for (size_t j = i; j < last; j++)
+								Manager::getComponentInfo(commands[j].component).destroy(commands[j].payload);
+
+							i = last;
+							break;
+						}
+
+						ComponentBitset constructed = manager.records[command.entity.index].archetype->getSignature();
+						ComponentBitset signature = constructed;
+
+						for (size_t j = i; j < last; j++)
+							signature.set(commands[j].component);
+
+						manager.move(command.entity, manager.getArchetype(signature));
+
+						for (size_t j = i; j < last; j++)
+						{
+							const ComponentInfo& info = Manager::getComponentInfo(commands[j].component);
+							void* component = manager.getComponentPointer(command.entity, commands[j].component);
+
+							if (constructed[commands[j].component])
+								info.destroy(component);
+
+							info.move(component, commands[j].payload);
+							constructed.set(commands[j].component);
+						}
+
+						i = last;
+						break;
+					}
+				}
+			}
+
+			commands.clear();
+			arena.reset();
+		}
+
+	}
+}
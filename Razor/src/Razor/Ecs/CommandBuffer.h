@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Manager.h"
+#include "Razor/Memory/LinearArena.h"
+
+#define COMMAND_BUFFER_ARENA_SIZE (256 * 1024)
+
+namespace Razor {
+	namespace ECS {
+
+		// Structural changes recorded while the archetypes are being iterated,
+		// applied in recording order by Manager::flush(). Recording is thread
+		// safe, component values live in the buffer arena until the flush.
+		class CommandBuffer
+		{
+		public:
+			CommandBuffer(Manager& manager);
+			~CommandBuffer();
+
+			CommandBuffer(const CommandBuffer&) = delete;
+			CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+			// The id is valid right away, the entity exists after the flush
+			EntityId spawn();
+
+			template<typename... Ts>
+			EntityId spawn(Ts&&... components)
+			{
+				EntityId entity = spawn();
+				(add<std::decay_t<Ts>>(entity, std::forward<Ts>(components)), ...);
+
+				return entity;
+			}
+
+			void despawn(EntityId entity);
+
+			template<typename T, typename... Args>
+			void add(EntityId entity, Args&&... args)
+			{
+				void* payload = arena.allocate(sizeof(T), std::max(alignof(T), (size_t)ARENA_ALIGNMENT));
+				new (payload) T(std::forward<Args>(args)...);
+
+				push({ Command::Type::Add, entity, (uint32)Manager::getComponentTypeId<T>(), payload });
+			}
+
+			template<typename T>
+			void remove(EntityId entity)
+			{
+				push({ Command::Type::Remove, entity, (uint32)Manager::getComponentTypeId<T>(), nullptr });
+			}
+
+			inline bool isEmpty() const { return commands.empty(); }
+
+			void flush();
+
+		private:
+			friend class Manager;
+
+			struct Command
+			{
+				enum class Type : uint8
+				{
+					Spawn,
+					Despawn,
+					Add,
+					Remove
+				};
+
+				Type type;
+				EntityId entity;
+				uint32 component;
+				void* payload;
+			};
+
+			void push(const Command& command);
+
+			Manager& manager;
+			LinearArena arena;
+			std::vector<Command> commands;
+			std::mutex mutex;
+		};
+
+	}
+}
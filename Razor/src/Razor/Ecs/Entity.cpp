@@ -7,9 +7,17 @@
 namespace Razor {
 	namespace ECS {
 
-		Entity::Entity(Manager& manager) :
+		Entity::Entity(Manager& manager, EntityId id) :
 			manager(manager), 
-			alive(true)
+			id(id),
+			alive(true),
+			pending(false),
+			index(0),
+			groupIndices({}),
+			memberBitset(),
+			componentArray({}),
+			componentBitset(),
+			groupBitset()
 		{
 		}
 
@@ -29,6 +37,12 @@ namespace Razor {
 				c->render();
 		}
 
+		void Entity::destroy()
+		{
+			alive = false;
+			manager.queueRefresh(this);
+		}
+
 		void Entity::addGroup(size_t group) noexcept
 		{
 			groupBitset[group] = true;
@@ -38,6 +52,7 @@ namespace Razor {
 		void Entity::removeGroup(size_t group) noexcept
 		{
 			groupBitset[group] = false;
+			manager.queueRefresh(this);
 		}
 
 	}
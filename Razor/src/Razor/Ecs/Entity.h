@@ -13,17 +13,34 @@ namespace Razor {
 		using ComponentBitset = std::bitset<MAX_COMPONENTS>;
 		using ComponentArray = std::array<Component*, MAX_COMPONENTS>;
 
+		// Slot index plus the generation of the slot when the entity was created.
+		// Slots are reused once their entity is destroyed, the generation is bumped
+		// so handles kept around after that are detected as stale.
+		struct EntityId
+		{
+			uint32 index;
+			uint32 generation;
+
+			inline bool operator==(const EntityId& other) const { return index == other.index && generation == other.generation; }
+			inline bool operator!=(const EntityId& other) const { return !(*this == other); }
+			inline bool isValid() const { return index != 0xffffffff; }
+		};
+
+		constexpr EntityId INVALID_ENTITY{ 0xffffffff, 0 };
+
 		class Entity
 		{
 		public:
-			Entity(Manager& manager);
+			Entity(Manager& manager, EntityId id);
 			~Entity();
 
 			void update(float delta);
 			void render();
 
 			inline bool isAlive() const { return alive; }
-			inline void destroy() { alive = false; }
+			inline EntityId getId() const { return id; }
+			// Deferred, the entity is deleted by the next Manager::refresh()
+			void destroy();
 
 			template<typename T>
 			inline bool hasComponent() const {
@@ -65,9 +82,19 @@ namespace Razor {
 			}
 
 		private:
+			friend class Manager;
+
 			Manager& manager;
+			EntityId id;
 
 			bool alive;
+			// Already queued for the next refresh
+			bool pending;
+			// Position in the manager entities and in each group it belongs to
+			uint32 index;
+			std::array<uint32, MAX_GROUPS> groupIndices;
+			GroupBitset memberBitset;
+
 			std::vector<std::unique_ptr<Component>> components;
 
 			ComponentArray componentArray;
@@ -76,4 +103,17 @@ namespace Razor {
 		};
 
 	}
-}
\ No newline at end of file
+}
+
+namespace std {
+
+	template<>
+	struct hash<Razor::ECS::EntityId>
+	{
+		size_t operator()(const Razor::ECS::EntityId& id) const
+		{
+			return hash<uint64>()(((uint64)id.generation << 32) | id.index);
+		}
+	};
+
+}
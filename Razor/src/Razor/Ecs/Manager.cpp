@@ -4,18 +4,69 @@
 namespace Razor {
 	namespace ECS {
 
-		Manager::Manager()
+		static std::array<ComponentInfo, MAX_COMPONENTS> s_components;
+		static std::atomic<size_t> s_componentsCount(0);
+
+		Manager::Manager() :
+			archetypes_map({}),
+			archetypes({}),
+			records({}),
+			free_entities({}),
+			next_entity(0),
+			iterating(0),
+			commands(nullptr),
+			scheduler(nullptr)
 		{
+			commands = new CommandBuffer(*this);
+			scheduler = new Scheduler();
 		}
 
 		Manager::~Manager()
 		{
+			delete scheduler;
+			delete commands;
+
+			for (auto archetype : archetypes)
+				delete archetype;
+		}
+
+		size_t Manager::registerComponent(const ComponentInfo& info)
+		{
+			size_t type = s_componentsCount.fetch_add(1, std::memory_order_relaxed);
+			RZ_ASSERT(type < MAX_COMPONENTS, "Too many component types, raise MAX_COMPONENTS");
+
+			s_components[type] = info;
+
+			return type;
+		}
+
+		const ComponentInfo& Manager::getComponentInfo(size_t type)
+		{
+			return s_components[type];
+		}
+
+		void Manager::checkAccess(const ComponentBitset& reads, const ComponentBitset& writes)
+		{
+#ifdef RZ_DEBUG
+			System* system = System::getCurrent();
+
+			if (system == nullptr)
+				return;
+
+			ComponentBitset declared = system->getReads() | system->getWrites();
+
+			RZ_ASSERT((reads & ~declared).none(), "System queries components it didn't declare");
+			RZ_ASSERT((writes & ~system->getWrites()).none(), "System writes components it declared as read only");
+#endif
 		}
 
 		void Manager::update(float delta)
 		{
 			for (auto& e : entities)
 				e->update(delta);
+
+			scheduler->run(*this, delta);
+			flush();
 		}
 
 		void Manager::render()
@@ -26,42 +77,247 @@ namespace Razor {
 
 		void Manager::refresh()
 		{
-			for (auto i = 0; i < MAX_GROUPS; i++)
+			flush();
+
+			// Only the entities destroyed or removed from a group since the last refresh
+			for (Entity* entity : pendingEntities)
 			{
-				auto& group = groupedEntities[i];
+				entity->pending = false;
 
-				group.erase(std::remove_if(std::begin(group), std::end(group),
-				[i](Entity* entity)
+				for (size_t group = 0; group < MAX_GROUPS; group++)
 				{
-					return !entity->isAlive() || !entity->hasGroup(i);
-				}), std::end(group));
+					if (entity->memberBitset[group] && (!entity->isAlive() || !entity->hasGroup(group)))
+						removeFromGroup(entity, group);
+				}
+
+				if (entity->isAlive())
+					continue;
+
+				records[entity->id.index].entity = nullptr;
+				despawn(entity->id);
+
+				uint32 index = entity->index;
+				std::swap(entities[index], entities.back());
+				entities[index]->index = index;
+				entities.pop_back();
 			}
 
-			entities.erase(std::remove_if(std::begin(entities), std::end(entities),
-			[](const std::unique_ptr<Entity>& entity)
-			{
-				return !entity->isAlive();
-			}), std::end(entities));
+			pendingEntities.clear();
 		}
 
 		Entity& Manager::createEntity()
 		{
-			Entity* entity = new Entity(*this);
+			Entity* entity = new Entity(*this, spawn());
+			entity->index = (uint32)entities.size();
+			records[entity->id.index].entity = entity;
+
 			std::unique_ptr<Entity> ptr{ entity };
 			entities.emplace_back(std::move(ptr));
 
 			return *entity;
 		}
 
+		Entity* Manager::getEntity(EntityId entity) const
+		{
+			return isAlive(entity) ? records[entity.index].entity : nullptr;
+		}
+
 		void Manager::addToGroup(Entity* entity, size_t group)
 		{
+			if (entity->memberBitset[group])
+				return;
+
+			entity->groupIndices[group] = (uint32)groupedEntities[group].size();
+			entity->memberBitset[group] = true;
 			groupedEntities[group].emplace_back(entity);
 		}
 
+		void Manager::removeFromGroup(Entity* entity, size_t group)
+		{
+			auto& members = groupedEntities[group];
+			uint32 index = entity->groupIndices[group];
+
+			members[index] = members.back();
+			members[index]->groupIndices[group] = index;
+			members.pop_back();
+
+			entity->memberBitset[group] = false;
+		}
+
+		void Manager::queueRefresh(Entity* entity)
+		{
+			if (entity->pending)
+				return;
+
+			entity->pending = true;
+			pendingEntities.push_back(entity);
+		}
+
 		std::vector<Entity*>& Manager::getEntitiesByGroup(size_t group)
 		{
 			return groupedEntities[group];
 		}
 
+		EntityId Manager::spawn()
+		{
+			checkStructuralChange();
+
+			EntityId entity = reserve();
+			place(entity, getArchetype(ComponentBitset()));
+
+			return entity;
+		}
+
+		void Manager::despawn(EntityId entity)
+		{
+			checkStructuralChange();
+
+			if (!isAlive(entity))
+				return;
+
+			EntityRecord& record = records[entity.index];
+
+			// Deleted with the other legacy entities on the next refresh
+			if (record.entity != nullptr)
+			{
+				record.entity->destroy();
+				return;
+			}
+
+			EntityId moved = record.archetype->remove(record.chunk, record.row, true);
+
+			if (moved.isValid())
+			{
+				records[moved.index].chunk = record.chunk;
+				records[moved.index].row = record.row;
+			}
+
+			record.archetype = nullptr;
+			record.generation++;
+
+			std::unique_lock<std::mutex> lock(free_mutex);
+			free_entities.push_back({ entity.index, record.generation });
+		}
+
+		bool Manager::isAlive(EntityId entity) const
+		{
+			return entity.index < records.size()
+				&& records[entity.index].generation == entity.generation
+				&& records[entity.index].archetype != nullptr;
+		}
+
+		void Manager::flush()
+		{
+			commands->flush();
+		}
+
+		EntityId Manager::reserve()
+		{
+			{
+				std::unique_lock<std::mutex> lock(free_mutex);
+
+				if (!free_entities.empty())
+				{
+					EntityId entity = free_entities.back();
+					free_entities.pop_back();
+
+					return entity;
+				}
+			}
+
+			return { next_entity.fetch_add(1, std::memory_order_relaxed), 0 };
+		}
+
+		Manager::EntityRecord& Manager::getRecord(EntityId entity)
+		{
+			if (entity.index >= records.size())
+				records.resize(next_entity.load(std::memory_order_relaxed), { nullptr, 0, 0, 0, nullptr });
+
+			return records[entity.index];
+		}
+
+		Archetype* Manager::getArchetype(const ComponentBitset& signature)
+		{
+			auto it = archetypes_map.find(signature);
+
+			if (it != archetypes_map.end())
+				return it->second;
+
+			Archetype* archetype = new Archetype(signature);
+			archetypes_map[signature] = archetype;
+			archetypes.push_back(archetype);
+
+			return archetype;
+		}
+
+		Archetype* Manager::getAddTarget(Archetype* archetype, size_t type)
+		{
+			if (archetype->add_edges[type] == nullptr)
+			{
+				ComponentBitset signature = archetype->getSignature();
+				signature.set(type);
+				archetype->add_edges[type] = getArchetype(signature);
+			}
+
+			return archetype->add_edges[type];
+		}
+
+		Archetype* Manager::getRemoveTarget(Archetype* archetype, size_t type)
+		{
+			if (archetype->remove_edges[type] == nullptr)
+			{
+				ComponentBitset signature = archetype->getSignature();
+				signature.reset(type);
+				archetype->remove_edges[type] = getArchetype(signature);
+			}
+
+			return archetype->remove_edges[type];
+		}
+
+		void Manager::place(EntityId entity, Archetype* archetype)
+		{
+			EntityRecord& record = getRecord(entity);
+			RZ_ASSERT(record.archetype == nullptr && record.generation == entity.generation, "Entity already exists");
+
+			record.archetype = archetype;
+			archetype->push(entity, record.chunk, record.row);
+		}
+
+		void Manager::move(EntityId entity, Archetype* target)
+		{
+			EntityRecord& record = records[entity.index];
+			Archetype* source = record.archetype;
+
+			if (source == target)
+				return;
+
+			uint32 chunk = 0;
+			uint32 row = 0;
+			target->push(entity, chunk, row);
+
+			for (size_t type : source->getTypes())
+			{
+				const ComponentInfo& info = getComponentInfo(type);
+				void* component = source->getComponent(record.chunk, record.row, type);
+
+				if (target->has(type))
+					info.move(target->getComponent(chunk, row, type), component);
+				else
+					info.destroy(component);
+			}
+
+			EntityId moved = source->remove(record.chunk, record.row, false);
+
+			if (moved.isValid())
+			{
+				records[moved.index].chunk = record.chunk;
+				records[moved.index].row = record.row;
+			}
+
+			record.archetype = target;
+			record.chunk = chunk;
+			record.row = row;
+		}
+
 	}
 }
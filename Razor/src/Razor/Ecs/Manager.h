@@ -2,11 +2,17 @@
 
 #include "Entity.h"
 #include "Component.h"
-#include "System.h"
+#include "Archetype.h"
+#include "Razor/Core/Parallel.h"
+
+#define ECS_CHUNKS_GRAIN 1
 
 namespace Razor {
 	namespace ECS {
 
+		class CommandBuffer;
+		class Scheduler;
+
 		class Manager
 		{
 		public:
@@ -16,29 +22,250 @@ namespace Razor {
 			template<typename T>
 			inline static size_t getComponentTypeId() noexcept
 			{
-				static_assert(std::is_base_of<Component, T>::value, "T must inherit from Component");
-
-				static size_t typeId { getUniqueComponentId() };
+				static size_t typeId { registerComponent(ComponentInfo::create<T>()) };
 				return typeId;
 			}
 
+			static const ComponentInfo& getComponentInfo(size_t type);
+
+			// Legacy entities, then the scheduled systems, then the recorded commands
 			void update(float delta);
 			void render();
+			// Applies the recorded commands, deletes the destroyed entities and
+			// updates the groups, in time proportional to what changed
 			void refresh();
 			Entity& createEntity();
 			void addToGroup(Entity* entity, size_t group);
 			std::vector<Entity*>& getEntitiesByGroup(size_t group);
+			// nullptr once the entity has been deleted
+			Entity* getEntity(EntityId entity) const;
+
+			// Archetype storage, components are plain movable types stored by value.
+			// Structural changes (spawn, despawn, add, remove) are main thread only
+			// and not allowed during a query, use the command buffer there.
+
+			EntityId spawn();
+
+			template<typename... Ts>
+			EntityId spawn(Ts&&... components)
+			{
+				checkStructuralChange();
+
+				EntityId entity = reserve();
+				place(entity, getArchetype(getSignature<std::decay_t<Ts>...>()));
+				(new (getComponentPointer(entity, getComponentTypeId<std::decay_t<Ts>>())) std::decay_t<Ts>(std::forward<Ts>(components)), ...);
+
+				return entity;
+			}
+
+			void despawn(EntityId entity);
+			bool isAlive(EntityId entity) const;
+
+			template<typename T, typename... Args>
+			T& add(EntityId entity, Args&&... args)
+			{
+				size_t type = getComponentTypeId<T>();
+				checkStructuralChange();
+				RZ_ASSERT(isAlive(entity), "Adding a component to a dead entity");
+
+				if (records[entity.index].archetype->has(type))
+				{
+					T* component = (T*)getComponentPointer(entity, type);
+					*component = T(std::forward<Args>(args)...);
+
+					return *component;
+				}
+
+				move(entity, getAddTarget(records[entity.index].archetype, type));
+
+				return *new (getComponentPointer(entity, type)) T(std::forward<Args>(args)...);
+			}
+
+			template<typename T>
+			void remove(EntityId entity)
+			{
+				size_t type = getComponentTypeId<T>();
+				checkStructuralChange();
+
+				if (isAlive(entity) && records[entity.index].archetype->has(type))
+					move(entity, getRemoveTarget(records[entity.index].archetype, type));
+			}
+
+			template<typename T>
+			T* get(EntityId entity) const
+			{
+				size_t type = getComponentTypeId<std::remove_const_t<T>>();
+
+				if (!isAlive(entity) || !records[entity.index].archetype->has(type))
+					return nullptr;
+
+				return (T*)getComponentPointer(entity, type);
+			}
+
+			template<typename T>
+			bool has(EntityId entity) const
+			{
+				return isAlive(entity) && records[entity.index].archetype->has(getComponentTypeId<std::remove_const_t<T>>());
+			}
+
+			// Calls function(Ts&...) or function(EntityId, Ts&...) for every entity
+			// having all the components, walking the chunk arrays linearly.
+			// const components are read only.
+			template<typename... Ts, typename F>
+			void each(F&& function)
+			{
+				ComponentBitset signature = getSignature<std::remove_const_t<Ts>...>();
+				checkAccess(signature, getWriteSignature<Ts...>());
+				iterating.fetch_add(1, std::memory_order_relaxed);
+
+				for (Archetype* archetype : archetypes)
+				{
+					if ((archetype->getSignature() & signature) != signature)
+						continue;
+
+					for (uint32 chunk = 0; chunk < archetype->getChunkCount(); chunk++)
+						eachInChunk<Ts...>(*archetype, chunk, function);
+				}
+
+				iterating.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			// Same as each() with the matching chunks split across the job system,
+			// function is called concurrently and must only touch its own entity
+			template<typename... Ts, typename F>
+			void eachParallel(F&& function)
+			{
+				ComponentBitset signature = getSignature<std::remove_const_t<Ts>...>();
+				checkAccess(signature, getWriteSignature<Ts...>());
+				iterating.fetch_add(1, std::memory_order_relaxed);
+
+				std::vector<std::pair<Archetype*, uint32>> chunks;
+
+				for (Archetype* archetype : archetypes)
+				{
+					if ((archetype->getSignature() & signature) != signature)
+						continue;
+
+					for (uint32 chunk = 0; chunk < archetype->getChunkCount(); chunk++)
+						chunks.push_back({ archetype, chunk });
+				}
+
+				parallel_for(0, chunks.size(), ECS_CHUNKS_GRAIN, [&](size_t first, size_t last)
+				{
+					for (size_t i = first; i < last; i++)
+						eachInChunk<Ts...>(*chunks[i].first, chunks[i].second, function);
+				});
+
+				iterating.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			template<typename... Ts>
+			static ComponentBitset getSignature()
+			{
+				ComponentBitset signature;
+				(signature.set(getComponentTypeId<Ts>()), ...);
+
+				return signature;
+			}
+
+			// Components of the list that aren't const
+			template<typename... Ts>
+			static ComponentBitset getWriteSignature()
+			{
+				ComponentBitset signature;
+				(signature.set(getComponentTypeId<std::remove_const_t<Ts>>(), !std::is_const<Ts>::value), ...);
+
+				return signature;
+			}
+
+			inline CommandBuffer& getCommands() { return *commands; }
+			inline Scheduler& getScheduler() { return *scheduler; }
+			// Applies the recorded commands, refresh() does it as well
+			void flush();
+
+			inline bool isIterating() const { return iterating.load(std::memory_order_relaxed) > 0; }
+			inline const std::vector<Archetype*>& getArchetypes() const { return archetypes; }
 
 		private:
-			inline static size_t getUniqueComponentId() noexcept
+			friend class CommandBuffer;
+			friend class Entity;
+
+			struct EntityRecord
+			{
+				Archetype* archetype;
+				uint32 chunk;
+				uint32 row;
+				uint32 generation;
+				// Set for the entities made by createEntity()
+				Entity* entity;
+			};
+
+			static size_t registerComponent(const ComponentInfo& info);
+			// Queries made by a scheduled system must stay within its declared access
+			static void checkAccess(const ComponentBitset& reads, const ComponentBitset& writes);
+
+			template<typename... Ts, typename F>
+			static void eachInChunk(Archetype& archetype, uint32 chunk, F& function)
 			{
-				static size_t lastId{ 0u };
-				return lastId++;
+				uint32 count = archetype.getChunkSize(chunk);
+				EntityId* entities = archetype.getEntities(chunk);
+				std::tuple<Ts*...> arrays((Ts*)archetype.getArray(chunk, getComponentTypeId<std::remove_const_t<Ts>>())...);
+
+				for (uint32 i = 0; i < count; i++)
+				{
+					if constexpr (std::is_invocable<F&, EntityId, Ts&...>::value)
+						function(entities[i], std::get<Ts*>(arrays)[i]...);
+					else
+						function(std::get<Ts*>(arrays)[i]...);
+				}
+			}
+
+			// Ids can be reserved from any thread by the command buffers, the
+			// records catch up on the next structural change
+			EntityId reserve();
+			EntityRecord& getRecord(EntityId entity);
+
+			void queueRefresh(Entity* entity);
+			void removeFromGroup(Entity* entity, size_t group);
+
+			Archetype* getArchetype(const ComponentBitset& signature);
+			Archetype* getAddTarget(Archetype* archetype, size_t type);
+			Archetype* getRemoveTarget(Archetype* archetype, size_t type);
+
+			void place(EntityId entity, Archetype* archetype);
+			// Moves the shared components to the target archetype and destroys the others,
+			// components only present in the target are left uninitialized
+			void move(EntityId entity, Archetype* target);
+
+			inline void* getComponentPointer(EntityId entity, size_t type) const
+			{
+				const EntityRecord& record = records[entity.index];
+				return record.archetype->getComponent(record.chunk, record.row, type);
+			}
+
+			inline void checkStructuralChange() const
+			{
+				RZ_ASSERT(!isIterating(), "Structural changes during a query must go through the command buffer");
 			}
 
 			std::vector<std::unique_ptr<Entity>> entities;
 			std::array<std::vector<Entity*>, MAX_GROUPS> groupedEntities;
+			std::vector<Entity*> pendingEntities;
+
+			std::unordered_map<ComponentBitset, Archetype*> archetypes_map;
+			std::vector<Archetype*> archetypes;
+			std::vector<EntityRecord> records;
+			std::vector<EntityId> free_entities;
+			std::mutex free_mutex;
+			std::atomic<uint32> next_entity;
+			std::atomic<uint32> iterating;
+			CommandBuffer* commands;
+			Scheduler* scheduler;
 		};
 
 	}
-}
\ No newline at end of file
+}
+
+#include "CommandBuffer.h"
+#include "System.h"
+#include "Scheduler.h"
@@ -0,0 +1,169 @@
+#include "rzpch.h"
+#include "Scheduler.h"
+#include "Razor/Core/Parallel.h"
+
+#define SCHEDULER_TIMING_SMOOTHING 0.05
+
+namespace Razor {
+	namespace ECS {
+
+		Scheduler::Scheduler() :
+			nodes({}),
+			handles({}),
+			dirty(false)
+		{
+		}
+
+		Scheduler::~Scheduler()
+		{
+			for (auto& node : nodes)
+				delete node.system;
+		}
+
+		void Scheduler::add(System* system)
+		{
+			SystemNode node;
+			node.system = system;
+			node.level = 0;
+			node.timing = { 0.0, 0.0, 0.0 };
+
+			nodes.push_back(node);
+			dirty = true;
+		}
+
+		bool Scheduler::remove(System* system)
+		{
+			auto it = std::find_if(nodes.begin(), nodes.end(), [system](const SystemNode& node) { return node.system == system; });
+
+			if (it == nodes.end())
+				return false;
+
+			delete it->system;
+			nodes.erase(it);
+			dirty = true;
+
+			return true;
+		}
+
+		void Scheduler::build()
+		{
+			for (uint32 i = 0; i < nodes.size(); i++)
+			{
+				SystemNode& node = nodes[i];
+				node.dependencies.clear();
+				node.level = 0;
+
+				for (uint32 j = 0; j < i; j++)
+				{
+					if (!node.system->conflicts(*nodes[j].system))
+						continue;
+
+					node.dependencies.push_back(j);
+					node.level = std::max(node.level, nodes[j].level + 1);
+				}
+			}
+
+			dirty = false;
+		}
+
+		void Scheduler::run(Manager& manager, float delta)
+		{
+			RZ_PROFILE_FUNCTION();
+
+			if (dirty)
+				build();
+
+			bool parallel = JobSystem::exists() && JobSystem::get().getThreadsCount() > 1 && !Parallel::isDeterministic();
+
+			if (!parallel)
+			{
+				for (auto& node : nodes)
+					execute(node, manager, delta);
+
+				return;
+			}
+
+			JobSystem& jobs = JobSystem::get();
+			std::vector<JobHandle> dependencies;
+			handles.resize(nodes.size());
+
+			for (uint32 i = 0; i < nodes.size(); i++)
+			{
+				SystemNode& node = nodes[i];
+				dependencies.clear();
+
+				for (uint32 dependency : node.dependencies)
+					dependencies.push_back(handles[dependency]);
+
+				handles[i] = jobs.schedule(
+					[this, &node, &manager, delta]() { execute(node, manager, delta); },
+					dependencies,
+					node.system->isMainThread() ? JobSystem::Affinity::MainThread : JobSystem::Affinity::Any
+				);
+			}
+
+			for (auto& handle : handles)
+				jobs.wait(handle);
+		}
+
+		void Scheduler::execute(SystemNode& node, Manager& manager, float delta)
+		{
+			// A worker waiting inside a system may pick up another one
+			System* previous = System::getCurrent();
+			System::setCurrent(node.system);
+
+			uint64 start = TraceProfiler::now();
+			node.system->update(manager, delta);
+			double time = (TraceProfiler::now() - start) / 1000000.0;
+
+			System::setCurrent(previous);
+
+			Timing& timing = node.timing;
+			timing.average = timing.last == 0.0 ? time : timing.average + (time - timing.average) * SCHEDULER_TIMING_SMOOTHING;
+			timing.last = time;
+			timing.max = std::max(timing.max, time);
+		}
+
+		void Scheduler::dump()
+		{
+			if (dirty)
+				build();
+
+			Log::info("ECS schedule: %d systems", (int)nodes.size());
+
+			for (auto& node : nodes)
+			{
+				std::string reads;
+				std::string writes;
+				std::string dependencies;
+
+				for (size_t type = 0; type < MAX_COMPONENTS; type++)
+				{
+					if (node.system->getReads()[type])
+						reads += std::string(reads.empty() ? "" : ", ") + Manager::getComponentInfo(type).name;
+
+					if (node.system->getWrites()[type])
+						writes += std::string(writes.empty() ? "" : ", ") + Manager::getComponentInfo(type).name;
+				}
+
+				for (uint32 dependency : node.dependencies)
+					dependencies += std::string(dependencies.empty() ? "" : ", ") + nodes[dependency].system->getName();
+
+				Log::info(
+					"  [%u] %-24s %8.3f ms (avg %.3f, max %.3f)%s",
+					node.level,
+					node.system->getName().c_str(),
+					node.timing.last,
+					node.timing.average,
+					node.timing.max,
+					node.system->isMainThread() ? " main thread" : ""
+				);
+				Log::info("      reads: %s | writes: %s", reads.empty() ? "-" : reads.c_str(), writes.empty() ? "-" : writes.c_str());
+
+				if (!dependencies.empty())
+					Log::info("      after: %s", dependencies.c_str());
+			}
+		}
+
+	}
+}
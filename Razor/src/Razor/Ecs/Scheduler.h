@@ -0,0 +1,69 @@
+#pragma once
+
+#include "System.h"
+#include "Razor/Core/JobSystem.h"
+
+namespace Razor {
+	namespace ECS {
+
+		class System;
+
+		// Runs the systems on the job system every frame. A system depends on
+		// every system registered before it that it conflicts with, the
+		// resulting DAG is rebuilt whenever systems are added or removed.
+		// Without a job system, or in deterministic mode, systems run one
+		// after the other in registration order, which is a valid order of the DAG.
+		class Scheduler
+		{
+		public:
+			struct Timing
+			{
+				double last;
+				double average;
+				double max;
+			};
+
+			Scheduler();
+			~Scheduler();
+
+			// Takes ownership of the system
+			void add(System* system);
+			bool remove(System* system);
+
+			template<typename T, typename... Args>
+			T* add(Args&&... args)
+			{
+				T* system = new T(std::forward<Args>(args)...);
+				add(system);
+
+				return system;
+			}
+
+			void run(Manager& manager, float delta);
+
+			// Logs the systems in dependency levels with their access and timings (ms)
+			void dump();
+
+			inline size_t getSystemsCount() const { return nodes.size(); }
+			inline System* getSystem(size_t index) const { return nodes[index].system; }
+			inline const Timing& getTiming(size_t index) const { return nodes[index].timing; }
+
+		private:
+			struct SystemNode
+			{
+				System* system;
+				std::vector<uint32> dependencies;
+				uint32 level;
+				Timing timing;
+			};
+
+			void build();
+			void execute(SystemNode& node, Manager& manager, float delta);
+
+			std::vector<SystemNode> nodes;
+			std::vector<JobHandle> handles;
+			bool dirty;
+		};
+
+	}
+}
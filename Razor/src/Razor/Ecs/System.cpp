@@ -4,7 +4,13 @@
 namespace Razor {
 	namespace ECS {
 
-		System::System()
+		static thread_local System* t_currentSystem = nullptr;
+
+		System::System(const std::string& name) :
+			name(name),
+			reads(),
+			writes(),
+			main_thread(false)
 		{
 
 		}
@@ -14,5 +20,20 @@ namespace Razor {
 
 		}
 
+		bool System::conflicts(const System& other) const
+		{
+			return (writes & (other.reads | other.writes)).any() || (other.writes & reads).any();
+		}
+
+		System* System::getCurrent()
+		{
+			return t_currentSystem;
+		}
+
+		void System::setCurrent(System* system)
+		{
+			t_currentSystem = system;
+		}
+
 	}
-}
\ No newline at end of file
+}
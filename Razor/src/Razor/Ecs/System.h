@@ -1,16 +1,52 @@
 #pragma once
 
+#include "Manager.h"
+
 namespace Razor {
 	namespace ECS {
 
+		// Logic over the archetype storage. A system declares in its constructor
+		// which components it reads and writes, the Scheduler runs systems that
+		// don't conflict at the same time.
 		class System
 		{
 		public:
-			System();
-			~System();
+			System(const std::string& name = "System");
+			virtual ~System();
+
+			virtual void update(Manager& manager, float delta) {}
+
+			inline const std::string& getName() const { return name; }
+			inline const ComponentBitset& getReads() const { return reads; }
+			inline const ComponentBitset& getWrites() const { return writes; }
+			inline bool isMainThread() const { return main_thread; }
+
+			// Both write the same component, or one reads what the other writes
+			bool conflicts(const System& other) const;
+
+			// System being updated on the calling thread, nullptr outside of the scheduler
+			static System* getCurrent();
+
+		protected:
+			template<typename T>
+			void read() { reads.set(Manager::getComponentTypeId<T>()); }
+
+			template<typename T>
+			void write() { writes.set(Manager::getComponentTypeId<T>()); }
+
+			// For systems touching GL or other main thread only state
+			inline void setMainThread(bool main_thread) { this->main_thread = main_thread; }
 
 		private:
+			friend class Scheduler;
+
+			static void setCurrent(System* system);
+
+			std::string name;
+			ComponentBitset reads;
+			ComponentBitset writes;
+			bool main_thread;
 		};
 
 	}
-}
\ No newline at end of file
+}
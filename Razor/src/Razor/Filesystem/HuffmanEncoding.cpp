@@ -4,7 +4,8 @@
 namespace Razor
 {
 
-	HuffmanEncoding::HuffmanEncoding()
+	HuffmanEncoding::HuffmanEncoding() :
+		verbose(true)
 	{
 	}
 
@@ -117,7 +118,7 @@ namespace Razor
 
 	void HuffmanEncoding::printCodes(TreeNode* root, const std::string& str)
 	{
-		if (root == nullptr) return;
+		if (root == nullptr || !verbose) return;
 
 		if (root->data != '$')
 			std::cout << root->data << " : " << str << " : " << frequencies[root->data] << std::endl;
@@ -128,6 +129,9 @@ namespace Razor
 
 	void HuffmanEncoding::printStats()
 	{
+		if (!verbose)
+			return;
+
 		int i = (int)getInputSize();
 		int o = (int)getOutputSize();
 
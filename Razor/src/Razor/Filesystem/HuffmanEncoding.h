@@ -48,7 +48,10 @@ namespace Razor
 		unsigned int getInputSize();
 		unsigned int getOutputSize();
 
+		inline void setVerbose(bool value) { verbose = value; }
+
 	private:
+		bool verbose;
 		TreeQueue tree;
 		TreeQueue decode_tree;
 		std::map<char, std::string> codes;
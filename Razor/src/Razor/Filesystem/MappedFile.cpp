@@ -0,0 +1,116 @@
+#include "rzpch.h"
+#include "MappedFile.h"
+
+#ifndef RZ_PLATFORM_WINDOWS
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace Razor
+{
+
+	MappedFile::MappedFile() :
+		data(nullptr),
+		size(0)
+#ifdef RZ_PLATFORM_WINDOWS
+		,
+		file(nullptr),
+		mapping(nullptr)
+#endif
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+
+#ifdef RZ_PLATFORM_WINDOWS
+		HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (handle == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER length;
+
+		// Empty files can't be mapped
+		if (!GetFileSizeEx(handle, &length) || length.QuadPart == 0)
+		{
+			CloseHandle(handle);
+			return false;
+		}
+
+		mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (mapping == nullptr)
+		{
+			CloseHandle(handle);
+			return false;
+		}
+
+		data = (const uint8*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+		if (data == nullptr)
+		{
+			CloseHandle(mapping);
+			CloseHandle(handle);
+			mapping = nullptr;
+			return false;
+		}
+
+		file = handle;
+		size = (uint64)length.QuadPart;
+#else
+		int descriptor = ::open(path.c_str(), O_RDONLY);
+
+		if (descriptor < 0)
+			return false;
+
+		struct stat infos;
+
+		if (fstat(descriptor, &infos) != 0 || infos.st_size == 0)
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		void* view = mmap(nullptr, (size_t)infos.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		// The mapping keeps its own reference to the file
+		::close(descriptor);
+
+		if (view == MAP_FAILED)
+			return false;
+
+		data = (const uint8*)view;
+		size = (uint64)infos.st_size;
+#endif
+
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (data == nullptr)
+			return;
+
+#ifdef RZ_PLATFORM_WINDOWS
+		UnmapViewOfFile(data);
+		CloseHandle(mapping);
+		CloseHandle(file);
+		mapping = nullptr;
+		file = nullptr;
+#else
+		munmap((void*)data, (size_t)size);
+#endif
+
+		data = nullptr;
+		size = 0;
+	}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+
+namespace Razor
+{
+
+	// Read only mapping of a whole file, pages are brought in by the OS on
+	// first access. The view is page aligned.
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool open(const std::string& path);
+		void close();
+
+		inline const uint8* getData() const { return data; }
+		inline uint64 getSize() const { return size; }
+		inline bool isOpened() const { return data != nullptr; }
+
+	private:
+		const uint8* data;
+		uint64 size;
+#ifdef RZ_PLATFORM_WINDOWS
+		void* file;
+		void* mapping;
+#endif
+	};
+
+}
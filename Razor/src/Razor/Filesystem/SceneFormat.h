@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+#include "Razor/Maths/Maths.h"
+#include <glm/glm.hpp>
+
+// "RZA" and the format generation
+#define RZA_MAGIC 0x01415a52
+#define RZA_VERSION 2
+// Sections and blobs start on a cache line
+#define RZA_ALIGNMENT 64
+// No parent, mesh material or light node
+#define RZA_NONE 0xffffffff
+#define RZA_TEXTURE_SLOTS 9
+
+#define RZA_NODE_ACTIVE 0x1
+#define RZA_MESH_CULLING 0x1
+#define RZA_MESH_RECEIVE_SHADOWS 0x2
+
+namespace Razor
+{
+
+	// Memory mappable scene file (.rza), little-endian. Every offset is
+	// relative to the start of the file so the mapping can live anywhere,
+	// records are plain structs read in place, sections and vertex blobs
+	// start on RZA_ALIGNMENT. Nodes are stored parents first, so the graph
+	// is built in a single pass over the node table.
+	//
+	// [header][nodes][mesh refs][meshes][materials][lights][strings][blobs]
+	struct RzaSection
+	{
+		uint64 offset;
+		uint32 count;
+		// Record size, checked against the loader's structs
+		uint32 stride;
+	};
+
+	// Bytes of the strings section, not null terminated
+	struct RzaString
+	{
+		uint32 offset;
+		uint32 length;
+	};
+
+	struct RzaBlob
+	{
+		uint64 offset;
+		uint32 count;
+		uint32 reserved;
+	};
+
+	struct alignas(RZA_ALIGNMENT) RzaHeader
+	{
+		uint32 magic;
+		uint32 version;
+		// Whole file, truncated files are rejected
+		uint64 size;
+		RzaString name;
+		RzaSection nodes;
+		RzaSection mesh_refs;
+		RzaSection meshes;
+		RzaSection materials;
+		RzaSection lights;
+		RzaSection strings;
+	};
+
+	struct RzaNode
+	{
+		uint32 parent;
+		RzaString name;
+		glm::vec3 position;
+		glm::vec3 rotation;
+		glm::vec3 scale;
+		// Range of the mesh refs table
+		uint32 first_mesh;
+		uint32 mesh_count;
+		uint32 flags;
+		uint32 reserved;
+	};
+
+	// Mesh and material by their index in the asset tables
+	struct RzaMeshRef
+	{
+		uint32 mesh;
+		uint32 material;
+	};
+
+	// Assets carry a stable id (hash of their content) so files can be
+	// matched against each other, nodes reference them by table index
+	struct RzaMesh
+	{
+		uint64 id;
+		RzaString name;
+		RzaBlob vertices;
+		RzaBlob normals;
+		RzaBlob uvs;
+		RzaBlob tangents;
+		RzaBlob indices;
+		AABB bounds;
+		uint32 draw_mode;
+		uint32 flags;
+	};
+
+	enum class RzaMaterialType : uint32
+	{
+		Pbr,
+		Phong,
+		Color
+	};
+
+	// Preset state of a material besides its name and textures, the world
+	// partition cells store it too. The color materials keep their color in
+	// diffuse_color, the other fields are the phong ones.
+	struct RzaMaterialParameters
+	{
+		RzaMaterialType type;
+		glm::vec3 diffuse_color;
+		glm::vec3 specular_color;
+		glm::vec3 ambient_color;
+		glm::vec3 emissive_color;
+		glm::vec2 diffuse_tiling;
+		glm::vec2 specular_tiling;
+		glm::vec2 normal_tiling;
+		float alpha;
+		float shininess;
+		float shininess_strength;
+		float normal_strength;
+	};
+
+	struct RzaMaterial
+	{
+		uint64 id;
+		RzaString name;
+		RzaMaterialParameters parameters;
+		// Indexed by Material::TextureType
+		RzaString textures[RZA_TEXTURE_SLOTS];
+	};
+
+	struct RzaLight
+	{
+		// Node holding the light, RZA_NONE for the scene ones
+		uint32 node;
+		uint32 type;
+		glm::vec3 ambient;
+		glm::vec3 diffuse;
+		glm::vec3 specular;
+		glm::vec3 position;
+		glm::vec3 direction;
+		float intensity;
+		float constant;
+		float linear;
+		float quadratic;
+		float inner_cutoff;
+		float outer_cutoff;
+		uint32 cast_shadows;
+	};
+
+	static_assert(sizeof(RzaHeader) == 2 * RZA_ALIGNMENT, "RzaHeader layout changed");
+	static_assert(sizeof(RzaNode) == RZA_ALIGNMENT, "RzaNode layout changed");
+	static_assert(sizeof(RzaMesh) == 2 * RZA_ALIGNMENT, "RzaMesh layout changed");
+	// Hashed as bytes for the material ids, no padding allowed
+	static_assert(sizeof(RzaMaterialParameters) == 23 * sizeof(float), "RzaMaterialParameters layout changed");
+
+}
@@ -1,9 +1,150 @@
 #include "rzpch.h"
 #include "Serializer.h"
+#include "SceneFormat.h"
+#include "MappedFile.h"
+#include "BinaryReader.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Lighting/Directional.h"
+#include "Razor/Lighting/Point.h"
+#include "Razor/Lighting/Spot.h"
+#include "Razor/Materials/Texture.h"
+#include "Razor/Materials/TexturesManager.h"
+#include "Razor/Materials/Presets/PbrMaterial.h"
+#include "Razor/Materials/Presets/PhongMaterial.h"
+#include "Razor/Materials/Presets/ColorMaterial.h"
 
 namespace Razor
 {
 
+	static uint64 alignOffset(uint64 offset)
+	{
+		return (offset + RZA_ALIGNMENT - 1) & ~(uint64)(RZA_ALIGNMENT - 1);
+	}
+
+	// FNV-1a, asset ids only need to be stable
+	static uint64 hashBytes(uint64 hash, const void* data, size_t size)
+	{
+		const uint8* bytes = (const uint8*)data;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ull;
+		}
+
+		return hash;
+	}
+
+	template<typename T>
+	static uint64 hashArray(uint64 hash, const std::vector<T>& array)
+	{
+		return hashBytes(hash, array.data(), array.size() * sizeof(T));
+	}
+
+	static bool isValid(const MappedFile& file, const RzaSection& section, uint32 stride)
+	{
+		return section.stride == stride
+			&& section.offset % RZA_ALIGNMENT == 0
+			&& section.offset <= file.getSize()
+			&& (uint64)section.count * stride <= file.getSize() - section.offset;
+	}
+
+	static bool isValid(const MappedFile& file, const RzaBlob& blob, uint64 element)
+	{
+		return blob.offset % RZA_ALIGNMENT == 0
+			&& blob.offset <= file.getSize()
+			&& (uint64)blob.count * element <= file.getSize() - blob.offset;
+	}
+
+	template<typename T>
+	static void copyBlob(const MappedFile& file, const RzaBlob& blob, std::vector<T>& array)
+	{
+		const T* data = (const T*)(file.getData() + blob.offset);
+		array.assign(data, data + blob.count);
+	}
+
+	static RzaLight makeLight(Light* light, uint32 node)
+	{
+		RzaLight record = {};
+		record.node = node;
+		record.type = (uint32)light->getType();
+		record.ambient = light->getAmbient();
+		record.diffuse = light->getDiffuse();
+		record.specular = light->getSpecular();
+		record.intensity = light->getIntensity();
+		record.cast_shadows = light->isCastingShadows() ? 1 : 0;
+
+		if (Directional* directional = dynamic_cast<Directional*>(light))
+		{
+			record.position = directional->getPosition();
+			record.direction = directional->getDirection();
+		}
+		else if (Spot* spot = dynamic_cast<Spot*>(light))
+		{
+			record.position = spot->getPosition();
+			record.direction = spot->getDirection();
+			record.constant = spot->getConstant();
+			record.linear = spot->getLinear();
+			record.quadratic = spot->getQuadratic();
+			record.inner_cutoff = spot->getInnerCutoff();
+			record.outer_cutoff = spot->getOuterCutoff();
+		}
+		else if (Point* point = dynamic_cast<Point*>(light))
+		{
+			record.position = point->getPosition();
+			record.constant = point->getConstant();
+			record.linear = point->getLinear();
+			record.quadratic = point->getQuadratic();
+		}
+
+		return record;
+	}
+
+	static std::shared_ptr<Light> createLight(const RzaLight& record, Camera* camera)
+	{
+		std::shared_ptr<Light> light = nullptr;
+
+		switch ((Light::Type)record.type)
+		{
+			case Light::Type::DIRECTIONAL:
+			{
+				std::shared_ptr<Directional> directional = std::make_shared<Directional>(camera, record.position, record.direction);
+				light = directional;
+				break;
+			}
+			case Light::Type::SPOT:
+			{
+				std::shared_ptr<Spot> spot = std::make_shared<Spot>(camera, record.position, record.direction);
+				spot->setConstant(record.constant);
+				spot->setLinear(record.linear);
+				spot->setQuadratic(record.quadratic);
+				spot->setInnerCutoff(record.inner_cutoff);
+				spot->setOuterCutoff(record.outer_cutoff);
+				light = spot;
+				break;
+			}
+			case Light::Type::POINT:
+			{
+				std::shared_ptr<Point> point = std::make_shared<Point>(camera, record.position);
+				point->setConstant(record.constant);
+				point->setLinear(record.linear);
+				point->setQuadratic(record.quadratic);
+				light = point;
+				break;
+			}
+			default:
+				return nullptr;
+		}
+
+		light->setAmbient(record.ambient);
+		light->setDiffuse(record.diffuse);
+		light->setSpecular(record.specular);
+		light->setIntensity(record.intensity);
+		light->setCastingShadows(record.cast_shadows != 0);
+
+		return light;
+	}
+
 	Serializer::Serializer()
 	{
 	}
@@ -12,39 +153,484 @@ namespace Razor
 	{
 	}
 
-	/*void Serializer::importScene(const std::string& filename)
+	RzaMaterialParameters Serializer::getMaterialParameters(Material* material)
 	{
-		Scene scene;
-		std::ifstream in(filename.c_str(), std::ios::binary);
-		std::string name;
-		bool active;
-		unsigned int nodes_size;
+		RzaMaterialParameters parameters = {};
+		parameters.type = RzaMaterialType::Pbr;
 
-		readData<std::string>(in, &name);
-		readData<unsigned int>(in, &nodes_size);
-		readData<bool>(in, &active);
+		if (PhongMaterial* phong = dynamic_cast<PhongMaterial*>(material))
+		{
+			parameters.type = RzaMaterialType::Phong;
+			parameters.diffuse_color = phong->getDiffuseColor();
+			parameters.specular_color = phong->getSpecularColor();
+			parameters.ambient_color = phong->getAmbientColor();
+			parameters.emissive_color = phong->getEmissiveColor();
+			parameters.diffuse_tiling = phong->getDiffuseTiling();
+			parameters.specular_tiling = phong->getSpecularTiling();
+			parameters.normal_tiling = phong->getNormalTiling();
+			parameters.alpha = phong->getAlpha();
+			parameters.shininess = phong->getShininess();
+			parameters.shininess_strength = phong->getShininessStrength();
+			parameters.normal_strength = phong->getNormalStrength();
+		}
+		else if (ColorMaterial* color = dynamic_cast<ColorMaterial*>(material))
+		{
+			parameters.type = RzaMaterialType::Color;
+			parameters.diffuse_color = color->getColor();
+		}
 
-		in.close();
+		return parameters;
+	}
 
-		scene.setName(name);
-		scene.setActive(active);
+	std::shared_ptr<Material> Serializer::createMaterial(const RzaMaterialParameters& parameters)
+	{
+		switch (parameters.type)
+		{
+			case RzaMaterialType::Phong:
+			{
+				std::shared_ptr<PhongMaterial> phong = std::make_shared<PhongMaterial>();
+				phong->setDiffuseColor(parameters.diffuse_color);
+				phong->setSpecularColor(parameters.specular_color);
+				phong->setAmbientColor(parameters.ambient_color);
+				phong->setEmissiveColor(parameters.emissive_color);
+				phong->setDiffuseTiling(parameters.diffuse_tiling);
+				phong->setSpecularTiling(parameters.specular_tiling);
+				phong->setNormalTiling(parameters.normal_tiling);
+				phong->setAlpha(parameters.alpha);
+				phong->setShininess(parameters.shininess);
+				phong->setShininessStrength(parameters.shininess_strength);
+				phong->setNormalStrenght(parameters.normal_strength);
 
-		Log::trace("Imported scene \"%s\". (%d nodes read)", scene.getName().c_str(), nodes_size);
+				return phong;
+			}
+			case RzaMaterialType::Color:
+				return std::make_shared<ColorMaterial>(parameters.diffuse_color);
+			default:
+				return std::make_shared<PbrMaterial>();
+		}
 	}
 
-	void Serializer::exportScene(Scene* scene, const std::string& filename)
+	void Serializer::readString(std::ifstream& stream, std::string* string)
 	{
-		std::ofstream out("./data/test.rza", std::ios::binary);
+		uint32 size = 0;
+		readData<uint32>(stream, &size);
+
+		string->resize(size);
+
+		if (size > 0)
+			stream.read(&(*string)[0], size);
+	}
+
+	void Serializer::writeString(std::ofstream& stream, const std::string* string)
+	{
+		uint32 size = (uint32)string->size();
+		writeData<uint32>(stream, &size);
+		stream.write(string->data(), size);
+	}
+
+	bool Serializer::importScene(Scene* scene, const std::string& filename, TexturesManager* textures)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		static Histogram& s_loadTime = Metrics::histogram("assets.scene_load_time", "us", "Map and build time of a .rza scene");
+		uint64 start = TraceProfiler::now();
+
+		if (BinaryReader::isBigEndian())
+		{
+			Log::error("Import scene: .rza files are little-endian only");
+			return false;
+		}
+
+		MappedFile file;
+
+		if (!file.open(filename))
+		{
+			Log::error("Import scene: Can't map %s", filename.c_str());
+			return false;
+		}
+
+		const RzaHeader* header = (const RzaHeader*)file.getData();
+
+		if (file.getSize() < sizeof(RzaHeader) || header->magic != RZA_MAGIC || header->version != RZA_VERSION || header->size != file.getSize())
+		{
+			Log::error("Import scene: %s isn't a .rza file of version %d", filename.c_str(), RZA_VERSION);
+			return false;
+		}
+
+		if (!isValid(file, header->nodes, sizeof(RzaNode)) || !isValid(file, header->mesh_refs, sizeof(RzaMeshRef))
+			|| !isValid(file, header->meshes, sizeof(RzaMesh)) || !isValid(file, header->materials, sizeof(RzaMaterial))
+			|| !isValid(file, header->lights, sizeof(RzaLight)) || !isValid(file, header->strings, 1))
+		{
+			Log::error("Import scene: %s has corrupted sections", filename.c_str());
+			return false;
+		}
+
+		const uint8* base = file.getData();
+		const RzaNode* nodes = (const RzaNode*)(base + header->nodes.offset);
+		const RzaMeshRef* refs = (const RzaMeshRef*)(base + header->mesh_refs.offset);
+		const RzaMesh* meshes = (const RzaMesh*)(base + header->meshes.offset);
+		const RzaMaterial* materials = (const RzaMaterial*)(base + header->materials.offset);
+		const RzaLight* lights = (const RzaLight*)(base + header->lights.offset);
+		const char* strings = (const char*)(base + header->strings.offset);
+
+		auto getString = [&](const RzaString& string)
+		{
+			if ((uint64)string.offset + string.length > header->strings.count)
+				return std::string();
+
+			return std::string(strings + string.offset, string.length);
+		};
+
+		std::vector<std::shared_ptr<Material>> loaded_materials(header->materials.count);
+
+		for (uint32 i = 0; i < header->materials.count; i++)
+		{
+			const RzaMaterial& record = materials[i];
+			std::shared_ptr<Material> material = createMaterial(record.parameters);
+
+			material->setName(getString(record.name));
+
+			for (uint32 t = 0; t < RZA_TEXTURE_SLOTS; t++)
+			{
+				std::string path = getString(record.textures[t]);
+
+				if (path.empty())
+					continue;
+
+				Material::TextureType type = (Material::TextureType)t;
+				material->getTexturePath(type) = path;
+
+				if (textures == nullptr)
+					continue;
+
+				Texture* texture = textures->acquireTexture(path);
+
+				if (texture == nullptr)
+				{
+					texture = new Texture(path, true);
+					textures->addTexture(path, texture);
+				}
+
+				material->setTextureMap(type, texture->getId());
+			}
+
+			loaded_materials[i] = material;
+		}
+
+		std::vector<std::shared_ptr<StaticMesh>> loaded_meshes(header->meshes.count);
+
+		for (uint32 i = 0; i < header->meshes.count; i++)
+		{
+			const RzaMesh& record = meshes[i];
+
+			if (!isValid(file, record.vertices, sizeof(float)) || !isValid(file, record.normals, sizeof(float))
+				|| !isValid(file, record.uvs, sizeof(float)) || !isValid(file, record.tangents, sizeof(float))
+				|| !isValid(file, record.indices, sizeof(unsigned int)))
+			{
+				Log::error("Import scene: Mesh %d of %s is corrupted", i, filename.c_str());
+				return false;
+			}
+
+			// StaticMesh owns its arrays, each one is a single copy out of the mapping
+			std::shared_ptr<StaticMesh> mesh = StaticMesh::create();
+			mesh->setName(getString(record.name));
+			copyBlob(file, record.vertices, mesh->getVertices());
+			copyBlob(file, record.normals, mesh->getNormals());
+			copyBlob(file, record.uvs, mesh->getUvs());
+			copyBlob(file, record.tangents, mesh->getTangents());
+			copyBlob(file, record.indices, mesh->getIndices());
+			mesh->setBoundingBox(record.bounds);
+			mesh->setDrawMode((StaticMesh::DrawMode)record.draw_mode);
+			mesh->setCulling((record.flags & RZA_MESH_CULLING) != 0);
+			mesh->isReceivingShadows() = (record.flags & RZA_MESH_RECEIVE_SHADOWS) != 0;
+
+			loaded_meshes[i] = mesh;
+		}
 
-		unsigned int nodes_size = (unsigned int)scene->getNodesSize();
+		// Parents come first, one pass builds the whole hierarchy
+		std::vector<std::shared_ptr<Node>> loaded_nodes(header->nodes.count);
+		std::vector<std::shared_ptr<Node>> roots;
 
-		writeData<std::string>(out, &scene->getName());
-		writeData<unsigned int>(out, &nodes_size);
-		writeData<bool>(out, &scene->isActive());
+		for (uint32 i = 0; i < header->nodes.count; i++)
+		{
+			const RzaNode& record = nodes[i];
 
-		out.close();
+			if ((record.parent != RZA_NONE && record.parent >= i) || (uint64)record.first_mesh + record.mesh_count > header->mesh_refs.count)
+			{
+				Log::error("Import scene: Node %d of %s is corrupted", i, filename.c_str());
+				return false;
+			}
 
-		Log::trace("Exported scene \"%s\". (%d nodes written)", scene->getName().c_str(), nodes_size);
-	}*/
+			std::shared_ptr<Node> node = Node::create();
+			node->name = getString(record.name);
+			node->transform.setPosition(record.position);
+			node->transform.setRotation(record.rotation);
+			node->transform.setScale(record.scale);
+			node->active = (record.flags & RZA_NODE_ACTIVE) != 0;
+
+			for (uint32 m = record.first_mesh; m < record.first_mesh + record.mesh_count; m++)
+			{
+				if (refs[m].mesh >= header->meshes.count)
+					continue;
+
+				std::shared_ptr<StaticMesh>& mesh = loaded_meshes[refs[m].mesh];
+
+				if (refs[m].material < header->materials.count)
+					mesh->setMaterial(loaded_materials[refs[m].material]);
+
+				node->meshes.push_back(mesh);
+			}
+
+			if (record.parent == RZA_NONE)
+				roots.push_back(node);
+			else
+			{
+				loaded_nodes[record.parent]->addChild(node);
+			}
+
+			loaded_nodes[i] = node;
+		}
+
+		for (uint32 i = 0; i < header->lights.count; i++)
+		{
+			std::shared_ptr<Light> light = createLight(lights[i], scene->getActiveCamera());
+
+			if (light == nullptr)
+				continue;
+
+			if (lights[i].node < header->nodes.count)
+				loaded_nodes[lights[i].node]->lights.push_back(light);
+
+			scene->addLight(light, light->getType());
+		}
+
+		for (auto& mesh : loaded_meshes)
+			mesh->setupBuffers();
+
+		for (auto& root : roots)
+			scene->getSceneGraph()->addNode(root);
+
+		scene->setName(getString(header->name));
+
+		s_loadTime.record((TraceProfiler::now() - start) / 1000);
+		Log::trace("Imported scene \"%s\". (%d nodes read)", scene->getName().c_str(), (int)header->nodes.count);
+
+		return true;
+	}
+
+	bool Serializer::exportScene(Scene* scene, const std::string& filename)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		if (BinaryReader::isBigEndian())
+		{
+			Log::error("Export scene: .rza files are little-endian only");
+			return false;
+		}
+
+		std::vector<RzaNode> nodes;
+		std::vector<RzaMeshRef> refs;
+		std::vector<RzaMesh> meshes;
+		std::vector<RzaMaterial> materials;
+		std::vector<RzaLight> lights;
+		std::string strings;
+
+		std::vector<StaticMesh*> mesh_sources;
+		std::unordered_map<StaticMesh*, uint32> mesh_indices;
+		std::unordered_map<Material*, uint32> material_indices;
+		std::unordered_set<Light*> node_lights;
+
+		auto addString = [&](const std::string& string)
+		{
+			RzaString record = { (uint32)strings.size(), (uint32)string.size() };
+			strings += string;
+
+			return record;
+		};
+
+		auto addMesh = [&](StaticMesh* mesh)
+		{
+			auto it = mesh_indices.find(mesh);
+
+			if (it != mesh_indices.end())
+				return it->second;
+
+			uint64 id = 0xcbf29ce484222325ull;
+			id = hashArray(id, mesh->getVertices());
+			id = hashArray(id, mesh->getNormals());
+			id = hashArray(id, mesh->getUvs());
+			id = hashArray(id, mesh->getTangents());
+			id = hashArray(id, mesh->getIndices());
+
+			RzaMesh record = {};
+			record.id = id;
+			record.name = addString(mesh->getName());
+			record.bounds = mesh->getLocalBoundingBox();
+			record.draw_mode = (uint32)mesh->getDrawMode();
+			record.flags = (mesh->hasCulling() ? RZA_MESH_CULLING : 0) | (mesh->isReceivingShadows() ? RZA_MESH_RECEIVE_SHADOWS : 0);
+
+			uint32 index = (uint32)meshes.size();
+			meshes.push_back(record);
+			mesh_sources.push_back(mesh);
+			mesh_indices[mesh] = index;
+
+			return index;
+		};
+
+		auto addMaterial = [&](Material* material)
+		{
+			if (material == nullptr)
+				return (uint32)RZA_NONE;
+
+			auto it = material_indices.find(material);
+
+			if (it != material_indices.end())
+				return it->second;
+
+			RzaMaterial record = {};
+			record.name = addString(material->getName());
+			record.parameters = getMaterialParameters(material);
+
+			uint64 id = hashBytes(0xcbf29ce484222325ull, &record.parameters, sizeof(record.parameters));
+
+			for (uint32 t = 0; t < RZA_TEXTURE_SLOTS; t++)
+			{
+				const std::string& path = material->getTexturePath((Material::TextureType)t);
+
+				if (path == "Not set")
+					continue;
+
+				record.textures[t] = addString(path);
+				id = hashBytes(id, path.data(), path.size());
+			}
+
+			record.id = id;
+
+			uint32 index = (uint32)materials.size();
+			materials.push_back(record);
+			material_indices[material] = index;
+
+			return index;
+		};
+
+		// Breadth first, parents always come before their children
+		std::vector<std::pair<Node*, uint32>> queue;
+
+		for (auto& root : scene->getSceneGraph()->getNodes())
+			queue.push_back({ root.get(), RZA_NONE });
+
+		for (size_t n = 0; n < queue.size(); n++)
+		{
+			Node* node = queue[n].first;
+
+			RzaNode record = {};
+			record.parent = queue[n].second;
+			record.name = addString(node->name);
+			record.position = node->transform.getPosition();
+			record.rotation = node->transform.getRotation();
+			record.scale = node->transform.getScale();
+			record.first_mesh = (uint32)refs.size();
+			record.mesh_count = (uint32)node->meshes.size();
+			record.flags = node->active ? RZA_NODE_ACTIVE : 0;
+			nodes.push_back(record);
+
+			for (auto& mesh : node->meshes)
+				refs.push_back({ addMesh(mesh.get()), addMaterial(mesh->getMaterial().get()) });
+
+			for (auto& light : node->lights)
+			{
+				lights.push_back(makeLight(light.get(), (uint32)n));
+				node_lights.insert(light.get());
+			}
+
+			for (auto& child : node->nodes)
+				queue.push_back({ child.get(), (uint32)n });
+		}
+
+		for (auto& light : scene->getLights())
+			if (node_lights.find(light.get()) == node_lights.end())
+				lights.push_back(makeLight(light.get(), RZA_NONE));
+
+		RzaHeader header = {};
+		header.magic = RZA_MAGIC;
+		header.version = RZA_VERSION;
+		header.name = addString(scene->getName());
+
+		uint64 offset = sizeof(RzaHeader);
+
+		auto placeSection = [&](RzaSection& section, size_t count, uint32 stride)
+		{
+			offset = alignOffset(offset);
+			section = { offset, (uint32)count, stride };
+			offset += (uint64)count * stride;
+		};
+
+		auto placeBlob = [&](RzaBlob& blob, size_t count, uint64 element)
+		{
+			offset = alignOffset(offset);
+			blob = { offset, (uint32)count, 0 };
+			offset += count * element;
+		};
+
+		placeSection(header.nodes, nodes.size(), sizeof(RzaNode));
+		placeSection(header.mesh_refs, refs.size(), sizeof(RzaMeshRef));
+		placeSection(header.meshes, meshes.size(), sizeof(RzaMesh));
+		placeSection(header.materials, materials.size(), sizeof(RzaMaterial));
+		placeSection(header.lights, lights.size(), sizeof(RzaLight));
+		placeSection(header.strings, strings.size(), 1);
+
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			StaticMesh* mesh = mesh_sources[i];
+
+			placeBlob(meshes[i].vertices, mesh->getVertices().size(), sizeof(float));
+			placeBlob(meshes[i].normals, mesh->getNormals().size(), sizeof(float));
+			placeBlob(meshes[i].uvs, mesh->getUvs().size(), sizeof(float));
+			placeBlob(meshes[i].tangents, mesh->getTangents().size(), sizeof(float));
+			placeBlob(meshes[i].indices, mesh->getIndices().size(), sizeof(unsigned int));
+		}
+
+		header.size = alignOffset(offset);
+
+		std::vector<uint8> buffer((size_t)header.size, 0);
+
+		auto copy = [&](uint64 at, const void* data, size_t size)
+		{
+			if (size > 0)
+				memcpy(buffer.data() + at, data, size);
+		};
+
+		copy(0, &header, sizeof(RzaHeader));
+		copy(header.nodes.offset, nodes.data(), nodes.size() * sizeof(RzaNode));
+		copy(header.mesh_refs.offset, refs.data(), refs.size() * sizeof(RzaMeshRef));
+		copy(header.meshes.offset, meshes.data(), meshes.size() * sizeof(RzaMesh));
+		copy(header.materials.offset, materials.data(), materials.size() * sizeof(RzaMaterial));
+		copy(header.lights.offset, lights.data(), lights.size() * sizeof(RzaLight));
+		copy(header.strings.offset, strings.data(), strings.size());
+
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			StaticMesh* mesh = mesh_sources[i];
+
+			copy(meshes[i].vertices.offset, mesh->getVertices().data(), mesh->getVertices().size() * sizeof(float));
+			copy(meshes[i].normals.offset, mesh->getNormals().data(), mesh->getNormals().size() * sizeof(float));
+			copy(meshes[i].uvs.offset, mesh->getUvs().data(), mesh->getUvs().size() * sizeof(float));
+			copy(meshes[i].tangents.offset, mesh->getTangents().data(), mesh->getTangents().size() * sizeof(float));
+			copy(meshes[i].indices.offset, mesh->getIndices().data(), mesh->getIndices().size() * sizeof(unsigned int));
+		}
+
+		std::ofstream out(filename, std::ios::binary);
+		out.write((const char*)buffer.data(), buffer.size());
+
+		if (!out)
+		{
+			Log::error("Export scene: Can't write %s", filename.c_str());
+			return false;
+		}
+
+		Log::trace("Exported scene \"%s\". (%d nodes written)", scene->getName().c_str(), (int)nodes.size());
+
+		return true;
+	}
 
 }
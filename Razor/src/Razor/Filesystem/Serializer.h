@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Razor/Scene/Scene.h"
+#include "SceneFormat.h"
 
 namespace Razor
 {
 	class Engine;
+	class Material;
+	class TexturesManager;
 
 	class Serializer
 	{
@@ -12,8 +15,15 @@ namespace Razor
 		Serializer();
 		~Serializer();
 
-		//void importScene(const std::string& filename);
-		//void exportScene(Scene* scene, const std::string& filename);
+		// Maps a .rza file (see SceneFormat.h) and adds its nodes and lights to
+		// the scene. Creates the GL buffers, so on the main thread, textures
+		// are only loaded when a manager is given.
+		bool importScene(Scene* scene, const std::string& filename, TexturesManager* textures = nullptr);
+		bool exportScene(Scene* scene, const std::string& filename);
+
+		// Presets that aren't stored come back as PBR
+		static RzaMaterialParameters getMaterialParameters(Material* material);
+		static std::shared_ptr<Material> createMaterial(const RzaMaterialParameters& parameters);
 
 		template<typename T>
 		void readData(std::ifstream& stream, T* data)
@@ -22,16 +32,36 @@ namespace Razor
 		}
 
 		template<typename T>
-		void writeData(std::ofstream& stream, T* data)
+		void writeData(std::ofstream& stream, const T* data)
 		{
-			stream.write(reinterpret_cast<char*>(data), sizeof(T));
+			stream.write(reinterpret_cast<const char*>(data), sizeof(T));
 		}
 
-		//template<typename T>
-		//inline void readArray(std::ifstream& stream, std::vector<T>* array)
-		//{
+		// Element count followed by the raw elements, T must be trivially copyable
+		template<typename T>
+		void readArray(std::ifstream& stream, std::vector<T>* array)
+		{
+			uint32 size = 0;
+			readData<uint32>(stream, &size);
+
+			array->resize(size);
+
+			if (size > 0)
+				stream.read(reinterpret_cast<char*>(array->data()), size * sizeof(T));
+		}
+
+		template<typename T>
+		void writeArray(std::ofstream& stream, const std::vector<T>* array)
+		{
+			uint32 size = (uint32)array->size();
+			writeData<uint32>(stream, &size);
+
+			if (size > 0)
+				stream.write(reinterpret_cast<const char*>(array->data()), size * sizeof(T));
+		}
 
-		//}
+		void readString(std::ifstream& stream, std::string* string);
+		void writeString(std::ofstream& stream, const std::string* string);
 	};
 
 }
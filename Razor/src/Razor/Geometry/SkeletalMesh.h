@@ -11,6 +11,7 @@ namespace Razor
 		~SkeletalMesh();
 
 		inline std::shared_ptr<Bone> getRootBone() { return root_bone; }
+		inline void setRootBone(std::shared_ptr<Bone> bone) { root_bone = bone; }
 
 	private:
 		std::shared_ptr<Bone> root_bone;
@@ -3,10 +3,13 @@
 #include <glad/glad.h>
 #include "Razor/Physics/PhysicsBody.h"
 #include "Razor/Core/Transform.h"
+#include "Razor/Core/Parallel.h"
 #include <glm/gtc/type_ptr.hpp>
 #include "Razor/Geometry/Geometry.h"
 #include "Razor/Materials/Presets/ColorMaterial.h"
 #include "Razor/Rendering/ForwardRenderer.h"
+#include "Razor/Rendering/RenderState.h"
+#include "Razor/Memory/Allocators.h"
 
 namespace Razor
 {
@@ -34,6 +37,8 @@ namespace Razor
 		physics_enabled(false),
 		receive_shadows(true),
 		bounding_box(AABB()),
+		local_bounding_box(AABB()),
+		local_bounding_dirty(true),
 		bounding_mesh(nullptr),
 		show_bounding_box(false)
 	{
@@ -60,6 +65,11 @@ namespace Razor
 		}
 	}
 
+	std::shared_ptr<StaticMesh> StaticMesh::create()
+	{
+		return std::allocate_shared<StaticMesh>(PoolStlAllocator<StaticMesh>());
+	}
+
 	StaticMesh::StaticMeshInstance::~StaticMeshInstance()
 	{
 		delete transform;
@@ -68,6 +78,8 @@ namespace Razor
 
 	void StaticMesh::setupBuffers() 
 	{
+		local_bounding_dirty = true;
+
 		vao = new VertexArray();
 
 		vbo = new VertexBuffer(getVertices().data(), (unsigned int)getVertices().size() * sizeof(float));
@@ -127,19 +139,70 @@ namespace Razor
 	}
 
 	void StaticMesh::updateBoundings(Transform& transform)
+	{
+		updateBoundingMesh(computeBoundings(transform));
+	}
+
+	const AABB& StaticMesh::computeBoundings(Transform& transform)
 	{
 		std::vector<float>& verts = getVertices();
-		bounding_box = AABB();
 		glm::mat3 matrix = glm::mat3(transform.getMatrix());
 
-		for (size_t i = 0; i < verts.size(); i += 3)
-			bounding_box.set(matrix * glm::vec3(verts[i + 0], verts[i + 1], verts[i + 2]));
+		bounding_box = parallel_reduce(0, verts.size() / 3, BOUNDINGS_VERTICES_GRAIN, AABB(),
+			[&](size_t first, size_t last, AABB box)
+			{
+				for (size_t i = first * 3; i < last * 3; i += 3)
+					box.set(matrix * glm::vec3(verts[i + 0], verts[i + 1], verts[i + 2]));
 
-		bounding_mesh = std::make_shared<Bounding>(bounding_box);
+				return box;
+			},
+			[](AABB a, const AABB& b)
+			{
+				a.set(glm::vec3(b.min_x, b.min_y, b.min_z));
+				a.set(glm::vec3(b.max_x, b.max_y, b.max_z));
+
+				return a;
+			}
+		);
+
+		return bounding_box;
+	}
+
+	void StaticMesh::updateBoundingMesh(const AABB& box)
+	{
+		bounding_mesh = std::make_shared<Bounding>(box);
 		bounding_mesh->setMaterial(ForwardRenderer::getColorMaterial());
 		bounding_mesh->vbo->updateSubData((unsigned int)bounding_mesh->vertices.size(), &bounding_mesh->getVertices()[0]);
 	}
 
+	const AABB& StaticMesh::getLocalBoundingBox()
+	{
+		std::vector<float>& verts = getVertices();
+
+		if (!local_bounding_dirty)
+			return local_bounding_box;
+
+		local_bounding_box = parallel_reduce(0, verts.size() / 3, BOUNDINGS_VERTICES_GRAIN, AABB(),
+			[&](size_t first, size_t last, AABB box)
+			{
+				for (size_t i = first * 3; i < last * 3; i += 3)
+					box.set(glm::vec3(verts[i + 0], verts[i + 1], verts[i + 2]));
+
+				return box;
+			},
+			[](AABB a, const AABB& b)
+			{
+				a.merge(b);
+
+				return a;
+			}
+		);
+
+		local_bounding_dirty = false;
+
+		return local_bounding_box;
+	}
+
 	std::shared_ptr<StaticMesh::StaticMeshInstance> StaticMesh::addInstance(const std::string& name, Transform* transform, PhysicsBody* body)
 	{
 		unsigned int index = (unsigned int)instances.size();
@@ -184,39 +247,35 @@ namespace Razor
 
 	void StaticMesh::draw()
 	{
+		draw(drawMode, getVertexCount(), (uint32)getIndices().size());
+	}
+
+	void StaticMesh::draw(DrawMode mode, uint32 vertex_count, uint32 index_count)
+	{
+		RenderState::setCulling(hasCulling());
+
 		if (hasCulling())
 		{
-			glEnable(GL_CULL_FACE);
-			glFrontFace((GLenum)windingOrder);
-			glCullFace((GLenum)cullType);
+			RenderState::setFrontFace((uint32)windingOrder);
+			RenderState::setCullFace((uint32)cullType);
 		}
-		else
-			glDisable(GL_CULL_FACE);
 
-		if (drawMode == DrawMode::LINES      || 
-			drawMode == DrawMode::LINE_STRIP ||
-			drawMode == DrawMode::LINE_LOOP
+		if (mode == DrawMode::LINES      || 
+			mode == DrawMode::LINE_STRIP ||
+			mode == DrawMode::LINE_LOOP
 			)
 		{
-			glLineWidth(line_width);
-			
-
-			if (is_line_dashed)
-			{
-				glLineStipple(line_factor, line_pattern);
-				glEnable(GL_LINE_STIPPLE);
-			}
-			else
-				glDisable(GL_LINE_STIPPLE);
+			RenderState::setLineWidth(line_width);
+			RenderState::setLineStipple(is_line_dashed, line_factor, line_pattern);
 		}
 		else
-			glLineWidth(1.0f);
+			RenderState::setLineWidth(1.0f);
 
 
-		if (getIndices().size() > 0)
-			glDrawElements((GLenum)drawMode, (GLsizei)getIndices().size(), GL_UNSIGNED_INT, 0);
+		if (index_count > 0)
+			glDrawElements((GLenum)mode, (GLsizei)index_count, GL_UNSIGNED_INT, 0);
 		else
-			glDrawArrays((GLenum)drawMode, 0, getVertexCount());
+			glDrawArrays((GLenum)mode, 0, (GLsizei)vertex_count);
 
 		if (show_bounding_box && bounding_mesh != nullptr)
 			bounding_mesh->draw();
@@ -224,14 +283,13 @@ namespace Razor
 
 	void StaticMesh::drawInstances()
 	{
+		RenderState::setCulling(hasCulling());
+
 		if (hasCulling())
 		{
-			glEnable(GL_CULL_FACE);
-			glFrontFace((GLenum)windingOrder);
-			glCullFace((GLenum)cullType);
+			RenderState::setFrontFace((uint32)windingOrder);
+			RenderState::setCullFace((uint32)cullType);
 		}
-		else
-			glDisable(GL_CULL_FACE);
 
 		if (getIndices().size() > 0)
 			glDrawElementsInstanced((GLenum)drawMode, (GLsizei)getIndices().size(), GL_UNSIGNED_INT, 0, (GLsizei)getInstances().size());
@@ -5,6 +5,8 @@
 #include "Razor/Buffers/Buffers.h"
 #include "Razor/Maths/Maths.h"
 
+#define BOUNDINGS_VERTICES_GRAIN 4096
+
 namespace Razor 
 {
 	class PhysicsBody;
@@ -19,6 +21,10 @@ namespace Razor
 
 		typedef std::vector<std::shared_ptr<StaticMesh>> List;
 
+		// Mesh and control block in one block of the size class pools, meshes
+		// larger than MAX_POOL_BLOCK_SIZE (debug containers) fall back to the heap
+		static std::shared_ptr<StaticMesh> create();
+
 		struct StaticMeshInstance 
 		{
 			StaticMeshInstance(unsigned int index, const std::string& name, Transform* transform, PhysicsBody* body = nullptr) :
@@ -189,10 +195,16 @@ namespace Razor
 		}
 
 		void draw();
+		// Counts and mode captured earlier, the live ones may have changed since
+		void draw(DrawMode mode, uint32 vertex_count, uint32 index_count);
 		void drawInstances();
 		void setupBuffers();
 		void setupInstances();
 		void updateBoundings(Transform& transform);
+		// World box only, no GL call, any thread
+		const AABB& computeBoundings(Transform& transform);
+		// Rebuilds the box drawn around the mesh, on the GL thread
+		void updateBoundingMesh(const AABB& box);
 		void updateInstance(const glm::mat4& matrix, unsigned int index);
 		void calculateTangents();
 
@@ -212,6 +224,11 @@ namespace Razor
 		inline IndexBuffer* getIbo() { return ibo; }
 		inline DrawMode getDrawMode() { return drawMode; }
 		inline AABB& getBoundingBox() { return bounding_box; }
+		// Model space bounds, recomputed after setVertices(), setupBuffers() or
+		// invalidateBoundings()
+		const AABB& getLocalBoundingBox();
+		// To call after editing the vertices through getVertices()
+		inline void invalidateBoundings() { local_bounding_dirty = true; }
 		inline std::shared_ptr<Bounding> getBoundingMesh() { return bounding_mesh; }
 		inline float& getLineWidth() { return line_width; }
 		inline bool& isLineDashed() { return is_line_dashed; }
@@ -228,7 +245,7 @@ namespace Razor
 		inline void setCulling(bool value) { this->culling = value; }
 		inline void setMaterial(std::shared_ptr<Material> material) { this->material = material; }
 		inline void setIndices(std::vector<unsigned int> indices) { this->indices = indices; }
-		inline void setVertices(std::vector<float> vertices) { this->vertices = vertices; }
+		inline void setVertices(std::vector<float> vertices) { this->vertices = vertices; local_bounding_dirty = true; }
 		inline void setUvs(std::vector<float> uvs) { this->uvs = uvs; }
 		inline void setNormals(std::vector<float> normals) { this->normals = normals; }
 		inline void setTangents(std::vector<float> tangents) { this->tangents = tangents; }
@@ -304,6 +321,8 @@ namespace Razor
 		int line_pattern;
 
 		AABB bounding_box;
+		AABB local_bounding_box;
+		bool local_bounding_dirty;
 		std::shared_ptr<Bounding> bounding_mesh;
 
 		bool show_bounding_box;
@@ -1,6 +1,7 @@
 #include "rzpch.h"
 #include "Landscape.h"
 #include "Razor/Materials/Texture.h"
+#include "Razor/Core/Parallel.h"
 #include <glm/gtx/string_cast.hpp>
 
 #define STB_IMAGE_STATIC
@@ -36,7 +37,13 @@ namespace Razor
 
 	void Landscape::generate()
 	{
-		mesh = std::make_shared<StaticMesh>();
+		build();
+		mesh->setupBuffers();
+	}
+
+	void Landscape::build()
+	{
+		mesh = StaticMesh::create();
 		mesh->setWindingOrder(StaticMesh::WindingOrder::CLOCKWISE);
 
 		std::vector<float> vertices;
@@ -54,71 +61,107 @@ namespace Razor
 			min_height = temp;
 		}
 
-		for (unsigned int row = 0; row <= subdivisions.y; row++)
+		unsigned int columns = (unsigned int)subdivisions.x + 1;
+		unsigned int rows = (unsigned int)subdivisions.y + 1;
+		size_t vertex_count = (size_t)rows * columns;
+
+		vertices.resize(vertex_count * 3);
+		normals.resize(vertex_count * 3);
+		uvs.resize(vertex_count * 2);
+		tangents.resize(vertex_count * 3);
+
+		// Rows are independent, each one writes its own slice of the buffers
+		parallel_for(0, rows, LANDSCAPE_ROWS_GRAIN, [&](size_t first, size_t last)
 		{
-			for (unsigned int col = 0; col <= subdivisions.x; col++)
+			for (unsigned int row = (unsigned int)first; row < (unsigned int)last; row++)
 			{
-				glm::dvec3 position = glm::dvec3(
-					(double)(col * size.x) / subdivisions.x - (size.x / 2.0f),
-					0.0f, 
-					(double)((subdivisions.y - row) * size.y) / subdivisions.y - (size.y / 2.0f)
-				);
+				for (unsigned int col = 0; col < columns; col++)
+				{
+					size_t vertex = (size_t)row * columns + col;
+
+					glm::dvec3 position = glm::dvec3(
+						(double)(col * size.x) / subdivisions.x - (size.x / 2.0f),
+						0.0f, 
+						(double)((subdivisions.y - row) * size.y) / subdivisions.y - (size.y / 2.0f)
+					);
 
-				glm::dvec2 heightmap_pos = glm::dvec2(
-					(double)((position.x + size.x / 2.0f) / size.x) * (heightmap_width - 1.0f),
-					(double)((1.0f - (position.z + size.y / 2.0f) / size.y) * (heightmap_height - 1.0f))
-				);
+					glm::dvec2 heightmap_pos = glm::dvec2(
+						(double)((position.x + size.x / 2.0f) / size.x) * (heightmap_width - 1.0f),
+						(double)((1.0f - (position.z + size.y / 2.0f) / size.y) * (heightmap_height - 1.0f))
+					);
 
-				position.y = getHeightAtXZ(heightmap_pos);
+					position.y = getHeightAtXZ(heightmap_pos);
 
-				vertices.push_back((float)position.x);
-				vertices.push_back((float)position.y);
-				vertices.push_back((float)position.z);
+					vertices[vertex * 3 + 0] = (float)position.x;
+					vertices[vertex * 3 + 1] = (float)position.y;
+					vertices[vertex * 3 + 2] = (float)position.z;
 
-				glm::dvec3 normal = calculateNormal(heightmap_pos);
+					glm::dvec3 normal = calculateNormal(heightmap_pos);
 
-				normals.push_back((float)normal.x);
-				normals.push_back((float)normal.y);
-				normals.push_back((float)normal.z);
+					normals[vertex * 3 + 0] = (float)normal.x;
+					normals[vertex * 3 + 1] = (float)normal.y;
+					normals[vertex * 3 + 2] = (float)normal.z;
 
-				uvs.push_back((float)(col / subdivisions.x));
-				uvs.push_back((float)(1.0f - row / subdivisions.y));
+					uvs[vertex * 2 + 0] = (float)(col / subdivisions.x);
+					uvs[vertex * 2 + 1] = (float)(1.0f - row / subdivisions.y);
 
-				tangents.push_back((float)position.x);
-				tangents.push_back((float)position.y);
-				tangents.push_back((float)position.z);
+					tangents[vertex * 3 + 0] = (float)position.x;
+					tangents[vertex * 3 + 1] = (float)position.y;
+					tangents[vertex * 3 + 2] = (float)position.z;
+				}
 			}
-		}
-		
-		for (unsigned int row = 0; row < subdivisions.y - 1; row++)
-		{
-			for (unsigned int col = 0; col < subdivisions.x - 1; col++)
-			{
-				unsigned int idx1 = (col + 1 + (row + 1) * ((unsigned int)subdivisions.x + 1));
-				unsigned int idx2 = (col + 1 + row * ((unsigned int)subdivisions.x + 1));
-				unsigned int idx3 = (col + row * ((unsigned int)subdivisions.x + 1));
-				unsigned int idx4 = (col + (row + 1) * ((unsigned int)subdivisions.x + 1));
+		});
 
-				bool isVisibleIdx1 = ((unsigned int)vertices[idx1 * 3 + 1] >= min_height);
-				bool isVisibleIdx2 = ((unsigned int)vertices[idx2 * 3 + 1] >= min_height);
-				bool isVisibleIdx3 = ((unsigned int)vertices[idx3 * 3 + 1] >= min_height);
-				bool isVisibleIdx4 = ((unsigned int)vertices[idx4 * 3 + 1] >= min_height);
+		// Triangles per row vary with the visibility test, gather them per row
+		// and concatenate in order so the index buffer doesn't depend on scheduling
+		unsigned int quad_rows = (unsigned int)subdivisions.y - 1;
+		std::vector<std::vector<unsigned int>> row_indices(quad_rows);
 
-				if (isVisibleIdx4 && isVisibleIdx1 && isVisibleIdx3) 
-				{
-					indices.push_back(idx4);
-					indices.push_back(idx1);
-					indices.push_back(idx3);
-				}
+		parallel_for(0, quad_rows, LANDSCAPE_ROWS_GRAIN, [&](size_t first, size_t last)
+		{
+			for (unsigned int row = (unsigned int)first; row < (unsigned int)last; row++)
+			{
+				std::vector<unsigned int>& row_list = row_indices[row];
+				row_list.reserve(((unsigned int)subdivisions.x - 1) * 6);
 
-				if (isVisibleIdx1 && isVisibleIdx2 && isVisibleIdx3)
+				for (unsigned int col = 0; col < subdivisions.x - 1; col++)
 				{
-					indices.push_back(idx1);
-					indices.push_back(idx2);
-					indices.push_back(idx3);
+					unsigned int idx1 = (col + 1 + (row + 1) * columns);
+					unsigned int idx2 = (col + 1 + row * columns);
+					unsigned int idx3 = (col + row * columns);
+					unsigned int idx4 = (col + (row + 1) * columns);
+
+					bool isVisibleIdx1 = ((unsigned int)vertices[idx1 * 3 + 1] >= min_height);
+					bool isVisibleIdx2 = ((unsigned int)vertices[idx2 * 3 + 1] >= min_height);
+					bool isVisibleIdx3 = ((unsigned int)vertices[idx3 * 3 + 1] >= min_height);
+					bool isVisibleIdx4 = ((unsigned int)vertices[idx4 * 3 + 1] >= min_height);
+
+					if (isVisibleIdx4 && isVisibleIdx1 && isVisibleIdx3) 
+					{
+						row_list.push_back(idx4);
+						row_list.push_back(idx1);
+						row_list.push_back(idx3);
+					}
+
+					if (isVisibleIdx1 && isVisibleIdx2 && isVisibleIdx3)
+					{
+						row_list.push_back(idx1);
+						row_list.push_back(idx2);
+						row_list.push_back(idx3);
+					}
 				}
 			}
-		}
+		});
+
+		size_t index_count = 0;
+
+		for (auto& row_list : row_indices)
+			index_count += row_list.size();
+
+		indices.reserve(index_count);
+
+		for (auto& row_list : row_indices)
+			indices.insert(indices.end(), row_list.begin(), row_list.end());
 
 		mesh->setVertexCount((unsigned int)subdivisions.y * (unsigned int)subdivisions.x * 3u);
 		mesh->setVertices(vertices);
@@ -127,8 +170,6 @@ namespace Razor
 		mesh->setTangents(tangents);
 		mesh->setIndices(indices);
 
-		mesh->setupBuffers();
-
 		stbi_image_free(heightmap_data);
 	}
 
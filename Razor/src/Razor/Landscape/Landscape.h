@@ -3,6 +3,8 @@
 #include "Razor/Geometry/StaticMesh.h"
 #include <glm/glm.hpp>
 
+#define LANDSCAPE_ROWS_GRAIN 16
+
 namespace Razor
 {
 	class Texture;
@@ -16,8 +18,12 @@ namespace Razor
 		~Landscape();
 
 		void generate();
+		// Builds the mesh data without uploading it, generate() = build() + upload
+		void build();
 
 		inline std::shared_ptr<StaticMesh> getMesh() const { return mesh; }
+		inline void setSize(const glm::vec2& size) { this->size = size; }
+		inline void setSubdivisions(const glm::vec2& subdivisions) { this->subdivisions = subdivisions; }
 		glm::vec3 calculateNormal(const glm::vec2& position);
 		float getHeightAtXZ(const glm::vec2& position);
 
@@ -17,7 +17,7 @@ namespace Razor
 {
 
 	LightBound::LightBound(Light* light) :
-		node(std::make_shared<Node>()),
+		node(Node::create()),
 		light(light)
 	{
 	}
@@ -62,18 +62,18 @@ namespace Razor
 		circle->setMaterial(ForwardRenderer::colorMaterial);
 		circle->setLineDashed(false);
 
-		circle_node_x = std::make_shared<Node>();
+		circle_node_x = Node::create();
 		circle_node_x->transform.setPosition(point->getPosition());
 		circle_node_x->meshes.push_back(circle);
 		circle_node_x->name = "Circle_X";
-		node->nodes.push_back(circle_node_x);
+		node->addChild(circle_node_x);
 
-		circle_node_z = std::make_shared<Node>();
+		circle_node_z = Node::create();
 		circle_node_z->transform.setRotation(glm::vec3(PI * 0.5f, 0.0f, 0.0f));
 		circle_node_z->transform.setPosition(point->getPosition());
 		circle_node_z->meshes.push_back(circle);
 		circle_node_z->name = "Circle_Z";
-		node->nodes.push_back(circle_node_z);
+		node->addChild(circle_node_z);
 
 		ForwardRenderer::addLineMesh(node, 0);
 	}
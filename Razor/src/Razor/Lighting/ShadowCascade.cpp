@@ -59,6 +59,10 @@ namespace Razor
 
 		updateLightViewMatrix(light_dir, light_pos);
 		updateLightProjectionMatrix();
+
+		// Casters between the light and the cascade still throw their shadow into it
+		frustum = Frustum::fromMatrix(ortho_proj_matrix * light_view_matrix);
+		frustum.planes[Frustum::PLANE_NEAR] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 	}
 
 	void ShadowCascade::updateLightViewMatrix(const glm::vec3& light_direction, const glm::vec3& light_position)
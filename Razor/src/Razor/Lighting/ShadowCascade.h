@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Razor/Maths/Frustum.h"
+
 #define FRUSTUM_CORNERS 8
 
 namespace Razor
@@ -23,6 +25,7 @@ namespace Razor
 
 		inline glm::mat4 getLightViewMatrix() { return light_view_matrix; }
 		inline glm::mat4 getOrthoProjMatrix() { return ortho_proj_matrix; }
+		inline const Frustum& getFrustum() const { return frustum; }
 		inline TextureAttachment* getDepthTexture() { return depth_texture; }
 
 	private:
@@ -34,6 +37,8 @@ namespace Razor
 		glm::mat4 proj_view_matrix;
 		glm::mat4 ortho_proj_matrix;
 		glm::mat4 light_view_matrix;
+		// Casters of the cascade, without near plane
+		Frustum frustum;
 
 		glm::vec3 centroid;
 		std::array<glm::vec3, FRUSTUM_CORNERS> frustum_corners;
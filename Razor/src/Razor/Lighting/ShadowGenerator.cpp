@@ -7,6 +7,7 @@
 #include "Razor/Cameras/Camera.h"
 #include "Razor/Lighting/Directional.h"
 #include "Razor/Scene/Scene.h"
+#include "Razor/Core/Parallel.h"
 
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
@@ -53,13 +54,18 @@ namespace Razor
 	{
 		std::shared_ptr<Directional> directional = nullptr;
 
-		for (auto light : scene->getLights())
+		for (auto& light : scene->getLights())
 			directional = std::dynamic_pointer_cast<Directional>(light);
 
+		// Cascades only write their own matrices, the depth passes themselves
+		// stay on the GL thread
 		if (directional != nullptr)
 		{
-			for (unsigned int i = 0; i < cascades_count; i++)
-				cascades[i]->update(camera, view_matrix, directional);
+			parallel_for(0, cascades_count, 1, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; i++)
+					cascades[i]->update(camera, view_matrix, directional);
+			});
 		}
 	}
 
@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "CubemapTexture.h"
+#include "Razor/Rendering/RenderState.h"
 
 #include "glad/glad.h"
 
@@ -22,11 +23,11 @@ namespace Razor
 
 	CubemapTexture* CubemapTexture::load()
 	{
-		glActiveTexture(GL_TEXTURE0);
+		RenderState::setActiveTexture(0);
 		glEnable(GL_TEXTURE_CUBE_MAP);
 		glGenTextures(1, &id);
 
-		glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+		RenderState::editTexture(GL_TEXTURE_CUBE_MAP, id);
 
 		for (unsigned int i = 0; i < textures.size(); i++)
 		{
@@ -58,13 +59,13 @@ namespace Razor
 	{
 		assert(unit >= 0 && unit <= 31);
 
-		glActiveTexture(GL_TEXTURE0 + unit);
-		glBindTexture(GL_TEXTURE_2D, id);
+		RenderState::bindTexture(unit, GL_TEXTURE_2D, id);
 	}
 
 	void CubemapTexture::unbind()
 	{
 		glDeleteTextures(1, &id);
+		RenderState::releaseTexture(id);
 	}
 
 }
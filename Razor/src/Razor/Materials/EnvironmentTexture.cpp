@@ -1,6 +1,7 @@
 #include "rzpch.h"
 #include <glad/glad.h>
 #include "EnvironmentTexture.h"
+#include "Razor/Rendering/RenderState.h"
 
 #define STB_IMAGE_STATIC
 #define STB_IMAGE_IMPLEMENTATION
@@ -29,7 +30,7 @@ namespace Razor
 		if (data)
 		{
 			glGenTextures(1, &id);
-			glBindTexture(GL_TEXTURE_2D, id);
+			RenderState::editTexture(GL_TEXTURE_2D, id);
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
 
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
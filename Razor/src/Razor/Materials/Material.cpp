@@ -38,22 +38,22 @@ namespace Razor {
 	{
 		if (shader != nullptr)
 		{
-			std::string paramType;
+			const char* paramType;
 			unsigned int sIdx = 0, dIdx = 0, pIdx = 0;
 
-			for (auto light : lights)
+			for (auto& light : lights)
 			{
 				if (light->getType() == Light::Type::DIRECTIONAL)
 				{
 					std::shared_ptr<Directional> directional = std::dynamic_pointer_cast<Directional>(light);
 					paramType = "directionalLights";
 
-					shader->setUniform3f(formatParamName(paramType, dIdx, "position"), directional->getPosition());
-					shader->setUniform3f(formatParamName(paramType, dIdx, "direction"), directional->getDirection());
-					shader->setUniform3f(formatParamName(paramType, dIdx, "ambient"), directional->getAmbient());
-					shader->setUniform3f(formatParamName(paramType, dIdx, "diffuse"), directional->getDiffuse());
-					shader->setUniform3f(formatParamName(paramType, dIdx, "specular"), directional->getSpecular());
-					shader->setUniform1f(formatParamName(paramType, dIdx, "intensity"), directional->getIntensity());
+					shader->setUniform3f(hashUniformElement(paramType, dIdx, "position"), directional->getPosition());
+					shader->setUniform3f(hashUniformElement(paramType, dIdx, "direction"), directional->getDirection());
+					shader->setUniform3f(hashUniformElement(paramType, dIdx, "ambient"), directional->getAmbient());
+					shader->setUniform3f(hashUniformElement(paramType, dIdx, "diffuse"), directional->getDiffuse());
+					shader->setUniform3f(hashUniformElement(paramType, dIdx, "specular"), directional->getSpecular());
+					shader->setUniform1f(hashUniformElement(paramType, dIdx, "intensity"), directional->getIntensity());
 
 					dIdx++;
 				}
@@ -62,14 +62,14 @@ namespace Razor {
 					std::shared_ptr<Point> point = std::dynamic_pointer_cast<Point>(light);
 					paramType = "pointLights";
 
-					shader->setUniform3f(formatParamName(paramType, pIdx, "position"), point->getPosition());
-					shader->setUniform1f(formatParamName(paramType, pIdx, "constant"), point->getLinear());
-					shader->setUniform1f(formatParamName(paramType, pIdx, "linear"), point->getConstant());
-					shader->setUniform1f(formatParamName(paramType, pIdx, "quadratic"), point->getQuadratic());
-					shader->setUniform3f(formatParamName(paramType, pIdx, "ambient"), point->getAmbient());
-					shader->setUniform3f(formatParamName(paramType, pIdx, "diffuse"), point->getDiffuse());
-					shader->setUniform3f(formatParamName(paramType, pIdx, "specular"), point->getSpecular());
-					shader->setUniform1f(formatParamName(paramType, pIdx, "intensity"), point->getIntensity());
+					shader->setUniform3f(hashUniformElement(paramType, pIdx, "position"), point->getPosition());
+					shader->setUniform1f(hashUniformElement(paramType, pIdx, "constant"), point->getLinear());
+					shader->setUniform1f(hashUniformElement(paramType, pIdx, "linear"), point->getConstant());
+					shader->setUniform1f(hashUniformElement(paramType, pIdx, "quadratic"), point->getQuadratic());
+					shader->setUniform3f(hashUniformElement(paramType, pIdx, "ambient"), point->getAmbient());
+					shader->setUniform3f(hashUniformElement(paramType, pIdx, "diffuse"), point->getDiffuse());
+					shader->setUniform3f(hashUniformElement(paramType, pIdx, "specular"), point->getSpecular());
+					shader->setUniform1f(hashUniformElement(paramType, pIdx, "intensity"), point->getIntensity());
 
 					pIdx++;
 				}
@@ -78,17 +78,17 @@ namespace Razor {
 					std::shared_ptr<Spot> spot = std::dynamic_pointer_cast<Spot>(light);
 					paramType = "spotLights";
 
-					shader->setUniform3f(formatParamName(paramType, sIdx, "direction"), spot->getDirection());
-					shader->setUniform3f(formatParamName(paramType, sIdx, "position"), spot->getPosition());
-					shader->setUniform1f(formatParamName(paramType, sIdx, "intensity"), spot->getIntensity());
-					shader->setUniform1f(formatParamName(paramType, sIdx, "constant"), spot->getConstant());
-					shader->setUniform1f(formatParamName(paramType, sIdx, "linear"), spot->getLinear());
-					shader->setUniform1f(formatParamName(paramType, sIdx, "quadratic"), spot->getQuadratic());
-					shader->setUniform1f(formatParamName(paramType, sIdx, "inner_cutoff"), spot->getInnerCutoff());
-					shader->setUniform1f(formatParamName(paramType, sIdx, "outer_cutoff"), spot->getOuterCutoff());
-					shader->setUniform3f(formatParamName(paramType, sIdx, "ambient"), spot->getAmbient());
-					shader->setUniform3f(formatParamName(paramType, sIdx, "diffuse"), spot->getDiffuse());
-					shader->setUniform3f(formatParamName(paramType, sIdx, "specular"), spot->getSpecular());
+					shader->setUniform3f(hashUniformElement(paramType, sIdx, "direction"), spot->getDirection());
+					shader->setUniform3f(hashUniformElement(paramType, sIdx, "position"), spot->getPosition());
+					shader->setUniform1f(hashUniformElement(paramType, sIdx, "intensity"), spot->getIntensity());
+					shader->setUniform1f(hashUniformElement(paramType, sIdx, "constant"), spot->getConstant());
+					shader->setUniform1f(hashUniformElement(paramType, sIdx, "linear"), spot->getLinear());
+					shader->setUniform1f(hashUniformElement(paramType, sIdx, "quadratic"), spot->getQuadratic());
+					shader->setUniform1f(hashUniformElement(paramType, sIdx, "inner_cutoff"), spot->getInnerCutoff());
+					shader->setUniform1f(hashUniformElement(paramType, sIdx, "outer_cutoff"), spot->getOuterCutoff());
+					shader->setUniform3f(hashUniformElement(paramType, sIdx, "ambient"), spot->getAmbient());
+					shader->setUniform3f(hashUniformElement(paramType, sIdx, "diffuse"), spot->getDiffuse());
+					shader->setUniform3f(hashUniformElement(paramType, sIdx, "specular"), spot->getSpecular());
 
 					sIdx++;
 				}
@@ -118,6 +118,22 @@ namespace Razor {
 		textures_maps[type] = id;
 	}
 
+	std::string& Material::getTexturePath(TextureType type)
+	{
+		switch (type)
+		{
+			case TextureType::Specular : return specular_path;
+			case TextureType::Normal : return normal_path;
+			case TextureType::Metallic : return metallic_path;
+			case TextureType::Roughness : return roughness_path;
+			case TextureType::Ao : return ao_path;
+			case TextureType::Orm : return orm_path;
+			case TextureType::Opacity : return opacity_path;
+			case TextureType::Emissive : return emissive_path;
+			default : return diffuse_path;
+		}
+	}
+
 	void Material::removeTextureMap(TextureType type)
 	{
 		TexturesMap::iterator it = textures_maps.find(type);
@@ -141,13 +157,5 @@ namespace Razor {
 		}
 	}
 
-	std::string Material::formatParamName(const std::string& type, unsigned int index, const std::string& name)
-	{
-		std::stringstream str;
-		str << type << "[" << index << "]." << name;
-
-		return str.str();
-	}
-
 }
 
@@ -35,6 +35,7 @@ namespace Razor {
 		virtual void removeTextureMap(TextureType type);
 
 		inline unsigned int getId() { return id; }
+		inline const TexturesMap& getTexturesMaps() const { return textures_maps; }
 
 		inline void setName(const std::string& name) { this->name = name; }
 		inline std::string getName() { return name; }
@@ -59,8 +60,6 @@ namespace Razor {
 		inline unsigned int getOpacityMap() { return textures_maps[TextureType::Opacity]; }
 		inline unsigned int getEmissiveMap() { return textures_maps[TextureType::Emissive]; }
 
-		std::string formatParamName(const std::string& type, unsigned int index, const std::string& name);
-
 		inline std::string& getDiffusePath() { return diffuse_path; }
 		inline std::string& getSpecularPath() { return specular_path; }
 		inline std::string& getNormalPath() { return normal_path; }
@@ -81,6 +80,8 @@ namespace Razor {
 		inline void setOpacityPath(const std::string& path) { opacity_path = path; }
 		inline void setEmissivePath(const std::string& path) { emissive_path = path; }
 
+		std::string& getTexturePath(TextureType type);
+
 	protected:
 		unsigned int id;
 		std::string name;
@@ -27,16 +27,16 @@ namespace Razor
 	{
 		if (shader != nullptr)
 		{
-			shader->setUniform1f("sun_factor", sun_factor);
-			shader->setUniform3f("ray_origin", ray_origin);
-			shader->setUniform1f("planet_radius", planet_radius);
-			shader->setUniform1f("atmosphere_radius", atmosphere_radius);
-			shader->setUniform3f("rayleigh_scattering", rayleigh_scattering);
-			shader->setUniform1f("mie_scattering", mie_scattering);
-			shader->setUniform1f("rayleigh_scale_height", rayleigh_scale_height);
-			shader->setUniform1f("mie_scale_height", mie_scale_height);
-			shader->setUniform1f("mie_scattering_direction", mie_scattering_direction);
-			shader->setUniform2f("limits", limits);
+			shader->setUniform1f(RZ_UNIFORM("sun_factor"), sun_factor);
+			shader->setUniform3f(RZ_UNIFORM("ray_origin"), ray_origin);
+			shader->setUniform1f(RZ_UNIFORM("planet_radius"), planet_radius);
+			shader->setUniform1f(RZ_UNIFORM("atmosphere_radius"), atmosphere_radius);
+			shader->setUniform3f(RZ_UNIFORM("rayleigh_scattering"), rayleigh_scattering);
+			shader->setUniform1f(RZ_UNIFORM("mie_scattering"), mie_scattering);
+			shader->setUniform1f(RZ_UNIFORM("rayleigh_scale_height"), rayleigh_scale_height);
+			shader->setUniform1f(RZ_UNIFORM("mie_scale_height"), mie_scale_height);
+			shader->setUniform1f(RZ_UNIFORM("mie_scattering_direction"), mie_scattering_direction);
+			shader->setUniform2f(RZ_UNIFORM("limits"), limits);
 		}
 	}
 
@@ -18,7 +18,7 @@ namespace Razor
 	{
 		if (shader != nullptr)
 		{
-			shader->setUniform3f("color", color);
+			shader->setUniform3f(RZ_UNIFORM("color"), color);
 		}
 	}
 
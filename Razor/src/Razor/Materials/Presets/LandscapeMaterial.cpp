@@ -1,6 +1,7 @@
 #include "rzpch.h"
 #include "LandscapeMaterial.h"
 #include "glad/glad.h"
+#include "Razor/Rendering/RenderState.h"
 
 namespace Razor
 {
@@ -39,123 +40,110 @@ namespace Razor
 		{
 			if (hasDiffuseMap())
 			{
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, getDiffuseMap());
-				shader->setUniform1i("material.diffuseMap", 0);
+				RenderState::bindTexture(0, GL_TEXTURE_2D, getDiffuseMap());
+				shader->setUniform1i(RZ_UNIFORM("material.diffuseMap"), 0);
 			}
 
 			if (hasSpecularMap())
 			{
-				glActiveTexture(GL_TEXTURE1);
-				glBindTexture(GL_TEXTURE_2D, getSpecularMap());
-				shader->setUniform1i("material.specularMap", 1);
+				RenderState::bindTexture(1, GL_TEXTURE_2D, getSpecularMap());
+				shader->setUniform1i(RZ_UNIFORM("material.specularMap"), 1);
 			}
 
 			if (hasNormalMap())
 			{
-				glActiveTexture(GL_TEXTURE2);
-				glBindTexture(GL_TEXTURE_2D, getNormalMap());
-				shader->setUniform1i("material.normalMap", 2);
+				RenderState::bindTexture(2, GL_TEXTURE_2D, getNormalMap());
+				shader->setUniform1i(RZ_UNIFORM("material.normalMap"), 2);
 			}
 
-			shader->setUniform1i("material.shadowMap", 3);
+			shader->setUniform1i(RZ_UNIFORM("material.shadowMap"), 3);
 
 			if (has_splatmap)
 			{
-				glActiveTexture(GL_TEXTURE4);
-				glBindTexture(GL_TEXTURE_2D, splatmap);
-				shader->setUniform1i("material.splatmap", 4);
+				RenderState::bindTexture(4, GL_TEXTURE_2D, splatmap);
+				shader->setUniform1i(RZ_UNIFORM("material.splatmap"), 4);
 			}
 
 			if (has_red_channel_diffuse)
 			{
-				glActiveTexture(GL_TEXTURE5);
-				glBindTexture(GL_TEXTURE_2D, red_channel_diffuse);
-				shader->setUniform1i("material.red_channel_diffuse", 5);
+				RenderState::bindTexture(5, GL_TEXTURE_2D, red_channel_diffuse);
+				shader->setUniform1i(RZ_UNIFORM("material.red_channel_diffuse"), 5);
 			}
 
 			if (has_red_channel_specular)
 			{
-				glActiveTexture(GL_TEXTURE6);
-				glBindTexture(GL_TEXTURE_2D, red_channel_specular);
-				shader->setUniform1i("material.red_channel_specular", 6);
+				RenderState::bindTexture(6, GL_TEXTURE_2D, red_channel_specular);
+				shader->setUniform1i(RZ_UNIFORM("material.red_channel_specular"), 6);
 			}
 
 			if (has_red_channel_normal)
 			{
-				glActiveTexture(GL_TEXTURE7);
-				glBindTexture(GL_TEXTURE_2D, red_channel_normal);
-				shader->setUniform1i("material.red_channel_normal", 7);
+				RenderState::bindTexture(7, GL_TEXTURE_2D, red_channel_normal);
+				shader->setUniform1i(RZ_UNIFORM("material.red_channel_normal"), 7);
 			}
 
 			if (has_green_channel_diffuse)
 			{
-				glActiveTexture(GL_TEXTURE8);
-				glBindTexture(GL_TEXTURE_2D, green_channel_diffuse);
-				shader->setUniform1i("material.green_channel_diffuse", 8);
+				RenderState::bindTexture(8, GL_TEXTURE_2D, green_channel_diffuse);
+				shader->setUniform1i(RZ_UNIFORM("material.green_channel_diffuse"), 8);
 			}
 
 			if (has_green_channel_specular)
 			{
-				glActiveTexture(GL_TEXTURE9);
-				glBindTexture(GL_TEXTURE_2D, green_channel_specular);
-				shader->setUniform1i("material.green_channel_specular", 9);
+				RenderState::bindTexture(9, GL_TEXTURE_2D, green_channel_specular);
+				shader->setUniform1i(RZ_UNIFORM("material.green_channel_specular"), 9);
 			}
 
 			if (has_green_channel_normal)
 			{
-				glActiveTexture(GL_TEXTURE10);
-				glBindTexture(GL_TEXTURE_2D, green_channel_normal);
-				shader->setUniform1i("material.green_channel_normal", 10);
+				RenderState::bindTexture(10, GL_TEXTURE_2D, green_channel_normal);
+				shader->setUniform1i(RZ_UNIFORM("material.green_channel_normal"), 10);
 			}
 
 			if (has_blue_channel_diffuse)
 			{
-				glActiveTexture(GL_TEXTURE11);
-				glBindTexture(GL_TEXTURE_2D, blue_channel_diffuse);
-				shader->setUniform1i("material.blue_channel_diffuse", 11);
+				RenderState::bindTexture(11, GL_TEXTURE_2D, blue_channel_diffuse);
+				shader->setUniform1i(RZ_UNIFORM("material.blue_channel_diffuse"), 11);
 			}
 
 			if (has_blue_channel_specular)
 			{
-				glActiveTexture(GL_TEXTURE12);
-				glBindTexture(GL_TEXTURE_2D, blue_channel_specular);
-				shader->setUniform1i("material.blue_channel_specular", 12);
+				RenderState::bindTexture(12, GL_TEXTURE_2D, blue_channel_specular);
+				shader->setUniform1i(RZ_UNIFORM("material.blue_channel_specular"), 12);
 			}
 
 			if (has_blue_channel_normal)
 			{
-				glActiveTexture(GL_TEXTURE13);
-				glBindTexture(GL_TEXTURE_2D, blue_channel_normal);
-				shader->setUniform1i("material.blue_channel_normal", 13);
+				RenderState::bindTexture(13, GL_TEXTURE_2D, blue_channel_normal);
+				shader->setUniform1i(RZ_UNIFORM("material.blue_channel_normal"), 13);
 			}
 
-			shader->setUniform3f("material.diffuseColor", diffuse_color.x, diffuse_color.y, diffuse_color.z);
-			shader->setUniform3f("material.specularColor", specular_color.x, specular_color.y, specular_color.z);
-			shader->setUniform3f("material.ambientColor", ambient_color.x, ambient_color.y, ambient_color.z);
-
-			shader->setUniform1f("material.shininess", shininess);
-			shader->setUniform1f("material.shininess_strength", shininess_strength);
-			shader->setUniform1f("material.normal_strength", normal_strength);
-
-			shader->setUniform1i("material.hasDiffuse", (int)hasDiffuseMap());
-			shader->setUniform1i("material.hasSpecular", (int)hasSpecularMap());
-			shader->setUniform1i("material.hasNormal", (int)hasNormalMap());
-
-			shader->setUniform1i("material.hasRedChannelDiffuse", (int)has_red_channel_diffuse);
-			shader->setUniform1i("material.hasRedChannelSpecular", (int)has_red_channel_specular);
-			shader->setUniform1i("material.hasRedChannelNormal", (int)has_red_channel_normal);
-			shader->setUniform1i("material.hasGreenChannelDiffuse", (int)has_green_channel_diffuse);
-			shader->setUniform1i("material.hasGreenChannelSpecular", (int)has_green_channel_specular);
-			shader->setUniform1i("material.hasGreenChannelNormal", (int)has_green_channel_normal);
-			shader->setUniform1i("material.hasBlueChannelDiffuse", (int)has_blue_channel_diffuse);
-			shader->setUniform1i("material.hasBlueChannelSpecular", (int)has_blue_channel_specular);
-			shader->setUniform1i("material.hasBlueChannelNormal", (int)has_blue_channel_normal);
-			shader->setUniform1i("material.hasSplatmap", (int)has_splatmap);
-
-			shader->setUniform2f("material.diffuse_tiling", diffuse_tiling);
-			shader->setUniform2f("material.specular_tiling", specular_tiling);
-			shader->setUniform2f("material.normal_tiling", normal_tiling);
+			shader->setUniform3f(RZ_UNIFORM("material.diffuseColor"), diffuse_color.x, diffuse_color.y, diffuse_color.z);
+			shader->setUniform3f(RZ_UNIFORM("material.specularColor"), specular_color.x, specular_color.y, specular_color.z);
+			shader->setUniform3f(RZ_UNIFORM("material.ambientColor"), ambient_color.x, ambient_color.y, ambient_color.z);
+
+			shader->setUniform1f(RZ_UNIFORM("material.shininess"), shininess);
+			shader->setUniform1f(RZ_UNIFORM("material.shininess_strength"), shininess_strength);
+			shader->setUniform1f(RZ_UNIFORM("material.normal_strength"), normal_strength);
+
+			shader->setUniform1i(RZ_UNIFORM("material.hasDiffuse"), (int)hasDiffuseMap());
+			shader->setUniform1i(RZ_UNIFORM("material.hasSpecular"), (int)hasSpecularMap());
+			shader->setUniform1i(RZ_UNIFORM("material.hasNormal"), (int)hasNormalMap());
+
+			shader->setUniform1i(RZ_UNIFORM("material.hasRedChannelDiffuse"), (int)has_red_channel_diffuse);
+			shader->setUniform1i(RZ_UNIFORM("material.hasRedChannelSpecular"), (int)has_red_channel_specular);
+			shader->setUniform1i(RZ_UNIFORM("material.hasRedChannelNormal"), (int)has_red_channel_normal);
+			shader->setUniform1i(RZ_UNIFORM("material.hasGreenChannelDiffuse"), (int)has_green_channel_diffuse);
+			shader->setUniform1i(RZ_UNIFORM("material.hasGreenChannelSpecular"), (int)has_green_channel_specular);
+			shader->setUniform1i(RZ_UNIFORM("material.hasGreenChannelNormal"), (int)has_green_channel_normal);
+			shader->setUniform1i(RZ_UNIFORM("material.hasBlueChannelDiffuse"), (int)has_blue_channel_diffuse);
+			shader->setUniform1i(RZ_UNIFORM("material.hasBlueChannelSpecular"), (int)has_blue_channel_specular);
+			shader->setUniform1i(RZ_UNIFORM("material.hasBlueChannelNormal"), (int)has_blue_channel_normal);
+			shader->setUniform1i(RZ_UNIFORM("material.hasSplatmap"), (int)has_splatmap);
+
+			shader->setUniform2f(RZ_UNIFORM("material.diffuse_tiling"), diffuse_tiling);
+			shader->setUniform2f(RZ_UNIFORM("material.specular_tiling"), specular_tiling);
+			shader->setUniform2f(RZ_UNIFORM("material.normal_tiling"), normal_tiling);
 		}
 	}
 
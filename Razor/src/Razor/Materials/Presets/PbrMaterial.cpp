@@ -1,6 +1,7 @@
 #include "rzpch.h"
 #include "PbrMaterial.h"
 #include "glad/glad.h"
+#include "Razor/Rendering/RenderState.h"
 
 namespace Razor
 {
@@ -19,62 +20,54 @@ namespace Razor
 		{
 			if (hasDiffuseMap())
 			{
-				glActiveTexture(GL_TEXTURE3);
-				glBindTexture(GL_TEXTURE_2D, getDiffuseMap());
+				RenderState::bindTexture(3, GL_TEXTURE_2D, getDiffuseMap());
 			}
 
 			if (hasNormalMap())
 			{
-				glActiveTexture(GL_TEXTURE4);
-				glBindTexture(GL_TEXTURE_2D, getNormalMap());
+				RenderState::bindTexture(4, GL_TEXTURE_2D, getNormalMap());
 			}
 
 			if (hasMetallicMap())
 			{
-				glActiveTexture(GL_TEXTURE5);
-				glBindTexture(GL_TEXTURE_2D, getMetallicMap());
+				RenderState::bindTexture(5, GL_TEXTURE_2D, getMetallicMap());
 			}
 
 			if (hasRoughnessMap())
 			{
-				glActiveTexture(GL_TEXTURE6);
-				glBindTexture(GL_TEXTURE_2D, getRoughnessMap());
+				RenderState::bindTexture(6, GL_TEXTURE_2D, getRoughnessMap());
 			}
 
 			if (hasAoMap())
 			{
-				glActiveTexture(GL_TEXTURE7);
-				glBindTexture(GL_TEXTURE_2D, getAoMap());
+				RenderState::bindTexture(7, GL_TEXTURE_2D, getAoMap());
 			}
 
 			if (hasOrmMap())
 			{
-				glActiveTexture(GL_TEXTURE8);
-				glBindTexture(GL_TEXTURE_2D, getOrmMap());
+				RenderState::bindTexture(8, GL_TEXTURE_2D, getOrmMap());
 			}
 
 			if (hasOpacityMap())
 			{
 	
-				glActiveTexture(GL_TEXTURE9);
-				glBindTexture(GL_TEXTURE_2D, getOpacityMap());
-				glDisable(GL_BLEND);
+				RenderState::bindTexture(9, GL_TEXTURE_2D, getOpacityMap());
+				RenderState::setBlend(false);
 			}
 
 			if (hasEmissiveMap())
 			{
-				glActiveTexture(GL_TEXTURE10);
-				glBindTexture(GL_TEXTURE_2D, getEmissiveMap());
+				RenderState::bindTexture(10, GL_TEXTURE_2D, getEmissiveMap());
 			}
 
-			shader->setUniform1i("hasAlbedo", (int)hasDiffuseMap());
-			shader->setUniform1i("hasNormal", (int)hasNormalMap());
-			shader->setUniform1i("hasMetallic", (int)hasMetallicMap());
-			shader->setUniform1i("hasRoughness", (int)hasRoughnessMap());
-			shader->setUniform1i("hasAo", (int)hasAoMap());
-			shader->setUniform1i("hasOrm", (int)hasOrmMap());
-			shader->setUniform1i("hasOpacity", (int)hasOpacityMap());
-			shader->setUniform1i("hasEmissive", (int)hasEmissiveMap());
+			shader->setUniform1i(RZ_UNIFORM("hasAlbedo"), (int)hasDiffuseMap());
+			shader->setUniform1i(RZ_UNIFORM("hasNormal"), (int)hasNormalMap());
+			shader->setUniform1i(RZ_UNIFORM("hasMetallic"), (int)hasMetallicMap());
+			shader->setUniform1i(RZ_UNIFORM("hasRoughness"), (int)hasRoughnessMap());
+			shader->setUniform1i(RZ_UNIFORM("hasAo"), (int)hasAoMap());
+			shader->setUniform1i(RZ_UNIFORM("hasOrm"), (int)hasOrmMap());
+			shader->setUniform1i(RZ_UNIFORM("hasOpacity"), (int)hasOpacityMap());
+			shader->setUniform1i(RZ_UNIFORM("hasEmissive"), (int)hasEmissiveMap());
 		}
 	}
 
@@ -1,6 +1,7 @@
 #include "rzpch.h"
 #include "PhongMaterial.h"
 #include "glad/glad.h"
+#include "Razor/Rendering/RenderState.h"
 
 namespace Razor
 {
@@ -38,38 +39,35 @@ namespace Razor
 		{
 			if (hasDiffuseMap())
 			{
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, getDiffuseMap());
-				shader->setUniform1i("material.diffuseMap", 0);
+				RenderState::bindTexture(0, GL_TEXTURE_2D, getDiffuseMap());
+				shader->setUniform1i(RZ_UNIFORM("material.diffuseMap"), 0);
 			}
 
 			if (hasSpecularMap())
 			{
-				glActiveTexture(GL_TEXTURE1);
-				glBindTexture(GL_TEXTURE_2D, getSpecularMap());
-				shader->setUniform1i("material.specularMap", 1);
+				RenderState::bindTexture(1, GL_TEXTURE_2D, getSpecularMap());
+				shader->setUniform1i(RZ_UNIFORM("material.specularMap"), 1);
 			}
 
 			if (hasNormalMap())
 			{
-				glActiveTexture(GL_TEXTURE2);
-				glBindTexture(GL_TEXTURE_2D, getNormalMap());
-				shader->setUniform1i("material.normalMap", 2);
+				RenderState::bindTexture(2, GL_TEXTURE_2D, getNormalMap());
+				shader->setUniform1i(RZ_UNIFORM("material.normalMap"), 2);
 			}
 			
 			//shader->setUniform1i("material.shadowMap", 3);
 
 			//shader->setUniform1f("material.alpha", alpha);
 
-			shader->setUniform3f("material.diffuseColor", diffuse_color.x, diffuse_color.y, diffuse_color.z);
+			shader->setUniform3f(RZ_UNIFORM("material.diffuseColor"), diffuse_color.x, diffuse_color.y, diffuse_color.z);
 		/*	shader->setUniform3f("material.specularColor", specular_color.x, specular_color.y, specular_color.z);
 			shader->setUniform3f("material.ambientColor", ambient_color.x, ambient_color.y, ambient_color.z);*/
 
-			shader->setUniform1f("material.shininess", shininess);
+			shader->setUniform1f(RZ_UNIFORM("material.shininess"), shininess);
 			//shader->setUniform1f("material.shininess_strength", shininess_strength);
 			//shader->setUniform1f("material.normal_strength", normal_strength);
 
-			shader->setUniform1i("material.hasDiffuse", (int)hasDiffuseMap());
+			shader->setUniform1i(RZ_UNIFORM("material.hasDiffuse"), (int)hasDiffuseMap());
 			//shader->setUniform1i("material.hasSpecular", (int)hasSpecularMap());
 			//shader->setUniform1i("material.hasNormal", (int)hasNormalMap());
 
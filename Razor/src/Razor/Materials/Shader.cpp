@@ -2,19 +2,30 @@
 #include "Shader.h"
 #include "Razor/Filesystem/File.h"
 #include "Razor/Materials/ShadersManager.h"
+#include "Razor/Rendering/RenderState.h"
+#include "Razor/Buffers/UniformBuffer.h"
 
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace Razor {
 
+	uint32 hashUniformElement(const char* array, uint32 index, const char* member)
+	{
+		char digits[16];
+		snprintf(digits, sizeof(digits), "[%u].", index);
+
+		return hashUniform(member, hashUniform(digits, hashUniform(array)));
+	}
+
 	Shader::Shader(const std::string& name, const std::string& vert_name, const std::string& frag_name, bool isInternal) :
 		dirty(true),
 		is_internal(isInternal),
 		frag_name(frag_name),
 		vert_name(vert_name),
 		name(name),
-		uniforms_cache({})
+		uniforms(),
+		missing_uniforms()
 	{
 		load();
 	}
@@ -25,12 +36,12 @@ namespace Razor {
 
 	void Shader::bind()
 	{
-		glUseProgram(program);
+		RenderState::useProgram(program);
 	}
 
 	void Shader::unbind()
 	{
-		glUseProgram(0);
+		RenderState::useProgram(0);
 	}
 
 	bool Shader::load()
@@ -201,6 +212,8 @@ namespace Razor {
 		{
 			Log::info("Linked shader: %s.", name.c_str());
 			status |= Status::Linked;
+
+			reflect();
 		}
 
 		for (; it != shaders.end(); it++)
@@ -209,6 +222,89 @@ namespace Razor {
 		return status & Status::Linked;
 	}
 
+	void Shader::reflect()
+	{
+		RZ_PROFILE_FUNCTION();
+
+		uniforms.clear();
+		missing_uniforms.clear();
+
+		int32 count = 0;
+		int32 max_length = 0;
+		glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+		glGetProgramInterfaceiv(program, GL_UNIFORM, GL_MAX_NAME_LENGTH, &max_length);
+
+		std::vector<char> buffer(max_length + 16);
+		const GLenum properties[] = { GL_LOCATION, GL_TYPE, GL_ARRAY_SIZE };
+
+		for (int32 i = 0; i < count; i++)
+		{
+			int32 values[3];
+			glGetProgramResourceiv(program, GL_UNIFORM, i, 3, properties, 3, nullptr, values);
+
+			// Members of uniform and storage blocks are set through their buffer
+			if (values[0] < 0)
+				continue;
+
+			int32 length = 0;
+			glGetProgramResourceName(program, GL_UNIFORM, i, max_length, &length, buffer.data());
+			buffer[length] = '\0';
+
+			uniforms.push_back({ hashUniform(buffer.data()), values[0], (uint32)values[1], values[2] });
+
+			// Arrays are reported as "name[0]", with consecutive locations for the rest
+			if (length > 3 && strcmp(&buffer[length - 3], "[0]") == 0)
+			{
+				buffer[length - 3] = '\0';
+				uniforms.push_back({ hashUniform(buffer.data()), values[0], (uint32)values[1], values[2] });
+
+				for (int32 e = 1; e < values[2]; e++)
+				{
+					snprintf(&buffer[length - 3], 16, "[%d]", e);
+					uniforms.push_back({ hashUniform(buffer.data()), values[0] + e, (uint32)values[1], 1 });
+				}
+			}
+		}
+
+		std::sort(uniforms.begin(), uniforms.end(), [](const Uniform& a, const Uniform& b) { return a.id < b.id; });
+
+		for (size_t i = 1; i < uniforms.size(); i++)
+		{
+			if (uniforms[i].id == uniforms[i - 1].id)
+				Log::error("Shader \"%s\" uniforms at locations %d and %d share the id 0x%08x", name.c_str(), uniforms[i - 1].location, uniforms[i].location, uniforms[i].id);
+		}
+
+		// Blocks are bound to the engine binding point of their name
+		const GLenum interfaces[] = { GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK };
+
+		for (GLenum block_interface : interfaces)
+		{
+			int32 blocks = 0;
+			glGetProgramInterfaceiv(program, block_interface, GL_ACTIVE_RESOURCES, &blocks);
+			glGetProgramInterfaceiv(program, block_interface, GL_MAX_NAME_LENGTH, &max_length);
+
+			buffer.resize(std::max<size_t>(buffer.size(), max_length + 1));
+
+			for (int32 b = 0; b < blocks; b++)
+			{
+				glGetProgramResourceName(program, block_interface, b, max_length, nullptr, buffer.data());
+
+				int32 binding = UniformBuffer::findBinding(buffer.data());
+
+				if (binding < 0)
+				{
+					Log::warn("Shader \"%s\" block has no binding point: %s", name.c_str(), buffer.data());
+					continue;
+				}
+
+				if (block_interface == GL_UNIFORM_BLOCK)
+					glUniformBlockBinding(program, b, binding);
+				else
+					glShaderStorageBlockBinding(program, b, binding);
+			}
+		}
+	}
+
 	void Shader::setUniform1i(const std::string & name, int value){
 		glUniform1i(getUniformLocation(name), value);
 	}
@@ -261,19 +357,56 @@ namespace Razor {
 		glUniformMatrix4dv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
-	unsigned int Shader::getUniformLocation(const std::string& uniform_name)
+	void Shader::setUniform1i(uint32 id, int value) {
+		glUniform1i(getUniformLocation(id), value);
+	}
+	void Shader::setUniform4i(uint32 id, const glm::ivec4& value) {
+		glUniform4i(getUniformLocation(id), value.x, value.y, value.z, value.w);
+	}
+	void Shader::setUniform1f(uint32 id, float value) {
+		glUniform1f(getUniformLocation(id), value);
+	}
+	void Shader::setUniform2f(uint32 id, float x, float y) {
+		glUniform2f(getUniformLocation(id), x, y);
+	}
+	void Shader::setUniform2f(uint32 id, const glm::vec2& value) {
+		glUniform2f(getUniformLocation(id), value.x, value.y);
+	}
+	void Shader::setUniform3f(uint32 id, const glm::vec3& value) {
+		glUniform3f(getUniformLocation(id), value.x, value.y, value.z);
+	}
+	void Shader::setUniform3f(uint32 id, float x, float y, float z) {
+		glUniform3f(getUniformLocation(id), x, y, z);
+	}
+	void Shader::setUniform4f(uint32 id, const glm::vec4& value) {
+		glUniform4f(getUniformLocation(id), value.x, value.y, value.z, value.w);
+	}
+	void Shader::setUniform4f(uint32 id, float x, float y, float z, float w) {
+		glUniform4f(getUniformLocation(id), x, y, z, w);
+	}
+	void Shader::setUniformMat4f(uint32 id, const glm::mat4& matrix) {
+		glUniformMatrix4fv(getUniformLocation(id), 1, GL_FALSE, glm::value_ptr(matrix));
+	}
+
+	int32 Shader::getUniformLocation(uint32 id) const
 	{
-		if (uniforms_cache.find(uniform_name) != uniforms_cache.end())
-			return uniforms_cache[uniform_name];
+		auto it = std::lower_bound(uniforms.begin(), uniforms.end(), id, [](const Uniform& uniform, uint32 id) { return uniform.id < id; });
 
-		int location = glGetUniformLocation(program, uniform_name.c_str());
+		return it != uniforms.end() && it->id == id ? it->location : -1;
+	}
 
-		if (location == -1)
-			Log::warn("Shader \"%s\" Uniform location not found: %s", name.c_str(), uniform_name.c_str());
+	int32 Shader::getUniformLocation(const std::string& uniform_name)
+	{
+		uint32 id = hashUniform(uniform_name.c_str());
+		int32 location = getUniformLocation(id);
 
-		uniforms_cache[uniform_name] = location;
+		if (location == -1 && std::find(missing_uniforms.begin(), missing_uniforms.end(), id) == missing_uniforms.end())
+		{
+			Log::warn("Shader \"%s\" Uniform location not found: %s", name.c_str(), uniform_name.c_str());
+			missing_uniforms.push_back(id);
+		}
 
 		return location;
 	}
 
-}
+}
\ No newline at end of file
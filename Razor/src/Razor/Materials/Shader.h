@@ -3,9 +3,25 @@
 #include "Razor/Core/Core.h"
 #include <glm/glm.hpp>
 
+// FNV-1a, uniform ids are the hash of their full GLSL name
+#define UNIFORM_HASH_SEED 2166136261u
+#define UNIFORM_HASH_PRIME 16777619u
+
+// Id of a uniform name literal, hashed at compile time
+#define RZ_UNIFORM(name) std::integral_constant<uint32, Razor::hashUniform(name)>::value
+
 namespace Razor 
 {
 
+	// A name can be hashed in pieces, each one continuing from the previous hash
+	constexpr uint32 hashUniform(const char* name, uint32 hash = UNIFORM_HASH_SEED)
+	{
+		return *name == '\0' ? hash : hashUniform(name + 1, (hash ^ (uint32)(uint8)*name) * UNIFORM_HASH_PRIME);
+	}
+
+	// Id of array[index].member, without building the name
+	uint32 hashUniformElement(const char* array, uint32 index, const char* member);
+
 	class Shader
 	{
 	public:
@@ -49,6 +65,15 @@ namespace Razor
 		typedef std::map<State, std::string> SourcesMap;
 		typedef std::map<std::pair<State, std::string>, int> ConstantsMap;
 
+		// Active uniform reflected at link time, array elements have their own entry
+		struct Uniform
+		{
+			uint32 id;
+			int32 location;
+			uint32 type;
+			int32 size;
+		};
+
 		bool load();
 		void defineConstant(State state, const std::string& name, int value);
 		void replaceConstants();
@@ -63,6 +88,7 @@ namespace Razor
 		inline int getProgram() { return program; }
 		inline bool isInternal() { return is_internal; }
 		inline bool isDirty() { return dirty; }
+		inline const std::vector<Uniform>& getUniforms() const { return uniforms; }
 
 		inline Status getStatus() 
 		{
@@ -94,8 +120,25 @@ namespace Razor
 		void setUniformMat4f(const std::string& name, const glm::mat4& matrix);
 		void setUniformMat4d(const std::string& name, const glm::dmat4& matrix);
 
+		void setUniform1i(uint32 id, int value);
+		void setUniform4i(uint32 id, const glm::ivec4& value);
+
+		void setUniform1f(uint32 id, float value);
+		void setUniform2f(uint32 id, float x, float y);
+		void setUniform2f(uint32 id, const glm::vec2& value);
+		void setUniform3f(uint32 id, const glm::vec3& value);
+		void setUniform3f(uint32 id, float x, float y, float z);
+		void setUniform4f(uint32 id, const glm::vec4& value);
+		void setUniform4f(uint32 id, float x, float y, float z, float w);
+
+		void setUniformMat4f(uint32 id, const glm::mat4& matrix);
+
+		// Location of a reflected uniform, -1 if the program doesn't use it
+		int32 getUniformLocation(uint32 id) const;
+
 	private:
-		unsigned int getUniformLocation(const std::string& name);
+		void reflect();
+		int32 getUniformLocation(const std::string& name);
 
 		int id;
 		int program;
@@ -108,8 +151,11 @@ namespace Razor
 		SourcesMap sources;
 		ShadersMap shaders;
 		ConstantsMap constants;
-	
-		std::unordered_map<std::string, int> uniforms_cache;
+
+		// Sorted by id, searched on every set
+		std::vector<Uniform> uniforms;
+		// Names looked up but missing, warned about once
+		std::vector<uint32> missing_uniforms;
 	};
 
 }
@@ -1,6 +1,9 @@
 #include "rzpch.h"
 #include "Texture.h"
 #include "Razor/Core/Utils.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Memory/MemoryTracker.h"
+#include "Razor/Rendering/RenderState.h"
 
 #include "glad/glad.h"
 
@@ -11,6 +14,9 @@
 namespace Razor
 {
 
+	// The flip flag of this stb_image copy is global, decodes from the streaming jobs share it
+	static std::mutex s_loaderMutex;
+
 	Texture::Texture(
 		const std::string& filename,
 		bool mipmaps,
@@ -36,18 +42,93 @@ namespace Razor
 		this->load();
 	}
 
-	Texture* Texture::Texture::load()
+	Texture::Texture() :
+		filename(""),
+		mipmaps(false),
+		lodBias(0.0f),
+		flipped(true),
+		id(NULL),
+		data(NULL),
+		components_count(0),
+		width(0),
+		height(0),
+		channel_type(ChannelType::RGB_ALPHA),
+		free_after_load(true),
+		min_filter(Filter::LINEAR),
+		mag_filter(Filter::LINEAR),
+		wrap_s(WrapType::REPEAT),
+		wrap_t(WrapType::REPEAT)
 	{
-		stbi_set_flip_vertically_on_load(flipped);
-		data = stbi_load(filename.c_str(), &width, &height, &components_count, 0);
+	}
+
+	Texture* Texture::decode(const std::string& filename, bool mipmaps, bool flipped)
+	{
+		Texture* texture = new Texture();
+		texture->setFilename(filename);
+		texture->setHavingMipmaps(mipmaps);
+		texture->setFlipped(flipped);
+
+		if (!texture->read())
+		{
+			delete texture;
+			return nullptr;
+		}
+
+		return texture;
+	}
+
+	bool Texture::read()
+	{
+		MemoryTagScope memory(MemoryTag::Assets);
+
+		static Counter& s_failed = Metrics::counter("assets.textures_failed", "Textures that could not be loaded");
+
+		{
+			std::lock_guard<std::mutex> lock(s_loaderMutex);
+
+			stbi_set_flip_vertically_on_load(flipped);
+			data = stbi_load(filename.c_str(), &width, &height, &components_count, 0);
+		}
 
 		if (data == NULL)
 		{
 			Log::error("Texture loading failed: %s", filename.c_str());
-			return nullptr;
+			s_failed.add();
+			return false;
 		}
 
-		glBindTexture(GL_TEXTURE_2D, id);
+		std::string size = std::string("(" + std::to_string(width) + "x" + std::to_string(height) + ")");
+		Log::info("Loaded texture: %s %s %s", filename.c_str(), size.c_str(), Utils::bytesToSize(Utils::getFileSize(filename)).c_str());
+
+		return true;
+	}
+
+	Texture* Texture::Texture::load()
+	{
+		static Histogram& s_loadTime = Metrics::histogram("assets.texture_load_time", "us", "Decode and upload time of a texture");
+		uint64 start = TraceProfiler::now();
+
+		if (!read() || upload() == nullptr)
+			return nullptr;
+
+		s_loadTime.record((TraceProfiler::now() - start) / 1000);
+
+		return this;
+	}
+
+	Texture* Texture::upload()
+	{
+		MemoryTagScope memory(MemoryTag::Assets);
+
+		static Counter& s_loaded = Metrics::counter("assets.textures_loaded", "Textures uploaded to the GPU");
+
+		if (data == NULL)
+			return nullptr;
+
+		if (id == 0)
+			glGenTextures(1, &id);
+
+		RenderState::editTexture(GL_TEXTURE_2D, id);
 
 		GLenum format;
 		if (components_count == 1)
@@ -65,11 +146,13 @@ namespace Razor
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		std::string size = std::string("(" + std::to_string(width) + "x" + std::to_string(height) + ")");
-		Log::info("Loaded texture: %s %s %s", filename.c_str(), size.c_str(), Utils::bytesToSize(Utils::getFileSize(filename)).c_str());
-	
-		if(free_after_load)
+		if (free_after_load)
+		{
 			stbi_image_free(data);
+			data = NULL;
+		}
+
+		s_loaded.add();
 
 		return this;
 	}
@@ -78,22 +161,26 @@ namespace Razor
 	{
 		assert(unit >= 0 && unit <= 31);
 
-		glActiveTexture(GL_TEXTURE0 + unit);
-		glBindTexture(GL_TEXTURE_2D, id);
+		RenderState::bindTexture(unit, GL_TEXTURE_2D, id);
 	}
 
 	void Texture::unbind()
 	{
-		glBindTexture(GL_TEXTURE_2D, 0);
-		glActiveTexture(GL_TEXTURE0);
+		RenderState::editTexture(GL_TEXTURE_2D, 0);
+		RenderState::setActiveTexture(0);
 	}
 
 	Texture::~Texture()
 	{
-		if(!free_after_load)
+		// Kept after the upload, or decoded and never uploaded
+		if (data != NULL)
 			stbi_image_free(data);
 
-		glDeleteTextures(1, &id);
+		if (id != 0)
+		{
+			glDeleteTextures(1, &id);
+			RenderState::releaseTexture(id);
+		}
 	}
 
 }
@@ -48,7 +48,11 @@ namespace Razor {
 		);
 		virtual ~Texture();
 
+		// Reads the pixels only, safe off the main thread, upload() sends them to GL later
+		static Texture* decode(const std::string& filename, bool mipmaps = false, bool flipped = true);
+
 		Texture* load();
+		Texture* upload();
 		void bind(unsigned int unit);
 		void unbind();
 
@@ -61,6 +65,7 @@ namespace Razor {
 		inline int getWidth() { return width; }
 		inline int getHeight() { return height; }
 		inline int getComponentsCount() { return components_count; }
+		inline size_t getDataSize() { return (size_t)width * height * components_count; }
 		inline ChannelType getChannelType() { return channel_type; }
 		inline Filter& getMinFilter() { return min_filter; }
 		inline Filter& getMaxFilter() { return mag_filter; }
@@ -83,6 +88,10 @@ namespace Razor {
 		inline void setWrapT(WrapType wrap) { wrap_t = wrap; }
 
 	private:
+		Texture();
+
+		bool read();
+
 		unsigned char* data;
 		unsigned int id;
 		std::string filename;
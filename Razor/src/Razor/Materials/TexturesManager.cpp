@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "TexturesManager.h"
+#include "Texture.h"
 
 namespace Razor
 {
@@ -11,6 +12,11 @@ namespace Razor
 
 	TexturesManager::~TexturesManager()
 	{
+		for (auto& texture : textures)
+			delete texture.second.texture;
+
+		for (auto texture : retired)
+			delete texture;
 	}
 
 	bool TexturesManager::hasTexture(const std::string & path)
@@ -20,20 +26,56 @@ namespace Razor
 
 	void TexturesManager::addTexture(const std::string& path, Texture* texture)
 	{
-		textures[path] = texture;
+		auto it = textures.find(path);
+
+		if (it == textures.end())
+		{
+			textures[path] = { texture, 1 };
+			return;
+		}
+
+		if (it->second.texture != texture)
+		{
+			retired.push_back(it->second.texture);
+			it->second.texture = texture;
+		}
+
+		it->second.references++;
+	}
+
+	Texture* TexturesManager::acquireTexture(const std::string& path)
+	{
+		auto it = textures.find(path);
+
+		if (it == textures.end())
+			return nullptr;
+
+		it->second.references++;
+
+		return it->second.texture;
 	}
 
 	bool TexturesManager::removeTexture(const std::string& path)
 	{
-		return false;
+		auto it = textures.find(path);
+
+		if (it == textures.end())
+			return false;
+
+		if (--it->second.references > 0)
+			return true;
+
+		delete it->second.texture;
+		textures.erase(it);
+
+		return true;
 	}
 
 	Texture* TexturesManager::getTexture(const std::string & path)
 	{
-		if (hasTexture(path))
-			return textures[path];
+		auto it = textures.find(path);
 
-		return nullptr;
+		return it != textures.end() ? it->second.texture : nullptr;
 	}
 
 }
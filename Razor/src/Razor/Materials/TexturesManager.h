@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Razor/Core/Core.h"
+
 namespace Razor
 {
 	class Texture;
@@ -11,12 +13,25 @@ namespace Razor
 		~TexturesManager();
 
 		bool hasTexture(const std::string& path);
+		// Materials share textures by path, each one using a texture holds a
+		// reference. Adding counts as the first one.
 		void addTexture(const std::string& path, Texture* texture);
+		Texture* acquireTexture(const std::string& path);
+		// Drops a reference, the texture is deleted with the last one
 		bool removeTexture(const std::string& path);
+		// Doesn't take a reference (previews)
 		Texture* getTexture(const std::string& path);
 
 	private:
-		std::unordered_map<std::string, Texture*> textures;
+		struct Entry
+		{
+			Texture* texture;
+			uint32 references;
+		};
+
+		std::unordered_map<std::string, Entry> textures;
+		// Replaced textures may still be bound by a material, freed with the manager
+		std::vector<Texture*> retired;
 	};
 
 }
@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "VideoTexture.h"
+#include "Razor/Rendering/RenderState.h"
 
 #include <glad/glad.h>
 #include <opencv2/core/core.hpp>
@@ -49,7 +50,7 @@ namespace Razor
 
 	void VideoTexture::bind()
 	{
-		glBindTexture(GL_TEXTURE_2D, id);
+		RenderState::editTexture(GL_TEXTURE_2D, id);
 	}
 
 	void VideoTexture::update()
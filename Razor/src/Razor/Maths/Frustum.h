@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Razor/Maths/Maths.h"
+
+namespace Razor
+{
+
+	// Planes of a view frustum, normals pointing inside. A point p is inside
+	// a plane when dot(plane.xyz, p) + plane.w >= 0.
+	struct Frustum
+	{
+		// Prefixed, NEAR and FAR are defined by the Windows headers
+		enum Plane
+		{
+			PLANE_LEFT = 0,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			PLANE_COUNT
+		};
+
+		std::array<glm::vec4, PLANE_COUNT> planes;
+
+		// Extracted from a projection * view matrix (Gribb & Hartmann)
+		static Frustum fromMatrix(const glm::mat4& matrix)
+		{
+			Frustum frustum;
+
+			for (int i = 0; i < 4; i++)
+			{
+				frustum.planes[PLANE_LEFT][i] = matrix[i][3] + matrix[i][0];
+				frustum.planes[PLANE_RIGHT][i] = matrix[i][3] - matrix[i][0];
+				frustum.planes[PLANE_BOTTOM][i] = matrix[i][3] + matrix[i][1];
+				frustum.planes[PLANE_TOP][i] = matrix[i][3] - matrix[i][1];
+				frustum.planes[PLANE_NEAR][i] = matrix[i][3] + matrix[i][2];
+				frustum.planes[PLANE_FAR][i] = matrix[i][3] - matrix[i][2];
+			}
+
+			for (auto& plane : frustum.planes)
+				plane = plane * (1.0f / glm::length(glm::vec3(plane.x, plane.y, plane.z)));
+
+			return frustum;
+		}
+
+		// Conservative, boxes crossing the corners outside may pass
+		bool intersects(const AABB& box) const
+		{
+			for (auto& plane : planes)
+			{
+				float x = plane.x >= 0.0f ? box.max_x : box.min_x;
+				float y = plane.y >= 0.0f ? box.max_y : box.min_y;
+				float z = plane.z >= 0.0f ? box.max_z : box.min_z;
+
+				if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+					return false;
+			}
+
+			return true;
+		}
+	};
+
+}
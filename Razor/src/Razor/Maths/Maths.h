@@ -20,6 +20,70 @@ namespace Razor
 			if (t.z < min_z) min_z = t.z;
 			if (t.z > max_z) max_z = t.z;
 		}
+
+		inline static AABB fromMinMax(const glm::vec3& min, const glm::vec3& max)
+		{
+			return { min.x, max.x, min.y, max.y, min.z, max.z };
+		}
+
+		inline glm::vec3 getMin() const { return glm::vec3(min_x, min_y, min_z); }
+		inline glm::vec3 getMax() const { return glm::vec3(max_x, max_y, max_z); }
+		inline glm::vec3 getCenter() const { return (getMin() + getMax()) * 0.5f; }
+		inline glm::vec3 getExtents() const { return (getMax() - getMin()) * 0.5f; }
+
+		void merge(const AABB& box)
+		{
+			min_x = std::min(min_x, box.min_x);
+			max_x = std::max(max_x, box.max_x);
+			min_y = std::min(min_y, box.min_y);
+			max_y = std::max(max_y, box.max_y);
+			min_z = std::min(min_z, box.min_z);
+			max_z = std::max(max_z, box.max_z);
+		}
+
+		inline bool contains(const AABB& box) const
+		{
+			return box.min_x >= min_x && box.max_x <= max_x
+				&& box.min_y >= min_y && box.max_y <= max_y
+				&& box.min_z >= min_z && box.max_z <= max_z;
+		}
+
+		inline bool contains(const glm::vec3& point) const
+		{
+			return point.x >= min_x && point.x <= max_x
+				&& point.y >= min_y && point.y <= max_y
+				&& point.z >= min_z && point.z <= max_z;
+		}
+
+		inline bool overlaps(const AABB& box) const
+		{
+			return box.min_x <= max_x && box.max_x >= min_x
+				&& box.min_y <= max_y && box.max_y >= min_y
+				&& box.min_z <= max_z && box.max_z >= min_z;
+		}
+
+		// Surface area, the cost metric of the BVH
+		inline float area() const
+		{
+			float x = max_x - min_x;
+			float y = max_y - min_y;
+			float z = max_z - min_z;
+
+			return 2.0f * (x * y + y * z + z * x);
+		}
+
+		// Box enclosing this one once transformed
+		AABB transform(const glm::mat4& matrix) const
+		{
+			glm::vec3 center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+			glm::vec3 extents = getExtents();
+			glm::vec3 world_extents = glm::vec3(0.0f);
+
+			for (int i = 0; i < 3; i++)
+				world_extents[i] = std::abs(matrix[0][i]) * extents.x + std::abs(matrix[1][i]) * extents.y + std::abs(matrix[2][i]) * extents.z;
+
+			return fromMinMax(center - world_extents, center + world_extents);
+		}
 	};
 
 	class Maths
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "LinearArena.h"
+#include "PoolAllocator.h"
+
+namespace Razor
+{
+
+	// STL adapter over a LinearArena, deallocation is a no-op. Default
+	// constructed allocators use the frame arena of the calling thread and
+	// fall back to the heap when there is none.
+	template<typename T>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+
+		ArenaAllocator() : arena(LinearArena::getFrameArena()), tag(nullptr) {}
+		ArenaAllocator(LinearArena* arena, const char* tag = nullptr) : arena(arena), tag(tag) {}
+
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena), tag(other.tag) {}
+
+		T* allocate(size_t count)
+		{
+			if (arena == nullptr)
+				return (T*)::operator new(count * sizeof(T));
+
+			return (T*)arena->allocate(count * sizeof(T), std::max(alignof(T), (size_t)ARENA_ALIGNMENT), tag);
+		}
+
+		void deallocate(T* pointer, size_t count)
+		{
+			if (arena == nullptr)
+				::operator delete(pointer);
+		}
+
+		template<typename U>
+		bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+		template<typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+		LinearArena* arena;
+		const char* tag;
+	};
+
+	// STL adapter over the shared size class pools, meant for node based
+	// containers and allocate_shared, larger requests go to the heap
+	template<typename T>
+	class PoolStlAllocator
+	{
+	public:
+		typedef T value_type;
+
+		PoolStlAllocator() {}
+
+		template<typename U>
+		PoolStlAllocator(const PoolStlAllocator<U>&) {}
+
+		T* allocate(size_t count)
+		{
+			PoolAllocator* pool = count == 1 ? PoolAllocator::get(sizeof(T)) : nullptr;
+
+			return (T*)(pool != nullptr ? pool->allocate() : ::operator new(count * sizeof(T)));
+		}
+
+		void deallocate(T* pointer, size_t count)
+		{
+			PoolAllocator* pool = count == 1 ? PoolAllocator::get(sizeof(T)) : nullptr;
+
+			if (pool != nullptr)
+				pool->deallocate(pointer);
+			else
+				::operator delete(pointer);
+		}
+
+		template<typename U>
+		bool operator==(const PoolStlAllocator<U>&) const { return true; }
+		template<typename U>
+		bool operator!=(const PoolStlAllocator<U>&) const { return false; }
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+	template<typename K, typename V>
+	using FrameUnorderedMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, ArenaAllocator<std::pair<const K, V>>>;
+
+}
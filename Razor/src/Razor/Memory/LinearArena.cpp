@@ -0,0 +1,96 @@
+#include "rzpch.h"
+#include "LinearArena.h"
+#include "MemoryStats.h"
+
+namespace Razor
+{
+
+	thread_local LinearArena* LinearArena::t_frameArena = nullptr;
+
+	LinearArena::LinearArena(const char* name, size_t capacity) :
+		name(name),
+		data((char*)::operator new(capacity)),
+		capacity(capacity),
+		peak(0),
+		overflows(0),
+		offset(0),
+		overflow_mutex(),
+		overflow_blocks({})
+	{
+	}
+
+	LinearArena::~LinearArena()
+	{
+		for (void* block : overflow_blocks)
+			::operator delete(block);
+
+		::operator delete(data);
+	}
+
+	void* LinearArena::allocate(size_t size, size_t alignment, const char* tag)
+	{
+		MemoryStats::add(tag != nullptr ? tag : name, size);
+
+		// Over-allocate by the alignment so the bump stays a single atomic add
+		size_t padded = size + alignment - 1;
+		size_t start = offset.fetch_add(padded, std::memory_order_relaxed);
+
+		if (start + padded <= capacity)
+		{
+			uintptr_t address = (uintptr_t)(data + start);
+			address = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+			return (void*)address;
+		}
+
+		std::unique_lock<std::mutex> lock(overflow_mutex);
+
+		void* block = ::operator new(padded);
+		overflow_blocks.push_back(block);
+		overflows++;
+
+		uintptr_t address = ((uintptr_t)block + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+		return (void*)address;
+	}
+
+	void LinearArena::rewind(size_t marker)
+	{
+		// Overflow blocks can only go away once the outermost scope ends
+		if (marker == 0 && !overflow_blocks.empty())
+			reset();
+		else
+			peak = std::max(peak, offset.exchange(marker, std::memory_order_relaxed));
+	}
+
+	void LinearArena::reset()
+	{
+		size_t used = offset.exchange(0, std::memory_order_relaxed);
+		peak = std::max(peak, used);
+
+		for (void* block : overflow_blocks)
+			::operator delete(block);
+
+		overflow_blocks.clear();
+
+		if (overflows > 0)
+		{
+			size_t grown = std::max(capacity * 2, peak);
+
+			Log::warn("Arena \"%s\" overflowed %d times, growing to %s", name, (int)overflows, Utils::bytesToSize(grown).c_str());
+
+			::operator delete(data);
+			data = (char*)::operator new(grown);
+			capacity = grown;
+			overflows = 0;
+		}
+	}
+
+	LinearArena& LinearArena::getScratch()
+	{
+		static thread_local LinearArena scratch("Scratch", SCRATCH_ARENA_SIZE);
+
+		return scratch;
+	}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+
+#define FRAME_ARENA_SIZE (4 * 1024 * 1024)
+#define SCRATCH_ARENA_SIZE (1024 * 1024)
+#define ARENA_ALIGNMENT 16
+
+namespace Razor
+{
+
+	// Bump allocator, allocations are released all at once by reset().
+	// allocate() may be called from several threads, reset() may not.
+	// Running out of space falls back to the heap for the rest of the frame
+	// and the next reset() grows the block to the peak usage, so steady
+	// frames end up without heap allocations.
+	class LinearArena
+	{
+	public:
+		LinearArena(const char* name = "Arena", size_t capacity = FRAME_ARENA_SIZE);
+		~LinearArena();
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		void* allocate(size_t size, size_t alignment = ARENA_ALIGNMENT, const char* tag = nullptr);
+		void reset();
+
+		template<typename T, typename... Args>
+		T* create(Args&&... args)
+		{
+			return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		// Only for arenas owned by a single thread (scratch arenas)
+		inline size_t getMarker() const { return offset.load(std::memory_order_relaxed); }
+		void rewind(size_t marker);
+
+		inline const char* getName() const { return name; }
+		inline size_t getCapacity() const { return capacity; }
+		inline size_t getUsed() const { return std::min(offset.load(std::memory_order_relaxed), capacity); }
+		inline size_t getPeak() const { return peak; }
+		inline uint32 getOverflows() const { return overflows; }
+
+		// Arena used for transient data on the calling thread, the game loop
+		// switches it for every frame. nullptr outside of the loop.
+		inline static LinearArena* getFrameArena() { return t_frameArena; }
+		inline static void setFrameArena(LinearArena* arena) { t_frameArena = arena; }
+
+		static LinearArena& getScratch();
+
+	private:
+		const char* name;
+		char* data;
+		size_t capacity;
+		size_t peak;
+		uint32 overflows;
+		std::atomic<size_t> offset;
+		std::mutex overflow_mutex;
+		std::vector<void*> overflow_blocks;
+
+		static thread_local LinearArena* t_frameArena;
+	};
+
+	class FrameArenaScope
+	{
+	public:
+		FrameArenaScope(LinearArena* arena) : previous(LinearArena::getFrameArena()) { LinearArena::setFrameArena(arena); }
+		~FrameArenaScope() { LinearArena::setFrameArena(previous); }
+
+	private:
+		LinearArena* previous;
+	};
+
+	// Everything allocated from the thread scratch arena inside the scope is released at its end
+	class ScratchScope
+	{
+	public:
+		ScratchScope() : arena(LinearArena::getScratch()), marker(arena.getMarker()) {}
+		~ScratchScope() { arena.rewind(marker); }
+
+		inline LinearArena& getArena() { return arena; }
+
+	private:
+		LinearArena& arena;
+		size_t marker;
+	};
+
+}
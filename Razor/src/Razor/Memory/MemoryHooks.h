@@ -0,0 +1,62 @@
+#pragma once
+
+#include "MemoryTracker.h"
+
+// Global operator new / delete routing every heap allocation of the program
+// through the MemoryTracker. Defines symbols: include it in exactly one
+// translation unit of the executable (Entrypoint.h does).
+#ifdef RZ_MEMORY_TRACKING
+
+void* operator new(size_t size)
+{
+	return Razor::MemoryTracker::allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+	return Razor::MemoryTracker::allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	try { return Razor::MemoryTracker::allocate(size); }
+	catch (...) { return nullptr; }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	try { return Razor::MemoryTracker::allocate(size); }
+	catch (...) { return nullptr; }
+}
+
+void operator delete(void* pointer) noexcept
+{
+	Razor::MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	Razor::MemoryTracker::deallocate(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	Razor::MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	Razor::MemoryTracker::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	Razor::MemoryTracker::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	Razor::MemoryTracker::deallocate(pointer);
+}
+
+#endif
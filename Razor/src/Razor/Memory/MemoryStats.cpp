@@ -0,0 +1,54 @@
+#include "rzpch.h"
+#include "MemoryStats.h"
+
+namespace Razor
+{
+
+	std::array<MemoryStats::Slot, MAX_MEMORY_SUBSYSTEMS> MemoryStats::s_slots;
+	std::array<MemoryStats::Entry, MAX_MEMORY_SUBSYSTEMS> MemoryStats::s_report;
+	uint32 MemoryStats::s_reportSize = 0;
+
+#ifdef RZ_MEMORY_DEBUG
+	void MemoryStats::add(const char* subsystem, size_t bytes)
+	{
+		for (auto& slot : s_slots)
+		{
+			const char* current = slot.subsystem.load(std::memory_order_acquire);
+
+			// Claim a free slot, someone else may have claimed it for the same subsystem meanwhile
+			if (current == nullptr && !slot.subsystem.compare_exchange_strong(current, subsystem, std::memory_order_acq_rel))
+			{
+				if (current != subsystem)
+					continue;
+			}
+			else if (current != nullptr && current != subsystem)
+			{
+				continue;
+			}
+
+			slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+			slot.allocations.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+#endif
+
+	void MemoryStats::endFrame()
+	{
+		s_reportSize = 0;
+
+		for (auto& slot : s_slots)
+		{
+			const char* subsystem = slot.subsystem.load(std::memory_order_acquire);
+
+			if (subsystem == nullptr)
+				break;
+
+			Entry& entry = s_report[s_reportSize++];
+			entry.subsystem = subsystem;
+			entry.bytes = slot.bytes.exchange(0, std::memory_order_relaxed);
+			entry.allocations = slot.allocations.exchange(0, std::memory_order_relaxed);
+		}
+	}
+
+}
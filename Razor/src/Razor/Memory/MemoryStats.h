@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+
+#define MAX_MEMORY_SUBSYSTEMS 64
+
+#if defined(RZ_DEBUG) && !defined(RZ_MEMORY_DEBUG)
+	#define RZ_MEMORY_DEBUG
+#endif
+
+namespace Razor
+{
+
+	// Bytes handed out by the arenas and pools per subsystem during the last
+	// frame. Subsystems are identified by their name pointer, use literals.
+	class MemoryStats
+	{
+	public:
+		struct Entry
+		{
+			const char* subsystem;
+			uint64 bytes;
+			uint32 allocations;
+		};
+
+#ifdef RZ_MEMORY_DEBUG
+		static void add(const char* subsystem, size_t bytes);
+#else
+		inline static void add(const char* subsystem, size_t bytes) {}
+#endif
+
+		static void endFrame();
+
+		inline static const Entry* getReport() { return s_report.data(); }
+		inline static uint32 getReportSize() { return s_reportSize; }
+
+	private:
+		struct Slot
+		{
+			std::atomic<const char*> subsystem;
+			std::atomic<uint64> bytes;
+			std::atomic<uint32> allocations;
+		};
+
+		static std::array<Slot, MAX_MEMORY_SUBSYSTEMS> s_slots;
+		static std::array<Entry, MAX_MEMORY_SUBSYSTEMS> s_report;
+		static uint32 s_reportSize;
+	};
+
+}
@@ -0,0 +1,405 @@
+#include "rzpch.h"
+#include "MemoryTracker.h"
+#include "Razor/Core/Metrics.h"
+
+#ifdef RZ_PLATFORM_WINDOWS
+	#include <DbgHelp.h>
+	#pragma comment (lib, "Dbghelp.lib")
+#endif
+
+#define MEMORY_HEADER_MAGIC 0x525a4d45
+
+namespace Razor
+{
+
+	// Prepended to every tracked block, keeps the 16 bytes alignment of malloc
+	struct alignas(16) MemoryHeader
+	{
+		uint64 size;
+		uint32 magic;
+		MemoryTag tag;
+		bool sampled;
+		// Shard of the allocating thread, the free is counted there too
+		uint8 shard;
+	};
+
+	// Counters written by allocations. Frees go to the shard of the
+	// allocation, so a shard's live bytes never drift and its peak holds.
+	struct TagCounters
+	{
+		std::atomic<int64> live_bytes;
+		std::atomic<int64> live_allocations;
+		std::atomic<uint64> total_allocations;
+		std::atomic<int64> peak_bytes;
+	};
+
+	// Each shard on its own cache lines, threads rarely share one
+	struct alignas(64) TagShard
+	{
+		std::array<TagCounters, (size_t)MemoryTag::Count> tags;
+	};
+
+	// Only touched when the stats are read or configured
+	struct TagSlot
+	{
+		std::atomic<uint64> budget;
+		std::atomic<bool> over_budget;
+	};
+
+	struct MemorySample
+	{
+		void* pointer;
+		uint64 size;
+		MemoryTag tag;
+		uint32 frame_count;
+		void* frames[MAX_MEMORY_SAMPLE_FRAMES];
+	};
+
+	// Everything here is constant initialized, allocations can happen
+	// before any constructor of the program has run
+	static_assert(MEMORY_TRACKER_SHARDS <= 256, "The shard index is stored in a byte of the header");
+	static std::array<TagShard, MEMORY_TRACKER_SHARDS> s_shards;
+	static std::array<TagSlot, (size_t)MemoryTag::Count> s_tags;
+	static std::atomic<uint32> s_nextShard(0);
+	static std::atomic<uint64> s_sampleRate(MEMORY_SAMPLE_RATE);
+	static MemorySample s_samples[MAX_MEMORY_SAMPLES];
+	static uint32 s_sampleCount = 0;
+	static std::atomic_flag s_samplesLock = ATOMIC_FLAG_INIT;
+
+	static thread_local MemoryTag t_tag = MemoryTag::General;
+	static thread_local uint64 t_sampleBytes = 0;
+	static thread_local uint32 t_shard = MEMORY_TRACKER_SHARDS;
+
+	static uint32 getShard()
+	{
+		if (t_shard == MEMORY_TRACKER_SHARDS)
+			t_shard = s_nextShard.fetch_add(1, std::memory_order_relaxed) % MEMORY_TRACKER_SHARDS;
+
+		return t_shard;
+	}
+
+	static const char* s_tagNames[] = { "General", "Render", "Physics", "Net", "Assets", "Audio", "Editor" };
+
+	static void addSample(void* pointer, uint64 size, MemoryTag tag)
+	{
+		MemorySample sample;
+		sample.pointer = pointer;
+		sample.size = size;
+		sample.tag = tag;
+#ifdef RZ_PLATFORM_WINDOWS
+		// Skips addSample, allocate and operator new
+		sample.frame_count = CaptureStackBackTrace(3, MAX_MEMORY_SAMPLE_FRAMES, sample.frames, nullptr);
+#else
+		sample.frame_count = 0;
+#endif
+
+		while (s_samplesLock.test_and_set(std::memory_order_acquire));
+
+		// Full table, the allocation still counts but won't be listed
+		if (s_sampleCount < MAX_MEMORY_SAMPLES)
+			s_samples[s_sampleCount++] = sample;
+
+		s_samplesLock.clear(std::memory_order_release);
+	}
+
+	static void removeSample(void* pointer)
+	{
+		while (s_samplesLock.test_and_set(std::memory_order_acquire));
+
+		for (uint32 i = 0; i < s_sampleCount; i++)
+		{
+			if (s_samples[i].pointer == pointer)
+			{
+				s_samples[i] = s_samples[--s_sampleCount];
+				break;
+			}
+		}
+
+		s_samplesLock.clear(std::memory_order_release);
+	}
+
+	void* MemoryTracker::allocate(size_t size)
+	{
+		MemoryHeader* header = (MemoryHeader*)std::malloc(sizeof(MemoryHeader) + size);
+
+		if (header == nullptr)
+			throw std::bad_alloc();
+
+		MemoryTag tag = t_tag;
+		uint32 shard = getShard();
+		TagCounters& counters = s_shards[shard].tags[(size_t)tag];
+
+		header->size = size;
+		header->magic = MEMORY_HEADER_MAGIC;
+		header->tag = tag;
+		header->sampled = false;
+		header->shard = (uint8)shard;
+
+		int64 live = counters.live_bytes.fetch_add((int64)size, std::memory_order_relaxed) + (int64)size;
+		int64 peak = counters.peak_bytes.load(std::memory_order_relaxed);
+
+		while (live > peak && !counters.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+
+		counters.live_allocations.fetch_add(1, std::memory_order_relaxed);
+		counters.total_allocations.fetch_add(1, std::memory_order_relaxed);
+
+		uint64 rate = s_sampleRate.load(std::memory_order_relaxed);
+
+		if (rate > 0)
+		{
+			t_sampleBytes += size;
+
+			if (t_sampleBytes >= rate)
+			{
+				t_sampleBytes = 0;
+				header->sampled = true;
+				addSample(header + 1, size, tag);
+			}
+		}
+
+		return header + 1;
+	}
+
+	void MemoryTracker::deallocate(void* pointer)
+	{
+		if (pointer == nullptr)
+			return;
+
+		MemoryHeader* header = (MemoryHeader*)pointer - 1;
+
+		RZ_ASSERT(header->magic == MEMORY_HEADER_MAGIC, "Freeing memory that wasn't allocated by the tracker");
+
+		TagCounters& counters = s_shards[header->shard].tags[(size_t)header->tag];
+		counters.live_bytes.fetch_sub((int64)header->size, std::memory_order_relaxed);
+		counters.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+
+		if (header->sampled)
+			removeSample(pointer);
+
+		// Catches double frees
+		header->magic = 0;
+		std::free(header);
+	}
+
+	MemoryTag MemoryTracker::getTag()
+	{
+		return t_tag;
+	}
+
+	void MemoryTracker::setTag(MemoryTag tag)
+	{
+		t_tag = tag;
+	}
+
+	const char* MemoryTracker::getTagName(MemoryTag tag)
+	{
+		return tag < MemoryTag::Count ? s_tagNames[(size_t)tag] : "Unknown";
+	}
+
+	void MemoryTracker::setBudget(MemoryTag tag, uint64 bytes)
+	{
+		s_tags[(size_t)tag].budget.store(bytes, std::memory_order_relaxed);
+		s_tags[(size_t)tag].over_budget.store(false, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::setSampleRate(uint64 bytes)
+	{
+		s_sampleRate.store(bytes, std::memory_order_relaxed);
+	}
+
+	MemoryTracker::TagStats MemoryTracker::getStats(MemoryTag tag)
+	{
+		TagSlot& slot = s_tags[(size_t)tag];
+
+		int64 live_bytes = 0;
+		int64 live_allocations = 0;
+		uint64 total_allocations = 0;
+		uint64 peak_bytes = 0;
+
+		for (TagShard& shard : s_shards)
+		{
+			TagCounters& counters = shard.tags[(size_t)tag];
+			live_bytes += counters.live_bytes.load(std::memory_order_relaxed);
+			live_allocations += counters.live_allocations.load(std::memory_order_relaxed);
+			total_allocations += counters.total_allocations.load(std::memory_order_relaxed);
+			peak_bytes += (uint64)counters.peak_bytes.load(std::memory_order_relaxed);
+		}
+
+		TagStats stats;
+		// Shards are read one after the other, a sum can briefly dip below zero
+		stats.live_bytes = (uint64)std::max<int64>(live_bytes, 0);
+		stats.live_allocations = (uint64)std::max<int64>(live_allocations, 0);
+		stats.total_allocations = total_allocations;
+		stats.budget = slot.budget.load(std::memory_order_relaxed);
+		stats.peak_bytes = std::max(peak_bytes, stats.live_bytes);
+
+		return stats;
+	}
+
+	void MemoryTracker::update()
+	{
+#ifdef RZ_MEMORY_TRACKING
+		static const char* live_names[] = {
+			"memory.general.live_bytes", "memory.render.live_bytes", "memory.physics.live_bytes", "memory.net.live_bytes",
+			"memory.assets.live_bytes", "memory.audio.live_bytes", "memory.editor.live_bytes"
+		};
+
+		static const char* peak_names[] = {
+			"memory.general.peak_bytes", "memory.render.peak_bytes", "memory.physics.peak_bytes", "memory.net.peak_bytes",
+			"memory.assets.peak_bytes", "memory.audio.peak_bytes", "memory.editor.peak_bytes"
+		};
+
+		static Gauge* live_gauges[(size_t)MemoryTag::Count] = {};
+		static Gauge* peak_gauges[(size_t)MemoryTag::Count] = {};
+
+		for (size_t i = 0; i < (size_t)MemoryTag::Count; i++)
+		{
+			TagSlot& slot = s_tags[i];
+			TagStats stats = getStats((MemoryTag)i);
+			uint64 live = stats.live_bytes;
+			uint64 budget = stats.budget;
+
+			if (live_gauges[i] == nullptr)
+			{
+				live_gauges[i] = &Metrics::gauge(live_names[i], "Heap bytes allocated by the subsystem");
+				peak_gauges[i] = &Metrics::gauge(peak_names[i], "High-water mark of the subsystem heap usage");
+			}
+
+			live_gauges[i]->set((double)live);
+			peak_gauges[i]->set((double)stats.peak_bytes);
+
+			if (budget == 0)
+				continue;
+
+			bool over = live > budget;
+
+			if (over && !slot.over_budget.exchange(true, std::memory_order_relaxed))
+			{
+				Log::warn(
+					"Memory budget exceeded for %s: %s / %s",
+					s_tagNames[i],
+					Utils::bytesToSize(live).c_str(),
+					Utils::bytesToSize(budget).c_str()
+				);
+			}
+			else if (!over)
+			{
+				slot.over_budget.store(false, std::memory_order_relaxed);
+			}
+		}
+#endif
+	}
+
+	void MemoryTracker::report()
+	{
+		if (!isEnabled())
+		{
+			Log::info("Memory tracking is disabled in this build");
+			return;
+		}
+
+		Log::info("%-10s %12s %12s %12s %14s %12s", "Tag", "Live", "Peak", "Budget", "Allocations", "Total");
+
+		for (size_t i = 0; i < (size_t)MemoryTag::Count; i++)
+		{
+			TagStats stats = getStats((MemoryTag)i);
+
+			Log::info(
+				"%-10s %12s %12s %12s %14llu %12llu",
+				s_tagNames[i],
+				Utils::bytesToSize(stats.live_bytes).c_str(),
+				Utils::bytesToSize(stats.peak_bytes).c_str(),
+				stats.budget > 0 ? Utils::bytesToSize(stats.budget).c_str() : "-",
+				(unsigned long long)stats.live_allocations,
+				(unsigned long long)stats.total_allocations
+			);
+		}
+	}
+
+	void MemoryTracker::reportLeaks()
+	{
+		if (!isEnabled())
+			return;
+
+		uint64 total = 0;
+
+		for (size_t i = 0; i < (size_t)MemoryTag::Count; i++)
+		{
+			TagStats stats = getStats((MemoryTag)i);
+
+			if (stats.live_allocations == 0)
+				continue;
+
+			total += stats.live_bytes;
+			Log::warn(
+				"Leak report: %s still holds %s in %llu allocations",
+				s_tagNames[i],
+				Utils::bytesToSize(stats.live_bytes).c_str(),
+				(unsigned long long)stats.live_allocations
+			);
+		}
+
+		if (total == 0)
+		{
+			Log::info("Leak report: no live allocations");
+			return;
+		}
+
+		Log::warn("Leak report: %s still allocated, static storage included", Utils::bytesToSize(total).c_str());
+
+		// Copied first, logging allocates and frees samples itself
+		std::vector<MemorySample> samples;
+		samples.reserve(MAX_MEMORY_SAMPLES);
+
+		while (s_samplesLock.test_and_set(std::memory_order_acquire));
+
+		// The copy itself may have been sampled
+		for (uint32 i = 0; i < s_sampleCount; i++)
+			if (s_samples[i].pointer != samples.data())
+				samples.push_back(s_samples[i]);
+
+		s_samplesLock.clear(std::memory_order_release);
+
+#ifdef RZ_PLATFORM_WINDOWS
+		HANDLE process = GetCurrentProcess();
+		bool symbols = SymInitialize(process, nullptr, TRUE) == TRUE;
+		char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+		SYMBOL_INFO* symbol = (SYMBOL_INFO*)buffer;
+#endif
+
+		for (auto& sample : samples)
+		{
+			Log::warn("Sampled leak: %s from %s", Utils::bytesToSize(sample.size).c_str(), s_tagNames[(size_t)sample.tag]);
+
+			for (uint32 i = 0; i < sample.frame_count; i++)
+			{
+#ifdef RZ_PLATFORM_WINDOWS
+				DWORD64 address = (DWORD64)sample.frames[i];
+				symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+				symbol->MaxNameLen = MAX_SYM_NAME;
+
+				IMAGEHLP_LINE64 line;
+				line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+				DWORD displacement = 0;
+
+				if (symbols && SymFromAddr(process, address, nullptr, symbol))
+				{
+					if (SymGetLineFromAddr64(process, address, &displacement, &line))
+						Log::warn("    %s (%s:%d)", symbol->Name, line.FileName, (int)line.LineNumber);
+					else
+						Log::warn("    %s", symbol->Name);
+
+					continue;
+				}
+#endif
+				Log::warn("    0x%p", sample.frames[i]);
+			}
+		}
+
+#ifdef RZ_PLATFORM_WINDOWS
+		if (symbols)
+			SymCleanup(process);
+#endif
+	}
+
+}
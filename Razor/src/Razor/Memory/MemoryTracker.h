@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+
+#define MEMORY_SAMPLE_RATE (512 * 1024)
+#define MAX_MEMORY_SAMPLES 4096
+#define MAX_MEMORY_SAMPLE_FRAMES 16
+// Copies of the tag counters, threads are spread over them and reads add them up
+#define MEMORY_TRACKER_SHARDS 16
+
+// On everywhere but Dist, cheap enough for staging builds
+#if !defined(RZ_DIST) && !defined(RZ_NO_MEMORY_TRACKING) && !defined(RZ_MEMORY_TRACKING)
+	#define RZ_MEMORY_TRACKING
+#endif
+
+namespace Razor
+{
+
+	enum class MemoryTag : uint8
+	{
+		General,
+		Render,
+		Physics,
+		Net,
+		Assets,
+		Audio,
+		Editor,
+		Count
+	};
+
+	// Heap accounting per subsystem, fed by the global operator new / delete
+	// of MemoryHooks.h. Every allocation carries the tag of the scope it was
+	// made in, jobs inherit the tag of the thread that created them.
+	// Roughly one allocation per MEMORY_SAMPLE_RATE bytes also records its
+	// call stack, the ones still alive at shutdown are listed by reportLeaks().
+	// Peaks are kept per shard on the allocation path, their sum is reported
+	// so a spike freed within the frame still shows, possibly overestimated
+	// when threads peak at different times.
+	class MemoryTracker
+	{
+	public:
+		struct TagStats
+		{
+			uint64 live_bytes;
+			uint64 live_allocations;
+			uint64 peak_bytes;
+			uint64 total_allocations;
+			uint64 budget;
+		};
+
+		static void* allocate(size_t size);
+		static void deallocate(void* pointer);
+
+		static MemoryTag getTag();
+		static void setTag(MemoryTag tag);
+		static const char* getTagName(MemoryTag tag);
+
+		// 0 removes the budget, exceeding it warns once until usage drops back
+		static void setBudget(MemoryTag tag, uint64 bytes);
+		// 0 disables call stack sampling
+		static void setSampleRate(uint64 bytes);
+
+		static TagStats getStats(MemoryTag tag);
+
+		// Budget warnings and metrics, once per frame
+		static void update();
+		static void report();
+		// Everything still allocated, call it last thing before exiting
+		static void reportLeaks();
+
+		inline static bool isEnabled()
+		{
+#ifdef RZ_MEMORY_TRACKING
+			return true;
+#else
+			return false;
+#endif
+		}
+	};
+
+	class MemoryTagScope
+	{
+	public:
+		MemoryTagScope(MemoryTag tag) : previous(MemoryTracker::getTag()) { MemoryTracker::setTag(tag); }
+		~MemoryTagScope() { MemoryTracker::setTag(previous); }
+
+		MemoryTagScope(const MemoryTagScope&) = delete;
+		MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+	private:
+		MemoryTag previous;
+	};
+
+}
@@ -0,0 +1,87 @@
+#include "rzpch.h"
+#include "PoolAllocator.h"
+#include "MemoryStats.h"
+
+namespace Razor
+{
+
+	PoolAllocator::PoolAllocator(size_t block_size, const char* name, size_t blocks_per_chunk) :
+		name(name),
+		block_size((std::max(block_size, sizeof(Block)) + POOL_ALIGNMENT - 1) & ~(POOL_ALIGNMENT - 1)),
+		blocks_per_chunk(blocks_per_chunk),
+		allocated(0),
+		free_list(nullptr),
+		chunks({}),
+		mutex()
+	{
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		for (char* chunk : chunks)
+			::operator delete(chunk);
+	}
+
+	void* PoolAllocator::allocate()
+	{
+		MemoryStats::add(name, block_size);
+
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if (free_list == nullptr)
+			grow();
+
+		Block* block = free_list;
+		free_list = block->next;
+		allocated++;
+
+		return block;
+	}
+
+	void PoolAllocator::deallocate(void* block)
+	{
+		if (block == nullptr)
+			return;
+
+		std::unique_lock<std::mutex> lock(mutex);
+
+		Block* head = (Block*)block;
+		head->next = free_list;
+		free_list = head;
+		allocated--;
+	}
+
+	void PoolAllocator::grow()
+	{
+		char* chunk = (char*)::operator new(block_size * blocks_per_chunk);
+		chunks.push_back(chunk);
+
+		for (size_t i = blocks_per_chunk; i > 0; i--)
+		{
+			Block* block = (Block*)(chunk + (i - 1) * block_size);
+			block->next = free_list;
+			free_list = block;
+		}
+	}
+
+	PoolAllocator* PoolAllocator::get(size_t size)
+	{
+		// Never destroyed, objects in static storage may give blocks back after
+		// function statics are gone
+		static PoolAllocator* pools[MAX_POOL_BLOCK_SIZE / POOL_SIZE_CLASS];
+		static std::once_flag flags[MAX_POOL_BLOCK_SIZE / POOL_SIZE_CLASS];
+
+		if (size == 0 || size > MAX_POOL_BLOCK_SIZE)
+			return nullptr;
+
+		size_t index = (size - 1) / POOL_SIZE_CLASS;
+
+		std::call_once(flags[index], [index]
+		{
+			pools[index] = new PoolAllocator((index + 1) * POOL_SIZE_CLASS, "Pools");
+		});
+
+		return pools[index];
+	}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+
+#define POOL_BLOCKS_PER_CHUNK 256
+#define POOL_SIZE_CLASS 16
+#define MAX_POOL_BLOCK_SIZE 512
+#define POOL_ALIGNMENT 16
+
+namespace Razor
+{
+
+	// Fixed size blocks threaded on a free list, grows by chunks and never
+	// gives memory back before destruction. Thread safe.
+	class PoolAllocator
+	{
+	public:
+		PoolAllocator(size_t block_size, const char* name = "Pool", size_t blocks_per_chunk = POOL_BLOCKS_PER_CHUNK);
+		~PoolAllocator();
+
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+		void* allocate();
+		void deallocate(void* block);
+
+		inline size_t getBlockSize() const { return block_size; }
+		inline size_t getCapacity() const { return chunks.size() * blocks_per_chunk; }
+		inline size_t getAllocated() const { return allocated; }
+
+		// Shared pools for every size class up to MAX_POOL_BLOCK_SIZE, nullptr above.
+		// They live until the process exits.
+		static PoolAllocator* get(size_t size);
+
+	private:
+		struct Block
+		{
+			Block* next;
+		};
+
+		void grow();
+
+		const char* name;
+		size_t block_size;
+		size_t blocks_per_chunk;
+		size_t allocated;
+		Block* free_list;
+		std::vector<char*> chunks;
+		std::mutex mutex;
+	};
+
+	template<typename T>
+	class ObjectPool
+	{
+	public:
+		ObjectPool(const char* name = "ObjectPool", size_t blocks_per_chunk = POOL_BLOCKS_PER_CHUNK) :
+			pool(std::max(sizeof(T), sizeof(void*)), name, blocks_per_chunk)
+		{}
+
+		template<typename... Args>
+		T* create(Args&&... args)
+		{
+			return new (pool.allocate()) T(std::forward<Args>(args)...);
+		}
+
+		void destroy(T* object)
+		{
+			if (object == nullptr)
+				return;
+
+			object->~T();
+			pool.deallocate(object);
+		}
+
+		inline size_t getAllocated() const { return pool.getAllocated(); }
+
+	private:
+		PoolAllocator pool;
+	};
+
+}
@@ -0,0 +1,164 @@
+#include "rzpch.h"
+#include "MetricsServer.h"
+#include "Razor/Core/Metrics.h"
+
+namespace Razor
+{
+
+	MetricsServer::MetricsServer() :
+		running(false),
+		listening(INVALID_SOCKET),
+		port(0)
+	{
+	}
+
+	MetricsServer::~MetricsServer()
+	{
+		stop();
+	}
+
+	bool MetricsServer::start(unsigned short port)
+	{
+		if (running)
+			return true;
+
+		WSADATA data;
+
+		if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+		{
+			Log::error("Metrics server: wsa startup failed");
+			return false;
+		}
+
+		listening = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+		if (listening == INVALID_SOCKET)
+		{
+			Log::error("Metrics server: cannot create socket");
+			WSACleanup();
+			return false;
+		}
+
+		// Local only, there is no authentication
+		sockaddr_in hint = { 0 };
+		hint.sin_family = AF_INET;
+		hint.sin_port = htons(port);
+		inet_pton(AF_INET, "127.0.0.1", &hint.sin_addr);
+
+		if (bind(listening, (sockaddr*)&hint, sizeof(hint)) == SOCKET_ERROR || listen(listening, SOMAXCONN) == SOCKET_ERROR)
+		{
+			Log::error("Metrics server: cannot listen on port %d", (int)port);
+			closesocket(listening);
+			listening = INVALID_SOCKET;
+			WSACleanup();
+			return false;
+		}
+
+		this->port = port;
+		running = true;
+		thread = std::thread(&MetricsServer::serve, this);
+
+		Log::info("Metrics server listening on 127.0.0.1:%d", (int)port);
+
+		return true;
+	}
+
+	void MetricsServer::stop()
+	{
+		if (!running)
+			return;
+
+		running = false;
+
+		// Unblocks accept()
+		closesocket(listening);
+		listening = INVALID_SOCKET;
+
+		if (thread.joinable())
+			thread.join();
+
+		WSACleanup();
+	}
+
+	void MetricsServer::serve()
+	{
+		TraceProfiler::setThreadName("Metrics");
+
+		while (running)
+		{
+			SOCKET client = accept(listening, nullptr, nullptr);
+
+			if (client == INVALID_SOCKET)
+				continue;
+
+			// A client that never sends would block recv() and stop() with it
+			DWORD timeout = METRICS_SERVER_TIMEOUT;
+			setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+			setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+
+			handle(client);
+			closesocket(client);
+		}
+	}
+
+	void MetricsServer::handle(SOCKET client)
+	{
+		char buffer[1024];
+		int bytes = recv(client, buffer, sizeof(buffer) - 1, 0);
+
+		if (bytes <= 0)
+			return;
+
+		buffer[bytes] = '\0';
+
+		// Only the request line matters: "GET <path> HTTP/1.1"
+		std::string request(buffer);
+		std::string path;
+		size_t begin = request.find(' ');
+		size_t end = begin != std::string::npos ? request.find(' ', begin + 1) : std::string::npos;
+
+		if (end != std::string::npos)
+			path = request.substr(begin + 1, end - begin - 1);
+
+		std::string status = "200 OK";
+		std::string type = "text/plain; version=0.0.4";
+		std::string body;
+
+		if (request.compare(0, 4, "GET ") != 0)
+		{
+			status = "405 Method Not Allowed";
+		}
+		else if (path == "/metrics")
+		{
+			body = Metrics::dump(Metrics::Format::TEXT);
+		}
+		else if (path == "/metrics.json")
+		{
+			type = "application/json";
+			body = Metrics::dump(Metrics::Format::JSON);
+		}
+		else
+		{
+			status = "404 Not Found";
+		}
+
+		std::string response =
+			"HTTP/1.1 " + status + "\r\n"
+			"Content-Type: " + type + "\r\n"
+			"Content-Length: " + std::to_string(body.size()) + "\r\n"
+			"Connection: close\r\n\r\n" + body;
+
+		size_t sent = 0;
+
+		while (sent < response.size())
+		{
+			int result = send(client, response.c_str() + sent, (int)(response.size() - sent), 0);
+
+			if (result <= 0)
+				break;
+
+			sent += result;
+		}
+	}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Network.h"
+
+#define METRICS_SERVER_PORT 9100
+// Milliseconds a client may stay silent before its connection is dropped
+#define METRICS_SERVER_TIMEOUT 1000
+
+namespace Razor
+{
+
+	// Minimal HTTP endpoint bound to 127.0.0.1 for scrapers:
+	//   GET /metrics       Prometheus text format
+	//   GET /metrics.json  JSON
+	// Serves one request per connection on its own thread.
+	class MetricsServer
+	{
+	public:
+		MetricsServer();
+		~MetricsServer();
+
+		bool start(unsigned short port = METRICS_SERVER_PORT);
+		void stop();
+
+		inline bool isRunning() const { return running; }
+		inline unsigned short getPort() const { return port; }
+
+	private:
+		void serve();
+		void handle(SOCKET client);
+
+		std::thread thread;
+		std::atomic<bool> running;
+		SOCKET listening;
+		unsigned short port;
+	};
+
+}
@@ -3,6 +3,7 @@
 #include "TCPClient.h"
 #include "Razor/Network/Packet.h"
 #include "Razor/Core/Timer.h"
+#include "Razor/Memory/MemoryTracker.h"
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -83,6 +84,8 @@ namespace Razor {
 		}
 
 		std::thread hearbeat_thread([=]() {
+			MemoryTagScope memory(MemoryTag::Net);
+
 			while (true) {
 				if ((clock() - timer_start) / CLOCKS_PER_SEC >= 2) {
 					//std::cout << "Ping Heartbeat" << std::endl;
@@ -2,6 +2,8 @@
 #include "TCPServer.h"
 
 #include "Razor/Network/Packet.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Memory/MemoryTracker.h"
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -9,6 +11,9 @@
 
 namespace Razor {
 
+	// Per packet logging, capped so a flood doesn't stall the server loop
+	static LogCategory s_packetLog("Packets", 100);
+
 	TCPServer::TCPServer() :
 		clients({}),
 		channels({}),
@@ -68,6 +73,8 @@ namespace Razor {
 
 	void TCPServer::listen_socket(const SOCKET& listening)
 	{
+		MemoryTagScope memory(MemoryTag::Net);
+
 		int state = listen(listening, SOMAXCONN);
 		Network::log(Network::State::SOCKET_LISTENING);
 
@@ -75,9 +82,16 @@ namespace Razor {
 		FD_ZERO(&master);
 		FD_SET(listening, &master);
 
+		static Histogram& s_tickTime = Metrics::histogram("server.tick_time", "us", "Time to handle the sockets ready after a select");
+		static Counter& s_connections = Metrics::counter("network.connections", "Accepted connections");
+		static Counter& s_packetsIn = Metrics::counter("network.packets_in", "Packets received");
+		static Counter& s_bytesIn = Metrics::counter("network.bytes_in", "Bytes received");
+		static Gauge& s_clients = Metrics::gauge("network.clients", "Connected sockets");
+
 		while (true) {
 			fd_set copy = master;
 			int size = select(0, &copy, nullptr, nullptr, nullptr);
+			uint64 tick_start = TraceProfiler::now();
 
 			for (int i = 0; i < size; i++) 
 			{
@@ -90,9 +104,10 @@ namespace Razor {
 				if (sock == listening) {
 					SOCKET client = accept(listening, (sockaddr*)&addr, &addrlen);
 					FD_SET(client, &master);
+					s_connections.add();
 
 					std::string connected = Network::getState(Network::State::SOCKET_CONNECTED);
-					Log::info(std::string(connected + " (%s:%d)").c_str(), inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+					Log::info("%s (%s:%d)", connected, inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
 
 					std::string message = Network::getState(Network::State::WELCOME_MESSAGE);
 					message += "\r\n";
@@ -112,7 +127,7 @@ namespace Razor {
 						getpeername(sock, (sockaddr*)&addr, &addrlen);
 
 						std::string disconnected = Network::getState(Network::State::SOCKET_DISCONNECTED);
-						Log::info(std::string(disconnected + " (%s:%d)").c_str(), inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+						Log::info("%s (%s:%d)", disconnected, inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
 
 						//auto clients_it = clients.find(sock);
 
@@ -177,6 +192,9 @@ namespace Razor {
 						FD_CLR(sock, &master);
 					}
 					else {
+						s_packetsIn.add();
+						s_bytesIn.add(bytes);
+
 						auto packet = reinterpret_cast<Packet*>(buffer);
 		
 						if (packet != nullptr) {
@@ -192,6 +210,7 @@ namespace Razor {
 								getpeername(sock, (sockaddr*)&addr, &addrlen);
 
 								Log::warn(
+									s_packetLog,
 									"[IN] %s - %s (%s:%d)", 
 									packet->to_string().c_str(),
 									Utils::bytesToSize(bytes).c_str(),
@@ -501,6 +520,9 @@ namespace Razor {
 					}
 				}
 			}
+
+			s_clients.set((double)(master.fd_count - 1));
+			s_tickTime.record((TraceProfiler::now() - tick_start) / 1000);
 		}
 
 		WSACleanup();
@@ -5,22 +5,31 @@
 namespace Razor
 {
 
-	ParticleSystem::ParticleSystem()
+	ParticleSystem::ParticleSystem() :
+		pool("Particles")
 	{
 	}
 
 	ParticleSystem::~ParticleSystem()
 	{
+		for (auto particle : particles)
+			pool.destroy(particle);
 	}
 
 	void ParticleSystem::update(float dt)
 	{
-		ParticleArray::iterator it;
+		ParticleArray::iterator it = particles.begin();
 
-		for (it = particles.begin(); it != particles.end(); ++it)
+		while (it != particles.end())
 		{
-			if (!(*it)->update(dt))
-				particles.erase(it);
+			if ((*it)->update(dt))
+			{
+				++it;
+				continue;
+			}
+
+			pool.destroy(*it);
+			it = particles.erase(it);
 		}
 	}
 
@@ -33,7 +42,7 @@ namespace Razor
 		float scale
 	)
 	{
-		Particle* particle = new Particle(
+		Particle* particle = pool.create(
 			position,
 			velocity,
 			gravity,
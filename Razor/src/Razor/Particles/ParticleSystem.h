@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Razor/Memory/PoolAllocator.h"
+
 namespace Razor
 {
 	class Particle;
@@ -27,6 +29,7 @@ namespace Razor
 
 	private:
 		ParticleArray particles;
+		ObjectPool<Particle> pool;
 	};
 
 }
@@ -18,6 +18,8 @@ namespace Razor
 		void init() override;
 		void updateTransform() override;
 
+		inline const glm::vec3& getExtents() const { return extents; }
+
 	private:
 		glm::vec3 extents;
 	};
@@ -15,6 +15,8 @@ namespace Razor
 
 		void init() override;
 
+		inline float getRadius() const { return radius; }
+
 	private:
 		float radius;
 	};
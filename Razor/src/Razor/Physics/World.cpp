@@ -1,5 +1,9 @@
 #include "rzpch.h"
 #include "World.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Core/Parallel.h"
+#include "Razor/Core/JobSystem.h"
+#include "Razor/Memory/MemoryTracker.h"
 #include "PhysicsBody.h"
 #include "Razor/Scene/Node.h"
 #include "Razor/Cameras/Camera.h"
@@ -10,6 +14,7 @@
 #include "Razor/Geometry/Geometry.h"
 #include "Razor/Rendering/ForwardRenderer.h"
 #include "Razor/Materials/Presets/ColorMaterial.h"
+#include "Razor/Memory/Allocators.h"
 
 #include "btBulletDynamicsCommon.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
@@ -44,9 +49,19 @@ namespace Razor
 
 	void World::tick(float dt)
 	{
+		RZ_PROFILE_FUNCTION();
+		MemoryTagScope memory(MemoryTag::Physics);
+
+		static Histogram& s_tickTime = Metrics::histogram("physics.tick_time", "us", "Simulation step and node sync time");
+		static Gauge& s_bodies = Metrics::gauge("physics.bodies", "Nodes in the physics world");
+		uint64 start = TraceProfiler::now();
+
 		delta = dt;
 		world->stepSimulation(dt);
 		updateNodes();
+
+		s_tickTime.record((TraceProfiler::now() - start) / 1000);
+		s_bodies.set((double)nodes.size());
 	}
 
 	void World::setGravity(const glm::vec3& gravity)
@@ -57,8 +72,11 @@ namespace Razor
 
 	void World::addNode(std::shared_ptr<Node> node)
 	{
-		for (auto mesh : node->meshes)
+		for (auto& mesh : node->meshes)
 		{
+			if (mesh->getPhysicsBody() == nullptr)
+				continue;
+
 			mesh->getPhysicsBody()->init();
 			world->addRigidBody(mesh->getPhysicsBody()->getBody());
 		}
@@ -68,7 +86,7 @@ namespace Razor
 
 	void World::removeNode(std::shared_ptr<Node> node)
 	{
-		for (auto mesh : node->meshes)
+		for (auto& mesh : node->meshes)
 			if(mesh->getPhysicsBody() != nullptr)
 					world->removeRigidBody(mesh->getPhysicsBody()->getBody());
 
@@ -77,46 +95,77 @@ namespace Razor
 
 	void World::updateNodes()
 	{
-		std::vector<std::shared_ptr<Node>>::iterator node_it = nodes.begin();
+		MemoryTagScope memory(MemoryTag::Physics);
 
-		for (; node_it != nodes.end(); ++node_it)
-		{
-			std::vector<std::shared_ptr<StaticMesh>>::iterator mesh_it = (*node_it)->meshes.begin();
+		node_updates.resize(nodes.size());
 
-			for (; mesh_it != (*node_it)->meshes.end(); mesh_it++)
+		parallel_for(0, nodes.size(), WORLD_NODES_GRAIN, [&](size_t first, size_t last)
+		{
+			for (size_t n = first; n < last; n++)
 			{
-				if ((*mesh_it)->getPhysicsEnabled() && (*mesh_it)->getPhysicsBody() != nullptr)
+				std::shared_ptr<Node>& node = nodes[n];
+				NodeUpdate& update = node_updates[n];
+
+				update.boundings.clear();
+				update.instances.clear();
+
+				for (auto& mesh : node->meshes)
 				{
-					btMotionState* mesh_motion_state = (*mesh_it)->getPhysicsBody()->getBody()->getMotionState();
+					if (!mesh->getPhysicsEnabled() || mesh->getPhysicsBody() == nullptr)
+						continue;
+
+					btMotionState* mesh_motion_state = mesh->getPhysicsBody()->getBody()->getMotionState();
+
+					if (mesh_motion_state == nullptr)
+						continue;
+
+					node->transform = getMotionStateTransform(mesh_motion_state);
 
-					if (mesh_motion_state != nullptr)
+					if (mesh->isBoundingBoxVisible())
+						update.boundings.push_back({ mesh, node->transform, AABB() });
+
+					for (auto& i : mesh->getInstances())
 					{
-						(*node_it)->transform = getMotionStateTransform(mesh_motion_state);
+						if (i->body == nullptr || !i->body->initialized)
+							continue;
 
-						if ((*mesh_it)->getBoundingMesh() != nullptr && (*mesh_it)->isBoundingBoxVisible())
-							(*mesh_it)->updateBoundings((*node_it)->transform);
+						btMotionState* instance_motion_state = i->body->getBody()->getMotionState();
 
-						for (auto i : (*mesh_it)->getInstances())
+						if (instance_motion_state != nullptr)
 						{
-							if (i->body != nullptr)
-							{
-								if (i->body->initialized)
-								{
-									btMotionState* instance_motion_state = i->body->getBody()->getMotionState();
-
-									if (instance_motion_state != nullptr)
-									{
-								
-										Transform t = getMotionStateTransform(instance_motion_state);
-										(*mesh_it)->updateInstance(t.getMatrix(), i->index);
-									}
-								}
-							}
+							Transform t = getMotionStateTransform(instance_motion_state);
+							update.instances.push_back({ mesh, i->index, t.getMatrix() });
 						}
 					}
 				}
 			}
+		});
+
+		std::vector<NodeUpdate::MeshBounds> boundings;
+		std::vector<NodeUpdate::InstanceMatrix> instances;
+
+		for (auto& update : node_updates)
+		{
+			for (auto& bounds : update.boundings)
+			{
+				bounds.box = bounds.mesh->computeBoundings(bounds.transform);
+				boundings.push_back(bounds);
+			}
+
+			instances.insert(instances.end(), update.instances.begin(), update.instances.end());
 		}
+
+		if (boundings.empty() && instances.empty())
+			return;
+
+		JobSystem::get().runOnMainThread([boundings = std::move(boundings), instances = std::move(instances)]()
+		{
+			for (auto& bounds : boundings)
+				bounds.mesh->updateBoundingMesh(bounds.box);
+
+			for (auto& instance : instances)
+				instance.mesh->updateInstance(instance.matrix, instance.index);
+		});
 	}
 
 	Transform World::getMotionStateTransform(btMotionState* motion_state)
@@ -146,7 +195,7 @@ namespace Razor
 		return final_transform;
 	}
 
-	void World::raycast(RaycastResult* result, Camera* camera, const glm::vec2& mouse, glm::vec2& viewport, float distance)
+	glm::vec3 World::getRayDirection(Camera* camera, const glm::vec2& mouse, const glm::vec2& viewport)
 	{
 		float mx = mouse.x / (viewport.x * 0.5f) - 1.0f;
 		float my = mouse.y / (viewport.y * 0.5f) - 1.0f;
@@ -154,7 +203,12 @@ namespace Razor
 		glm::mat4 inverse = glm::inverse(camera->getProjectionMatrix() * camera->getViewMatrix());
 		glm::vec4 screen = glm::vec4(mx, my, 1.0f, 1.0f);
 
-		glm::vec3 direction = glm::normalize(glm::vec3(inverse * screen));
+		return glm::normalize(glm::vec3(inverse * screen));
+	}
+
+	void World::raycast(RaycastResult* result, Camera* camera, const glm::vec2& mouse, glm::vec2& viewport, float distance)
+	{
+		glm::vec3 direction = getRayDirection(camera, mouse, viewport);
 
 		glm::vec3 start = camera->getPosition();
 		glm::vec3 end = start + direction * distance;
@@ -172,10 +226,9 @@ namespace Razor
 
 		if (debug_ray_trace_lines)
 		{
-			/// TODO: optimize this
-			std::shared_ptr<Ray> ray = std::make_shared<Ray>(start, end, distance);
+			std::shared_ptr<Ray> ray = std::allocate_shared<Ray>(PoolStlAllocator<Ray>(), start, end, distance);
 			ray->setMaterial(debug_lines_mat);
-			std::shared_ptr<Node> ray_node = std::make_shared<Node>();
+			std::shared_ptr<Node> ray_node = Node::create();
 			ray_node->meshes.push_back(ray);
 			ForwardRenderer::addLineMesh(ray_node, 1);
 		}
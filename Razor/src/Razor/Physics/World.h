@@ -5,12 +5,15 @@
 #include <Razor/Core/Transform.h>
 #include <Razor/Maths/Maths.h>
 
+#define WORLD_NODES_GRAIN 64
+
 class btMotionState;
 
 namespace Razor
 {
 	class PhysicsBody;
 	class Node;
+	class StaticMesh;
 	class Camera;
 	class ColorMaterial;
 
@@ -40,8 +43,32 @@ namespace Razor
 		
 		Transform getMotionStateTransform(btMotionState* motion_state);
 		void raycast(RaycastResult* result, Camera* camera, const glm::vec2& mouse, glm::vec2& viewport, float distance);
+		// Direction of the ray from the camera through the mouse position
+		static glm::vec3 getRayDirection(Camera* camera, const glm::vec2& mouse, const glm::vec2& viewport);
 
 	private:
+		// Results of the parallel decomposition. Bounding and instance buffers
+		// live on the GPU, they are written by the main thread before it renders.
+		struct NodeUpdate
+		{
+			struct MeshBounds
+			{
+				std::shared_ptr<StaticMesh> mesh;
+				Transform transform;
+				AABB box;
+			};
+
+			struct InstanceMatrix
+			{
+				std::shared_ptr<StaticMesh> mesh;
+				unsigned int index;
+				glm::mat4 matrix;
+			};
+
+			std::vector<MeshBounds> boundings;
+			std::vector<InstanceMatrix> instances;
+		};
+
 		bool debug_ray_trace_lines;
 		float delta;
 		glm::vec3 gravity;
@@ -53,6 +80,7 @@ namespace Razor
 		btCollisionConfiguration* config;
 
 		std::vector<std::shared_ptr<Node>> nodes;
+		std::vector<NodeUpdate> node_updates;
 		std::shared_ptr<ColorMaterial> debug_lines_mat;
 	};
 
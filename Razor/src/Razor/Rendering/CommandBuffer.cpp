@@ -0,0 +1,159 @@
+#include "rzpch.h"
+#include "CommandBuffer.h"
+
+#include "Razor/Core/JobSystem.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Materials/Shader.h"
+#include "Razor/Materials/Material.h"
+#include "Razor/Buffers/VertexArray.h"
+#include "Razor/Geometry/StaticMesh.h"
+#include "RenderState.h"
+
+#include <glad/glad.h>
+
+namespace Razor
+{
+
+	CommandBuffer::CommandBuffer(uint32 id) :
+		data(),
+		count(0),
+		id(id)
+	{
+	}
+
+	CommandBuffer::~CommandBuffer()
+	{
+	}
+
+	CommandStream::CommandStream() :
+		buffers(),
+		packets()
+	{
+	}
+
+	CommandStream::~CommandStream()
+	{
+	}
+
+	void CommandStream::begin(size_t count)
+	{
+		size_t threads = JobSystem::exists() ? std::max(JobSystem::get().getThreadsCount(), 1u) : 1;
+
+		while (buffers.size() < threads)
+			buffers.push_back(std::make_unique<CommandBuffer>((uint32)buffers.size()));
+
+		for (auto& buffer : buffers)
+			buffer->clear();
+
+		packets.assign(count, { 0, 0, 0 });
+	}
+
+	CommandBuffer& CommandStream::getBuffer()
+	{
+		// Threads outside of the job system record into the main thread buffer
+		int index = JobSystem::getThreadIndex();
+
+		return *buffers[index >= 0 && index < (int)buffers.size() ? index : 0];
+	}
+
+	void CommandStream::submit()
+	{
+		RZ_PROFILE_FUNCTION();
+
+		static Gauge& s_commands = Metrics::gauge("renderer.commands", "Render commands recorded last frame");
+		static Gauge& s_bytes = Metrics::gauge("renderer.command_bytes", "Bytes of render commands recorded last frame");
+
+		uint64 commands = 0;
+		uint64 bytes = 0;
+
+		for (auto& buffer : buffers)
+		{
+			commands += buffer->getCount();
+			bytes += buffer->getSize();
+		}
+
+		s_commands.set((double)commands);
+		s_bytes.set((double)bytes);
+
+		for (const Packet& packet : packets)
+		{
+			if (packet.size > 0)
+				execute(buffers[packet.buffer]->getData() + packet.offset, packet.size);
+		}
+	}
+
+	void CommandStream::execute(const uint8* data, size_t size)
+	{
+		const size_t header = CommandBuffer::getAlignedSize(sizeof(RenderCommand));
+		const uint8* end = data + size;
+
+		while (data < end)
+		{
+			const RenderCommand* command = reinterpret_cast<const RenderCommand*>(data);
+			const void* payload = data + header;
+
+			switch (command->type)
+			{
+				case RenderCommand::Type::BindShader:
+				{
+					static_cast<const BindShaderCommand*>(payload)->shader->bind();
+					break;
+				}
+				case RenderCommand::Type::BindVertexArray:
+				{
+					static_cast<const BindVertexArrayCommand*>(payload)->vao->bind();
+					break;
+				}
+				case RenderCommand::Type::BindMaterial:
+				{
+					const BindMaterialCommand* bind = static_cast<const BindMaterialCommand*>(payload);
+					bind->material->bind(bind->shader);
+					break;
+				}
+				case RenderCommand::Type::SetBlend:
+				{
+					bool enabled = static_cast<const SetBlendCommand*>(payload)->enabled;
+
+					RenderState::setBlend(enabled);
+
+					if (enabled)
+						RenderState::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+					break;
+				}
+				case RenderCommand::Type::SetUniformVec3:
+				{
+					const SetUniformVec3Command* uniform = static_cast<const SetUniformVec3Command*>(payload);
+					uniform->shader->setUniform3f(uniform->id, uniform->value);
+					break;
+				}
+				case RenderCommand::Type::SetUniformIVec4:
+				{
+					const SetUniformIVec4Command* uniform = static_cast<const SetUniformIVec4Command*>(payload);
+					uniform->shader->setUniform4i(uniform->id, uniform->value);
+					break;
+				}
+				case RenderCommand::Type::SetUniformMat4:
+				{
+					const SetUniformMat4Command* uniform = static_cast<const SetUniformMat4Command*>(payload);
+					uniform->shader->setUniformMat4f(uniform->id, uniform->value);
+					break;
+				}
+				case RenderCommand::Type::DrawMesh:
+				{
+					const DrawMeshCommand* draw = static_cast<const DrawMeshCommand*>(payload);
+					draw->mesh->draw((StaticMesh::DrawMode)draw->draw_mode, draw->vertex_count, draw->index_count);
+					break;
+				}
+				default:
+				{
+					RZ_ASSERT(false, "Render command without a replay case");
+					break;
+				}
+			}
+
+			data += command->size;
+		}
+	}
+
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+#include <glm/glm.hpp>
+
+// Commands start on this boundary, so their payload can be read in place
+#define COMMAND_ALIGNMENT 16
+// Draws recorded by a job, chunks restart from unknown GL state
+#define COMMAND_RECORD_GRAIN 128
+
+namespace Razor
+{
+
+	class Shader;
+	class Material;
+	class VertexArray;
+	class StaticMesh;
+
+	// Commands only hold engine objects and values, never GL names or calls,
+	// so they can be recorded anywhere and executed by whatever backend submits them.
+	// Uniforms are set by id (RZ_UNIFORM), no name is held.
+	struct RenderCommand
+	{
+		enum class Type : uint32
+		{
+			BindShader,
+			BindVertexArray,
+			BindMaterial,
+			SetBlend,
+			SetUniformVec3,
+			SetUniformIVec4,
+			SetUniformMat4,
+			DrawMesh
+		};
+
+		Type type;
+		// Bytes up to the next command, header included
+		uint32 size;
+	};
+
+	struct BindShaderCommand
+	{
+		static const RenderCommand::Type TYPE = RenderCommand::Type::BindShader;
+		Shader* shader;
+	};
+
+	struct BindVertexArrayCommand
+	{
+		static const RenderCommand::Type TYPE = RenderCommand::Type::BindVertexArray;
+		VertexArray* vao;
+	};
+
+	struct BindMaterialCommand
+	{
+		static const RenderCommand::Type TYPE = RenderCommand::Type::BindMaterial;
+		Material* material;
+		Shader* shader;
+	};
+
+	struct SetBlendCommand
+	{
+		static const RenderCommand::Type TYPE = RenderCommand::Type::SetBlend;
+		bool enabled;
+	};
+
+	struct SetUniformVec3Command
+	{
+		static const RenderCommand::Type TYPE = RenderCommand::Type::SetUniformVec3;
+		Shader* shader;
+		uint32 id;
+		glm::vec3 value;
+	};
+
+	struct SetUniformIVec4Command
+	{
+		static const RenderCommand::Type TYPE = RenderCommand::Type::SetUniformIVec4;
+		Shader* shader;
+		uint32 id;
+		glm::ivec4 value;
+	};
+
+	struct SetUniformMat4Command
+	{
+		static const RenderCommand::Type TYPE = RenderCommand::Type::SetUniformMat4;
+		Shader* shader;
+		uint32 id;
+		glm::mat4 value;
+	};
+
+	struct DrawMeshCommand
+	{
+		static const RenderCommand::Type TYPE = RenderCommand::Type::DrawMesh;
+		// Counts read when the snapshot was captured, not from the live mesh
+		StaticMesh* mesh;
+		uint32 draw_mode;
+		uint32 vertex_count;
+		uint32 index_count;
+	};
+
+	// Linear buffer of commands written by a single thread, the memory is kept
+	// between frames so steady frames don't allocate
+	class CommandBuffer
+	{
+	public:
+		CommandBuffer(uint32 id = 0);
+		~CommandBuffer();
+
+		template<typename T>
+		void push(const T& command)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Commands are copied as bytes");
+
+			size_t offset = data.size();
+			size_t size = getAlignedSize(sizeof(RenderCommand)) + getAlignedSize(sizeof(T));
+
+			data.resize(offset + size);
+
+			RenderCommand header = { T::TYPE, (uint32)size };
+			memcpy(&data[offset], &header, sizeof(RenderCommand));
+			memcpy(&data[offset + getAlignedSize(sizeof(RenderCommand))], &command, sizeof(T));
+
+			count++;
+		}
+
+		inline void clear() { data.clear(); count = 0; }
+
+		inline const uint8* getData() const { return data.data(); }
+		inline size_t getSize() const { return data.size(); }
+		inline uint32 getCount() const { return count; }
+		inline uint32 getId() const { return id; }
+
+		inline static size_t getAlignedSize(size_t size) { return (size + COMMAND_ALIGNMENT - 1) & ~(size_t)(COMMAND_ALIGNMENT - 1); }
+
+	private:
+		std::vector<uint8> data;
+		uint32 count;
+		uint32 id;
+	};
+
+	// Commands of a frame recorded in parallel, one buffer per job thread.
+	// Each draw of a sorted queue records a packet at its queue position, so
+	// replaying the packets in order gives the sorted stream whatever thread
+	// recorded them. Recording may run anywhere, submit() on the GL thread only.
+	class CommandStream
+	{
+	public:
+		CommandStream();
+		~CommandStream();
+
+		CommandStream(const CommandStream&) = delete;
+		CommandStream& operator=(const CommandStream&) = delete;
+
+		// Clears every buffer, packets are empty until recorded
+		void begin(size_t packets);
+
+		// Buffer of the calling thread
+		CommandBuffer& getBuffer();
+		inline void beginPacket(const CommandBuffer& buffer, size_t index) { packets[index] = { buffer.getId(), (uint32)buffer.getSize(), 0 }; }
+		inline void endPacket(const CommandBuffer& buffer, size_t index) { packets[index].size = (uint32)buffer.getSize() - packets[index].offset; }
+
+		void submit();
+
+		inline size_t getPacketsCount() const { return packets.size(); }
+
+	private:
+		struct Packet
+		{
+			uint32 buffer;
+			uint32 offset;
+			uint32 size;
+		};
+
+		static void execute(const uint8* data, size_t size);
+
+		std::vector<std::unique_ptr<CommandBuffer>> buffers;
+		std::vector<Packet> packets;
+	};
+
+}
@@ -4,6 +4,7 @@
 #include "Razor/Buffers/GBuffer.h"
 #include "Razor/Buffers/TextureAttachment.h"
 #include "Razor/Buffers/FrameBuffer.h"
+#include "Razor/Buffers/UniformBuffer.h"
 #include "Razor/Materials/ShadersManager.h"
 #include "Razor/Materials/Shader.h"
 #include "Razor/Scene/ScenesManager.h"
@@ -18,6 +19,10 @@
 #include "Razor/Materials/EnvironmentTexture.h"
 #include <glm/gtx/string_cast.hpp>
 #include "Razor/Core/Utils.h"
+#include "Razor/Scene/FrameSnapshot.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Core/Parallel.h"
+#include "Razor/Rendering/RenderState.h"
 
 namespace Razor
 {
@@ -41,7 +46,12 @@ namespace Razor
 		geometry_shader(nullptr),
 		pbr_pipeline(nullptr),
 		render_size(glm::ivec2(1920, 1080)),
-		quad(nullptr)
+		quad(nullptr),
+		camera_buffer(nullptr),
+		point_lights_buffer(nullptr),
+		point_lights(),
+		culler(),
+		commands()
 	{
 		shadersManager = shaders_manager;
 
@@ -52,7 +62,7 @@ namespace Razor
 		//ironAOMap = new Texture("./data/pbr/gold/ao.png", false);
 
 		//glEnable(GL_MULTISAMPLE);
-		glEnable(GL_DEPTH_TEST);
+		RenderState::setDepthTest(true);
 		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 
 		setup_framebuffers();
@@ -82,7 +92,7 @@ namespace Razor
 			float bColor = ((rand() % 100) / 200.0f) + 0.5f; // between 0.5 and 1.0
 			glm::vec3 col = glm::vec3(200.0f, 200.0f, 200.0f);
 			
-			std::shared_ptr<Razor::Node> node_point = std::make_shared<Razor::Node>();
+			std::shared_ptr<Razor::Node> node_point = Razor::Node::create();
 			node_point->name = "Point Light " + std::to_string(i);
 			std::shared_ptr<Point> point_light = std::make_shared<Razor::Point>(scenesManager->getActiveScene()->getActiveCamera(), pos);
 			point_light->setDiffuse(col);
@@ -98,6 +108,8 @@ namespace Razor
 	{
 		delete pbr_pipeline;
 		delete g_buffer;
+		delete camera_buffer;
+		delete point_lights_buffer;
 	}
 
 	void DeferredRenderer::setup_deferred_shaders()
@@ -113,6 +125,9 @@ namespace Razor
 		deferred_shader->setUniform1i("gPosition", 0);
 		deferred_shader->setUniform1i("gNormal", 1);
 		deferred_shader->setUniform1i("gAlbedoSpec", 2);
+
+		camera_buffer = new UniformBuffer(UniformBuffer::Type::UNIFORM, UNIFORM_BINDING_CAMERA, sizeof(CameraBlock));
+		point_lights_buffer = new UniformBuffer(UniformBuffer::Type::STORAGE, STORAGE_BINDING_POINT_LIGHTS, 64 * sizeof(PointLightBlock));
 	}
 
 	void DeferredRenderer::setup_framebuffers()
@@ -120,33 +135,31 @@ namespace Razor
 		g_buffer = new GBuffer(render_size);
 	}
 
-	void DeferredRenderer::render()
+	void DeferredRenderer::render(const FrameSnapshot& snapshot, const RenderQueue& queue, float alpha)
 	{
 		//geometryPass();
-		lightingPass();
+		lightingPass(snapshot, queue, alpha);
 	}
 
 	void DeferredRenderer::bindLights(Shader* shader, const std::vector<std::shared_ptr<Light>>& lights)
 	{
 		if (shader != nullptr)
 		{
-			std::string paramType;
 			unsigned int sIdx = 0, dIdx = 0, pIdx = 0;
 
-			for (auto light : lights)
+			for (auto& light : lights)
 			{
 				if (light->getType() == Light::Type::POINT)
 				{
 					std::shared_ptr<Point> point = std::dynamic_pointer_cast<Point>(light);
-					paramType = "point_lights";
 
-					shader->setUniform3f(formatParamName(paramType, pIdx, "position"), point->getPosition());
-					//shader->setUniform1f(formatParamName(paramType, pIdx, "linear"), point->getConstant());
-					//shader->setUniform1f(formatParamName(paramType, pIdx, "quadratic"), point->getQuadratic());
-					shader->setUniform3f(formatParamName(paramType, pIdx, "diffuse"), point->getDiffuse());
-					//shader->setUniform1f(formatParamName(paramType, pIdx, "intensity"), point->getIntensity());
-					//shader->setUniform3f(formatParamName(paramType, pIdx, "ambient"), point->getAmbient());
-					//shader->setUniform3f(formatParamName(paramType, pIdx, "specular"), point->getSpecular());
+					shader->setUniform3f(hashUniformElement("point_lights", pIdx, "position"), point->getPosition());
+					//shader->setUniform1f(hashUniformElement("point_lights", pIdx, "linear"), point->getConstant());
+					//shader->setUniform1f(hashUniformElement("point_lights", pIdx, "quadratic"), point->getQuadratic());
+					shader->setUniform3f(hashUniformElement("point_lights", pIdx, "diffuse"), point->getDiffuse());
+					//shader->setUniform1f(hashUniformElement("point_lights", pIdx, "intensity"), point->getIntensity());
+					//shader->setUniform3f(hashUniformElement("point_lights", pIdx, "ambient"), point->getAmbient());
+					//shader->setUniform3f(hashUniformElement("point_lights", pIdx, "specular"), point->getSpecular());
 
 					pIdx++;
 				}
@@ -154,21 +167,97 @@ namespace Razor
 		}
 	}
 
-	std::string DeferredRenderer::formatParamName(const std::string& type, unsigned int index, const std::string& name)
+	void DeferredRenderer::updateBlocks(const FrameSnapshot& snapshot, const glm::mat4& view, const glm::vec3& position)
 	{
-		std::stringstream str;
-		str << type << "[" << index << "]." << name;
+		RZ_PROFILE_FUNCTION();
+
+		CameraBlock camera = { view, snapshot.getCamera().projection, glm::vec4(position, 1.0f) };
+		camera_buffer->update(&camera, sizeof(CameraBlock));
+		camera_buffer->bind();
+
+		// Draws index this array, so it follows the snapshot light order
+		const std::vector<FrameSnapshot::LightState>& lights = snapshot.getLights();
+		point_lights.resize(lights.size());
 
-		return str.str();
+		for (size_t i = 0; i < lights.size(); i++)
+			point_lights[i] = { glm::vec4(lights[i].position, 1.0f), glm::vec4(lights[i].diffuse, 0.0f) };
+
+		point_lights_buffer->update(point_lights.data(), point_lights.size() * sizeof(PointLightBlock));
+		point_lights_buffer->bind();
+	}
+
+	void DeferredRenderer::record(const FrameSnapshot& snapshot, const RenderQueue& queue, Shader* shader)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		static_assert(SNAPSHOT_NODE_LIGHTS <= 4, "Light indices are an ivec4");
+
+		const std::vector<RenderQueue::DrawItem>& items = queue.getItems();
+		const std::vector<FrameSnapshot::NodeState>& nodes = snapshot.getNodes();
+
+		commands.begin(items.size());
+
+		parallel_for(0, items.size(), COMMAND_RECORD_GRAIN, [&](size_t first, size_t last)
+		{
+			CommandBuffer& buffer = commands.getBuffer();
+			// State bound by the previous draw of the chunk, chunks start from scratch
+			// as the draws before them may be replayed from another buffer
+			const RenderQueue::DrawData* previous = nullptr;
+
+			for (size_t i = first; i < last; i++)
+			{
+				const RenderQueue::DrawData& draw = queue.getData(items[i]);
+
+				// Landscapes have their own shader, the pass only draws meshes
+				if (draw.category != RenderQueue::RenderCategory::OBJECT || !culler.isVisible(draw.state, draw.mesh_index))
+					continue;
+
+				commands.beginPacket(buffer, i);
+
+				const FrameSnapshot::NodeState& state = nodes[draw.state];
+				const FrameSnapshot::NodeState* bound = previous != nullptr ? &nodes[previous->state] : nullptr;
+
+				// Consecutive nodes often share their lights, unused slots are -1
+				if (bound == nullptr || bound->light_count != state.light_count
+					|| !std::equal(state.lights.begin(), state.lights.begin() + state.light_count, bound->lights.begin()))
+				{
+					glm::ivec4 indices(-1);
+
+					for (unsigned int l = 0; l < state.light_count; l++)
+						indices[l] = state.lights[l];
+
+					buffer.push(SetUniformIVec4Command{ shader, RZ_UNIFORM("lightIndices"), indices });
+				}
+
+				buffer.push(SetUniformMat4Command{ shader, RZ_UNIFORM("model"), worlds[draw.state] });
+
+				if (draw.material != nullptr && (previous == nullptr || previous->material != draw.material))
+					buffer.push(BindMaterialCommand{ draw.material, shader });
+
+				if (previous == nullptr || previous->vao != draw.vao)
+					buffer.push(BindVertexArrayCommand{ draw.vao });
+
+				if (draw.transparent)
+					buffer.push(SetBlendCommand{ true });
+
+				buffer.push(DrawMeshCommand{ draw.mesh, (uint32)draw.draw_mode, draw.vertex_count, draw.index_count });
+
+				if (draw.transparent)
+					buffer.push(SetBlendCommand{ false });
+
+				commands.endPacket(buffer, i);
+				previous = &draw;
+			}
+		});
 	}
 
 	void DeferredRenderer::geometryPass()
 	{
 		Camera* camera = scenesManager->getActiveScene()->getActiveCamera();
-		SceneGraph::NodeList nodes = scenesManager->getActiveScene()->getSceneGraph()->getNodes();
+		SceneGraph::NodeList& nodes = scenesManager->getActiveScene()->getSceneGraph()->getNodes();
 
-		glBindFramebuffer(GL_FRAMEBUFFER, g_buffer->getBuffer());
-		glViewport(0, 0, render_size.x, render_size.y);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, g_buffer->getBuffer());
+		RenderState::setViewport(0, 0, render_size.x, render_size.y);
 
 		setClearColor(glm::vec4(1.0f));
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
@@ -179,11 +268,11 @@ namespace Razor
 
 
 
-		for (auto node : nodes)
+		for (auto& node : nodes)
 		{
-			geometry_shader->setUniformMat4f("model", node->transform.getMatrix());
+			geometry_shader->setUniformMat4f("model", node->world);
 
-			for (auto mesh : node->meshes)
+			for (auto& mesh : node->meshes)
 			{
 				std::shared_ptr<Material> material = mesh->getMaterial();
 
@@ -195,58 +284,97 @@ namespace Razor
 			}
 		}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
-	void DeferredRenderer::lightingPass()
+	void DeferredRenderer::lightingPass(const FrameSnapshot& snapshot, const RenderQueue& queue, float alpha)
 	{
-		Camera* camera = scenesManager->getActiveScene()->getActiveCamera();
+		RZ_PROFILE_FUNCTION();
+
+		static Gauge& s_visible = Metrics::gauge("culling.camera.visible", "Meshes in the camera frustum last frame");
+		static Gauge& s_culled = Metrics::gauge("culling.camera.culled", "Meshes of the snapshot outside the camera frustum last frame");
+
+		const FrameSnapshot::CameraState& camera = snapshot.getCamera();
+		glm::mat4 view = FrameSnapshot::interpolate(camera.previous_view, camera.view, alpha);
+		glm::vec3 position = glm::mix(camera.previous_position, camera.position, alpha);
 
-		glBindFramebuffer(GL_FRAMEBUFFER, g_buffer->getFrame());
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, g_buffer->getFrame());
 
-		glViewport(0, 0, render_size.x, render_size.y);
+		RenderState::setViewport(0, 0, render_size.x, render_size.y);
 		setClearColor(glm::vec4(0.0f));
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	
-		glDisable(GL_DEPTH_TEST);
+		RenderState::setDepthTest(false);
 		Transform p;
-		p.setPosition(camera->getPosition());
+		p.setPosition(position);
 		p.setScale(glm::vec3(300.0f));
 
 		Shader* shader_background = pbr_pipeline->getShaderBackground();
 		shader_background->bind();
-		shader_background->setUniformMat4f("projection", camera->getProjectionMatrix());
-		shader_background->setUniformMat4f("view", camera->getViewMatrix());
-		shader_background->setUniformMat4f("model", p.getMatrix());
+		shader_background->setUniformMat4f(RZ_UNIFORM("projection"), camera.projection);
+		shader_background->setUniformMat4f(RZ_UNIFORM("view"), view);
+		shader_background->setUniformMat4f(RZ_UNIFORM("model"), p.getMatrix());
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, pbr_pipeline->getEnvCubemap());
+		RenderState::bindTexture(0, GL_TEXTURE_CUBE_MAP, pbr_pipeline->getEnvCubemap());
 		cube->getVao()->bind();
 		cube->draw();
 
-		glEnable(GL_DEPTH_TEST);
+		RenderState::setDepthTest(true);
 
 		Shader* shader_pbr = pbr_pipeline->getShaderPBR();
 
 		shader_pbr->bind();
-		shader_pbr->setUniformMat4f("view", camera->getViewMatrix());
-		shader_pbr->setUniformMat4f("projection", camera->getProjectionMatrix());
-		shader_pbr->setUniform3f("camPos", camera->getPosition());
+		updateBlocks(snapshot, view, position);
 
-		bindLights(shader_pbr, scenesManager->getActiveScene()->getLights());
+		RenderState::bindTexture(0, GL_TEXTURE_CUBE_MAP, pbr_pipeline->getIrradianceMap());
+		RenderState::bindTexture(1, GL_TEXTURE_CUBE_MAP, pbr_pipeline->getPrefilterMap());
+		RenderState::bindTexture(2, GL_TEXTURE_2D, pbr_pipeline->getBrdfLutTexture());
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, pbr_pipeline->getIrradianceMap());
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, pbr_pipeline->getPrefilterMap());
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, pbr_pipeline->getBrdfLutTexture());
+		{
+			RZ_PROFILE_SCOPE("DrawNodes");
+
+			const std::vector<FrameSnapshot::NodeState>& nodes = snapshot.getNodes();
+
+			worlds.resize(nodes.size());
+
+			parallel_for(0, nodes.size(), COMMAND_RECORD_GRAIN, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; i++)
+					worlds[i] = FrameSnapshot::interpolate(nodes[i].previous_world, nodes[i].world, alpha);
+			});
 
-		SceneGraph::NodeList nodes = scenesManager->getActiveScene()->getSceneGraph()->getNodes();
+			// The snapshot holds what either of the last two camera frustums sees,
+			// the meshes are culled again against the interpolated one. The draws
+			// are the ones of the scene snapshot, like in the queue.
+			const SceneSnapshot* scene = snapshot.getSceneSnapshot();
 
-		for (auto node : nodes)
-			drawNode(node, shader_pbr, glm::mat4(1.0f));
+			culler.clear();
+
+			for (size_t i = 0; i < nodes.size(); i++)
+			{
+				if (scene == nullptr)
+				{
+					culler.add(nodes[i].node, worlds[i]);
+					continue;
+				}
+
+				// Nodes without draws still take their culler slot, the indices follow the snapshot
+				static const SceneSnapshot::DrawStates s_noDraws;
+				const SceneSnapshot::NodeRecord* record = scene->getNode(nodes[i].handle);
+
+				culler.add(nodes[i].node, worlds[i], record != nullptr && record->draws != nullptr ? *record->draws : s_noDraws);
+			}
+
+			uint32 visible = culler.cull(Frustum::fromMatrix(camera.projection * view));
+			s_visible.set((double)visible);
+			s_culled.set((double)(culler.getDrawsCount() - visible));
+
+			// Everything but the GL calls runs on the job threads, the GL thread
+			// only replays the commands in queue order
+			record(snapshot, queue, shader_pbr);
+			commands.submit();
+		}
 
 		//renderSphere();
 
@@ -255,54 +383,59 @@ namespace Razor
 		bindLights(deferred_shader, scenesManager->getActiveScene()->getLights());
 		deferred_shader->setUniform3f("viewPos", camera->getPosition());
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, g_buffer->getPosition());
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, g_buffer->getNormal());
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, g_buffer->getColor());
+		RenderState::bindTexture(0, GL_TEXTURE_2D, g_buffer->getPosition());
+		RenderState::bindTexture(1, GL_TEXTURE_2D, g_buffer->getNormal());
+		RenderState::bindTexture(2, GL_TEXTURE_2D, g_buffer->getColor());
 
 		quad->getVao()->bind();
 		quad->draw();*/
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 
-	void DeferredRenderer::drawNode(std::shared_ptr<Node> node, Shader* shader, glm::mat4 parent)
+	void DeferredRenderer::drawNode(const std::shared_ptr<Node>& node, Shader* shader)
 	{
 		if (node->active)
 		{
-			glm::mat4 local = parent * node->transform.getMatrix();
+			drawNode(node.get(), shader, node->world);
 
-			for (auto mesh : node->meshes)
-			{
-				shader->setUniformMat4f("model", local);
-				std::shared_ptr<Material> material = mesh->getMaterial();
+			std::vector<std::shared_ptr<Node>>::iterator it = node->nodes.begin();
 
-				if (material != nullptr) {
-					if (material->hasOpacityMap()) {
-						glEnable(GL_BLEND);
-						glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-					}
-					
-					material->bind(shader);
-				}
+			for (; it != node->nodes.end(); ++it)
+				drawNode(*it, shader);
+		}
+	}
 
-				mesh->getVao()->bind();
-				mesh->draw();
+	void DeferredRenderer::drawNode(Node* node, Shader* shader, const glm::mat4& world, const FrustumCuller* culler, uint32 index)
+	{
+		for (size_t m = 0; m < node->meshes.size(); m++)
+		{
+			if (culler != nullptr && !culler->isVisible(index, m))
+				continue;
+
+			const std::shared_ptr<StaticMesh>& mesh = node->meshes[m];
 
-				if (material != nullptr) {
-					if (material->hasOpacityMap()) {
-						glDisable(GL_BLEND);
-					}
+			shader->setUniformMat4f(RZ_UNIFORM("model"), world);
+			std::shared_ptr<Material> material = mesh->getMaterial();
+
+			if (material != nullptr) {
+				if (material->hasOpacityMap()) {
+					RenderState::setBlend(true);
+					RenderState::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 				}
+
+				material->bind(shader);
 			}
 
-			std::vector<std::shared_ptr<Node>>::iterator it = node->nodes.begin();
+			mesh->getVao()->bind();
+			mesh->draw();
 
-			for (; it != node->nodes.end(); ++it)
-				drawNode(*it, shader, local);
+			if (material != nullptr) {
+				if (material->hasOpacityMap()) {
+					RenderState::setBlend(false);
+				}
+			}
 		}
 	}
 
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Razor/Materials/Shader.h"
+#include "Razor/Rendering/FrustumCuller.h"
+#include "Razor/Rendering/CommandBuffer.h"
+#include "Razor/Rendering/RenderQueue.h"
 
 namespace Razor
 {
@@ -19,6 +22,8 @@ namespace Razor
 	class FrameBuffer;
 	class PBRPipeline;
 	class Node;
+	class FrameSnapshot;
+	class UniformBuffer;
 
 	class DeferredRenderer
 	{
@@ -108,17 +113,38 @@ namespace Razor
 		void onResize(const glm::vec2& size);
 		void clear(int flags);
 		void setClearColor(const glm::vec4& color);
-		void render();
+		// Draws the sorted queue, built from the same snapshot
+		void render(const FrameSnapshot& snapshot, const RenderQueue& queue, float alpha = 1.0f);
 		inline GBuffer* getGBuffer() { return g_buffer; }
 		inline PBRPipeline* getPBRPipeline() { return pbr_pipeline; }
 		void bindLights(Shader* shader, const std::vector<std::shared_ptr<Light>>& lights);
-		std::string formatParamName(const std::string& type, unsigned int index, const std::string& name);
 
-		void drawNode(std::shared_ptr<Node> node, Shader* shader, glm::mat4 parent);
+		void drawNode(const std::shared_ptr<Node>& node, Shader* shader);
+		// Meshes culled by the culler are skipped, index is the node in the culler
+		void drawNode(Node* node, Shader* shader, const glm::mat4& world, const FrustumCuller* culler = nullptr, uint32 index = 0);
 
 	private:
+		// Layout of the std140 Camera block
+		struct CameraBlock
+		{
+			glm::mat4 view;
+			glm::mat4 projection;
+			glm::vec4 position;
+		};
+
+		// Element of the std430 PointLights block
+		struct PointLightBlock
+		{
+			glm::vec4 position;
+			glm::vec4 diffuse;
+		};
+
 		void geometryPass();
-		void lightingPass();
+		void lightingPass(const FrameSnapshot& snapshot, const RenderQueue& queue, float alpha);
+		// Uploads the camera and every light of the snapshot, once per frame
+		void updateBlocks(const FrameSnapshot& snapshot, const glm::mat4& view, const glm::vec3& position);
+		// Records the visible draws of the queue on the job threads
+		void record(const FrameSnapshot& snapshot, const RenderQueue& queue, Shader* shader);
 
 		void setup_deferred_shaders();
 		void setup_framebuffers();
@@ -135,6 +161,14 @@ namespace Razor
 		Cube* cube;
 		UVSphere* sphere;
 		PBRPipeline* pbr_pipeline;
+
+		UniformBuffer* camera_buffer;
+		UniformBuffer* point_lights_buffer;
+		std::vector<PointLightBlock> point_lights;
+		FrustumCuller culler;
+		CommandStream commands;
+		// Interpolated world matrices of the snapshot nodes
+		std::vector<glm::mat4> worlds;
 	};
 
 }
@@ -26,6 +26,7 @@
 #include "Editor/Editor.h"
 #include "Razor/Landscape/Landscape.h"
 #include "Razor/Maths/Raycast.h"
+#include "Razor/Core/Metrics.h"
 
 #include "Razor/Materials/Presets/PhongMaterial.h"
 #include "Razor/Materials/Presets/ColorMaterial.h"
@@ -45,6 +46,7 @@
 
 #include "Razor/Network/Http.h"
 #include "Razor/Lighting/ShadowCascade.h"
+#include "Razor/Rendering/RenderState.h"
 
 namespace Razor 
 {
@@ -187,7 +189,8 @@ namespace Razor
 
 	ForwardRenderer::~ForwardRenderer()
 	{
-	
+		bounding_boxes.clear();
+		line_meshes.clear();
 	}
 	
 	void ForwardRenderer::update(float delta)
@@ -246,14 +249,25 @@ namespace Razor
 		//EditorViewport* vp = (EditorViewport*)Application::Get().getEditor()->getComponents()["Viewport"];
 		std::shared_ptr<Scene> scene = scenesManager->getActiveScene();
 
+		static Gauge& s_shadowVisible = Metrics::gauge("culling.shadow.visible", "Meshes drawn by the shadow cascades last frame");
+		static Gauge& s_shadowCulled = Metrics::gauge("culling.shadow.culled", "Meshes culled by the shadow cascades last frame");
+		static Gauge& s_cameraVisible = Metrics::gauge("culling.camera.visible", "Meshes in the camera frustum last frame");
+		static Gauge& s_cameraCulled = Metrics::gauge("culling.camera.culled", "Meshes of the snapshot outside the camera frustum last frame");
+
+		culler.clear();
+		culler.add(scene->getSceneGraph());
+
+		uint64 shadow_visible = 0;
+		uint64 shadow_tested = 0;
+
 		enableDepthTest();
-		glCullFace(GL_FRONT);
+		RenderState::setCullFace(GL_FRONT);
 
 		// Depth pass
 		depthShader->bind();
 		depthShader->setUniformMat4f("model", glm::mat4(1.0f));
 
-		for (auto light : scene->getLights())
+		for (auto& light : scene->getLights())
 		{
 			switch (light->getType())
 			{
@@ -268,7 +282,7 @@ namespace Razor
 
 				generator->getDepthBuffer()->bind();
 
-				glViewport(0, 0, (GLsizei)generator->getSize().x, (GLsizei)generator->getSize().y);
+				RenderState::setViewport(0, 0, (GLsizei)generator->getSize().x, (GLsizei)generator->getSize().y);
 				glClear(GL_DEPTH_BUFFER_BIT);
 
 				for (auto cascade : cascades)
@@ -281,12 +295,15 @@ namespace Razor
 
 					if (directional->isCastingShadows())
 					{
-						for (auto node : scene->getSceneGraph()->getNodes()) 
+						shadow_visible += culler.cull(cascade->getFrustum());
+						shadow_tested += culler.getDrawsCount();
+
+						for (auto& node : scene->getSceneGraph()->getNodes()) 
 						{
 							if (node->meshes.size() > 0)
 							{
 								if (node->meshes[0]->isReceivingShadows())
-									renderNode(depthShader, node, glm::mat4(1.0f), true);
+									renderNode(depthShader, node, true, &culler);
 							}
 						}
 					}
@@ -300,6 +317,9 @@ namespace Razor
 
 		depthShader->unbind();
 
+		s_shadowVisible.set((double)shadow_visible);
+		s_shadowCulled.set((double)(shadow_tested - shadow_visible));
+
 		//// Shadow blur pass
 
 		//blurShader->bind();
@@ -339,7 +359,7 @@ namespace Razor
 
 		// Render pass
 		
-		glCullFace(GL_BACK);
+		RenderState::setCullFace(GL_BACK);
 		setViewport(0, 0, framebuffer_size.x, framebuffer_size.y);
 		framebuffer->bind();
 	
@@ -364,12 +384,18 @@ namespace Razor
 
 		skyboxShader->unbind();*/
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RenderState::setBlend(true);
+		RenderState::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		Camera* camera = scene->getActiveCamera();
+		uint32 camera_visible = culler.cull(Frustum::fromMatrix(camera->getProjectionMatrix() * camera->getViewMatrix()));
+
+		s_cameraVisible.set((double)camera_visible);
+		s_cameraCulled.set((double)(culler.getDrawsCount() - camera_visible));
 
 		if (scene->getSceneGraph()->getNodes().size() > 0)
 		{
-			for (auto node : scene->getSceneGraph()->getNodes())
+			for (auto& node : scene->getSceneGraph()->getNodes())
 			{
 				if (node->name == "Terrain")
 				{
@@ -406,7 +432,7 @@ namespace Razor
 					//landscapeShader->setUniformMat4f("view", scene->getActiveCamera()->getViewMatrix());
 					//landscapeShader->setUniformMat4f("projection", scene->getActiveCamera()->getProjectionMatrix());
 			
-					//renderNode(landscapeShader, node, glm::mat4(1.0f));
+					//renderNode(landscapeShader, node);
 
 					//landscapeShader->unbind();
 				}
@@ -433,7 +459,7 @@ namespace Razor
 					defaultShader->bind();
 					defaultMaterial->bindLights(defaultShader, scene->getLights());
 				
-					for (auto light : scene->getLights())
+					for (auto& light : scene->getLights())
 					{
 						switch (light->getType())
 						{
@@ -452,7 +478,7 @@ namespace Razor
 							{
 								for (unsigned int i = 0; i < cascades.size(); i++)
 								{
-									glActiveTexture(GL_TEXTURE3); /// TODO: increment unit slot
+									RenderState::setActiveTexture(3); /// TODO: increment unit slot
 									cascades.at(i)->getDepthTexture()->bind();
 									//blur_attachment->bind();
 									defaultShader->setUniformMat4f("orthoProjectionMatrix", cascades.at(i)->getOrthoProjMatrix());
@@ -469,7 +495,7 @@ namespace Razor
 					defaultShader->setUniformMat4f("view", scene->getActiveCamera()->getViewMatrix());
 					defaultShader->setUniformMat4f("projection", scene->getActiveCamera()->getProjectionMatrix());
 
-					renderNode(defaultShader, node, glm::mat4(1.0f));
+					renderNode(defaultShader, node, false, &culler);
 
 					defaultShader->unbind();
 				}
@@ -478,10 +504,10 @@ namespace Razor
 			//colorbuffer = selection_mask;
 		}
 
-		glDisable(GL_BLEND);
+		RenderState::setBlend(false);
 
-		glBindTexture(GL_TEXTURE_2D, 0);
-		glActiveTexture(GL_TEXTURE0);
+		RenderState::editTexture(GL_TEXTURE_2D, 0);
+		RenderState::setActiveTexture(0);
 
 		gridShader->bind();
 
@@ -500,9 +526,15 @@ namespace Razor
 		framebuffer->unbind();
 	}
 
-	void ForwardRenderer::renderNode(Shader* shader, std::shared_ptr<Node> node, glm::mat4 parent, bool depth)
+	void ForwardRenderer::renderNode(Shader* shader, const std::shared_ptr<Node>& node, bool depth, const FrustumCuller* culler)
 	{
-		glm::mat4 local = parent * node->transform.getMatrix();
+		const glm::mat4& local = node->world;
+		// Nodes added after the gather aren't culled
+		uint32 index = culler != nullptr ? culler->find(node.get()) : CULLING_NONE;
+
+		// Children are inside their parent box, the whole subtree is out
+		if (index != CULLING_NONE && !culler->isVisible(index))
+			return;
 
 
 		if (node->name == "Cube_x")
@@ -518,8 +550,13 @@ namespace Razor
 			);*/
 		}
 
-		for (auto mesh : node->meshes)
+		for (size_t m = 0; m < node->meshes.size(); m++)
 		{
+			const std::shared_ptr<StaticMesh>& mesh = node->meshes[m];
+
+			if (index != CULLING_NONE && !culler->isVisible(index, m))
+				continue;
+
 			//if (mesh->getBoundingMesh() != nullptr && mesh->isBoundingBoxVisible()) // Enable for animation later
 			//	mesh->updateBoundings(node->transform);
 
@@ -548,19 +585,18 @@ namespace Razor
 
 			mesh->getVao()->unbind();
 
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, 0);
+			RenderState::bindTexture(0, GL_TEXTURE_2D, 0);
 		}
 
-		for (auto child : node->nodes)
-			renderNode(shader, child, local);
+		for (auto& child : node->nodes)
+			renderNode(shader, child, depth, culler);
 	}
 
 	void ForwardRenderer::renderParticleSystems()
 	{
 	}
 
-	void ForwardRenderer::renderLineMesh(std::shared_ptr<Node> node, bool isBoundingBox)
+	void ForwardRenderer::renderLineMesh(const std::shared_ptr<Node>& node, bool isBoundingBox)
 	{
 		std::shared_ptr<Scene> scene = scenesManager->getActiveScene();
 
@@ -571,7 +607,7 @@ namespace Razor
 		Transform t;
 		t.setPosition(node->transform.getPosition());
 
-		for (auto mesh : node->meshes)
+		for (auto& mesh : node->meshes)
 		{
 			if (!isBoundingBox)
 			{
@@ -593,7 +629,7 @@ namespace Razor
 			}
 		}
 
-		for (auto n : node->nodes)
+		for (auto& n : node->nodes)
 			renderLineMesh(n, isBoundingBox);
 	}
 
@@ -616,8 +652,8 @@ namespace Razor
 		gridShader->setUniformMat4f("view", scene->getActiveCamera()->getViewMatrix());
 		gridShader->setUniformMat4f("proj", scene->getActiveCamera()->getProjectionMatrix());
 
-		glDisable(GL_CULL_FACE);
-		for (auto node : selection->getNodes())
+		RenderState::setCulling(false);
+		for (auto& node : selection->getNodes())
 		{
 			if (node->meshes.size() > 0)
 			{
@@ -628,12 +664,12 @@ namespace Razor
 				node->meshes[0]->getVao()->unbind();
 			}
 
-			for (auto child : node->nodes)
+			for (auto& child : node->nodes)
 				if (child->meshes.size() > 0)
 					renderChildOutlines(glm::mat4(1.0f), child);
 		}
 
-		glEnable(GL_CULL_FACE);
+		RenderState::setCulling(true);
 		gridShader->unbind();
 		selection_mask->unbind();
 		selection_buffer->unbind();
@@ -646,10 +682,10 @@ namespace Razor
 		outlineShader->setUniform4f("color", outline_color);
 		outlineShader->setUniform1i("width", outline_width);
 
-		glDisable(GL_DEPTH_TEST);
+		RenderState::setDepthTest(false);
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RenderState::setBlend(true);
+		RenderState::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 		glActiveTexture(GL_TEXTURE0);
 		selection_mask->bind();
@@ -658,16 +694,16 @@ namespace Razor
 		quad->draw();
 		quad->getVao()->unbind();
 
-		glDisable(GL_BLEND);
-		glEnable(GL_DEPTH_TEST);
+		RenderState::setBlend(false);
+		RenderState::setDepthTest(true);
 
 		outlineShader->unbind();
 
-		glBindTexture(GL_TEXTURE_2D, 0);
+		RenderState::editTexture(GL_TEXTURE_2D, 0);
 		glActiveTexture(GL_TEXTURE0);*/
 	}
 
-	void ForwardRenderer::renderChildOutlines(const glm::mat4& parent, std::shared_ptr<Node> node)
+	void ForwardRenderer::renderChildOutlines(const glm::mat4& parent, const std::shared_ptr<Node>& node)
 	{
 		glm::mat4 local = parent * node->transform.getMatrix();
 		gridShader->setUniformMat4f("model", local);
@@ -676,7 +712,7 @@ namespace Razor
 		node->meshes[0]->draw();
 		node->meshes[0]->getVao()->unbind();
 
-		for (auto child : node->nodes) 
+		for (auto& child : node->nodes) 
 		{
 			child->transform.setScale(glm::vec3(0.004f));
 
@@ -734,17 +770,17 @@ namespace Razor
 
 	void ForwardRenderer::enableDepthTest()
 	{
-		glEnable(GL_DEPTH_TEST);
+		RenderState::setDepthTest(true);
 	}
 
 	void ForwardRenderer::disableDepthTest()
 	{
-		glDisable(GL_DEPTH_TEST);
+		RenderState::setDepthTest(false);
 	}
 
 	void ForwardRenderer::setViewport(unsigned int x, unsigned int y, float w, float h)
 	{
-		glViewport((GLint)x, (GLint)y, (GLsizei)w, (GLsizei)h);
+		RenderState::setViewport((GLint)x, (GLint)y, (GLsizei)w, (GLsizei)h);
 	}
 
 	void ForwardRenderer::setupShaders()
@@ -805,17 +841,17 @@ namespace Razor
 		std::shared_ptr<Scene> scene = scenesManager->getActiveScene();
 		std::vector<std::shared_ptr<Node>> sorted;
 
-		for (auto node : scene->getSceneGraph()->getNodes())
+		for (auto& node : scene->getSceneGraph()->getNodes())
 			walkRenderGraph(node, sorted);
 	
 		return sorted;
 	}
 
-	void ForwardRenderer::walkRenderGraph(std::shared_ptr<Node> node, std::vector<std::shared_ptr<Node>>& sorted)
+	void ForwardRenderer::walkRenderGraph(const std::shared_ptr<Node>& node, std::vector<std::shared_ptr<Node>>& sorted)
 	{
 		sorted.push_back(node);
 
-		for (auto child : node->nodes)
+		for (auto& child : node->nodes)
 			walkRenderGraph(child, sorted);
 	}
 
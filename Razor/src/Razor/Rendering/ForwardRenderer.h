@@ -7,6 +7,7 @@
 #include "Razor/Lighting/Directional.h"
 #include "Razor/Lighting/Point.h"
 #include "Razor/Materials/Texture.h"
+#include "Razor/Rendering/FrustumCuller.h"
 
 namespace Razor
 {
@@ -49,11 +50,12 @@ namespace Razor
 		void onEvent(Event& event);
 
 		void render();
-		void renderNode(Shader* shader, std::shared_ptr<Node> node, glm::mat4 parent, bool depth = false);
+		// Subtrees and meshes the culler rejects are skipped
+		void renderNode(Shader* shader, const std::shared_ptr<Node>& node, bool depth = false, const FrustumCuller* culler = nullptr);
 		void renderParticleSystems();
-		void renderLineMesh(std::shared_ptr<Node> node, bool isBoundingBox = false);
+		void renderLineMesh(const std::shared_ptr<Node>& node, bool isBoundingBox = false);
 		void renderOutlines();
-		void renderChildOutlines(const glm::mat4& parent, std::shared_ptr<Node> node);
+		void renderChildOutlines(const glm::mat4& parent, const std::shared_ptr<Node>& node);
 		inline static void addBoundingBox(std::shared_ptr<Node> aabb) { bounding_boxes.push_back(aabb); }
 		static void removeBoundingBox(unsigned int node_id);
 
@@ -67,7 +69,7 @@ namespace Razor
 		void setViewport(unsigned int x, unsigned int y, float w, float h);
 		void setupShaders();
 		std::vector<std::shared_ptr<Node>> sortRenderGraph();
-		void walkRenderGraph(std::shared_ptr<Node> node, std::vector<std::shared_ptr<Node>>& sorted);
+		void walkRenderGraph(const std::shared_ptr<Node>& node, std::vector<std::shared_ptr<Node>>& sorted);
 
 		static Shader* defaultShader;
 		static Shader* landscapeShader;;
@@ -180,6 +182,9 @@ namespace Razor
 		ScenesManager* scenesManager;
 		ShadersManager* shadersManager;
 
+		// Gathered once per frame, culled against the cascades and the camera
+		FrustumCuller culler;
+
 		std::shared_ptr<Light> light;
 
 		Shader* blurShader;
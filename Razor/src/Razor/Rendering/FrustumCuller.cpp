@@ -0,0 +1,270 @@
+#include "rzpch.h"
+#include "FrustumCuller.h"
+
+#include "Razor/Scene/Node.h"
+#include "Razor/Scene/SceneGraph.h"
+#include "Razor/Memory/Allocators.h"
+
+#include <immintrin.h>
+
+namespace Razor
+{
+
+	// Merging anything into it gives that box back, and it fails every plane
+	static const AABB s_emptyBox = AABB::fromMinMax(glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()));
+	// Passes every plane
+	static const AABB s_infiniteBox = AABB::fromMinMax(glm::vec3(-std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::max()));
+
+	FrustumCuller::FrustumCuller() :
+		dirty(false)
+	{
+	}
+
+	FrustumCuller::~FrustumCuller()
+	{
+	}
+
+	void FrustumCuller::clear()
+	{
+		nodes.clear();
+		parents.clear();
+		first_mesh.clear();
+		mesh_count.clear();
+		node_boxes.clear();
+		mesh_boxes.clear();
+		composite.clear();
+		std::fill(slots.begin(), slots.end(), CULLING_NONE);
+		dirty = true;
+	}
+
+	uint32 FrustumCuller::add(Node* node, const glm::mat4& world)
+	{
+		uint32 first = (uint32)mesh_boxes.size();
+		AABB box = s_emptyBox;
+
+		for (auto& mesh : node->meshes)
+		{
+			// Instances are placed by their own matrices
+			AABB mesh_box = mesh->getInstances().empty() ? mesh->getLocalBoundingBox().transform(world) : s_infiniteBox;
+
+			mesh_boxes.push_back(mesh_box);
+			box.merge(mesh_box);
+		}
+
+		return push(node, first, box, !node->landscapes.empty());
+	}
+
+	uint32 FrustumCuller::add(Node* node, const glm::mat4& world, const SceneSnapshot::DrawStates& draws)
+	{
+		uint32 first = (uint32)mesh_boxes.size();
+		AABB box = s_emptyBox;
+		bool landscapes = false;
+
+		for (const SceneSnapshot::DrawState& draw : draws)
+		{
+			if (draw.landscape)
+			{
+				landscapes = true;
+				continue;
+			}
+
+			AABB mesh_box = draw.instanced ? s_infiniteBox : draw.bounds.transform(world);
+
+			mesh_boxes.push_back(mesh_box);
+			box.merge(mesh_box);
+		}
+
+		return push(node, first, box, landscapes);
+	}
+
+	uint32 FrustumCuller::push(Node* node, uint32 first, AABB box, bool landscapes)
+	{
+		uint32 index = (uint32)nodes.size();
+		uint32 count = (uint32)mesh_boxes.size() - first;
+
+		nodes.push_back(node);
+		parents.push_back(-1);
+		first_mesh.push_back(first);
+		mesh_count.push_back(count);
+		composite.push_back(count > 1 || landscapes);
+		node_boxes.push_back(landscapes ? s_infiniteBox : box);
+
+		if (node->handle.isValid())
+		{
+			if (node->handle.index >= slots.size())
+				slots.resize(node->handle.index + 1, CULLING_NONE);
+
+			slots[node->handle.index] = index;
+		}
+
+		dirty = true;
+
+		return index;
+	}
+
+	void FrustumCuller::add(SceneGraph* graph)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		const std::vector<SceneGraph::FlatNode>& flat_nodes = graph->getFlatNodes();
+		// Flat node index to culler index
+		FrameVector<int32> indices(flat_nodes.size(), -1, ArenaAllocator<int32>(LinearArena::getFrameArena(), "Culling"));
+
+		for (size_t i = 0; i < flat_nodes.size(); i++)
+		{
+			const SceneGraph::FlatNode& entry = flat_nodes[i];
+
+			// Hidden parents hide their children, they are skipped together
+			if (!entry.visible)
+				continue;
+
+			uint32 index = add(entry.node, entry.node->world);
+			indices[i] = (int32)index;
+
+			if (entry.parent >= 0)
+				parents[index] = indices[entry.parent];
+		}
+	}
+
+	void FrustumCuller::prepare()
+	{
+		// Parents come first, children are merged into them walking backwards
+		for (size_t i = nodes.size(); i-- > 0;)
+		{
+			if (parents[i] >= 0)
+			{
+				node_boxes[parents[i]].merge(node_boxes[i]);
+				composite[parents[i]] = true;
+			}
+		}
+
+		node_bounds.assign(node_boxes);
+		mesh_bounds.assign(mesh_boxes);
+
+		node_visible.resize(nodes.size());
+		mesh_visible.resize(mesh_boxes.size());
+
+		dirty = false;
+	}
+
+	uint32 FrustumCuller::cull(const Frustum& frustum)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		if (dirty)
+			prepare();
+
+		test(frustum, node_bounds, 0, nodes.size(), node_visible.data());
+
+		uint32 visible = 0;
+
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			// Parents were culled before their children, a culled parent culls the subtree
+			if (parents[i] >= 0 && node_visible[parents[i]] == 0)
+				node_visible[i] = 0;
+
+			uint32 first = first_mesh[i];
+			uint32 count = mesh_count[i];
+
+			if (count == 0)
+				continue;
+
+			if (node_visible[i] != 0 && composite[i] != 0)
+				test(frustum, mesh_bounds, first, count, mesh_visible.data());
+			else
+				std::fill(mesh_visible.begin() + first, mesh_visible.begin() + first + count, node_visible[i]);
+
+			for (uint32 m = first; m < first + count; m++)
+				visible += mesh_visible[m];
+		}
+
+		return visible;
+	}
+
+	uint32 FrustumCuller::find(Node* node) const
+	{
+		if (!node->handle.isValid() || node->handle.index >= slots.size())
+			return CULLING_NONE;
+
+		uint32 index = slots[node->handle.index];
+
+		return index != CULLING_NONE && nodes[index] == node ? index : CULLING_NONE;
+	}
+
+	void FrustumCuller::test(const Frustum& frustum, const Bounds& bounds, size_t first, size_t count, uint8* visible)
+	{
+		for (size_t i = first; i < first + count; i += CULLING_LANES)
+		{
+#ifdef __AVX__
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+			for (auto& plane : frustum.planes)
+			{
+				// Corner of each box furthest along the plane normal
+				__m256 x = _mm256_loadu_ps(&(plane.x >= 0.0f ? bounds.max_x : bounds.min_x)[i]);
+				__m256 y = _mm256_loadu_ps(&(plane.y >= 0.0f ? bounds.max_y : bounds.min_y)[i]);
+				__m256 z = _mm256_loadu_ps(&(plane.z >= 0.0f ? bounds.max_z : bounds.min_z)[i]);
+
+				__m256 distance = _mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.x)), _mm256_mul_ps(y, _mm256_set1_ps(plane.y))),
+					_mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w))
+				);
+
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+			}
+
+			int mask = _mm256_movemask_ps(inside);
+#else
+			__m128 inside = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+
+			for (auto& plane : frustum.planes)
+			{
+				// Corner of each box furthest along the plane normal
+				__m128 x = _mm_loadu_ps(&(plane.x >= 0.0f ? bounds.max_x : bounds.min_x)[i]);
+				__m128 y = _mm_loadu_ps(&(plane.y >= 0.0f ? bounds.max_y : bounds.min_y)[i]);
+				__m128 z = _mm_loadu_ps(&(plane.z >= 0.0f ? bounds.max_z : bounds.min_z)[i]);
+
+				__m128 distance = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+					_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w))
+				);
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+			}
+
+			int mask = _mm_movemask_ps(inside);
+#endif
+
+			// The lanes past the range belong to other nodes or to the padding
+			size_t lanes = std::min((size_t)CULLING_LANES, first + count - i);
+
+			for (size_t lane = 0; lane < lanes; lane++)
+				visible[i + lane] = (uint8)((mask >> lane) & 1);
+		}
+	}
+
+	void FrustumCuller::Bounds::assign(const std::vector<AABB>& boxes)
+	{
+		// Padded so the last loads of a range stay in the arrays
+		size_t size = boxes.size() + CULLING_LANES;
+
+		min_x.resize(size, 0.0f);
+		max_x.resize(size, 0.0f);
+		min_y.resize(size, 0.0f);
+		max_y.resize(size, 0.0f);
+		min_z.resize(size, 0.0f);
+		max_z.resize(size, 0.0f);
+
+		for (size_t i = 0; i < boxes.size(); i++)
+		{
+			min_x[i] = boxes[i].min_x;
+			max_x[i] = boxes[i].max_x;
+			min_y[i] = boxes[i].min_y;
+			max_y[i] = boxes[i].max_y;
+			min_z[i] = boxes[i].min_z;
+			max_z[i] = boxes[i].max_z;
+		}
+	}
+
+}
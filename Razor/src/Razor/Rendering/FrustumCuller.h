@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+#include "Razor/Maths/Frustum.h"
+#include "Razor/Scene/SceneSnapshot.h"
+
+// Boxes tested per instruction, the bounds arrays are padded to it
+#ifdef __AVX__
+	#define CULLING_LANES 8
+#else
+	#define CULLING_LANES 4
+#endif
+// Node not added to the culler
+#define CULLING_NONE 0xffffffff
+
+namespace Razor
+{
+
+	class Node;
+	class SceneGraph;
+
+	// Frustum culling of the draws of a pass. Bounds are gathered once in
+	// structure of arrays form and tested CULLING_LANES boxes at a time, so one
+	// gather can be culled against several frustums (camera, shadow cascades).
+	//
+	// Culling is hierarchical: a node box covers its meshes and its children,
+	// a node outside the frustum culls its whole subtree, the meshes of a
+	// visible node are only tested when its box covers more than one mesh.
+	// Landscapes and instanced meshes can't be bounded, they always pass.
+	class FrustumCuller
+	{
+	public:
+		FrustumCuller();
+		~FrustumCuller();
+
+		void clear();
+		// Adds a node alone, children included by their parent aren't added
+		uint32 add(Node* node, const glm::mat4& world);
+		// Same from the draws captured in a scene snapshot, the live meshes aren't read
+		uint32 add(Node* node, const glm::mat4& world, const SceneSnapshot::DrawStates& draws);
+		// Adds every visible node of the graph, parents first, findable by handle
+		void add(SceneGraph* graph);
+
+		// Returns the number of visible draws (meshes)
+		uint32 cull(const Frustum& frustum);
+
+		uint32 find(Node* node) const;
+		inline bool isVisible(uint32 node) const { return node_visible[node] != 0; }
+		inline bool isVisible(uint32 node, size_t mesh) const { return mesh_visible[first_mesh[node] + mesh] != 0; }
+		inline size_t getNodesCount() const { return nodes.size(); }
+		inline size_t getDrawsCount() const { return mesh_boxes.size(); }
+
+	private:
+		struct Bounds
+		{
+			std::vector<float> min_x;
+			std::vector<float> max_x;
+			std::vector<float> min_y;
+			std::vector<float> max_y;
+			std::vector<float> min_z;
+			std::vector<float> max_z;
+
+			void assign(const std::vector<AABB>& boxes);
+		};
+
+		static void test(const Frustum& frustum, const Bounds& bounds, size_t first, size_t count, uint8* visible);
+		// Registers a node whose meshes were pushed since first
+		uint32 push(Node* node, uint32 first, AABB box, bool landscapes);
+		void prepare();
+
+		std::vector<Node*> nodes;
+		std::vector<int32> parents;
+		std::vector<uint32> first_mesh;
+		std::vector<uint32> mesh_count;
+		// Node boxes grow with their subtree in prepare()
+		std::vector<AABB> node_boxes;
+		std::vector<AABB> mesh_boxes;
+		// Nodes whose box is bigger than their only mesh
+		std::vector<uint8> composite;
+		Bounds node_bounds;
+		Bounds mesh_bounds;
+		bool dirty;
+
+		std::vector<uint8> node_visible;
+		std::vector<uint8> mesh_visible;
+		// Node handle index to culler index
+		std::vector<uint32> slots;
+	};
+
+}
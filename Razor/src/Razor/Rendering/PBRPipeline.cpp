@@ -6,6 +6,7 @@
 #include "Razor/Materials/ShadersManager.h"
 #include "Razor/Materials/EnvironmentTexture.h"
 #include "Razor/Geometry/Geometry.h"
+#include "Razor/Rendering/RenderState.h"
 
 namespace Razor
 {
@@ -62,8 +63,8 @@ namespace Razor
 		glGenFramebuffers(1, &frame_buffer);
 		glGenRenderbuffers(1, &render_buffer);
 
-		glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
-		glBindRenderbuffer(GL_RENDERBUFFER, render_buffer);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+		RenderState::bindRenderbuffer(render_buffer);
 		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32, 512, 512);
 		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, render_buffer);
 
@@ -74,7 +75,7 @@ namespace Razor
 	void PBRPipeline::setup_environment_map()
 	{
 		glGenTextures(1, &env_cubemap);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, env_cubemap);
+		RenderState::editTexture(GL_TEXTURE_CUBE_MAP, env_cubemap);
 
 		for (unsigned int i = 0; i < 6; ++i)
 			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
@@ -117,11 +118,10 @@ namespace Razor
 		shader_cubemap->setUniform1i("equirectangularMap", 0);
 		shader_cubemap->setUniformMat4f("projection", capture_projection);
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, env_texture->getId());
+		RenderState::bindTexture(0, GL_TEXTURE_2D, env_texture->getId());
 		
-		glViewport(0, 0, 512, 512);
-		glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+		RenderState::setViewport(0, 0, 512, 512);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
 
 		for (unsigned int i = 0; i < 6; ++i)
 		{
@@ -133,15 +133,15 @@ namespace Razor
 			cube->draw();
 		}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, env_cubemap);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::editTexture(GL_TEXTURE_CUBE_MAP, env_cubemap);
 		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 	}
 
 	void PBRPipeline::create_irradiance_cubemap()
 	{
 		glGenTextures(1, &irradiance_map);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, irradiance_map);
+		RenderState::editTexture(GL_TEXTURE_CUBE_MAP, irradiance_map);
 
 		for (unsigned int i = 0; i < 6; ++i)
 			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
@@ -152,8 +152,8 @@ namespace Razor
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
-		glBindRenderbuffer(GL_RENDERBUFFER, render_buffer);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+		RenderState::bindRenderbuffer(render_buffer);
 		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32, 32, 32);
 	}
 
@@ -163,11 +163,10 @@ namespace Razor
 		shader_irradiance->setUniform1i("environmentMap", 0);
 		shader_irradiance->setUniformMat4f("projection", capture_projection);
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, env_cubemap);
+		RenderState::bindTexture(0, GL_TEXTURE_CUBE_MAP, env_cubemap);
 
-		glViewport(0, 0, 32, 32);
-		glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+		RenderState::setViewport(0, 0, 32, 32);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
 
 		for (unsigned int i = 0; i < 6; ++i)
 		{
@@ -179,13 +178,13 @@ namespace Razor
 			cube->draw();
 		}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 	void PBRPipeline::create_prefilter_cubemap()
 	{
 		glGenTextures(1, &prefilter_map);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, prefilter_map);
+		RenderState::editTexture(GL_TEXTURE_CUBE_MAP, prefilter_map);
 
 		for (unsigned int i = 0; i < 6; ++i)
 			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
@@ -204,10 +203,9 @@ namespace Razor
 		shader_prefilter->bind();
 		shader_prefilter->setUniform1i("environmentMap", 0);
 		shader_prefilter->setUniformMat4f("projection", capture_projection);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, env_cubemap);
+		RenderState::bindTexture(0, GL_TEXTURE_CUBE_MAP, env_cubemap);
 
-		glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
 		unsigned int maxMipLevels = 5;
 
 		for (unsigned int mip = 0; mip < maxMipLevels; ++mip)
@@ -215,9 +213,9 @@ namespace Razor
 			unsigned int mipWidth = 128 * std::pow(0.5, mip);
 			unsigned int mipHeight = 128 * std::pow(0.5, mip);
 
-			glBindRenderbuffer(GL_RENDERBUFFER, render_buffer);
+			RenderState::bindRenderbuffer(render_buffer);
 			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32, mipWidth, mipHeight);
-			glViewport(0, 0, mipWidth, mipHeight);
+			RenderState::setViewport(0, 0, mipWidth, mipHeight);
 
 			float roughness = (float)mip / (float)(maxMipLevels - 1);
 			shader_prefilter->setUniform1f("roughness", roughness);
@@ -234,7 +232,7 @@ namespace Razor
 			}
 		}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 	void PBRPipeline::generate_lut_from_brdf()
@@ -242,7 +240,7 @@ namespace Razor
 		glGenTextures(1, &brdfLUTTexture);
 
 		// pre-allocate enough memory for the LUT texture.
-		glBindTexture(GL_TEXTURE_2D, brdfLUTTexture);
+		RenderState::editTexture(GL_TEXTURE_2D, brdfLUTTexture);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, 512, 512, 0, GL_RG, GL_FLOAT, 0);
 		// be sure to set wrapping mode to GL_CLAMP_TO_EDGE
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -251,19 +249,19 @@ namespace Razor
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 		// then re-configure capture framebuffer object and render screen-space quad with BRDF shader.
-		glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
-		glBindRenderbuffer(GL_RENDERBUFFER, render_buffer);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+		RenderState::bindRenderbuffer(render_buffer);
 		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, brdfLUTTexture, 0);
 
-		glViewport(0, 0, 512, 512);
+		RenderState::setViewport(0, 0, 512, 512);
 		shader_brdf->bind();
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		quad->getVao()->bind();
 		quad->draw();
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 }
\ No newline at end of file
@@ -0,0 +1,365 @@
+#include "rzpch.h"
+#include "RenderQueue.h"
+
+#include "Razor/Core/Metrics.h"
+#include "Razor/Scene/Node.h"
+#include "Razor/Scene/FrameSnapshot.h"
+
+#define RENDER_KEY_MASK(bits) ((1u << (bits)) - 1)
+
+namespace Razor
+{
+
+	static_assert(
+		RENDER_KEY_LAYER_BITS + 1 + RENDER_KEY_SHADER_BITS + RENDER_KEY_MATERIAL_BITS +
+		RENDER_KEY_TEXTURES_BITS + RENDER_KEY_VAO_BITS + RENDER_KEY_DEPTH_BITS == 64,
+		"Render key fields don't fill 64 bits"
+	);
+	static_assert(64 % RENDER_QUEUE_RADIX_BITS == 0, "Radix passes must cover the whole key");
+
+	RenderQueue::RenderQueue() :
+		items(),
+		scratch(),
+		draws(),
+		shaders(),
+		slots(nullptr),
+		heap_slots()
+	{
+		clear();
+	}
+
+	RenderQueue::Slots::Slots(LinearArena* arena) :
+		shaders(ArenaAllocator<uint8>(arena, "RenderQueue")),
+		vaos(ArenaAllocator<uint8>(arena, "RenderQueue")),
+		materials(ArenaAllocator<uint8>(arena, "RenderQueue")),
+		textures(ArenaAllocator<uint8>(arena, "RenderQueue"))
+	{
+	}
+
+	RenderQueue::~RenderQueue()
+	{
+	}
+
+	void RenderQueue::build(const FrameSnapshot& snapshot)
+	{
+		RZ_PROFILE_SCOPE("BuildRenderQueue");
+
+		static Histogram& s_sortTime = Metrics::histogram("renderer.queue_sort_time", "us", "Time spent sorting the render queue");
+
+		clear();
+
+		const glm::mat4& view = snapshot.getCamera().view;
+		const std::vector<FrameSnapshot::NodeState>& nodes = snapshot.getNodes();
+		const SceneSnapshot* scene = snapshot.getSceneSnapshot();
+
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			if (scene == nullptr)
+			{
+				add(nodes[i].node, (uint32)i, view, nodes[i].world);
+				continue;
+			}
+
+			const SceneSnapshot::NodeRecord* record = scene->getNode(nodes[i].handle);
+
+			if (record != nullptr && record->draws != nullptr)
+				add(*record->draws, nodes[i].node, (uint32)i, view, nodes[i].world);
+		}
+
+		uint64 start = TraceProfiler::now();
+		sort();
+		s_sortTime.record((TraceProfiler::now() - start) / 1000);
+
+		count();
+	}
+
+	void RenderQueue::add(Node* node, uint32 state, const glm::mat4& view, const glm::mat4& world)
+	{
+		// Distance along the view axis of the node origin, negative behind the camera
+		float depth = -(view * world[3]).z;
+
+		for (size_t m = 0; m < node->meshes.size(); m++)
+		{
+			const std::shared_ptr<StaticMesh>& mesh = node->meshes[m];
+
+			DrawData data = {};
+			data.node         = node;
+			data.mesh         = mesh.get();
+			data.vao          = mesh->getVao();
+			data.shader       = shaders[Shader::Type::DEFAULT]; // TODO: Get from material.
+			data.material     = mesh->getMaterial().get();
+			data.draw_mode    = mesh->getDrawMode();
+			data.vertex_count = (uint32)mesh->getVertexCount();
+			data.index_count  = (uint32)mesh->getIndices().size();
+			data.state        = state;
+			data.mesh_index   = (uint32)m;
+			data.category     = RenderCategory::OBJECT;
+			data.depth_pass   = mesh->isReceivingShadows();
+			data.transparent  = data.material != nullptr && data.material->hasOpacityMap();
+
+			add(data, depth);
+		}
+
+		for (auto& landscape : node->landscapes)
+		{
+			const std::shared_ptr<StaticMesh>& mesh = landscape->getMesh();
+
+			DrawData data = {};
+			data.node         = node;
+			data.mesh         = mesh.get();
+			data.vao          = mesh->getVao();
+			data.shader       = shaders[Shader::Type::LANDSCAPE];
+			data.material     = mesh->getMaterial().get();
+			data.draw_mode    = mesh->getDrawMode();
+			data.vertex_count = (uint32)mesh->getVertexCount();
+			data.index_count  = (uint32)mesh->getIndices().size();
+			data.state        = state;
+			data.category     = RenderCategory::LANDSCAPE;
+			data.depth_pass   = mesh->isReceivingShadows();
+			data.transparent  = false;
+
+			add(data, depth);
+		}
+	}
+
+	void RenderQueue::add(const SceneSnapshot::DrawStates& draws, Node* node, uint32 state, const glm::mat4& view, const glm::mat4& world)
+	{
+		float depth = -(view * world[3]).z;
+		uint32 mesh_index = 0;
+
+		for (const SceneSnapshot::DrawState& draw : draws)
+		{
+			DrawData data = {};
+			data.node         = node;
+			data.mesh         = draw.mesh.get();
+			data.vao          = draw.vao;
+			data.shader       = shaders[draw.landscape ? Shader::Type::LANDSCAPE : Shader::Type::DEFAULT];
+			data.material     = draw.material.get();
+			data.draw_mode    = draw.draw_mode;
+			data.vertex_count = draw.vertex_count;
+			data.index_count  = draw.index_count;
+			data.state        = state;
+			// Same index as the mesh in the culler, landscapes aren't in it
+			data.mesh_index   = draw.landscape ? 0 : mesh_index++;
+			data.category     = draw.landscape ? RenderCategory::LANDSCAPE : RenderCategory::OBJECT;
+			data.depth_pass   = draw.receives_shadows;
+			data.transparent  = draw.transparent;
+
+			add(data, depth);
+		}
+	}
+
+	void RenderQueue::add(const DrawData& data, float depth)
+	{
+		const MaterialSlot& material = getMaterialSlot(data.material);
+
+		DrawItem item;
+		item.index = (uint32)draws.size();
+		item.key = makeKey(
+			data.category,
+			data.transparent,
+			getSlot(slots->shaders, data.shader),
+			material.material,
+			material.textures,
+			getSlot(slots->vaos, data.vao),
+			depth
+		);
+
+		draws.push_back(data);
+		draws.back().textures = material.hash;
+		draws.back().texture_count = material.texture_count;
+
+		items.push_back(item);
+	}
+
+	void RenderQueue::sort()
+	{
+		RZ_PROFILE_FUNCTION();
+
+		const size_t size = items.size();
+
+		if (size < 2)
+			return;
+
+		constexpr uint32 passes = 64 / RENDER_QUEUE_RADIX_BITS;
+		constexpr uint64 mask = RENDER_KEY_MASK(RENDER_QUEUE_RADIX_BITS);
+
+		// Every pass histogram in a single read of the keys
+		std::array<std::array<uint32, 1 << RENDER_QUEUE_RADIX_BITS>, passes> histograms = {};
+
+		for (const DrawItem& item : items)
+		{
+			for (uint32 pass = 0; pass < passes; pass++)
+				histograms[pass][(item.key >> (pass * RENDER_QUEUE_RADIX_BITS)) & mask]++;
+		}
+
+		scratch.resize(size);
+
+		DrawItem* source = items.data();
+		DrawItem* destination = scratch.data();
+
+		for (uint32 pass = 0; pass < passes; pass++)
+		{
+			const uint32 shift = pass * RENDER_QUEUE_RADIX_BITS;
+			std::array<uint32, 1 << RENDER_QUEUE_RADIX_BITS>& histogram = histograms[pass];
+
+			// Every key has the same digit, the pass wouldn't move anything
+			if (histogram[(source[0].key >> shift) & mask] == size)
+				continue;
+
+			uint32 offset = 0;
+
+			for (uint32& bucket : histogram)
+			{
+				uint32 count = bucket;
+				bucket = offset;
+				offset += count;
+			}
+
+			// Scattering in order keeps the sort stable, equal keys stay in submission order
+			for (size_t i = 0; i < size; i++)
+				destination[histogram[(source[i].key >> shift) & mask]++] = source[i];
+
+			std::swap(source, destination);
+		}
+
+		if (source != items.data())
+			items.swap(scratch);
+	}
+
+	void RenderQueue::clear()
+	{
+		items.clear();
+		draws.clear();
+
+		LinearArena* arena = LinearArena::getFrameArena();
+
+		if (arena != nullptr)
+			slots = arena->create<Slots>(arena);
+		else
+		{
+			heap_slots = std::make_unique<Slots>(nullptr);
+			slots = heap_slots.get();
+		}
+	}
+
+	uint64 RenderQueue::makeKey(RenderCategory category, bool transparent, uint32 shader, uint32 material, uint32 textures, uint32 vao, float depth)
+	{
+		uint32 distance = (uint32)(glm::clamp(depth / RENDER_QUEUE_DEPTH_RANGE, 0.0f, 1.0f) * (float)RENDER_KEY_MASK(RENDER_KEY_DEPTH_BITS));
+
+		uint64 key = std::min((uint32)category, RENDER_KEY_MASK(RENDER_KEY_LAYER_BITS));
+		key = (key << 1) | (transparent ? 1 : 0);
+
+		// Blending needs the furthest draws first, state only breaks depth ties
+		if (transparent)
+			key = (key << RENDER_KEY_DEPTH_BITS) | (RENDER_KEY_MASK(RENDER_KEY_DEPTH_BITS) - distance);
+
+		key = (key << RENDER_KEY_SHADER_BITS) | std::min(shader, RENDER_KEY_MASK(RENDER_KEY_SHADER_BITS));
+		key = (key << RENDER_KEY_MATERIAL_BITS) | std::min(material, RENDER_KEY_MASK(RENDER_KEY_MATERIAL_BITS));
+		key = (key << RENDER_KEY_TEXTURES_BITS) | std::min(textures, RENDER_KEY_MASK(RENDER_KEY_TEXTURES_BITS));
+		key = (key << RENDER_KEY_VAO_BITS) | std::min(vao, RENDER_KEY_MASK(RENDER_KEY_VAO_BITS));
+
+		// Opaque draws front to back within a state, the depth test rejects more fragments
+		if (!transparent)
+			key = (key << RENDER_KEY_DEPTH_BITS) | distance;
+
+		return key;
+	}
+
+	uint32 RenderQueue::getSlot(FrameUnorderedMap<const void*, uint32>& slots, const void* object)
+	{
+		auto it = slots.find(object);
+
+		if (it != slots.end())
+			return it->second;
+
+		uint32 slot = (uint32)slots.size();
+		slots[object] = slot;
+
+		return slot;
+	}
+
+	const RenderQueue::MaterialSlot& RenderQueue::getMaterialSlot(Material* material)
+	{
+		auto it = slots->materials.find(material);
+
+		if (it != slots->materials.end())
+			return it->second;
+
+		MaterialSlot slot = {};
+		slot.material = (uint32)slots->materials.size();
+
+		if (material != nullptr)
+		{
+			// FNV-1a of the bound texture ids, materials sharing textures share a slot
+			uint64 hash = 14695981039346656037ull;
+
+			for (auto& texture : material->getTexturesMaps())
+			{
+				if (texture.second == 0)
+					continue;
+
+				hash = (hash ^ (uint64)texture.first) * 1099511628211ull;
+				hash = (hash ^ (uint64)texture.second) * 1099511628211ull;
+				slot.texture_count++;
+			}
+
+			slot.hash = slot.texture_count > 0 ? hash : 0;
+		}
+
+		auto texture = slots->textures.find(slot.hash);
+
+		if (texture == slots->textures.end())
+		{
+			slot.textures = (uint32)slots->textures.size();
+			slots->textures[slot.hash] = slot.textures;
+		}
+		else
+			slot.textures = texture->second;
+
+		return slots->materials.emplace(material, slot).first->second;
+	}
+
+	void RenderQueue::count()
+	{
+		static Counter& s_programBinds = Metrics::counter("renderer.program_binds_avoided", "Program binds saved by sorting compared to submission order");
+		static Counter& s_vaoBinds = Metrics::counter("renderer.vao_binds_avoided", "VAO binds saved by sorting compared to submission order");
+		static Counter& s_textureBinds = Metrics::counter("renderer.texture_binds_avoided", "Texture binds saved by sorting compared to submission order");
+
+		// Binds a frame issues when only changed state is bound
+		struct Binds
+		{
+			uint64 programs = 0;
+			uint64 vaos = 0;
+			uint64 textures = 0;
+			const DrawData* last = nullptr;
+
+			void add(const DrawData& draw)
+			{
+				if (last == nullptr || last->shader != draw.shader)
+					programs++;
+
+				if (last == nullptr || last->vao != draw.vao)
+					vaos++;
+
+				if (last == nullptr || last->textures != draw.textures)
+					textures += draw.texture_count;
+
+				last = &draw;
+			}
+		};
+
+		Binds naive, sorted;
+
+		for (const DrawData& draw : draws)
+			naive.add(draw);
+
+		for (const DrawItem& item : items)
+			sorted.add(draws[item.index]);
+
+		s_programBinds.add(naive.programs > sorted.programs ? naive.programs - sorted.programs : 0);
+		s_vaoBinds.add(naive.vaos > sorted.vaos ? naive.vaos - sorted.vaos : 0);
+		s_textureBinds.add(naive.textures > sorted.textures ? naive.textures - sorted.textures : 0);
+	}
+
+}
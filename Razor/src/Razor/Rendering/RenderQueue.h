@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Razor/Materials/Shader.h"
+#include "Razor/Materials/Material.h"
+#include "Razor/Geometry/StaticMesh.h"
+#include "Razor/Memory/Allocators.h"
+#include "Razor/Scene/SceneSnapshot.h"
+#include <glm/glm.hpp>
+
+// Sort key fields, most significant first. Opaque draws are grouped by state
+// then sorted front to back, transparent ones back to front then by state:
+// [layer 4][transparent 1][shader 8][material 12][textures 12][vao 12][depth 15]
+// [layer 4][transparent 1][depth 15][shader 8][material 12][textures 12][vao 12]
+#define RENDER_KEY_LAYER_BITS 4
+#define RENDER_KEY_SHADER_BITS 8
+#define RENDER_KEY_MATERIAL_BITS 12
+#define RENDER_KEY_TEXTURES_BITS 12
+#define RENDER_KEY_VAO_BITS 12
+#define RENDER_KEY_DEPTH_BITS 15
+// View distance mapped to the depth bits, further draws share the last value
+#define RENDER_QUEUE_DEPTH_RANGE 1024.0f
+#define RENDER_QUEUE_RADIX_BITS 8
+
+namespace Razor
+{
+
+	class Node;
+	class VertexArray;
+	class FrameSnapshot;
+
+	// Draws of a frame, built from a snapshot. Items are a 64 bit key and the
+	// index of their draw data, sorting them with a stable radix sort orders the
+	// frame so consecutive draws share as much GL state as possible. Doesn't
+	// touch the GPU so it can be filled and sorted without a context.
+	class RenderQueue
+	{
+	public:
+		RenderQueue();
+		~RenderQueue();
+
+		// Draw order of the layers
+		enum class RenderCategory : uint8
+		{
+			LANDSCAPE,
+			OBJECT,
+			FOLIAGE,
+			SKYBOX,
+			PARTICLE,
+			UI
+		};
+
+		struct DrawItem
+		{
+			uint64 key;
+			uint32 index;
+		};
+
+		// Everything needed to submit the draw, indexed by DrawItem::index
+		struct DrawData
+		{
+			Node* node;
+			StaticMesh* mesh;
+			VertexArray* vao;
+			Shader* shader;
+			Material* material;
+			StaticMesh::DrawMode draw_mode;
+			uint32 vertex_count;
+			uint32 index_count;
+			// Index of the node state in the snapshot
+			uint32 state;
+			// Index of the mesh in its node
+			uint32 mesh_index;
+			// Hash of the textures bound by the material, 0 without any
+			uint64 textures;
+			uint8 texture_count;
+			RenderCategory category;
+			bool depth_pass;
+			bool transparent;
+		};
+
+		// Clears, adds every captured node, sorts and updates the bind counters.
+		// Draws come from the scene snapshot of the frame, from the live nodes
+		// for snapshots captured without one.
+		void build(const FrameSnapshot& snapshot);
+		void add(Node* node, uint32 state, const glm::mat4& view, const glm::mat4& world);
+		void add(const SceneSnapshot::DrawStates& draws, Node* node, uint32 state, const glm::mat4& view, const glm::mat4& world);
+		void add(const DrawData& data, float depth);
+		void sort();
+		void clear();
+
+		static uint64 makeKey(RenderCategory category, bool transparent, uint32 shader, uint32 material, uint32 textures, uint32 vao, float depth);
+
+		inline void setShader(Shader::Type type, Shader* shader) { shaders[type] = shader; }
+
+		inline bool empty() const { return items.empty(); }
+		inline size_t size() const { return items.size(); }
+		inline const std::vector<DrawItem>& getItems() const { return items; }
+		inline const DrawData& getData(const DrawItem& item) const { return draws[item.index]; }
+
+	private:
+		// Dense ids given in order of first use, the pointers don't fit in the key.
+		// Ids past the field width share the last value, the binds still compare
+		// the real objects so only the ordering degrades.
+		struct MaterialSlot
+		{
+			uint32 material;
+			uint32 textures;
+			uint64 hash;
+			uint8 texture_count;
+		};
+
+		// Slot maps of a build, allocated in the frame arena of the frame the
+		// queue was cleared in and dropped with it
+		struct Slots
+		{
+			Slots(LinearArena* arena);
+
+			FrameUnorderedMap<const void*, uint32> shaders;
+			FrameUnorderedMap<const void*, uint32> vaos;
+			FrameUnorderedMap<const Material*, MaterialSlot> materials;
+			FrameUnorderedMap<uint64, uint32> textures;
+		};
+
+		static uint32 getSlot(FrameUnorderedMap<const void*, uint32>& slots, const void* object);
+		const MaterialSlot& getMaterialSlot(Material* material);
+		void count();
+
+		std::vector<DrawItem> items;
+		std::vector<DrawItem> scratch;
+		std::vector<DrawData> draws;
+		std::unordered_map<Shader::Type, Shader*> shaders;
+
+		Slots* slots;
+		// Slots of builds outside of the game loop, without a frame arena
+		std::unique_ptr<Slots> heap_slots;
+	};
+
+}
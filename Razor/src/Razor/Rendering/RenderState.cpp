@@ -0,0 +1,490 @@
+#include "rzpch.h"
+#include "RenderState.h"
+
+#include "Razor/Core/Metrics.h"
+
+#include <glad/glad.h>
+
+#ifdef RZ_RENDER_STATE_VALIDATION
+	// Elided only when the driver agrees with the cache
+	#define RENDER_STATE_CHECK(matches, query) check(matches, query)
+#else
+	#define RENDER_STATE_CHECK(matches, query) true
+#endif
+
+namespace Razor
+{
+
+	static const uint32 s_bufferTargets[RENDER_STATE_BUFFER_TARGETS] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER };
+	static const uint32 s_bufferBindings[RENDER_STATE_BUFFER_TARGETS] = { GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_UNIFORM_BUFFER_BINDING, GL_SHADER_STORAGE_BUFFER_BINDING };
+	static const uint32 s_blockTargets[RENDER_STATE_BLOCK_TARGETS] = { GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER };
+	static const uint32 s_blockBindings[RENDER_STATE_BLOCK_TARGETS] = { GL_UNIFORM_BUFFER_BINDING, GL_SHADER_STORAGE_BUFFER_BINDING };
+	// Slot of GL_ELEMENT_ARRAY_BUFFER, bound per vertex array
+	static const uint32 s_elementBufferSlot = 1;
+	static const uint32 s_textureTargets[RENDER_STATE_TEXTURE_TARGETS] = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_MULTISAMPLE };
+	static const uint32 s_textureBindings[RENDER_STATE_TEXTURE_TARGETS] = { GL_TEXTURE_BINDING_2D, GL_TEXTURE_BINDING_CUBE_MAP, GL_TEXTURE_BINDING_2D_MULTISAMPLE };
+
+	RenderState::Cache RenderState::s_cache;
+	uint64 RenderState::s_forwarded = 0;
+	uint64 RenderState::s_elided = 0;
+
+	static int32 getSlot(const uint32* targets, uint32 count, uint32 target)
+	{
+		for (uint32 i = 0; i < count; i++)
+		{
+			if (targets[i] == target)
+				return (int32)i;
+		}
+
+		return -1;
+	}
+
+#ifdef RZ_RENDER_STATE_VALIDATION
+	static uint32 getInteger(uint32 query)
+	{
+		GLint value = 0;
+		glGetIntegerv(query, &value);
+
+		return (uint32)value;
+	}
+
+	static uint32 getIndexedInteger(uint32 query, uint32 index)
+	{
+		GLint value = 0;
+		glGetIntegeri_v(query, index, &value);
+
+		return (uint32)value;
+	}
+
+	// Binding queries answer for the active unit
+	static uint32 getTextureInteger(uint32 unit, uint32 query)
+	{
+		GLint active = 0;
+		glGetIntegerv(GL_ACTIVE_TEXTURE, &active);
+
+		glActiveTexture(GL_TEXTURE0 + unit);
+		uint32 value = getInteger(query);
+		glActiveTexture(active);
+
+		return value;
+	}
+
+	static bool check(bool matches, uint32 query)
+	{
+		if (!matches)
+			Log::error("RenderState: Cache of 0x%04x is stale, a GL call went around it", query);
+
+		return matches;
+	}
+#endif
+
+	RenderState::Cache::Cache()
+	{
+		// 0xff bytes give RENDER_STATE_UNKNOWN, -1 and NaN
+		memset(this, 0xff, sizeof(Cache));
+	}
+
+	void RenderState::useProgram(uint32 program)
+	{
+		if (changed(s_cache.program, program, GL_CURRENT_PROGRAM))
+			glUseProgram(program);
+	}
+
+	void RenderState::bindVertexArray(uint32 vao)
+	{
+		if (changed(s_cache.vao, vao, GL_VERTEX_ARRAY_BINDING))
+		{
+			glBindVertexArray(vao);
+
+			// The element buffer binding is part of the vertex array
+			s_cache.buffers[s_elementBufferSlot] = RENDER_STATE_UNKNOWN;
+		}
+	}
+
+	void RenderState::bindBuffer(uint32 target, uint32 buffer)
+	{
+		int32 slot = getSlot(s_bufferTargets, RENDER_STATE_BUFFER_TARGETS, target);
+
+		if (slot < 0)
+		{
+			s_forwarded++;
+			glBindBuffer(target, buffer);
+		}
+		else if (changed(s_cache.buffers[slot], buffer, s_bufferBindings[slot]))
+			glBindBuffer(target, buffer);
+	}
+
+	void RenderState::bindBufferBase(uint32 target, uint32 index, uint32 buffer)
+	{
+		int32 slot = getSlot(s_blockTargets, RENDER_STATE_BLOCK_TARGETS, target);
+
+		if (slot >= 0 && index < RENDER_STATE_BLOCK_BINDINGS && s_cache.blocks[slot][index] == buffer &&
+			RENDER_STATE_CHECK(getIndexedInteger(s_blockBindings[slot], index) == buffer, s_blockBindings[slot]))
+		{
+			s_elided++;
+			return;
+		}
+
+		if (slot >= 0 && index < RENDER_STATE_BLOCK_BINDINGS)
+			s_cache.blocks[slot][index] = buffer;
+
+		int32 generic = getSlot(s_bufferTargets, RENDER_STATE_BUFFER_TARGETS, target);
+
+		if (generic >= 0)
+			s_cache.buffers[generic] = buffer;
+
+		s_forwarded++;
+		glBindBufferBase(target, index, buffer);
+	}
+
+	void RenderState::bindFramebuffer(uint32 target, uint32 framebuffer)
+	{
+		bool read = target != GL_DRAW_FRAMEBUFFER;
+		bool draw = target != GL_READ_FRAMEBUFFER;
+
+		if ((!read || (s_cache.read_framebuffer == framebuffer && RENDER_STATE_CHECK(getInteger(GL_READ_FRAMEBUFFER_BINDING) == framebuffer, GL_READ_FRAMEBUFFER_BINDING))) &&
+			(!draw || (s_cache.draw_framebuffer == framebuffer && RENDER_STATE_CHECK(getInteger(GL_DRAW_FRAMEBUFFER_BINDING) == framebuffer, GL_DRAW_FRAMEBUFFER_BINDING))))
+		{
+			s_elided++;
+			return;
+		}
+
+		if (read)
+			s_cache.read_framebuffer = framebuffer;
+
+		if (draw)
+			s_cache.draw_framebuffer = framebuffer;
+
+		s_forwarded++;
+		glBindFramebuffer(target, framebuffer);
+	}
+
+	void RenderState::bindRenderbuffer(uint32 renderbuffer)
+	{
+		if (changed(s_cache.renderbuffer, renderbuffer, GL_RENDERBUFFER_BINDING))
+			glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+	}
+
+	void RenderState::setActiveTexture(uint32 unit)
+	{
+		if (s_cache.active_unit == unit && RENDER_STATE_CHECK(getInteger(GL_ACTIVE_TEXTURE) == GL_TEXTURE0 + unit, GL_ACTIVE_TEXTURE))
+		{
+			s_elided++;
+			return;
+		}
+
+		s_cache.active_unit = unit;
+		s_forwarded++;
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+
+	void RenderState::bindTexture(uint32 unit, uint32 target, uint32 texture)
+	{
+		int32 slot = getSlot(s_textureTargets, RENDER_STATE_TEXTURE_TARGETS, target);
+
+		if (slot >= 0 && unit < RENDER_STATE_TEXTURE_UNITS)
+		{
+			uint32& cached = s_cache.textures[unit][slot];
+
+			if (cached == texture && RENDER_STATE_CHECK(getTextureInteger(unit, s_textureBindings[slot]) == texture, s_textureBindings[slot]))
+			{
+				s_elided++;
+				return;
+			}
+
+			cached = texture;
+		}
+
+		setActiveTexture(unit);
+
+		s_forwarded++;
+		glBindTexture(target, texture);
+	}
+
+	void RenderState::editTexture(uint32 target, uint32 texture)
+	{
+		uint32 unit = s_cache.active_unit < RENDER_STATE_TEXTURE_UNITS ? s_cache.active_unit : 0;
+
+		setActiveTexture(unit);
+		bindTexture(unit, target, texture);
+	}
+
+	void RenderState::bindSampler(uint32 unit, uint32 sampler)
+	{
+		if (unit < RENDER_STATE_TEXTURE_UNITS)
+		{
+			if (s_cache.samplers[unit] == sampler && RENDER_STATE_CHECK(getTextureInteger(unit, GL_SAMPLER_BINDING) == sampler, GL_SAMPLER_BINDING))
+			{
+				s_elided++;
+				return;
+			}
+
+			s_cache.samplers[unit] = sampler;
+		}
+
+		s_forwarded++;
+		glBindSampler(unit, sampler);
+	}
+
+	void RenderState::setBlend(bool enabled)
+	{
+		setCapability(s_cache.blend, GL_BLEND, enabled);
+	}
+
+	void RenderState::setBlendFunc(uint32 source, uint32 destination)
+	{
+		if (s_cache.blend_source == source && s_cache.blend_destination == destination &&
+			RENDER_STATE_CHECK(getInteger(GL_BLEND_SRC_RGB) == source && getInteger(GL_BLEND_DST_RGB) == destination, GL_BLEND_SRC_RGB))
+		{
+			s_elided++;
+			return;
+		}
+
+		s_cache.blend_source = source;
+		s_cache.blend_destination = destination;
+		s_forwarded++;
+		glBlendFunc(source, destination);
+	}
+
+	void RenderState::setDepthTest(bool enabled)
+	{
+		setCapability(s_cache.depth_test, GL_DEPTH_TEST, enabled);
+	}
+
+	void RenderState::setDepthMask(bool enabled)
+	{
+		if (changed(s_cache.depth_mask, enabled ? 1 : 0, GL_DEPTH_WRITEMASK))
+			glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	}
+
+	void RenderState::setDepthFunc(uint32 func)
+	{
+		if (changed(s_cache.depth_func, func, GL_DEPTH_FUNC))
+			glDepthFunc(func);
+	}
+
+	void RenderState::setCulling(bool enabled)
+	{
+		setCapability(s_cache.culling, GL_CULL_FACE, enabled);
+	}
+
+	void RenderState::setFrontFace(uint32 mode)
+	{
+		if (changed(s_cache.front_face, mode, GL_FRONT_FACE))
+			glFrontFace(mode);
+	}
+
+	void RenderState::setCullFace(uint32 mode)
+	{
+		if (changed(s_cache.cull_face, mode, GL_CULL_FACE_MODE))
+			glCullFace(mode);
+	}
+
+	void RenderState::setStencilTest(bool enabled)
+	{
+		setCapability(s_cache.stencil_test, GL_STENCIL_TEST, enabled);
+	}
+
+	void RenderState::setStencilFunc(uint32 func, int32 reference, uint32 mask)
+	{
+		if (s_cache.stencil_func == func && s_cache.stencil_reference == (uint32)reference && s_cache.stencil_value_mask == mask &&
+			RENDER_STATE_CHECK(getInteger(GL_STENCIL_FUNC) == func && getInteger(GL_STENCIL_REF) == (uint32)reference && getInteger(GL_STENCIL_VALUE_MASK) == mask, GL_STENCIL_FUNC))
+		{
+			s_elided++;
+			return;
+		}
+
+		s_cache.stencil_func = func;
+		s_cache.stencil_reference = (uint32)reference;
+		s_cache.stencil_value_mask = mask;
+		s_forwarded++;
+		glStencilFunc(func, reference, mask);
+	}
+
+	void RenderState::setStencilOp(uint32 stencil_fail, uint32 depth_fail, uint32 depth_pass)
+	{
+		if (s_cache.stencil_fail == stencil_fail && s_cache.stencil_depth_fail == depth_fail && s_cache.stencil_depth_pass == depth_pass &&
+			RENDER_STATE_CHECK(getInteger(GL_STENCIL_FAIL) == stencil_fail && getInteger(GL_STENCIL_PASS_DEPTH_FAIL) == depth_fail && getInteger(GL_STENCIL_PASS_DEPTH_PASS) == depth_pass, GL_STENCIL_FAIL))
+		{
+			s_elided++;
+			return;
+		}
+
+		s_cache.stencil_fail = stencil_fail;
+		s_cache.stencil_depth_fail = depth_fail;
+		s_cache.stencil_depth_pass = depth_pass;
+		s_forwarded++;
+		glStencilOp(stencil_fail, depth_fail, depth_pass);
+	}
+
+	void RenderState::setStencilMask(uint32 mask)
+	{
+		if (changed(s_cache.stencil_write_mask, mask, GL_STENCIL_WRITEMASK))
+			glStencilMask(mask);
+	}
+
+	void RenderState::setViewport(int32 x, int32 y, int32 width, int32 height)
+	{
+		int32* viewport = s_cache.viewport;
+
+		if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+		{
+#ifdef RZ_RENDER_STATE_VALIDATION
+			GLint actual[4] = {};
+			glGetIntegerv(GL_VIEWPORT, actual);
+#endif
+
+			if (RENDER_STATE_CHECK(actual[0] == x && actual[1] == y && actual[2] == width && actual[3] == height, GL_VIEWPORT))
+			{
+				s_elided++;
+				return;
+			}
+		}
+
+		viewport[0] = x;
+		viewport[1] = y;
+		viewport[2] = width;
+		viewport[3] = height;
+		s_forwarded++;
+		glViewport(x, y, width, height);
+	}
+
+	void RenderState::setLineWidth(float width)
+	{
+		if (s_cache.line_width == width)
+		{
+#ifdef RZ_RENDER_STATE_VALIDATION
+			GLfloat actual = 0.0f;
+			glGetFloatv(GL_LINE_WIDTH, &actual);
+#endif
+
+			if (RENDER_STATE_CHECK(actual == width, GL_LINE_WIDTH))
+			{
+				s_elided++;
+				return;
+			}
+		}
+
+		s_cache.line_width = width;
+		s_forwarded++;
+		glLineWidth(width);
+	}
+
+	void RenderState::setLineStipple(bool enabled, int32 factor, uint16 pattern)
+	{
+		if (enabled && (s_cache.line_stipple_factor != (uint32)factor || s_cache.line_stipple_pattern != pattern))
+		{
+			s_cache.line_stipple_factor = (uint32)factor;
+			s_cache.line_stipple_pattern = pattern;
+			s_forwarded++;
+			glLineStipple(factor, pattern);
+		}
+		else if (enabled)
+			s_elided++;
+
+		setCapability(s_cache.line_stipple, GL_LINE_STIPPLE, enabled);
+	}
+
+	void RenderState::releaseVertexArray(uint32 vao)
+	{
+		if (s_cache.vao == vao)
+		{
+			s_cache.vao = RENDER_STATE_UNKNOWN;
+			s_cache.buffers[s_elementBufferSlot] = RENDER_STATE_UNKNOWN;
+		}
+	}
+
+	void RenderState::releaseBuffer(uint32 buffer)
+	{
+		for (uint32& cached : s_cache.buffers)
+		{
+			if (cached == buffer)
+				cached = RENDER_STATE_UNKNOWN;
+		}
+
+		for (auto& target : s_cache.blocks)
+		{
+			for (uint32& cached : target)
+			{
+				if (cached == buffer)
+					cached = RENDER_STATE_UNKNOWN;
+			}
+		}
+	}
+
+	void RenderState::releaseFramebuffer(uint32 framebuffer)
+	{
+		if (s_cache.read_framebuffer == framebuffer)
+			s_cache.read_framebuffer = RENDER_STATE_UNKNOWN;
+
+		if (s_cache.draw_framebuffer == framebuffer)
+			s_cache.draw_framebuffer = RENDER_STATE_UNKNOWN;
+	}
+
+	void RenderState::releaseRenderbuffer(uint32 renderbuffer)
+	{
+		if (s_cache.renderbuffer == renderbuffer)
+			s_cache.renderbuffer = RENDER_STATE_UNKNOWN;
+	}
+
+	void RenderState::releaseTexture(uint32 texture)
+	{
+		for (auto& unit : s_cache.textures)
+		{
+			for (uint32& cached : unit)
+			{
+				if (cached == texture)
+					cached = RENDER_STATE_UNKNOWN;
+			}
+		}
+	}
+
+	void RenderState::invalidate()
+	{
+		s_cache = Cache();
+	}
+
+	void RenderState::endFrame()
+	{
+		static Counter& s_forwardedCalls = Metrics::counter("renderer.state_calls", "GL state calls forwarded to the driver");
+		static Counter& s_elidedCalls = Metrics::counter("renderer.state_calls_elided", "Redundant GL state calls skipped by the state cache");
+
+		s_forwardedCalls.add(s_forwarded);
+		s_elidedCalls.add(s_elided);
+
+		s_forwarded = 0;
+		s_elided = 0;
+	}
+
+	bool RenderState::changed(uint32& cached, uint32 value, uint32 query)
+	{
+		if (cached == value && RENDER_STATE_CHECK(getInteger(query) == value, query))
+		{
+			s_elided++;
+			return false;
+		}
+
+		cached = value;
+		s_forwarded++;
+
+		return true;
+	}
+
+	void RenderState::setCapability(uint32& cached, uint32 capability, bool enabled)
+	{
+		if (cached == (uint32)enabled && RENDER_STATE_CHECK((glIsEnabled(capability) == GL_TRUE) == enabled, capability))
+		{
+			s_elided++;
+			return;
+		}
+
+		cached = enabled ? 1 : 0;
+		s_forwarded++;
+
+		if (enabled)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+
+}
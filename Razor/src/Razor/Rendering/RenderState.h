@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+
+// Texture units and samplers shadowed, binds to higher units are forwarded as is
+#define RENDER_STATE_TEXTURE_UNITS 32
+// Array, element array, uniform and shader storage buffers
+#define RENDER_STATE_BUFFER_TARGETS 4
+// Indexed binding points shadowed per block target, higher ones are forwarded as is
+#define RENDER_STATE_BLOCK_BINDINGS 16
+// Uniform and shader storage blocks
+#define RENDER_STATE_BLOCK_TARGETS 2
+// 2D, cube map and 2D multisample textures
+#define RENDER_STATE_TEXTURE_TARGETS 3
+// Cached value of a state the driver may hold anything in
+#define RENDER_STATE_UNKNOWN 0xffffffff
+
+#if defined(RZ_DEBUG) && !defined(RZ_RENDER_STATE_VALIDATION)
+	#define RZ_RENDER_STATE_VALIDATION
+#endif
+
+namespace Razor
+{
+
+	// Shadow of the GL context state, calls only reach the driver when they
+	// change something. Every state change made on the GL thread must go through
+	// it, code drawing behind its back (ImGui, third party) is followed by
+	// invalidate(). The cache isn't synchronized, it lives on the GL thread.
+	//
+	// Texture binds don't move the active unit when they are elided, code
+	// calling glTex* functions after a bind uses editTexture().
+	//
+	// With RZ_RENDER_STATE_VALIDATION (debug builds) every elided call is checked
+	// against glGet, a stale cache is logged and the call forwarded.
+	class RenderState
+	{
+	public:
+		static void useProgram(uint32 program);
+		static void bindVertexArray(uint32 vao);
+		static void bindBuffer(uint32 target, uint32 buffer);
+		// Binds a block binding point, and the generic target along with it
+		static void bindBufferBase(uint32 target, uint32 index, uint32 buffer);
+		static void bindFramebuffer(uint32 target, uint32 framebuffer);
+		static void bindRenderbuffer(uint32 renderbuffer);
+
+		static void setActiveTexture(uint32 unit);
+		static void bindTexture(uint32 unit, uint32 target, uint32 texture);
+		// Binds on the active unit, for glTex* calls
+		static void editTexture(uint32 target, uint32 texture);
+		static void bindSampler(uint32 unit, uint32 sampler);
+
+		static void setBlend(bool enabled);
+		static void setBlendFunc(uint32 source, uint32 destination);
+		static void setDepthTest(bool enabled);
+		static void setDepthMask(bool enabled);
+		static void setDepthFunc(uint32 func);
+		static void setCulling(bool enabled);
+		static void setFrontFace(uint32 mode);
+		static void setCullFace(uint32 mode);
+		static void setStencilTest(bool enabled);
+		static void setStencilFunc(uint32 func, int32 reference, uint32 mask);
+		static void setStencilOp(uint32 stencil_fail, uint32 depth_fail, uint32 depth_pass);
+		static void setStencilMask(uint32 mask);
+		static void setViewport(int32 x, int32 y, int32 width, int32 height);
+		static void setLineWidth(float width);
+		static void setLineStipple(bool enabled, int32 factor = 1, uint16 pattern = 0xffff);
+
+		// Deleted objects are unbound by the driver and their names reused
+		static void releaseVertexArray(uint32 vao);
+		static void releaseBuffer(uint32 buffer);
+		static void releaseFramebuffer(uint32 framebuffer);
+		static void releaseRenderbuffer(uint32 renderbuffer);
+		static void releaseTexture(uint32 texture);
+
+		// Forgets every state, the next call of each reaches the driver
+		static void invalidate();
+		// Publishes the calls forwarded and elided since the last frame
+		static void endFrame();
+
+	private:
+		// Every field starts as RENDER_STATE_UNKNOWN, -1 or NaN, which no call matches
+		struct Cache
+		{
+			Cache();
+
+			uint32 program;
+			uint32 vao;
+			uint32 buffers[RENDER_STATE_BUFFER_TARGETS];
+			uint32 blocks[RENDER_STATE_BLOCK_TARGETS][RENDER_STATE_BLOCK_BINDINGS];
+			uint32 read_framebuffer;
+			uint32 draw_framebuffer;
+			uint32 renderbuffer;
+
+			uint32 active_unit;
+			uint32 textures[RENDER_STATE_TEXTURE_UNITS][RENDER_STATE_TEXTURE_TARGETS];
+			uint32 samplers[RENDER_STATE_TEXTURE_UNITS];
+
+			uint32 blend;
+			uint32 blend_source;
+			uint32 blend_destination;
+			uint32 depth_test;
+			uint32 depth_mask;
+			uint32 depth_func;
+			uint32 culling;
+			uint32 front_face;
+			uint32 cull_face;
+			uint32 stencil_test;
+			uint32 stencil_func;
+			uint32 stencil_reference;
+			uint32 stencil_value_mask;
+			uint32 stencil_fail;
+			uint32 stencil_depth_fail;
+			uint32 stencil_depth_pass;
+			uint32 stencil_write_mask;
+			int32 viewport[4];
+			float line_width;
+			uint32 line_stipple;
+			uint32 line_stipple_factor;
+			uint32 line_stipple_pattern;
+		};
+
+		static bool changed(uint32& cached, uint32 value, uint32 query);
+		static void setCapability(uint32& cached, uint32 capability, bool enabled);
+
+		static Cache s_cache;
+		static uint64 s_forwarded;
+		static uint64 s_elided;
+	};
+
+}
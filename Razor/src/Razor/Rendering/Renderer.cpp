@@ -3,10 +3,14 @@
 #include "Renderer.h"
 #include "ForwardRenderer.h"
 #include "DeferredRenderer.h"
+#include "RenderState.h"
 
 #include "Razor/Core/Engine.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Memory/MemoryTracker.h"
 
 #include "Razor/Scene/Node.h"
+#include "Razor/Scene/FrameSnapshot.h"
 #include "Razor/Materials/ShadersManager.h"
 #include "Razor/Scene/ScenesManager.h"
 #include "Razor/Materials/Texture.h"
@@ -27,15 +31,16 @@ namespace Razor
 		scenes_manager(scenesManager),
 		shaders_manager(shadersManager),
 		clear_color(glm::vec4(1.0f, 0.65f, 0.0f, 1.0f)),
-		g_buffer(nullptr)
+		g_buffer(nullptr),
+		queue()
 	{
 		//forward = new ForwardRenderer(window, engine, scenesManager, shadersManager);
 		deferred = new DeferredRenderer(window, engine, scenesManager, shadersManager);
 
 		g_buffer = deferred->getGBuffer();
 
-		internal_shaders[Shader::Type::DEFAULT] = shaders_manager->getShaders()["default"];
-		internal_shaders[Shader::Type::LANDSCAPE] = shaders_manager->getShaders()["landscape"];
+		queue.setShader(Shader::Type::DEFAULT, shaders_manager->getShaders()["default"]);
+		queue.setShader(Shader::Type::LANDSCAPE, shaders_manager->getShaders()["landscape"]);
 	}
 
 	Renderer::~Renderer()
@@ -48,93 +53,39 @@ namespace Razor
 	{
 	}
 
-	void Renderer::render()
+	void Renderer::render(const FrameSnapshot* snapshot, float alpha)
 	{
-		processQueue();
-	}
+		RZ_PROFILE_FUNCTION();
+		MemoryTagScope memory(MemoryTag::Render);
 
-	void Renderer::onResize(const glm::vec2& size)
-	{
-		deferred->onResize(size);
-	}
+		static Histogram& s_renderTime = Metrics::histogram("renderer.frame_time", "us", "CPU time spent submitting a frame");
+		uint64 start = TraceProfiler::now();
 
-	void Renderer::addRenderTask(std::shared_ptr<Node> node)
-	{
-		if (node->meshes.size() > 0)
-		{
-			StaticMesh::List::iterator it = node->meshes.begin();
-
-			for (; it != node->meshes.end(); ++it)
-			{
-				std::shared_ptr<StaticMesh> mesh = (*it);
-
-				RenderTask task;
-				task.category     = RenderCategory::OBJECT;
-				task.depth_pass   = mesh->isReceivingShadows();
-				task.draw_mode    = mesh->getDrawMode();
-				task.index_count  = (unsigned int)mesh->getIndices().size();
-				task.vertex_count = (unsigned int)mesh->getVertices().size();
-				task.vao          = mesh->getVao();
-
-				task.shader = internal_shaders[Shader::Type::DEFAULT]; // TODO: Get from material.
-
-				tasks.emplace(task);
-			}
-		}
-		
-		if (node->landscapes.size() > 0)
-		{
-			Landscape::List::iterator it = node->landscapes.begin();
-
-			for (; it != node->landscapes.end(); it++)
-			{
-				std::shared_ptr<StaticMesh> mesh = (*it)->getMesh();
-
-				RenderTask task;
-				task.category     = RenderCategory::LANDSCAPE;
-				task.depth_pass   = mesh->isReceivingShadows();
-				task.draw_mode    = mesh->getDrawMode();
-				task.index_count  = (unsigned int)mesh->getIndices().size();
-				task.vertex_count = (unsigned int)mesh->getVertices().size();
-				task.vao          = mesh->getVao();
-
-				task.shader = internal_shaders[Shader::Type::LANDSCAPE];
-
-				tasks.emplace(task);
-			}
-		}
-
-		Node::List::iterator it = node->nodes.begin();
-
-		for (; it != node->nodes.end(); ++it)
-			addRenderTask(*it);
+		// ImGui and the platform windows drew since the last frame without the cache
+		RenderState::invalidate();
+
+		if (snapshot != nullptr)
+			processQueue(*snapshot, alpha);
+
+		RenderState::endFrame();
+
+		s_renderTime.record((TraceProfiler::now() - start) / 1000);
 	}
 
-	bool operator < (const Renderer::RenderTask& lhs, const Renderer::RenderTask& rhs)
+	void Renderer::onResize(const glm::vec2& size)
 	{
-		return false;
+		deferred->onResize(size);
 	}
 
-	void Renderer::processQueue()
+	void Renderer::processQueue(const FrameSnapshot& snapshot, float alpha)
 	{
-		std::vector<std::shared_ptr<Node>>& nodes = scenes_manager->getActiveScene()->getSceneGraph()->getNodes();
-
-		for (auto node : nodes)
-			addRenderTask(node);
-
-		deferred->render();
-
-		while (!tasks.empty())
-		{
-			RenderTask task = tasks.top();
-
-			task.shader->bind();
-			task.vao->bind();
+		static Gauge& s_tasks = Metrics::gauge("renderer.tasks", "Draws queued last frame");
 
-			//std::cout << task.shader->getName() << std::endl;
+		queue.build(snapshot);
+		s_tasks.set((double)queue.size());
 
-			tasks.pop();
-		}
+		// The deferred pass records the sorted draws and replays them
+		deferred->render(snapshot, queue, alpha);
 	}
 
 }
@@ -3,6 +3,7 @@
 #include "Razor/Materials/Texture.h"
 #include "Razor/Geometry/StaticMesh.h"
 #include "Razor/Core/Window.h"
+#include "RenderQueue.h"
 
 namespace Razor
 {
@@ -19,6 +20,7 @@ namespace Razor
 	class FrameBuffer;
 	class Material;
 	class GBuffer;
+	class FrameSnapshot;
 
 	class Renderer
 	{
@@ -31,70 +33,19 @@ namespace Razor
 		);
 		~Renderer();
 
-		enum class RenderCategory
-		{
-			UI,
-			LANDSCAPE,
-			OBJECT,
-			FOLIAGE,
-			SKYBOX,
-			PARTICLE
-		};
-
-		enum class RenderSortKey
-		{
-			SHADER,
-			MATERIAL,
-			MESH,
-			TEXTURE
-		};
-
 		void update();
-		void render();
+		void render(const FrameSnapshot* snapshot, float alpha = 1.0f);
 
 		void setClearColor(const glm::vec4& color);
 		void onResize(const glm::vec2& size);
 
 		inline GBuffer* getGBuffer() { return g_buffer; }
-
-		struct RenderTask
-		{
-			RenderTask() :
-				vao(nullptr),
-				shader(nullptr),
-				category(RenderCategory::OBJECT),
-				uniforms({}),
-				sorting_keys({
-					RenderSortKey::SHADER,
-					RenderSortKey::TEXTURE,
-					RenderSortKey::MATERIAL,
-					RenderSortKey::MESH
-					}),
-				draw_mode(StaticMesh::DrawMode::TRIANGLES),
-				vertex_count(0),
-				index_count(0),
-				depth_pass(false)
-			{}
-
-			VertexArray* vao;
-			Shader* shader;
-			RenderCategory category;
-			std::unordered_map<const char*, Variant> uniforms;
-			std::unordered_map<Texture::Type, unsigned int> textures;
-			std::vector<RenderSortKey> sorting_keys;
-			StaticMesh::DrawMode draw_mode;
-			unsigned int vertex_count;
-			unsigned int index_count;
-			bool depth_pass;
-
-			friend bool operator < (const RenderTask& lhs, const RenderTask& rhs);
-		};
+		inline RenderQueue& getQueue() { return queue; }
 
 	protected:
-		void addRenderTask(std::shared_ptr<Node> node);
-		void processQueue();
+		void processQueue(const FrameSnapshot& snapshot, float alpha);
 
-		std::priority_queue<RenderTask> tasks;
+		RenderQueue queue;
 		
 		ForwardRenderer* forward;
 		DeferredRenderer* deferred;
@@ -104,7 +55,6 @@ namespace Razor
 		ScenesManager* scenes_manager;
 		ShadersManager* shaders_manager;
 
-		std::unordered_map<Shader::Type, Shader*> internal_shaders;
 		glm::vec4 clear_color;
 	};
 
@@ -0,0 +1,847 @@
+#include "rzpch.h"
+#include "BVH.h"
+#include "Razor/Memory/Allocators.h"
+
+#include <xmmintrin.h>
+
+namespace Razor
+{
+
+	static const AABB s_emptyBox = AABB::fromMinMax(glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()));
+
+	BVH::BVH() :
+		nodes({}),
+		root(-1),
+		free_nodes(-1),
+		leaves({}),
+		leaf_count(0),
+		cost(0.0f),
+		built_cost(0.0f),
+		wide_nodes({}),
+		wide_lanes({}),
+		wide_dirty(false)
+	{
+	}
+
+	BVH::~BVH()
+	{
+	}
+
+	AABB BVH::fatten(const AABB& box)
+	{
+		glm::vec3 margin = glm::vec3(BVH_FAT_MARGIN);
+
+		return AABB::fromMinMax(box.getMin() - margin, box.getMax() + margin);
+	}
+
+	void BVH::insert(NodeHandle handle, const AABB& box)
+	{
+		RZ_ASSERT(!contains(handle), "Node already in the BVH");
+
+		int32 leaf = allocate();
+		nodes[leaf] = { fatten(box), -1, -1, -1, handle };
+
+		if (handle.index >= leaves.size())
+			leaves.resize((size_t)handle.index + 1, -1);
+
+		leaves[handle.index] = leaf;
+		leaf_count++;
+
+		float before = cost;
+		insertLeaf(leaf);
+		built_cost += cost - before;
+
+		wide_dirty = true;
+	}
+
+	void BVH::update(NodeHandle handle, const AABB& box)
+	{
+		if (!contains(handle))
+		{
+			insert(handle, box);
+			return;
+		}
+
+		int32 leaf = leaves[handle.index];
+
+		if (nodes[leaf].box.contains(box))
+			return;
+
+		nodes[leaf].box = fatten(box);
+		refitAncestors(nodes[leaf].parent);
+
+		if (!wide_dirty)
+			refitWide(leaf);
+	}
+
+	void BVH::remove(NodeHandle handle)
+	{
+		if (!contains(handle))
+			return;
+
+		int32 leaf = leaves[handle.index];
+
+		float before = cost;
+		removeLeaf(leaf);
+		built_cost += cost - before;
+
+		release(leaf);
+		leaves[handle.index] = -1;
+		leaf_count--;
+
+		wide_dirty = true;
+	}
+
+	bool BVH::contains(NodeHandle handle) const
+	{
+		return handle.index < leaves.size()
+			&& leaves[handle.index] >= 0
+			&& nodes[leaves[handle.index]].handle == handle;
+	}
+
+	void BVH::clear()
+	{
+		nodes.clear();
+		leaves.clear();
+		wide_nodes.clear();
+		wide_lanes.clear();
+
+		root = -1;
+		free_nodes = -1;
+		leaf_count = 0;
+		cost = 0.0f;
+		built_cost = 0.0f;
+		wide_dirty = false;
+	}
+
+	void BVH::commit()
+	{
+		if (leaf_count >= BVH_REBUILD_MIN_LEAVES && cost > built_cost * BVH_REBUILD_RATIO)
+			rebuild();
+
+		if (wide_dirty)
+			collapse();
+	}
+
+	void BVH::rebuild()
+	{
+		RZ_PROFILE_FUNCTION();
+
+		std::vector<TreeNode> leaf_nodes;
+		leaf_nodes.reserve(leaf_count);
+
+		for (int32 leaf : leaves)
+			if (leaf >= 0)
+				leaf_nodes.push_back(nodes[leaf]);
+
+		nodes.clear();
+		free_nodes = -1;
+		cost = 0.0f;
+
+		std::vector<int32> indices(leaf_nodes.size());
+
+		for (size_t i = 0; i < leaf_nodes.size(); i++)
+		{
+			nodes.push_back(leaf_nodes[i]);
+			leaves[leaf_nodes[i].handle.index] = (int32)i;
+			indices[i] = (int32)i;
+		}
+
+		root = indices.empty() ? -1 : build(indices, 0, indices.size());
+
+		if (root >= 0)
+			nodes[root].parent = -1;
+
+		built_cost = cost;
+		wide_dirty = true;
+	}
+
+	int32 BVH::allocate()
+	{
+		if (free_nodes >= 0)
+		{
+			int32 node = free_nodes;
+			free_nodes = nodes[node].parent;
+
+			return node;
+		}
+
+		nodes.push_back({});
+
+		return (int32)nodes.size() - 1;
+	}
+
+	void BVH::release(int32 node)
+	{
+		nodes[node].parent = free_nodes;
+		nodes[node].left = -1;
+		nodes[node].handle = INVALID_NODE;
+		free_nodes = node;
+	}
+
+	void BVH::insertLeaf(int32 leaf)
+	{
+		if (root < 0)
+		{
+			root = leaf;
+			nodes[leaf].parent = -1;
+			return;
+		}
+
+		// Branch and bound search of the sibling adding the least area,
+		// counting the growth of every ancestor on the way down
+		const AABB box = nodes[leaf].box;
+		float box_area = box.area();
+
+		int32 sibling = root;
+		AABB merged = nodes[root].box;
+		merged.merge(box);
+		float best_cost = merged.area();
+
+		ScratchScope scratch;
+		FrameVector<std::pair<int32, float>> stack(ArenaAllocator<std::pair<int32, float>>(&scratch.getArena(), "BVH"));
+		stack.push_back({ root, 0.0f });
+
+		while (!stack.empty())
+		{
+			int32 node = stack.back().first;
+			float inherited = stack.back().second;
+			stack.pop_back();
+
+			AABB combined = nodes[node].box;
+			combined.merge(box);
+			float direct = combined.area();
+
+			if (direct + inherited < best_cost)
+			{
+				best_cost = direct + inherited;
+				sibling = node;
+			}
+
+			if (nodes[node].isLeaf())
+				continue;
+
+			float child_inherited = inherited + direct - nodes[node].box.area();
+
+			if (box_area + child_inherited < best_cost)
+			{
+				stack.push_back({ nodes[node].left, child_inherited });
+				stack.push_back({ nodes[node].right, child_inherited });
+			}
+		}
+
+		int32 parent = allocate();
+		int32 old_parent = nodes[sibling].parent;
+
+		nodes[parent].box = nodes[sibling].box;
+		nodes[parent].box.merge(box);
+		nodes[parent].parent = old_parent;
+		nodes[parent].left = sibling;
+		nodes[parent].right = leaf;
+		nodes[parent].handle = INVALID_NODE;
+
+		nodes[sibling].parent = parent;
+		nodes[leaf].parent = parent;
+
+		if (old_parent < 0)
+			root = parent;
+		else if (nodes[old_parent].left == sibling)
+			nodes[old_parent].left = parent;
+		else
+			nodes[old_parent].right = parent;
+
+		cost += nodes[parent].box.area();
+		refitAncestors(old_parent);
+	}
+
+	void BVH::removeLeaf(int32 leaf)
+	{
+		if (leaf == root)
+		{
+			root = -1;
+			return;
+		}
+
+		int32 parent = nodes[leaf].parent;
+		int32 grand_parent = nodes[parent].parent;
+		int32 sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+		cost -= nodes[parent].box.area();
+		nodes[sibling].parent = grand_parent;
+
+		if (grand_parent < 0)
+			root = sibling;
+		else if (nodes[grand_parent].left == parent)
+			nodes[grand_parent].left = sibling;
+		else
+			nodes[grand_parent].right = sibling;
+
+		release(parent);
+		refitAncestors(grand_parent);
+	}
+
+	void BVH::refitAncestors(int32 node)
+	{
+		while (node >= 0)
+		{
+			TreeNode& current = nodes[node];
+			float area = current.box.area();
+
+			current.box = nodes[current.left].box;
+			current.box.merge(nodes[current.right].box);
+			cost += current.box.area() - area;
+
+			node = current.parent;
+		}
+	}
+
+	int32 BVH::build(std::vector<int32>& indices, size_t first, size_t last)
+	{
+		if (last - first == 1)
+			return indices[first];
+
+		AABB bounds = s_emptyBox;
+		AABB centroids = s_emptyBox;
+
+		for (size_t i = first; i < last; i++)
+		{
+			const AABB& box = nodes[indices[i]].box;
+			glm::vec3 center = box.getCenter();
+
+			bounds.merge(box);
+			centroids.merge(AABB::fromMinMax(center, center));
+		}
+
+		glm::vec3 extent = centroids.getMax() - centroids.getMin();
+		int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+		float axis_min = centroids.getMin()[axis];
+		float axis_extent = extent[axis];
+
+		size_t middle = (first + last) / 2;
+
+		if (axis_extent > 0.0f)
+		{
+			auto bin_of = [&](int32 node)
+			{
+				float offset = (nodes[node].box.getCenter()[axis] - axis_min) / axis_extent;
+				return std::min((int)(offset * BVH_SAH_BINS), BVH_SAH_BINS - 1);
+			};
+
+			std::array<uint32, BVH_SAH_BINS> counts = {};
+			std::array<AABB, BVH_SAH_BINS> boxes;
+			boxes.fill(s_emptyBox);
+
+			for (size_t i = first; i < last; i++)
+			{
+				int bin = bin_of(indices[i]);
+				counts[bin]++;
+				boxes[bin].merge(nodes[indices[i]].box);
+			}
+
+			// Cost of splitting after each bin, swept from both sides
+			std::array<float, BVH_SAH_BINS> left_costs = {};
+			AABB left_box = s_emptyBox;
+			uint32 left_count = 0;
+
+			for (int bin = 0; bin < BVH_SAH_BINS - 1; bin++)
+			{
+				if (counts[bin] > 0)
+					left_box.merge(boxes[bin]);
+
+				left_count += counts[bin];
+				left_costs[bin] = left_count > 0 ? left_box.area() * left_count : 0.0f;
+			}
+
+			AABB right_box = s_emptyBox;
+			uint32 right_count = 0;
+			float best_cost = std::numeric_limits<float>::max();
+			int best_split = -1;
+
+			for (int bin = BVH_SAH_BINS - 1; bin > 0; bin--)
+			{
+				if (counts[bin] > 0)
+					right_box.merge(boxes[bin]);
+
+				right_count += counts[bin];
+
+				float split_cost = left_costs[bin - 1] + (right_count > 0 ? right_box.area() * right_count : 0.0f);
+
+				if (right_count > 0 && right_count < last - first && split_cost < best_cost)
+				{
+					best_cost = split_cost;
+					best_split = bin;
+				}
+			}
+
+			if (best_split > 0)
+			{
+				auto it = std::partition(indices.begin() + first, indices.begin() + last, [&](int32 node)
+				{
+					return bin_of(node) < best_split;
+				});
+
+				middle = it - indices.begin();
+			}
+		}
+
+		// Coincident centroids, split by count
+		if (middle == first || middle == last)
+			middle = (first + last) / 2;
+
+		int32 left = build(indices, first, middle);
+		int32 right = build(indices, middle, last);
+		int32 node = allocate();
+
+		nodes[node] = { bounds, -1, left, right, INVALID_NODE };
+		nodes[left].parent = node;
+		nodes[right].parent = node;
+		cost += bounds.area();
+
+		return node;
+	}
+
+	void BVH::collapse()
+	{
+		RZ_PROFILE_FUNCTION();
+
+		wide_nodes.clear();
+		wide_lanes.assign(nodes.size(), -1);
+		wide_dirty = false;
+
+		if (root < 0)
+			return;
+
+		if (nodes[root].isLeaf())
+		{
+			wide_nodes.push_back({});
+			wide_nodes[0].parent = -1;
+			setLane(wide_nodes[0], 0, nodes[root].box, -2 - root);
+
+			for (int lane = 1; lane < BVH_WIDTH; lane++)
+				setLane(wide_nodes[0], lane, s_emptyBox, -1);
+
+			wide_lanes[root] = 0;
+			return;
+		}
+
+		collapseNode(root, -1);
+	}
+
+	int32 BVH::collapseNode(int32 node, int32 parent)
+	{
+		int32 index = (int32)wide_nodes.size();
+		wide_nodes.push_back({});
+		wide_nodes[index].parent = parent;
+
+		// Pulls grandchildren up, opening the largest internal child first
+		std::array<int32, BVH_WIDTH> children = { nodes[node].left, nodes[node].right, -1, -1 };
+		int count = 2;
+
+		while (count < BVH_WIDTH)
+		{
+			int largest = -1;
+			float largest_area = -1.0f;
+
+			for (int i = 0; i < count; i++)
+			{
+				if (!nodes[children[i]].isLeaf() && nodes[children[i]].box.area() > largest_area)
+				{
+					largest = i;
+					largest_area = nodes[children[i]].box.area();
+				}
+			}
+
+			if (largest < 0)
+				break;
+
+			int32 opened = children[largest];
+			children[largest] = nodes[opened].left;
+			children[count++] = nodes[opened].right;
+		}
+
+		for (int lane = 0; lane < BVH_WIDTH; lane++)
+		{
+			if (lane >= count)
+			{
+				setLane(wide_nodes[index], lane, s_emptyBox, -1);
+				continue;
+			}
+
+			int32 child = children[lane];
+
+			if (nodes[child].isLeaf())
+			{
+				setLane(wide_nodes[index], lane, nodes[child].box, -2 - child);
+				wide_lanes[child] = index * BVH_WIDTH + lane;
+			}
+			else
+			{
+				int32 wide = collapseNode(child, index * BVH_WIDTH + lane);
+				setLane(wide_nodes[index], lane, nodes[child].box, wide);
+			}
+		}
+
+		return index;
+	}
+
+	void BVH::setLane(WideNode& wide, int lane, const AABB& box, int32 child)
+	{
+		wide.min_x[lane] = box.min_x;
+		wide.min_y[lane] = box.min_y;
+		wide.min_z[lane] = box.min_z;
+		wide.max_x[lane] = box.max_x;
+		wide.max_y[lane] = box.max_y;
+		wide.max_z[lane] = box.max_z;
+		wide.children[lane] = child;
+	}
+
+	void BVH::refitWide(int32 leaf)
+	{
+		int32 location = wide_lanes[leaf];
+		setLane(wide_nodes[location / BVH_WIDTH], location % BVH_WIDTH, nodes[leaf].box, -2 - leaf);
+
+		int32 wide = location / BVH_WIDTH;
+
+		while (wide_nodes[wide].parent >= 0)
+		{
+			const WideNode& current = wide_nodes[wide];
+			AABB box = s_emptyBox;
+
+			for (int lane = 0; lane < BVH_WIDTH; lane++)
+				if (current.children[lane] != -1)
+					box.merge({ current.min_x[lane], current.max_x[lane], current.min_y[lane], current.max_y[lane], current.min_z[lane], current.max_z[lane] });
+
+			int32 parent = current.parent;
+			setLane(wide_nodes[parent / BVH_WIDTH], parent % BVH_WIDTH, box, wide);
+			wide = parent / BVH_WIDTH;
+		}
+	}
+
+	void BVH::queryFrustum(const Frustum& frustum, std::vector<NodeHandle>& results) const
+	{
+		RZ_ASSERT(!wide_dirty, "BVH queried before commit()");
+
+		if (wide_nodes.empty())
+			return;
+
+		ScratchScope scratch;
+		FrameVector<int32> stack(ArenaAllocator<int32>(&scratch.getArena(), "BVH"));
+		stack.push_back(0);
+
+		while (!stack.empty())
+		{
+			const WideNode& wide = wide_nodes[stack.back()];
+			stack.pop_back();
+
+			__m128 inside = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+
+			for (auto& plane : frustum.planes)
+			{
+				// Corner of each box furthest along the plane normal
+				__m128 x = _mm_load_ps(plane.x >= 0.0f ? wide.max_x : wide.min_x);
+				__m128 y = _mm_load_ps(plane.y >= 0.0f ? wide.max_y : wide.min_y);
+				__m128 z = _mm_load_ps(plane.z >= 0.0f ? wide.max_z : wide.min_z);
+
+				__m128 distance = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+					_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w))
+				);
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+			}
+
+			int mask = _mm_movemask_ps(inside);
+
+			for (int lane = 0; lane < BVH_WIDTH; lane++)
+			{
+				int32 child = wide.children[lane];
+
+				if ((mask & (1 << lane)) == 0 || child == -1)
+					continue;
+
+				if (child >= 0)
+					stack.push_back(child);
+				else
+					results.push_back(nodes[-2 - child].handle);
+			}
+		}
+	}
+
+	void BVH::querySphere(const glm::vec3& center, float radius, std::vector<NodeHandle>& results) const
+	{
+		RZ_ASSERT(!wide_dirty, "BVH queried before commit()");
+
+		if (wide_nodes.empty())
+			return;
+
+		__m128 cx = _mm_set1_ps(center.x);
+		__m128 cy = _mm_set1_ps(center.y);
+		__m128 cz = _mm_set1_ps(center.z);
+		__m128 radius2 = _mm_set1_ps(radius * radius);
+		__m128 zero = _mm_setzero_ps();
+
+		ScratchScope scratch;
+		FrameVector<int32> stack(ArenaAllocator<int32>(&scratch.getArena(), "BVH"));
+		stack.push_back(0);
+
+		while (!stack.empty())
+		{
+			const WideNode& wide = wide_nodes[stack.back()];
+			stack.pop_back();
+
+			// Distance from the center to each box, 0 inside
+			__m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(wide.min_x), cx), zero), _mm_max_ps(_mm_sub_ps(cx, _mm_load_ps(wide.max_x)), zero));
+			__m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(wide.min_y), cy), zero), _mm_max_ps(_mm_sub_ps(cy, _mm_load_ps(wide.max_y)), zero));
+			__m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(wide.min_z), cz), zero), _mm_max_ps(_mm_sub_ps(cz, _mm_load_ps(wide.max_z)), zero));
+			__m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+			int mask = _mm_movemask_ps(_mm_cmple_ps(distance2, radius2));
+
+			for (int lane = 0; lane < BVH_WIDTH; lane++)
+			{
+				int32 child = wide.children[lane];
+
+				if ((mask & (1 << lane)) == 0 || child == -1)
+					continue;
+
+				if (child >= 0)
+					stack.push_back(child);
+				else
+					results.push_back(nodes[-2 - child].handle);
+			}
+		}
+	}
+
+	void BVH::queryAABB(const AABB& box, std::vector<NodeHandle>& results) const
+	{
+		RZ_ASSERT(!wide_dirty, "BVH queried before commit()");
+
+		if (wide_nodes.empty())
+			return;
+
+		__m128 min_x = _mm_set1_ps(box.min_x);
+		__m128 min_y = _mm_set1_ps(box.min_y);
+		__m128 min_z = _mm_set1_ps(box.min_z);
+		__m128 max_x = _mm_set1_ps(box.max_x);
+		__m128 max_y = _mm_set1_ps(box.max_y);
+		__m128 max_z = _mm_set1_ps(box.max_z);
+
+		ScratchScope scratch;
+		FrameVector<int32> stack(ArenaAllocator<int32>(&scratch.getArena(), "BVH"));
+		stack.push_back(0);
+
+		while (!stack.empty())
+		{
+			const WideNode& wide = wide_nodes[stack.back()];
+			stack.pop_back();
+
+			__m128 overlap = _mm_and_ps(
+				_mm_and_ps(
+					_mm_and_ps(_mm_cmple_ps(_mm_load_ps(wide.min_x), max_x), _mm_cmpge_ps(_mm_load_ps(wide.max_x), min_x)),
+					_mm_and_ps(_mm_cmple_ps(_mm_load_ps(wide.min_y), max_y), _mm_cmpge_ps(_mm_load_ps(wide.max_y), min_y))
+				),
+				_mm_and_ps(_mm_cmple_ps(_mm_load_ps(wide.min_z), max_z), _mm_cmpge_ps(_mm_load_ps(wide.max_z), min_z))
+			);
+
+			int mask = _mm_movemask_ps(overlap);
+
+			for (int lane = 0; lane < BVH_WIDTH; lane++)
+			{
+				int32 child = wide.children[lane];
+
+				if ((mask & (1 << lane)) == 0 || child == -1)
+					continue;
+
+				if (child >= 0)
+					stack.push_back(child);
+				else
+					results.push_back(nodes[-2 - child].handle);
+			}
+		}
+	}
+
+	// Slab test of the four boxes, distances where the ray enters them in entry
+	static inline int intersectRay(const float* min_x, const float* min_y, const float* min_z, const float* max_x, const float* max_y, const float* max_z,
+		const __m128* origin, const __m128* inverse, __m128 max_distance, __m128& entry)
+	{
+		__m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(min_x), origin[0]), inverse[0]);
+		__m128 x2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(max_x), origin[0]), inverse[0]);
+		__m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(min_y), origin[1]), inverse[1]);
+		__m128 y2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(max_y), origin[1]), inverse[1]);
+		__m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(min_z), origin[2]), inverse[2]);
+		__m128 z2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(max_z), origin[2]), inverse[2]);
+
+		entry = _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)), _mm_max_ps(_mm_min_ps(z1, z2), _mm_setzero_ps()));
+		__m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)), _mm_min_ps(_mm_max_ps(z1, z2), max_distance));
+
+		return _mm_movemask_ps(_mm_cmple_ps(entry, exit));
+	}
+
+	void BVH::queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<NodeHandle>& results) const
+	{
+		RZ_ASSERT(!wide_dirty, "BVH queried before commit()");
+
+		if (wide_nodes.empty())
+			return;
+
+		__m128 origins[3] = { _mm_set1_ps(origin.x), _mm_set1_ps(origin.y), _mm_set1_ps(origin.z) };
+		__m128 inverses[3] = { _mm_set1_ps(1.0f / direction.x), _mm_set1_ps(1.0f / direction.y), _mm_set1_ps(1.0f / direction.z) };
+		__m128 distance = _mm_set1_ps(max_distance);
+
+		ScratchScope scratch;
+		FrameVector<int32> stack(ArenaAllocator<int32>(&scratch.getArena(), "BVH"));
+		stack.push_back(0);
+
+		while (!stack.empty())
+		{
+			const WideNode& wide = wide_nodes[stack.back()];
+			stack.pop_back();
+
+			__m128 entry;
+			int mask = intersectRay(wide.min_x, wide.min_y, wide.min_z, wide.max_x, wide.max_y, wide.max_z, origins, inverses, distance, entry);
+
+			for (int lane = 0; lane < BVH_WIDTH; lane++)
+			{
+				int32 child = wide.children[lane];
+
+				if ((mask & (1 << lane)) == 0 || child == -1)
+					continue;
+
+				if (child >= 0)
+					stack.push_back(child);
+				else
+					results.push_back(nodes[-2 - child].handle);
+			}
+		}
+	}
+
+	NodeHandle BVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, float* distance) const
+	{
+		RZ_ASSERT(!wide_dirty, "BVH queried before commit()");
+
+		NodeHandle closest = INVALID_NODE;
+		float best = max_distance;
+
+		if (wide_nodes.empty())
+			return closest;
+
+		__m128 origins[3] = { _mm_set1_ps(origin.x), _mm_set1_ps(origin.y), _mm_set1_ps(origin.z) };
+		__m128 inverses[3] = { _mm_set1_ps(1.0f / direction.x), _mm_set1_ps(1.0f / direction.y), _mm_set1_ps(1.0f / direction.z) };
+
+		ScratchScope scratch;
+		FrameVector<std::pair<int32, float>> stack(ArenaAllocator<std::pair<int32, float>>(&scratch.getArena(), "BVH"));
+		stack.push_back({ 0, 0.0f });
+
+		while (!stack.empty())
+		{
+			std::pair<int32, float> top = stack.back();
+			stack.pop_back();
+
+			if (top.second > best)
+				continue;
+
+			const WideNode& wide = wide_nodes[top.first];
+
+			alignas(16) float entries[BVH_WIDTH];
+			__m128 entry;
+			int mask = intersectRay(wide.min_x, wide.min_y, wide.min_z, wide.max_x, wide.max_y, wide.max_z, origins, inverses, _mm_set1_ps(best), entry);
+			_mm_store_ps(entries, entry);
+
+			// Children pushed farthest first so the closest is visited next
+			std::array<int, BVH_WIDTH> order;
+			int count = 0;
+
+			for (int lane = 0; lane < BVH_WIDTH; lane++)
+				if ((mask & (1 << lane)) && wide.children[lane] != -1)
+					order[count++] = lane;
+
+			std::sort(order.begin(), order.begin() + count, [&](int a, int b) { return entries[a] > entries[b]; });
+
+			for (int i = 0; i < count; i++)
+			{
+				int lane = order[i];
+				int32 child = wide.children[lane];
+
+				if (child >= 0)
+					stack.push_back({ child, entries[lane] });
+				else if (entries[lane] <= best)
+				{
+					best = entries[lane];
+					closest = nodes[-2 - child].handle;
+				}
+			}
+		}
+
+		if (distance != nullptr && closest.isValid())
+			*distance = best;
+
+		return closest;
+	}
+
+	void BVH::queryNearest(const glm::vec3& point, uint32 k, std::vector<NodeHandle>& results) const
+	{
+		RZ_ASSERT(!wide_dirty, "BVH queried before commit()");
+
+		if (wide_nodes.empty() || k == 0)
+			return;
+
+		__m128 px = _mm_set1_ps(point.x);
+		__m128 py = _mm_set1_ps(point.y);
+		__m128 pz = _mm_set1_ps(point.z);
+		__m128 zero = _mm_setzero_ps();
+
+		typedef std::pair<float, int32> Candidate;
+
+		// Nodes by increasing distance, found leaves with the farthest on top
+		std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> open;
+		std::priority_queue<Candidate> found;
+		open.push({ 0.0f, 0 });
+
+		while (!open.empty())
+		{
+			Candidate entry = open.top();
+			open.pop();
+
+			if (found.size() == k && entry.first >= found.top().first)
+				break;
+
+			const WideNode& wide = wide_nodes[entry.second];
+
+			__m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(wide.min_x), px), zero), _mm_max_ps(_mm_sub_ps(px, _mm_load_ps(wide.max_x)), zero));
+			__m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(wide.min_y), py), zero), _mm_max_ps(_mm_sub_ps(py, _mm_load_ps(wide.max_y)), zero));
+			__m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(wide.min_z), pz), zero), _mm_max_ps(_mm_sub_ps(pz, _mm_load_ps(wide.max_z)), zero));
+
+			alignas(16) float distances[BVH_WIDTH];
+			_mm_store_ps(distances, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+
+			for (int lane = 0; lane < BVH_WIDTH; lane++)
+			{
+				int32 child = wide.children[lane];
+
+				if (child == -1 || (found.size() == k && distances[lane] >= found.top().first))
+					continue;
+
+				if (child >= 0)
+				{
+					open.push({ distances[lane], child });
+					continue;
+				}
+
+				found.push({ distances[lane], -2 - child });
+
+				if (found.size() > k)
+					found.pop();
+			}
+		}
+
+		size_t first = results.size();
+		results.resize(first + found.size());
+
+		for (size_t i = results.size(); i > first; i--)
+		{
+			results[i - 1] = nodes[found.top().second].handle;
+			found.pop();
+		}
+	}
+
+}
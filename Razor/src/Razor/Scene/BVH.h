@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Razor/Scene/Node.h"
+#include "Razor/Maths/Frustum.h"
+
+// Leaves are stored enlarged so small moves don't touch the tree
+#define BVH_FAT_MARGIN 0.1f
+// Full rebuild once refits made the tree this much more expensive than built
+#define BVH_REBUILD_RATIO 1.5f
+#define BVH_REBUILD_MIN_LEAVES 64
+#define BVH_SAH_BINS 16
+#define BVH_WIDTH 4
+
+namespace Razor
+{
+
+	// Dynamic AABB tree over scene nodes, keyed by node handle.
+	// Insertions pick the sibling with the lowest surface area cost, moved
+	// leaves refit their ancestors and the whole tree is rebuilt with binned
+	// SAH once refits degraded it. Queries walk a 4 wide copy of the tree
+	// (SoA boxes, one SSE test for the four children) regenerated after
+	// insertions and removals, refits update it in place.
+	// Not thread safe, SceneGraph serializes the accesses.
+	class BVH
+	{
+	public:
+		BVH();
+		~BVH();
+
+		BVH(const BVH&) = delete;
+		BVH& operator=(const BVH&) = delete;
+
+		void insert(NodeHandle handle, const AABB& box);
+		// Refits the leaf when the box left its enlarged bounds, inserts unknown handles
+		void update(NodeHandle handle, const AABB& box);
+		void remove(NodeHandle handle);
+		bool contains(NodeHandle handle) const;
+		void clear();
+
+		// Rebuilds the tree if degraded and brings the 4 wide layout up to date,
+		// must be called after changes and before queries
+		void commit();
+		void rebuild();
+
+		// Queries append the handles of the overlapping leaves to results
+		void queryFrustum(const Frustum& frustum, std::vector<NodeHandle>& results) const;
+		void querySphere(const glm::vec3& center, float radius, std::vector<NodeHandle>& results) const;
+		void queryAABB(const AABB& box, std::vector<NodeHandle>& results) const;
+		void queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<NodeHandle>& results) const;
+		// Closest leaf box hit by the ray, INVALID_NODE when none
+		NodeHandle raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, float* distance = nullptr) const;
+		// The k leaves closest to point (box distance), closest first
+		void queryNearest(const glm::vec3& point, uint32 k, std::vector<NodeHandle>& results) const;
+
+		inline uint32 getLeafCount() const { return leaf_count; }
+		// Sum of the internal nodes areas
+		inline float getCost() const { return cost; }
+
+	private:
+		struct TreeNode
+		{
+			AABB box;
+			int32 parent;
+			int32 left;
+			int32 right;
+			NodeHandle handle;
+
+			inline bool isLeaf() const { return left < 0; }
+		};
+
+		// Children are wide node indices, leaves are encoded as -2 - tree node
+		// and unused lanes as -1 with an empty box
+		struct alignas(16) WideNode
+		{
+			float min_x[BVH_WIDTH];
+			float min_y[BVH_WIDTH];
+			float min_z[BVH_WIDTH];
+			float max_x[BVH_WIDTH];
+			float max_y[BVH_WIDTH];
+			float max_z[BVH_WIDTH];
+			int32 children[BVH_WIDTH];
+			// Wide node * BVH_WIDTH + lane holding this node, -1 for the root
+			int32 parent;
+		};
+
+		int32 allocate();
+		void release(int32 node);
+		void insertLeaf(int32 leaf);
+		void removeLeaf(int32 leaf);
+		// Recomputes the boxes from node up to the root, tracking the cost
+		void refitAncestors(int32 node);
+		int32 build(std::vector<int32>& leaves, size_t first, size_t last);
+
+		void collapse();
+		int32 collapseNode(int32 node, int32 parent);
+		void setLane(WideNode& wide, int lane, const AABB& box, int32 child);
+		void refitWide(int32 leaf);
+
+		static AABB fatten(const AABB& box);
+
+		std::vector<TreeNode> nodes;
+		int32 root;
+		int32 free_nodes;
+		// Tree node of each leaf, indexed by NodeHandle::index
+		std::vector<int32> leaves;
+		uint32 leaf_count;
+
+		float cost;
+		// Cost without the refits since the last rebuild
+		float built_cost;
+
+		std::vector<WideNode> wide_nodes;
+		// Lane of each tree leaf in the wide nodes (node * BVH_WIDTH + lane)
+		std::vector<int32> wide_lanes;
+		bool wide_dirty;
+	};
+
+}
@@ -0,0 +1,250 @@
+#include "rzpch.h"
+#include "FrameSnapshot.h"
+#include "Razor/Scene/Scene.h"
+#include "Razor/Cameras/Camera.h"
+#include "Razor/Lighting/Directional.h"
+#include "Razor/Lighting/Point.h"
+#include "Razor/Lighting/Spot.h"
+#include "Razor/Maths/Frustum.h"
+#include <glm/gtc/quaternion.hpp>
+
+namespace Razor
+{
+
+	FrameSnapshot::FrameSnapshot() :
+		valid(false),
+		frame(0),
+		delta(0.0),
+		camera(),
+		nodes({}),
+		history({}),
+		lights({}),
+		query({}),
+		scene_snapshot(nullptr)
+	{
+	}
+
+	FrameSnapshot::~FrameSnapshot()
+	{
+	}
+
+	void FrameSnapshot::clear()
+	{
+		valid = false;
+		nodes.clear();
+		lights.clear();
+		scene_snapshot = nullptr;
+	}
+
+	void FrameSnapshot::capture(Scene* scene, uint64 frame, double delta, const FrameSnapshot* previous)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		const std::vector<NodeState>* previous_nodes = nullptr;
+		CameraState previous_camera = camera;
+
+		if (previous == this && valid)
+		{
+			// Catch-up step overwriting this snapshot, keep the step before around
+			history.swap(nodes);
+			previous_nodes = &history;
+		}
+		else if (previous != nullptr && previous != this && previous->isValid())
+		{
+			previous_nodes = &previous->nodes;
+			previous_camera = previous->camera;
+		}
+
+		clear();
+
+		this->frame = frame;
+		this->delta = delta;
+
+		if (scene == nullptr)
+			return;
+
+		Camera* active_camera = scene->getActiveCamera();
+
+		if (active_camera != nullptr)
+		{
+			camera.view = active_camera->getViewMatrix();
+			camera.projection = active_camera->getProjectionMatrix();
+			camera.position = active_camera->getPosition();
+
+			bool has_previous = previous_nodes != nullptr;
+			camera.previous_view = has_previous ? previous_camera.view : camera.view;
+			camera.previous_position = has_previous ? previous_camera.position : camera.position;
+		}
+
+		SceneGraph* graph = scene->getSceneGraph();
+		graph->updateWorldMatrices();
+
+		if (active_camera != nullptr)
+		{
+			// Rendering interpolates the camera, anything in either frustum may be drawn
+			query.clear();
+			graph->queryFrustum(Frustum::fromMatrix(camera.projection * camera.view), query);
+
+			if (camera.previous_view != camera.view)
+				graph->queryFrustum(Frustum::fromMatrix(camera.projection * camera.previous_view), query);
+
+			std::sort(query.begin(), query.end(), [](NodeHandle a, NodeHandle b) { return a.index < b.index; });
+			query.erase(std::unique(query.begin(), query.end()), query.end());
+
+			for (NodeHandle handle : query)
+			{
+				Node* node = graph->getNode(handle).get();
+
+				if (node != nullptr)
+					nodes.push_back({ node, handle, node->world, node->world, {}, 0 });
+			}
+		}
+		else
+		{
+			for (auto& entry : graph->getFlatNodes())
+			{
+				if (entry.visible)
+					nodes.push_back({ entry.node, entry.node->handle, entry.node->world, entry.node->world, {}, 0 });
+			}
+
+			std::sort(nodes.begin(), nodes.end(), [](const NodeState& a, const NodeState& b) { return a.handle.index < b.handle.index; });
+		}
+
+		// Both lists are sorted by handle, only entries of the same node interpolate
+		size_t p = 0;
+
+		for (auto& state : nodes)
+		{
+			while (previous_nodes != nullptr && p < previous_nodes->size() && (*previous_nodes)[p].handle.index < state.handle.index)
+				p++;
+
+			bool matching = previous_nodes != nullptr && p < previous_nodes->size()
+				&& (*previous_nodes)[p].handle == state.handle && (*previous_nodes)[p].node == state.node;
+
+			state.previous_world = matching ? (*previous_nodes)[p].world : state.world;
+		}
+
+		for (auto& light : scene->getLights())
+		{
+			LightState state;
+			state.light = light.get();
+			state.type = light->getType();
+			state.position = glm::vec3(0.0f);
+			state.direction = glm::vec3(0.0f);
+			state.diffuse = light->getDiffuse();
+			state.intensity = light->getIntensity();
+			state.range = std::numeric_limits<float>::max();
+
+			switch (state.type)
+			{
+				case Light::Type::DIRECTIONAL:
+					state.position = ((Directional*)light.get())->getPosition();
+					state.direction = ((Directional*)light.get())->getDirection();
+					break;
+				case Light::Type::POINT:
+					state.position = ((Point*)light.get())->getPosition();
+					state.range = sqrtf(std::max(state.diffuse.x, std::max(state.diffuse.y, state.diffuse.z)) / SNAPSHOT_LIGHT_CUTOFF);
+					break;
+				case Light::Type::SPOT:
+					state.position = ((Spot*)light.get())->getPosition();
+					state.direction = ((Spot*)light.get())->getDirection();
+					break;
+				default:
+					break;
+			}
+
+			lights.push_back(state);
+		}
+
+		// Point lights only reach the nodes within their range
+		for (size_t l = 0; l < lights.size() && l <= 0xff; l++)
+		{
+			if (lights[l].type != Light::Type::POINT)
+				continue;
+
+			query.clear();
+			graph->querySphere(lights[l].position, lights[l].range, query);
+
+			for (NodeHandle handle : query)
+			{
+				auto it = std::lower_bound(nodes.begin(), nodes.end(), handle.index,
+					[](const NodeState& state, uint32 index) { return state.handle.index < index; });
+
+				if (it != nodes.end() && it->handle == handle)
+					assignLight(*it, (uint8)l);
+			}
+		}
+
+		valid = true;
+	}
+
+	glm::mat4 FrameSnapshot::interpolate(const glm::mat4& previous, const glm::mat4& current, float alpha)
+	{
+		// Static nodes, most of the snapshot
+		if (alpha >= 1.0f || previous == current)
+			return current;
+
+		glm::vec3 previous_scale(glm::length(glm::vec3(previous[0])), glm::length(glm::vec3(previous[1])), glm::length(glm::vec3(previous[2])));
+		glm::vec3 current_scale(glm::length(glm::vec3(current[0])), glm::length(glm::vec3(current[1])), glm::length(glm::vec3(current[2])));
+
+		// Degenerate axes have no rotation to recover
+		if (glm::min(glm::min(previous_scale.x, previous_scale.y), previous_scale.z) < 1e-6f
+			|| glm::min(glm::min(current_scale.x, current_scale.y), current_scale.z) < 1e-6f)
+			return previous + (current - previous) * alpha;
+
+		// Mirrored matrices keep a proper rotation with a negative x scale
+		if (glm::determinant(glm::mat3(previous)) < 0.0f)
+			previous_scale.x = -previous_scale.x;
+
+		if (glm::determinant(glm::mat3(current)) < 0.0f)
+			current_scale.x = -current_scale.x;
+
+		glm::mat3 previous_rotation(glm::vec3(previous[0]) / previous_scale.x, glm::vec3(previous[1]) / previous_scale.y, glm::vec3(previous[2]) / previous_scale.z);
+		glm::mat3 current_rotation(glm::vec3(current[0]) / current_scale.x, glm::vec3(current[1]) / current_scale.y, glm::vec3(current[2]) / current_scale.z);
+
+		glm::quat rotation = glm::slerp(glm::quat_cast(previous_rotation), glm::quat_cast(current_rotation), alpha);
+		glm::vec3 scale = glm::mix(previous_scale, current_scale, alpha);
+		glm::vec3 translation = glm::mix(glm::vec3(previous[3]), glm::vec3(current[3]), alpha);
+
+		glm::mat3 basis = glm::mat3_cast(rotation);
+		glm::mat4 result(1.0f);
+		result[0] = glm::vec4(basis[0] * scale.x, 0.0f);
+		result[1] = glm::vec4(basis[1] * scale.y, 0.0f);
+		result[2] = glm::vec4(basis[2] * scale.z, 0.0f);
+		result[3] = glm::vec4(translation, 1.0f);
+
+		return result;
+	}
+
+	void FrameSnapshot::assignLight(NodeState& state, uint8 light)
+	{
+		if (state.light_count < SNAPSHOT_NODE_LIGHTS)
+		{
+			state.lights[state.light_count++] = light;
+			return;
+		}
+
+		// Full, replaces the farthest light if this one is closer
+		glm::vec3 center = glm::vec3(state.world[3]);
+		glm::vec3 offset = lights[light].position - center;
+		float distance = glm::dot(offset, offset);
+		size_t farthest = 0;
+		float farthest_distance = 0.0f;
+
+		for (size_t i = 0; i < SNAPSHOT_NODE_LIGHTS; i++)
+		{
+			offset = lights[state.lights[i]].position - center;
+			float d = glm::dot(offset, offset);
+
+			if (d > farthest_distance)
+			{
+				farthest = i;
+				farthest_distance = d;
+			}
+		}
+
+		if (distance < farthest_distance)
+			state.lights[farthest] = light;
+	}
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Razor/Core/Core.h"
+#include "Razor/Lighting/Light.h"
+#include "Razor/Scene/Node.h"
+#include <glm/glm.hpp>
+
+// Point light slots of the PBR shader
+#define SNAPSHOT_NODE_LIGHTS 4
+// Radiance below which a point light is considered out of range (1 / d^2 falloff)
+#define SNAPSHOT_LIGHT_CUTOFF (1.0f / 256.0f)
+
+namespace Razor
+{
+
+	class Scene;
+	class SceneSnapshot;
+
+	class FrameSnapshot
+	{
+	public:
+		FrameSnapshot();
+		~FrameSnapshot();
+
+		// previous_* hold the state of the update before, so rendering can
+		// interpolate between the last two fixed steps
+		struct CameraState
+		{
+			glm::mat4 view;
+			glm::mat4 projection;
+			glm::vec3 position;
+			glm::mat4 previous_view;
+			glm::vec3 previous_position;
+		};
+
+		// Only the nodes in the camera frustums are captured, sorted by handle
+		struct NodeState
+		{
+			Node* node;
+			NodeHandle handle;
+			glm::mat4 world;
+			glm::mat4 previous_world;
+			// Closest point lights in range, indices in getLights()
+			std::array<uint8, SNAPSHOT_NODE_LIGHTS> lights;
+			uint8 light_count;
+		};
+
+		struct LightState
+		{
+			Light* light;
+			Light::Type type;
+			glm::vec3 position;
+			glm::vec3 direction;
+			glm::vec3 diffuse;
+			float intensity;
+			float range;
+		};
+
+		void capture(Scene* scene, uint64 frame, double delta, const FrameSnapshot* previous = nullptr);
+		void clear();
+
+		// Translation and scale are lerped, rotation is slerped so spinning
+		// objects don't shear between updates. Shear itself isn't kept.
+		static glm::mat4 interpolate(const glm::mat4& previous, const glm::mat4& current, float alpha);
+
+		inline bool isValid() const { return valid; }
+		inline uint64 getFrame() const { return frame; }
+		inline double getDelta() const { return delta; }
+
+		inline const CameraState& getCamera() const { return camera; }
+		inline const std::vector<NodeState>& getNodes() const { return nodes; }
+		inline const std::vector<LightState>& getLights() const { return lights; }
+
+		// Scene snapshot published by the same update, the draws of the nodes
+		// are read from it. Kept alive until the snapshot is captured again.
+		inline const SceneSnapshot* getSceneSnapshot() const { return scene_snapshot.get(); }
+		inline void setSceneSnapshot(const std::shared_ptr<const SceneSnapshot>& snapshot) { scene_snapshot = snapshot; }
+
+	private:
+		void assignLight(NodeState& state, uint8 light);
+
+		bool valid;
+		uint64 frame;
+		double delta;
+
+		CameraState camera;
+		std::vector<NodeState> nodes;
+		std::vector<NodeState> history;
+		std::vector<LightState> lights;
+		std::vector<NodeHandle> query;
+		std::shared_ptr<const SceneSnapshot> scene_snapshot;
+	};
+
+}
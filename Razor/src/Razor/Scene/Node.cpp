@@ -1,6 +1,7 @@
 #include "rzpch.h"
 #include "Node.h"
 #include "Razor/Lighting/Light.h"
+#include "Razor/Memory/Allocators.h"
 
 namespace Razor
 {
@@ -20,29 +21,46 @@ namespace Razor
 
 	Node::~Node()
 	{
-		for (auto light : lights)
-			light.reset();
+		// Children outliving this node (still referenced elsewhere) lose their parent
+		for (auto& node : nodes)
+		{
+			if (node->parent == this)
+				node->parent = nullptr;
+		}
+	}
 
-		for (auto mesh : meshes)
-			mesh.reset();
+	std::shared_ptr<Node> Node::create()
+	{
+		return std::allocate_shared<Node>(PoolStlAllocator<Node>());
+	}
 
-		for (auto node : nodes) {
-			node->parent.reset();
-			node.reset();
-		}
+	void Node::addChild(std::shared_ptr<Node> child)
+	{
+		child->parent = this;
+		nodes.push_back(child);
+		childrenDirty = true;
+	}
+
+	bool Node::removeChild(Node* child)
+	{
+		auto it = std::find_if(nodes.begin(), nodes.end(), [child](const std::shared_ptr<Node>& node) { return node.get() == child; });
+
+		if (it == nodes.end())
+			return false;
+
+		child->parent = nullptr;
+		nodes.erase(it);
+		childrenDirty = true;
 
-		parent.reset();
-		meshes.clear();
-		nodes.clear();
-		lights.clear();
+		return true;
 	}
 
-	void Node::setupMeshBuffers(std::shared_ptr<Node> node)
+	void Node::setupMeshBuffers(const std::shared_ptr<Node>& node)
 	{
-		for (auto mesh : node->meshes)
+		for (auto& mesh : node->meshes)
 			mesh->setupBuffers();
 
-		for (auto n : node->nodes)
+		for (auto& n : node->nodes)
 			setupMeshBuffers(n);
 	}
 
@@ -10,6 +10,19 @@
 namespace Razor 
 {
 
+	// Slot of a node in its SceneGraph, stays valid until the node is removed
+	struct NodeHandle
+	{
+		uint32 index;
+		uint32 generation;
+
+		inline bool operator==(const NodeHandle& other) const { return index == other.index && generation == other.generation; }
+		inline bool operator!=(const NodeHandle& other) const { return !(*this == other); }
+		inline bool isValid() const { return index != 0xffffffff; }
+	};
+
+	constexpr NodeHandle INVALID_NODE{ 0xffffffff, 0 };
+
 	class Node
 	{
 	public:
@@ -57,7 +70,14 @@ namespace Razor
 		}
 		~Node();
 
-		void setupMeshBuffers(std::shared_ptr<Node> node);
+		// Node and control block in one block of the size class pools
+		static std::shared_ptr<Node> create();
+
+		void setupMeshBuffers(const std::shared_ptr<Node>& node);
+
+		// Attach or detach a child and flag the hierarchy for the SceneGraph
+		void addChild(std::shared_ptr<Node> child);
+		bool removeChild(Node* child);
 
 		std::string name;
 		std::vector<std::shared_ptr<Node>> nodes;
@@ -66,11 +86,27 @@ namespace Razor
 		std::vector<std::shared_ptr<Camera>> cameras;
 		std::vector<std::shared_ptr<Landscape>> landscapes;
 		Transform transform;
-		std::shared_ptr<Node> parent;
+		// Not owning, parents own their children
+		Node* parent;
 		unsigned int id;
 		bool isInstance;
 		bool opened;
 		bool active;
+
+		// Cached parent world * local, kept up to date by SceneGraph::updateWorldMatrices().
+		// worldVersion is bumped every time it changes, localVersion is the
+		// transform version it was computed from.
+		glm::mat4 world = glm::mat4(1.0f);
+		unsigned int worldVersion = 0;
+		unsigned int localVersion = 0;
+
+		// Set by the SceneGraph the node belongs to, childIndex is the position
+		// of the node in its parent's list (or in the roots)
+		NodeHandle handle = INVALID_NODE;
+		uint32 childIndex = 0;
+		// Set when children are added or removed, cleared once the SceneGraph
+		// flattened the hierarchy again
+		bool childrenDirty = true;
 	};
 
 }
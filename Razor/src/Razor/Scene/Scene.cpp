@@ -1,5 +1,6 @@
 #include "rzpch.h"
 #include "Scene.h"
+#include "WorldPartition.h"
 
 #include "Razor/Rendering/ForwardRenderer.h"
 
@@ -12,22 +13,38 @@ namespace Razor
 		graph(nullptr),
 		active_camera(nullptr),
 		lights({}),
-		particle_systems({})
+		particle_systems({}),
+		partition(nullptr),
+		physics_world(nullptr)
 	{
 		graph = new SceneGraph();
 	}
 
 	Scene::~Scene()
 	{
+		setWorldPartition(nullptr, nullptr);
+
 		delete graph;
 	}
 
+	void Scene::setWorldPartition(WorldPartition* partition, World* world)
+	{
+		if (this->partition != nullptr)
+		{
+			this->partition->close(graph, physics_world);
+			delete this->partition;
+		}
+
+		this->partition = partition;
+		physics_world = world;
+	}
+
 	size_t Scene::getInstancesSize()
 	{
 		size_t sum = 0;
 
-		for (auto n : graph->getNodes())
-			for (auto m : n->meshes)
+		for (auto& n : graph->getNodes())
+			for (auto& m : n->meshes)
 				sum += m->getInstances().size();
 	
 		return sum;
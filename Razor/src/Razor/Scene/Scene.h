@@ -8,6 +8,8 @@ namespace Razor
 	class Camera;
 	class ParticleSystem;
 	class ForwardRenderer;
+	class WorldPartition;
+	class World;
 
 	class Scene
 	{
@@ -18,7 +20,9 @@ namespace Razor
 			graph(nullptr),
 			active_camera(nullptr),
 			lights({}),
-			particle_systems({})
+			particle_systems({}),
+			partition(nullptr),
+			physics_world(nullptr)
 		{}
 		Scene(const std::string& name);
 		~Scene();
@@ -47,6 +51,11 @@ namespace Razor
 		inline void addParticleSystem(ParticleSystem* system) { particle_systems.push_back(system); }
 		inline std::vector<ParticleSystem*>& getParticleSystems() { return particle_systems; }
 
+		// Streams the cells of a cooked world around the active camera, owned by the
+		// scene. Its bodies go to the physics world, the previous partition is closed.
+		inline WorldPartition* getWorldPartition() const { return partition; }
+		void setWorldPartition(WorldPartition* partition, World* world);
+
 	private:
 		bool active;
 		std::string name;
@@ -55,6 +64,8 @@ namespace Razor
 		std::vector<std::shared_ptr<Light>> lights;
 		std::vector<Camera*> cameras;
 		std::vector<ParticleSystem*> particle_systems;
+		WorldPartition* partition;
+		World* physics_world;
 	};
 
 }
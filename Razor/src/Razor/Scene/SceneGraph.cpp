@@ -3,7 +3,19 @@
 
 namespace Razor {
 
-	SceneGraph::SceneGraph() : nodes({}), index(0)
+	SceneGraph::SceneGraph() :
+		nodes({}),
+		index(1),
+		slots({}),
+		free_slots({}),
+		ids({}),
+		names_indexed(false),
+		names({}),
+		named_nodes({}),
+		flat_nodes({}),
+		flat_dirty(true),
+		force_update(true),
+		unbounded_nodes({})
 	{
 	}
 
@@ -11,40 +23,454 @@ namespace Razor {
 	{
 	}
 
-	void SceneGraph::addNode(std::shared_ptr<Node> node)
+	NodeHandle SceneGraph::addNode(std::shared_ptr<Node> node, NodeHandle parent)
 	{
-		node->id = index++;
-		nodes.push_back(node);
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		if (parent.isValid() && !isSlotValid(parent))
+			return INVALID_NODE;
+
+		if (parent.isValid())
+		{
+			Node* parent_node = slots[parent.index].node.get();
+			node->childIndex = (uint32)parent_node->nodes.size();
+			parent_node->addChild(node);
+		}
+		else
+		{
+			node->childIndex = (uint32)nodes.size();
+			node->parent = nullptr;
+			nodes.push_back(node);
+		}
+
+		registerNode(node, parent.index);
+		flat_dirty = true;
+
+		return node->handle;
 	}
 
 	bool SceneGraph::removeNode(unsigned int id)
 	{
-		std::vector<std::shared_ptr<Node>>::iterator it = std::find_if(nodes.begin(), nodes.end(), [=](const std::shared_ptr<Node> n) {
-			return n->id == id;
-		});
+		std::lock_guard<std::mutex> lock(graph_mutex);
 
-		if (it != nodes.end())
-		{
-			it->reset();
-			nodes.erase(it);
+		return detachNode(findHandle(id));
+	}
+
+	bool SceneGraph::removeNode(NodeHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		return detachNode(handle);
+	}
+
+	bool SceneGraph::detachNode(NodeHandle handle)
+	{
+		if (!isSlotValid(handle))
+			return false;
+
+		// Keeps the node alive until its subtree is unregistered
+		std::shared_ptr<Node> node = slots[handle.index].node;
+		uint32 parent = slots[handle.index].parent;
+		NodeList& siblings = parent != INVALID_NODE.index ? slots[parent].node->nodes : nodes;
 
-			return true;
+		uint32 child = node->childIndex;
+
+		// Children pushed without going through addNode() may have moved it
+		if (child >= siblings.size() || siblings[child] != node)
+			child = (uint32)(std::find(siblings.begin(), siblings.end(), node) - siblings.begin());
+
+		if (child < siblings.size())
+		{
+			siblings[child] = siblings.back();
+			siblings[child]->childIndex = child;
+			siblings.pop_back();
 		}
 
-		return false;
+		if (parent != INVALID_NODE.index)
+			slots[parent].node->childrenDirty = true;
+
+		node->parent = nullptr;
+		unregisterNode(node.get());
+		flat_dirty = true;
+
+		return true;
 	}
 
 	std::shared_ptr<Node> SceneGraph::getNodeById(unsigned int id)
 	{
-		std::vector<std::shared_ptr<Node>>::iterator it;
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		NodeHandle handle = findHandle(id);
+
+		return isSlotValid(handle) ? slots[handle.index].node : nullptr;
+	}
+
+	std::shared_ptr<Node> SceneGraph::getNode(NodeHandle handle) const
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		return isSlotValid(handle) ? slots[handle.index].node : nullptr;
+	}
+
+	NodeHandle SceneGraph::getHandle(unsigned int id) const
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		return findHandle(id);
+	}
+
+	bool SceneGraph::isValid(NodeHandle handle) const
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		return isSlotValid(handle);
+	}
+
+	NodeHandle SceneGraph::findHandle(unsigned int id) const
+	{
+		auto it = ids.find(id);
+
+		return it != ids.end() ? it->second : INVALID_NODE;
+	}
+
+	bool SceneGraph::isSlotValid(NodeHandle handle) const
+	{
+		return handle.index < slots.size()
+			&& slots[handle.index].generation == handle.generation
+			&& slots[handle.index].node != nullptr;
+	}
+
+	std::shared_ptr<Node> SceneGraph::getNodeByName(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		const std::vector<NodeHandle>& handles = findByName(name);
+
+		return handles.empty() ? nullptr : slots[handles[0].index].node;
+	}
+
+	std::vector<NodeHandle> SceneGraph::getNodesByName(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		return findByName(name);
+	}
+
+	const std::vector<NodeHandle>& SceneGraph::findByName(const std::string& name)
+	{
+		static const std::vector<NodeHandle> s_empty;
+
+		if (!names_indexed)
+		{
+			names_indexed = true;
+
+			for (uint32 i = 0; i < slots.size(); i++)
+				if (slots[i].node != nullptr)
+					indexName(slots[i], { i, slots[i].generation });
+		}
+
+		auto it = names.find(name);
+
+		return it != names.end() ? named_nodes[it->second] : s_empty;
+	}
+
+	void SceneGraph::renameNode(Node* node, const std::string& name)
+	{
+		// The editor writes into the string buffer, only keep what's before the terminator
+		std::string value(name.c_str());
+
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		if (!isSlotValid(node->handle) || slots[node->handle.index].node.get() != node)
+		{
+			node->name = value;
+			return;
+		}
+
+		Slot& slot = slots[node->handle.index];
+
+		if (names_indexed)
+			unindexName(slot, node->handle);
+
+		node->name = value;
+
+		if (names_indexed)
+			indexName(slot, node->handle);
+	}
+
+	void SceneGraph::registerNode(const std::shared_ptr<Node>& node, uint32 parent)
+	{
+		if (isSlotValid(node->handle) && slots[node->handle.index].node == node)
+			return;
+
+		uint32 slot_index;
+
+		if (!free_slots.empty())
+		{
+			slot_index = free_slots.back();
+			free_slots.pop_back();
+		}
+		else
+		{
+			slot_index = (uint32)slots.size();
+			slots.push_back({ nullptr, 0, INVALID_NODE.index, INVALID_NODE.index });
+		}
+
+		Slot& slot = slots[slot_index];
+		slot.node = node;
+		slot.parent = parent;
+		slot.name = INVALID_NODE.index;
+
+		node->handle = { slot_index, slot.generation };
+
+		// Ids set beforehand (loaded or re-added nodes) are kept unless taken, 0 is none
+		if (node->id == 0 || ids.find(node->id) != ids.end())
+			node->id = index++;
+		else
+			index = std::max(index, node->id + 1);
+
+		ids[node->id] = node->handle;
+
+		if (names_indexed)
+			indexName(slot, node->handle);
+
+		for (uint32 i = 0; i < node->nodes.size(); i++)
+		{
+			node->nodes[i]->childIndex = i;
+			registerNode(node->nodes[i], slot_index);
+		}
+	}
+
+	void SceneGraph::unregisterNode(Node* node, bool recursive)
+	{
+		if (!isSlotValid(node->handle) || slots[node->handle.index].node.get() != node)
+			return;
+
+		if (recursive)
+			for (auto& child : node->nodes)
+				unregisterNode(child.get());
+
+		uint32 slot_index = node->handle.index;
+		Slot& slot = slots[slot_index];
+
+		if (names_indexed)
+			unindexName(slot, node->handle);
+
+		ids.erase(node->id);
+		bvh.remove(node->handle);
+		node->handle = INVALID_NODE;
+
+		slot.generation++;
+		slot.parent = INVALID_NODE.index;
+		free_slots.push_back(slot_index);
+		// Last, this may delete the node
+		slot.node.reset();
+	}
+
+	uint32 SceneGraph::internName(const std::string& name)
+	{
+		auto it = names.find(name);
+
+		if (it != names.end())
+			return it->second;
+
+		uint32 name_id = (uint32)named_nodes.size();
+		names[name] = name_id;
+		named_nodes.push_back({});
+
+		return name_id;
+	}
+
+	void SceneGraph::indexName(Slot& slot, NodeHandle handle)
+	{
+		slot.name = internName(slot.node->name);
+		named_nodes[slot.name].push_back(handle);
+	}
+
+	void SceneGraph::unindexName(Slot& slot, NodeHandle handle)
+	{
+		if (slot.name == INVALID_NODE.index)
+			return;
+
+		std::vector<NodeHandle>& handles = named_nodes[slot.name];
+		auto it = std::find(handles.begin(), handles.end(), handle);
+
+		if (it != handles.end())
+			handles.erase(it);
+
+		slot.name = INVALID_NODE.index;
+	}
+
+	void SceneGraph::updateWorldMatrices()
+	{
+		RZ_PROFILE_FUNCTION();
+
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		if (flat_dirty)
+			flatten();
+
+		// Children attached through Node::addChild() flag their parent, the
+		// pass notices it before reaching them and starts over on the new hierarchy
+		if (!propagate())
+		{
+			flatten();
+			propagate();
+		}
+
+		bvh.commit();
+	}
+
+	void SceneGraph::flatten()
+	{
+		RZ_PROFILE_FUNCTION();
+
+		flat_nodes.clear();
+
+		for (uint32 i = 0; i < nodes.size(); i++)
+		{
+			nodes[i]->childIndex = i;
+			nodes[i]->parent = nullptr;
+			registerNode(nodes[i], INVALID_NODE.index);
+			flat_nodes.push_back({ nodes[i].get(), -1, false, false });
+		}
+
+		// Breadth first, the list grows while it's walked. Children attached
+		// without addNode() get their handle here.
+		for (size_t i = 0; i < flat_nodes.size(); i++)
+		{
+			Node* parent = flat_nodes[i].node;
+			parent->childrenDirty = false;
+
+			for (uint32 c = 0; c < parent->nodes.size(); c++)
+			{
+				std::shared_ptr<Node>& child = parent->nodes[c];
+				child->childIndex = c;
+				child->parent = parent;
+				registerNode(child, parent->handle.index);
+				flat_nodes.push_back({ child.get(), (int)i, false, false });
+			}
+		}
+
+		// Nodes detached from their parent without removeNode() are
+		// unregistered here, their children may have been moved elsewhere
+		std::vector<bool> reached(slots.size(), false);
+
+		for (const FlatNode& entry : flat_nodes)
+			reached[entry.node->handle.index] = true;
+
+		for (uint32 i = 0; i < slots.size(); i++)
+			if (slots[i].node != nullptr && !reached[i])
+				unregisterNode(slots[i].node.get(), false);
+
+		flat_dirty = false;
+		force_update = true;
+	}
+
+	bool SceneGraph::propagate()
+	{
+		unbounded_nodes.clear();
 
-		for (it = nodes.begin(); it != nodes.end(); ++it)
+		for (size_t i = 0; i < flat_nodes.size(); i++)
 		{
-			if ((*it)->id == id)
-				return *it;
+			FlatNode& entry = flat_nodes[i];
+			Node* node = entry.node;
+
+			if (node->childrenDirty)
+				return false;
+
+			unsigned int version = node->transform.getVersion();
+			bool parent_changed = entry.parent >= 0 && flat_nodes[entry.parent].changed;
+
+			entry.changed = force_update || parent_changed || version != node->localVersion;
+			entry.visible = node->active && (entry.parent < 0 || flat_nodes[entry.parent].visible);
+
+			if (entry.changed)
+			{
+				const glm::mat4& local = node->transform.getMatrix();
+				node->world = entry.parent >= 0 ? flat_nodes[entry.parent].node->world * local : local;
+				node->localVersion = version;
+				node->worldVersion++;
+			}
+
+			bool bounded = entry.visible && !node->meshes.empty();
+			bool unbounded = entry.visible && !node->landscapes.empty();
+
+			for (size_t m = 0; bounded && m < node->meshes.size(); m++)
+				if (!node->meshes[m]->getInstances().empty())
+					unbounded = true;
+
+			if (unbounded)
+			{
+				unbounded_nodes.push_back(node->handle);
+				bounded = false;
+			}
+
+			if (bounded && (entry.changed || !bvh.contains(node->handle)))
+				bvh.update(node->handle, getWorldBounds(node));
+			else if (!bounded)
+				bvh.remove(node->handle);
 		}
 
-		return nullptr;
+		force_update = false;
+
+		return true;
+	}
+
+	void SceneGraph::queryFrustum(const Frustum& frustum, std::vector<NodeHandle>& results)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		bvh.queryFrustum(frustum, results);
+		results.insert(results.end(), unbounded_nodes.begin(), unbounded_nodes.end());
+	}
+
+	void SceneGraph::querySphere(const glm::vec3& center, float radius, std::vector<NodeHandle>& results)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		bvh.querySphere(center, radius, results);
+		results.insert(results.end(), unbounded_nodes.begin(), unbounded_nodes.end());
+	}
+
+	void SceneGraph::queryAABB(const AABB& box, std::vector<NodeHandle>& results)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+		bvh.queryAABB(box, results);
+	}
+
+	void SceneGraph::queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<NodeHandle>& results)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+		bvh.queryRay(origin, direction, max_distance, results);
+	}
+
+	std::shared_ptr<Node> SceneGraph::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, float* distance)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+
+		NodeHandle handle = bvh.raycast(origin, direction, max_distance, distance);
+
+		return isSlotValid(handle) ? slots[handle.index].node : nullptr;
+	}
+
+	void SceneGraph::queryNearest(const glm::vec3& point, uint32 k, std::vector<NodeHandle>& results)
+	{
+		std::lock_guard<std::mutex> lock(graph_mutex);
+		bvh.queryNearest(point, k, results);
+	}
+
+	AABB SceneGraph::getWorldBounds(Node* node)
+	{
+		if (node->meshes.empty())
+			return AABB::fromMinMax(glm::vec3(node->world[3]), glm::vec3(node->world[3]));
+
+		AABB box = node->meshes[0]->getLocalBoundingBox().transform(node->world);
+
+		for (size_t i = 1; i < node->meshes.size(); i++)
+			box.merge(node->meshes[i]->getLocalBoundingBox().transform(node->world));
+
+		return box;
 	}
 
 }
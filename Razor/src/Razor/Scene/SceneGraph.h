@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Node.h"
+#include "BVH.h"
 
 namespace Razor 
 {
@@ -13,16 +14,103 @@ namespace Razor
 
 		typedef std::vector<std::shared_ptr<Node>> NodeList;
 
+		// Every node of the hierarchy sorted by depth, parents always come
+		// before their children so world matrices resolve in a single pass
+		struct FlatNode
+		{
+			Node* node;
+			int parent;
+			bool changed;
+			bool visible;
+		};
+
 		inline NodeList& getNodes() { return nodes; }
-		void addNode(std::shared_ptr<Node> node);
+		// Registers the node and its children, attached to parent or as a root
+		NodeHandle addNode(std::shared_ptr<Node> node, NodeHandle parent = INVALID_NODE);
 
+		// Detaches the node from its parent and unregisters its subtree,
+		// siblings are reordered (the last one takes its place)
 		bool removeNode(unsigned int id);
+		bool removeNode(NodeHandle handle);
 
+		// Lookups take the graph lock, they can run while the update job edits the graph
 		std::shared_ptr<Node> getNodeById(unsigned int id);
+		std::shared_ptr<Node> getNode(NodeHandle handle) const;
+		NodeHandle getHandle(unsigned int id) const;
+		bool isValid(NodeHandle handle) const;
+
+		// The name index is only built on the first lookup, names edited
+		// afterwards must go through renameNode() to stay indexed
+		std::shared_ptr<Node> getNodeByName(const std::string& name);
+		std::vector<NodeHandle> getNodesByName(const std::string& name);
+		void renameNode(Node* node, const std::string& name);
+
+		// Recomputes the world matrix of the nodes whose transform or one of
+		// their ancestors' changed since the last call, static nodes are skipped
+		void updateWorldMatrices();
+		inline const std::vector<FlatNode>& getFlatNodes() const { return flat_nodes; }
+
+		// Spatial queries over the visible nodes with meshes, as bounded by the
+		// last updateWorldMatrices() (enlarged boxes, results are conservative).
+		// Landscapes and nodes drawing instances can't be bounded from their
+		// own transform, frustum and sphere queries always return them.
+		void queryFrustum(const Frustum& frustum, std::vector<NodeHandle>& results);
+		void querySphere(const glm::vec3& center, float radius, std::vector<NodeHandle>& results);
+		void queryAABB(const AABB& box, std::vector<NodeHandle>& results);
+		void queryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, std::vector<NodeHandle>& results);
+		std::shared_ptr<Node> raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, float* distance = nullptr);
+		void queryNearest(const glm::vec3& point, uint32 k, std::vector<NodeHandle>& results);
+
+		// Union of the node meshes bounds in world space
+		static AABB getWorldBounds(Node* node);
 
 	private:
+		struct Slot
+		{
+			std::shared_ptr<Node> node;
+			uint32 generation;
+			uint32 parent;
+			// Interned name, 0xffffffff until the name index is built
+			uint32 name;
+		};
+
+		// Same as the public ones, with the lock held
+		bool detachNode(NodeHandle handle);
+		bool isSlotValid(NodeHandle handle) const;
+		NodeHandle findHandle(unsigned int id) const;
+		const std::vector<NodeHandle>& findByName(const std::string& name);
+		void registerNode(const std::shared_ptr<Node>& node, uint32 parent);
+		void unregisterNode(Node* node, bool recursive = true);
+
+		uint32 internName(const std::string& name);
+		void indexName(Slot& slot, NodeHandle handle);
+		void unindexName(Slot& slot, NodeHandle handle);
+
+		void flatten();
+		// False when a node's children changed since the last flatten
+		bool propagate();
+
 		NodeList nodes;
 		unsigned int index;
+
+		std::vector<Slot> slots;
+		std::vector<uint32> free_slots;
+		std::unordered_map<unsigned int, NodeHandle> ids;
+
+		bool names_indexed;
+		std::unordered_map<std::string, uint32> names;
+		std::vector<std::vector<NodeHandle>> named_nodes;
+
+		std::vector<FlatNode> flat_nodes;
+		bool flat_dirty;
+		bool force_update;
+
+		BVH bvh;
+		std::vector<NodeHandle> unbounded_nodes;
+		// Guards the slots, the id and name indices, the hierarchy edits and the
+		// BVH, the update may run on a job while the editor adds, removes or
+		// queries nodes
+		mutable std::mutex graph_mutex;
 	};
 
 }
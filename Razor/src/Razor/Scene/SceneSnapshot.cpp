@@ -0,0 +1,219 @@
+#include "rzpch.h"
+#include "SceneSnapshot.h"
+#include "Razor/Scene/SceneGraph.h"
+#include "Razor/Core/Metrics.h"
+
+namespace Razor
+{
+
+	bool SceneSnapshot::DrawState::operator==(const DrawState& other) const
+	{
+		return mesh == other.mesh && material == other.material && vao == other.vao && draw_mode == other.draw_mode
+			&& vertex_count == other.vertex_count && index_count == other.index_count
+			&& bounds.min_x == other.bounds.min_x && bounds.min_y == other.bounds.min_y && bounds.min_z == other.bounds.min_z
+			&& bounds.max_x == other.bounds.max_x && bounds.max_y == other.bounds.max_y && bounds.max_z == other.bounds.max_z
+			&& instanced == other.instanced && landscape == other.landscape
+			&& receives_shadows == other.receives_shadows && transparent == other.transparent;
+	}
+
+	SceneSnapshot::SceneSnapshot() :
+		version(0),
+		frame(0),
+		pages({}),
+		lights(std::make_shared<Lights>())
+	{
+	}
+
+	SceneSnapshot::~SceneSnapshot()
+	{
+	}
+
+	const SceneSnapshot::NodeRecord* SceneSnapshot::getNode(NodeHandle handle) const
+	{
+		uint32 page = handle.index / SNAPSHOT_PAGE_SIZE;
+
+		if (!handle.isValid() || page >= pages.size())
+			return nullptr;
+
+		const NodeRecord& record = pages[page]->records[handle.index % SNAPSHOT_PAGE_SIZE];
+
+		return record.handle == handle ? &record : nullptr;
+	}
+
+	SnapshotPublisher::SnapshotPublisher() :
+		published(nullptr),
+		writable({}),
+		seen({}),
+		current({})
+	{
+	}
+
+	SnapshotPublisher::~SnapshotPublisher()
+	{
+	}
+
+	void SnapshotPublisher::publish(SceneGraph* graph, const FrameSnapshot& frame)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		std::shared_ptr<const SceneSnapshot> previous = get();
+		std::shared_ptr<SceneSnapshot> snapshot = std::make_shared<SceneSnapshot>();
+
+		snapshot->frame = frame.getFrame();
+
+		if (previous != nullptr)
+		{
+			snapshot->version = previous->version + 1;
+			snapshot->pages = previous->pages;
+			snapshot->lights = previous->lights;
+		}
+		else
+			snapshot->version = 1;
+
+		writable.assign(snapshot->pages.size(), nullptr);
+
+		for (auto& entry : graph->getFlatNodes())
+		{
+			Node* node = entry.node;
+			uint32 index = node->handle.index;
+
+			if (index >= seen.size())
+				seen.resize((size_t)index + 1, 0);
+
+			seen[index] = snapshot->version;
+
+			const SceneSnapshot::NodeRecord* published = snapshot->getNode(node->handle);
+
+			captureDraws(node, current);
+
+			bool moved = published == nullptr || published->world_version != node->worldVersion || published->visible != entry.visible;
+			bool rebound = published == nullptr || drawsChanged(published->draws, current);
+
+			if (!moved && !rebound)
+				continue;
+
+			SceneSnapshot::NodeRecord& record = write(*snapshot, index);
+			record.handle = node->handle;
+			record.id = node->id;
+			record.world_version = node->worldVersion;
+			record.visible = entry.visible;
+			record.world = node->world;
+
+			if (rebound)
+				record.draws = current.empty() ? nullptr : std::make_shared<SceneSnapshot::DrawStates>(current);
+		}
+
+		// Records of the nodes the pass didn't reach were removed from the graph
+		for (uint32 page = 0; page < snapshot->pages.size(); page++)
+		{
+			for (uint32 i = 0; i < SNAPSHOT_PAGE_SIZE; i++)
+			{
+				uint32 index = page * SNAPSHOT_PAGE_SIZE + i;
+
+				if (snapshot->pages[page]->records[i].handle.isValid() && seen[index] != snapshot->version)
+					write(*snapshot, index) = SceneSnapshot::NodeRecord();
+			}
+		}
+
+		if (lightsChanged(*snapshot->lights, frame.getLights()))
+			snapshot->lights = std::make_shared<SceneSnapshot::Lights>(frame.getLights());
+
+		writable.clear();
+		// Would keep the meshes of the last node alive
+		current.clear();
+		std::atomic_store(&published, std::shared_ptr<const SceneSnapshot>(snapshot));
+	}
+
+	void SnapshotPublisher::clear()
+	{
+		std::atomic_store(&published, std::shared_ptr<const SceneSnapshot>(nullptr));
+		seen.clear();
+	}
+
+	std::shared_ptr<const SceneSnapshot> SnapshotPublisher::get() const
+	{
+		return std::atomic_load(&published);
+	}
+
+	SceneSnapshot::NodeRecord& SnapshotPublisher::write(SceneSnapshot& snapshot, uint32 index)
+	{
+		static Counter& s_copied = Metrics::counter("scene.snapshot_pages_copied", "Snapshot pages copied on write");
+
+		uint32 page = index / SNAPSHOT_PAGE_SIZE;
+
+		while (snapshot.pages.size() <= page)
+		{
+			std::shared_ptr<SceneSnapshot::Page> fresh = std::make_shared<SceneSnapshot::Page>();
+			fresh->version = snapshot.version;
+			snapshot.pages.push_back(fresh);
+			writable.push_back(fresh);
+		}
+
+		if (writable[page] == nullptr)
+		{
+			// Still shared with the published versions
+			writable[page] = std::make_shared<SceneSnapshot::Page>(*snapshot.pages[page]);
+			writable[page]->version = snapshot.version;
+			snapshot.pages[page] = writable[page];
+			s_copied.add();
+		}
+
+		return writable[page]->records[index % SNAPSHOT_PAGE_SIZE];
+	}
+
+	void SnapshotPublisher::captureDraws(Node* node, SceneSnapshot::DrawStates& draws)
+	{
+		draws.clear();
+
+		auto capture = [&](const std::shared_ptr<StaticMesh>& mesh, bool landscape)
+		{
+			SceneSnapshot::DrawState draw;
+			draw.mesh             = mesh;
+			draw.material         = mesh->getMaterial();
+			draw.vao              = mesh->getVao();
+			draw.draw_mode        = mesh->getDrawMode();
+			draw.vertex_count     = (uint32)mesh->getVertexCount();
+			draw.index_count      = (uint32)mesh->getIndices().size();
+			draw.bounds           = mesh->getLocalBoundingBox();
+			draw.instanced        = !mesh->getInstances().empty();
+			draw.landscape        = landscape;
+			draw.receives_shadows = mesh->isReceivingShadows();
+			draw.transparent      = !landscape && draw.material != nullptr && draw.material->hasOpacityMap();
+
+			draws.push_back(draw);
+		};
+
+		for (auto& mesh : node->meshes)
+			capture(mesh, false);
+
+		for (auto& landscape : node->landscapes)
+			capture(landscape->getMesh(), true);
+	}
+
+	bool SnapshotPublisher::drawsChanged(const std::shared_ptr<const SceneSnapshot::DrawStates>& draws, const SceneSnapshot::DrawStates& current)
+	{
+		if (draws == nullptr)
+			return !current.empty();
+
+		return *draws != current;
+	}
+
+	bool SnapshotPublisher::lightsChanged(const SceneSnapshot::Lights& lights, const SceneSnapshot::Lights& frame)
+	{
+		if (lights.size() != frame.size())
+			return true;
+
+		for (size_t i = 0; i < lights.size(); i++)
+		{
+			const FrameSnapshot::LightState& a = lights[i];
+			const FrameSnapshot::LightState& b = frame[i];
+
+			if (a.light != b.light || a.type != b.type || a.position != b.position || a.direction != b.direction
+				|| a.diffuse != b.diffuse || a.intensity != b.intensity || a.range != b.range)
+				return true;
+		}
+
+		return false;
+	}
+
+}
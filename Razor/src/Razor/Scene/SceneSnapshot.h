@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Razor/Scene/FrameSnapshot.h"
+
+// Node records per copy-on-write page
+#define SNAPSHOT_PAGE_SIZE 64
+
+namespace Razor
+{
+
+	class SceneGraph;
+
+	// Immutable view of the scene published at the end of an update. Readers
+	// on other threads keep the shared_ptr as long as they need it, the live
+	// scene is never touched. Records are indexed by node handle and grouped
+	// in pages shared between the versions they didn't change in.
+	class SceneSnapshot
+	{
+	public:
+		// Draw of a mesh as read when its node was published. The render queue
+		// and the culler only read these copies, the mesh and the material are
+		// kept alive by the snapshot and only used on the GL thread to bind and
+		// submit with the counts read here.
+		struct DrawState
+		{
+			std::shared_ptr<StaticMesh> mesh;
+			std::shared_ptr<Material> material;
+			VertexArray* vao = nullptr;
+			StaticMesh::DrawMode draw_mode = StaticMesh::DrawMode::TRIANGLES;
+			uint32 vertex_count = 0;
+			uint32 index_count = 0;
+			AABB bounds;
+			// Instances are placed by their own matrices, they can't be bounded
+			bool instanced = false;
+			bool landscape = false;
+			bool receives_shadows = false;
+			bool transparent = false;
+
+			bool operator==(const DrawState& other) const;
+			inline bool operator!=(const DrawState& other) const { return !(*this == other); }
+		};
+
+		// Meshes in node order, then the landscapes
+		typedef std::vector<DrawState> DrawStates;
+
+		struct NodeRecord
+		{
+			NodeHandle handle = INVALID_NODE;
+			unsigned int id = 0;
+			unsigned int world_version = 0;
+			bool visible = false;
+			glm::mat4 world = glm::mat4(1.0f);
+			// Shared between versions until a draw of the node changes
+			std::shared_ptr<const DrawStates> draws;
+		};
+
+		struct Page
+		{
+			std::array<NodeRecord, SNAPSHOT_PAGE_SIZE> records;
+			// Snapshot version that last wrote the page
+			uint64 version = 0;
+		};
+
+		typedef std::vector<FrameSnapshot::LightState> Lights;
+
+		SceneSnapshot();
+		~SceneSnapshot();
+
+		// Null for a stale or unknown handle
+		const NodeRecord* getNode(NodeHandle handle) const;
+
+		// Calls function(const NodeRecord&) for every live node, in handle order
+		template<typename Function>
+		void forEach(Function function) const
+		{
+			for (auto& page : pages)
+				for (auto& record : page->records)
+					if (record.handle.isValid())
+						function(record);
+		}
+
+		inline uint64 getVersion() const { return version; }
+		inline uint64 getFrame() const { return frame; }
+		inline const std::vector<std::shared_ptr<const Page>>& getPages() const { return pages; }
+		// Light pointers are only there to identify them, don't dereference them
+		inline const Lights& getLights() const { return *lights; }
+
+	private:
+		friend class SnapshotPublisher;
+
+		uint64 version;
+		uint64 frame;
+		std::vector<std::shared_ptr<const Page>> pages;
+		std::shared_ptr<const Lights> lights;
+	};
+
+	// Builds the next SceneSnapshot from the live scene on the update thread,
+	// copying only the pages holding changed nodes, and publishes it
+	class SnapshotPublisher
+	{
+	public:
+		SnapshotPublisher();
+		~SnapshotPublisher();
+
+		SnapshotPublisher(const SnapshotPublisher&) = delete;
+		SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+		// The graph world matrices must be up to date, FrameSnapshot::capture() does it
+		void publish(SceneGraph* graph, const FrameSnapshot& frame);
+		void clear();
+
+		// Safe from any thread
+		std::shared_ptr<const SceneSnapshot> get() const;
+
+	private:
+		SceneSnapshot::NodeRecord& write(SceneSnapshot& snapshot, uint32 index);
+		static void captureDraws(Node* node, SceneSnapshot::DrawStates& draws);
+		static bool drawsChanged(const std::shared_ptr<const SceneSnapshot::DrawStates>& draws, const SceneSnapshot::DrawStates& current);
+		static bool lightsChanged(const SceneSnapshot::Lights& lights, const SceneSnapshot::Lights& frame);
+
+		std::shared_ptr<const SceneSnapshot> published;
+		// Pages cloned by the snapshot being built, null while still shared
+		std::vector<std::shared_ptr<SceneSnapshot::Page>> writable;
+		// Version that last saw the node of each slot, the others were removed
+		std::vector<uint64> seen;
+		// Draws of the node being published, reused between nodes
+		SceneSnapshot::DrawStates current;
+	};
+
+}
@@ -0,0 +1,844 @@
+#include "rzpch.h"
+#include "WorldPartition.h"
+#include "Razor/Scene/Scene.h"
+#include "Razor/Core/JobSystem.h"
+#include "Razor/Core/GameLoop.h"
+#include "Razor/Core/Metrics.h"
+#include "Razor/Filesystem/Serializer.h"
+#include "Razor/Materials/Texture.h"
+#include "Razor/Physics/World.h"
+#include "Razor/Physics/Bodies/CubePhysicsBody.h"
+#include "Razor/Physics/Bodies/SpherePhysicsBody.h"
+
+namespace Razor
+{
+
+	static const Material::TextureType s_textureTypes[] =
+	{
+		Material::TextureType::Diffuse,
+		Material::TextureType::Specular,
+		Material::TextureType::Normal,
+		Material::TextureType::Metallic,
+		Material::TextureType::Roughness,
+		Material::TextureType::Ao,
+		Material::TextureType::Orm,
+		Material::TextureType::Opacity,
+		Material::TextureType::Emissive
+	};
+
+	static std::string getCellFilename(int32 x, int32 z)
+	{
+		return "cell_" + std::to_string(x) + "_" + std::to_string(z) + ".rzc";
+	}
+
+	static size_t getUploadSize(StaticMesh* mesh)
+	{
+		size_t floats = mesh->getVertices().size() + mesh->getNormals().size() + mesh->getUvs().size() + mesh->getTangents().size();
+
+		return floats * sizeof(float) + mesh->getIndices().size() * sizeof(unsigned int);
+	}
+
+	WorldPartition::WorldPartition() :
+		directory(""),
+		cell_size(WORLD_CELL_SIZE),
+		margin(0.0f),
+		radius(WORLD_STREAMING_RADIUS),
+		hysteresis(WORLD_STREAMING_HYSTERESIS),
+		upload_budget(WORLD_UPLOAD_BUDGET),
+		cells({}),
+		resident({}),
+		candidates({}),
+		pending_loads(0),
+		uploads({}),
+		retired({})
+	{
+	}
+
+	WorldPartition::~WorldPartition()
+	{
+		close(nullptr, nullptr);
+	}
+
+	bool WorldPartition::cook(Scene* scene, const std::string& directory, float cell_size)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		struct CookedCell
+		{
+			AABB bounds;
+			std::vector<Node*> roots;
+		};
+
+		SceneGraph* graph = scene->getSceneGraph();
+		graph->updateWorldMatrices();
+
+		std::map<int64, CookedCell> cooked;
+		std::vector<Node*> stack;
+
+		for (auto& root : graph->getNodes())
+		{
+			AABB bounds;
+			bool bounded = false;
+			bool cookable = true;
+
+			stack.assign(1, root.get());
+
+			while (!stack.empty())
+			{
+				Node* node = stack.back();
+				stack.pop_back();
+
+				if (!node->landscapes.empty() || !node->lights.empty() || !node->cameras.empty())
+					cookable = false;
+
+				if (!node->meshes.empty())
+				{
+					AABB box = SceneGraph::getWorldBounds(node);
+
+					if (bounded)
+						bounds.merge(box);
+					else
+						bounds = box;
+
+					bounded = true;
+				}
+
+				for (auto& child : node->nodes)
+					stack.push_back(child.get());
+			}
+
+			if (!bounded || !cookable)
+				continue;
+
+			glm::vec3 center = bounds.getCenter();
+			int32 x = (int32)std::floor(center.x / cell_size);
+			int32 z = (int32)std::floor(center.z / cell_size);
+
+			CookedCell& cell = cooked[getKey(x, z)];
+
+			if (cell.roots.empty())
+				cell.bounds = bounds;
+			else
+				cell.bounds.merge(bounds);
+
+			cell.roots.push_back(root.get());
+		}
+
+		Serializer serializer;
+		std::ofstream index(directory + "/" + WORLD_INDEX_FILENAME, std::ios::binary);
+
+		if (!index)
+		{
+			Log::error("World partition: Can't write the index in %s", directory.c_str());
+			return false;
+		}
+
+		uint32 magic = WORLD_INDEX_MAGIC;
+		uint32 version = WORLD_FORMAT_VERSION;
+		uint32 cells_count = (uint32)cooked.size();
+
+		serializer.writeData<uint32>(index, &magic);
+		serializer.writeData<uint32>(index, &version);
+		serializer.writeData<float>(index, &cell_size);
+		serializer.writeData<uint32>(index, &cells_count);
+
+		std::vector<std::pair<Node*, int32>> nodes;
+		size_t meshes_count = 0;
+
+		for (auto& entry : cooked)
+		{
+			int32 x = (int32)(entry.first >> 32);
+			int32 z = (int32)(uint32)entry.first;
+
+			serializer.writeData<int32>(index, &x);
+			serializer.writeData<int32>(index, &z);
+			serializer.writeData<AABB>(index, &entry.second.bounds);
+
+			// Parents are written before their children
+			nodes.clear();
+
+			for (Node* root : entry.second.roots)
+			{
+				size_t first = nodes.size();
+				nodes.push_back({ root, -1 });
+
+				for (size_t n = first; n < nodes.size(); n++)
+					for (auto& child : nodes[n].first->nodes)
+						nodes.push_back({ child.get(), (int32)n });
+			}
+
+			std::ofstream out(directory + "/" + getCellFilename(x, z), std::ios::binary);
+
+			if (!out)
+			{
+				Log::error("World partition: Can't write the cell %d, %d in %s", x, z, directory.c_str());
+				return false;
+			}
+
+			uint32 cell_magic = WORLD_CELL_MAGIC;
+			uint32 nodes_count = (uint32)nodes.size();
+
+			serializer.writeData<uint32>(out, &cell_magic);
+			serializer.writeData<uint32>(out, &version);
+			serializer.writeData<uint32>(out, &nodes_count);
+
+			for (auto& record : nodes)
+			{
+				Node* node = record.first;
+				uint32 node_meshes = (uint32)node->meshes.size();
+
+				serializer.writeData<int32>(out, &record.second);
+				serializer.writeString(out, &node->name);
+				serializer.writeData<glm::vec3>(out, &node->transform.getPosition());
+				serializer.writeData<glm::vec3>(out, &node->transform.getRotation());
+				serializer.writeData<glm::vec3>(out, &node->transform.getScale());
+				serializer.writeData<uint32>(out, &node_meshes);
+
+				for (auto& mesh : node->meshes)
+				{
+					serializer.writeString(out, &mesh->getName());
+					serializer.writeArray<float>(out, &mesh->getVertices());
+					serializer.writeArray<float>(out, &mesh->getNormals());
+					serializer.writeArray<float>(out, &mesh->getUvs());
+					serializer.writeArray<float>(out, &mesh->getTangents());
+					serializer.writeArray<unsigned int>(out, &mesh->getIndices());
+					serializer.writeData<AABB>(out, &mesh->getLocalBoundingBox());
+
+					// Materials keep their preset, its parameters and their texture paths
+					std::shared_ptr<Material> material = mesh->getMaterial();
+					RzaMaterialParameters parameters = Serializer::getMaterialParameters(material.get());
+					std::string material_name = material != nullptr ? material->getName() : "";
+
+					serializer.writeString(out, &material_name);
+					serializer.writeData<RzaMaterialParameters>(out, &parameters);
+
+					for (Material::TextureType type : s_textureTypes)
+					{
+						std::string path = material != nullptr ? material->getTexturePath(type) : "";
+						serializer.writeString(out, &path);
+					}
+
+					PhysicsBody* body = mesh->getPhysicsBody();
+					Collider collider = Collider::None;
+					glm::vec3 extents = glm::vec3(0.0f);
+					float mass = body != nullptr ? body->mass : 0.0f;
+
+					if (CubePhysicsBody* cube = dynamic_cast<CubePhysicsBody*>(body))
+					{
+						collider = Collider::Box;
+						extents = cube->getExtents();
+					}
+					else if (SpherePhysicsBody* sphere = dynamic_cast<SpherePhysicsBody*>(body))
+					{
+						collider = Collider::Sphere;
+						extents = glm::vec3(sphere->getRadius());
+					}
+
+					serializer.writeData<Collider>(out, &collider);
+					serializer.writeData<float>(out, &mass);
+					serializer.writeData<glm::vec3>(out, &extents);
+				}
+
+				meshes_count += node->meshes.size();
+			}
+		}
+
+		Log::trace("World partition: Cooked %d cells (%d meshes) to %s", (int)cooked.size(), (int)meshes_count, directory.c_str());
+
+		return true;
+	}
+
+	bool WorldPartition::open(const std::string& directory)
+	{
+		if (isOpened())
+		{
+			Log::error("World partition: %s is already opened", this->directory.c_str());
+			return false;
+		}
+
+		Serializer serializer;
+		std::ifstream in(directory + "/" + WORLD_INDEX_FILENAME, std::ios::binary);
+
+		uint32 magic = 0;
+		uint32 version = 0;
+		uint32 cells_count = 0;
+
+		serializer.readData<uint32>(in, &magic);
+		serializer.readData<uint32>(in, &version);
+		serializer.readData<float>(in, &cell_size);
+		serializer.readData<uint32>(in, &cells_count);
+
+		if (!in || magic != WORLD_INDEX_MAGIC || version != WORLD_FORMAT_VERSION || cell_size <= 0.0f)
+		{
+			Log::error("World partition: %s doesn't hold a world of version %d", directory.c_str(), WORLD_FORMAT_VERSION);
+			cell_size = WORLD_CELL_SIZE;
+			return false;
+		}
+
+		this->directory = directory;
+		margin = 0.0f;
+
+		for (uint32 i = 0; i < cells_count && in; i++)
+		{
+			Cell* cell = new Cell();
+
+			serializer.readData<int32>(in, &cell->x);
+			serializer.readData<int32>(in, &cell->z);
+			serializer.readData<AABB>(in, &cell->bounds);
+			cell->filename = getCellFilename(cell->x, cell->z);
+
+			float min_x = cell->x * cell_size;
+			float min_z = cell->z * cell_size;
+
+			margin = std::max(margin, std::max(min_x - cell->bounds.min_x, cell->bounds.max_x - (min_x + cell_size)));
+			margin = std::max(margin, std::max(min_z - cell->bounds.min_z, cell->bounds.max_z - (min_z + cell_size)));
+
+			cells.push_back(cell);
+			grid[getKey(cell->x, cell->z)] = cell;
+		}
+
+		Log::trace("World partition: Opened %s (%d cells)", directory.c_str(), (int)cells.size());
+
+		return true;
+	}
+
+	void WorldPartition::close(SceneGraph* graph, World* world)
+	{
+		while (pending_loads.load() > 0)
+			std::this_thread::yield();
+
+		for (Cell* cell : cells)
+		{
+			if (cell->state == State::Active)
+			{
+				for (auto& node : cell->bodies)
+					if (world != nullptr)
+						world->removeNode(node);
+
+				for (NodeHandle handle : cell->handles)
+					if (graph != nullptr)
+						graph->removeNode(handle);
+			}
+
+			release(cell);
+			delete cell;
+		}
+
+		cells.clear();
+		grid.clear();
+		resident.clear();
+		uploads.clear();
+		retired.clear();
+
+		for (auto& entry : textures)
+			delete entry.second.texture;
+
+		textures.clear();
+	}
+
+	void WorldPartition::update(Camera* camera, SceneGraph* graph, World* world, uint64 frame)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		static Gauge& s_resident = Metrics::gauge("world.resident_cells", "World partition cells loaded or in flight");
+
+		if (cells.empty() || camera == nullptr)
+			return;
+
+		glm::vec3 position = camera->getPosition();
+		glm::vec3 direction = camera->getDirection();
+		float unload_distance = radius + hysteresis;
+
+		for (size_t i = 0; i < resident.size();)
+		{
+			Cell* cell = resident[i];
+			bool wanted = getDistance(cell, position) <= unload_distance;
+
+			switch (cell->state.load(std::memory_order_acquire))
+			{
+				case State::Unloaded:
+				case State::Failed:
+					cell->listed = false;
+					resident[i] = resident.back();
+					resident.pop_back();
+					continue;
+
+				case State::Loaded:
+					if (wanted)
+					{
+						std::lock_guard<std::mutex> lock(upload_mutex);
+						cell->priority = getPriority(cell, position, direction);
+						cell->state.store(State::Uploading, std::memory_order_release);
+						uploads.push_back(cell);
+					}
+					// Nothing was sent to GL yet, the textures it pinned are released on the main thread
+					else
+						retire(cell, frame);
+					break;
+
+				case State::Ready:
+					if (wanted)
+						attach(cell, graph, world);
+					else
+						retire(cell, frame);
+					break;
+
+				case State::Active:
+					if (!wanted)
+						detach(cell, graph, world, frame);
+					break;
+
+				default:
+					break;
+			}
+
+			i++;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(upload_mutex);
+
+			for (Cell* cell : uploads)
+				cell->priority = getPriority(cell, position, direction);
+		}
+
+		// Only the grid squares around the camera are looked at
+		float reach = radius + margin;
+		int32 min_x = (int32)std::floor((position.x - reach) / cell_size);
+		int32 max_x = (int32)std::floor((position.x + reach) / cell_size);
+		int32 min_z = (int32)std::floor((position.z - reach) / cell_size);
+		int32 max_z = (int32)std::floor((position.z + reach) / cell_size);
+
+		candidates.clear();
+
+		for (int32 x = min_x; x <= max_x; x++)
+		{
+			for (int32 z = min_z; z <= max_z; z++)
+			{
+				auto it = grid.find(getKey(x, z));
+
+				if (it == grid.end())
+					continue;
+
+				Cell* cell = it->second;
+
+				if (cell->listed || cell->state.load(std::memory_order_acquire) != State::Unloaded || getDistance(cell, position) > radius)
+					continue;
+
+				cell->priority = getPriority(cell, position, direction);
+				candidates.push_back(cell);
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const Cell* a, const Cell* b) { return a->priority < b->priority; });
+
+		for (Cell* cell : candidates)
+		{
+			if (pending_loads.load() >= WORLD_MAX_PENDING_LOADS)
+				break;
+
+			cell->listed = true;
+			cell->state.store(State::Loading, std::memory_order_release);
+			resident.push_back(cell);
+			pending_loads++;
+
+			JobSystem::get().schedule([this, cell]()
+			{
+				bool loaded = load(cell);
+
+				if (!loaded)
+					release(cell);
+
+				cell->state.store(loaded ? State::Loaded : State::Failed, std::memory_order_release);
+				pending_loads--;
+			});
+		}
+
+		s_resident.set((double)resident.size());
+	}
+
+	void WorldPartition::upload(uint64 frame)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		static Counter& s_uploaded = Metrics::counter("world.meshes_uploaded", "World partition meshes sent to GL");
+		static Counter& s_texturesUploaded = Metrics::counter("world.textures_uploaded", "World partition textures sent to GL");
+
+		{
+			std::lock_guard<std::mutex> lock(upload_mutex);
+
+			// The frame snapshots still being rendered may point to their nodes
+			auto released = std::partition(retired.begin(), retired.end(), [&](const Cell* cell)
+			{
+				return cell->retired_frame + FRAME_SNAPSHOTS > frame;
+			});
+
+			releasing.assign(released, retired.end());
+			retired.erase(released, retired.end());
+
+			std::sort(uploads.begin(), uploads.end(), [](const Cell* a, const Cell* b) { return a->priority < b->priority; });
+			uploading.assign(uploads.begin(), uploads.end());
+		}
+
+		for (Cell* cell : releasing)
+		{
+			release(cell);
+			cell->state.store(State::Unloaded, std::memory_order_release);
+		}
+
+		size_t spent = 0;
+
+		for (Cell* cell : uploading)
+		{
+			// Textures first, the meshes bind them as they go
+			while (!cell->images.empty() && (spent == 0 || spent < upload_budget))
+			{
+				auto it = cell->images.begin();
+				size_t size = uploadTexture(cell, it->first, it->second);
+
+				if (size > 0)
+					s_texturesUploaded.add();
+
+				spent += size;
+				cell->images.erase(it);
+			}
+
+			while (cell->images.empty() && cell->uploaded < cell->meshes.size() && (spent == 0 || spent < upload_budget))
+			{
+				std::shared_ptr<StaticMesh>& mesh = cell->meshes[cell->uploaded++];
+
+				spent += getUploadSize(mesh.get());
+				uploadMesh(cell, mesh);
+				s_uploaded.add();
+			}
+
+			if (cell->images.empty() && cell->uploaded == cell->meshes.size())
+			{
+				std::lock_guard<std::mutex> lock(upload_mutex);
+
+				uploads.erase(std::remove(uploads.begin(), uploads.end(), cell), uploads.end());
+				cell->state.store(State::Ready, std::memory_order_release);
+			}
+
+			if (spent >= upload_budget)
+				break;
+		}
+	}
+
+	float WorldPartition::getDistance(const Cell* cell, const glm::vec3& position)
+	{
+		glm::vec3 closest = glm::clamp(position, cell->bounds.getMin(), cell->bounds.getMax());
+
+		return glm::length(closest - position);
+	}
+
+	float WorldPartition::getPriority(const Cell* cell, const glm::vec3& position, const glm::vec3& direction) const
+	{
+		glm::vec3 offset = cell->bounds.getCenter() - position;
+		float length = glm::length(offset);
+		float facing = length > 0.0f ? glm::dot(offset / length, direction) : 1.0f;
+
+		return getDistance(cell, position) * (1.0f + WORLD_VIEW_WEIGHT * (1.0f - facing) * 0.5f);
+	}
+
+	bool WorldPartition::load(Cell* cell)
+	{
+		RZ_PROFILE_FUNCTION();
+		MemoryTagScope memory(MemoryTag::Assets);
+
+		Serializer serializer;
+		std::ifstream in(directory + "/" + cell->filename, std::ios::binary);
+
+		uint32 magic = 0;
+		uint32 version = 0;
+		uint32 nodes_count = 0;
+
+		serializer.readData<uint32>(in, &magic);
+		serializer.readData<uint32>(in, &version);
+		serializer.readData<uint32>(in, &nodes_count);
+
+		if (!in || magic != WORLD_CELL_MAGIC || version != WORLD_FORMAT_VERSION)
+		{
+			Log::error("World partition: %s isn't a cell of version %d", cell->filename.c_str(), WORLD_FORMAT_VERSION);
+			return false;
+		}
+
+		std::vector<Node*> loaded;
+		loaded.reserve(nodes_count);
+
+		for (uint32 i = 0; i < nodes_count; i++)
+		{
+			std::shared_ptr<Node> node = Node::create();
+
+			int32 parent = -1;
+			glm::vec3 position, rotation, scale;
+			uint32 meshes_count = 0;
+
+			serializer.readData<int32>(in, &parent);
+			serializer.readString(in, &node->name);
+			serializer.readData<glm::vec3>(in, &position);
+			serializer.readData<glm::vec3>(in, &rotation);
+			serializer.readData<glm::vec3>(in, &scale);
+			serializer.readData<uint32>(in, &meshes_count);
+
+			if (!in || parent >= (int32)i)
+			{
+				Log::error("World partition: %s is corrupted", cell->filename.c_str());
+				return false;
+			}
+
+			node->transform.setPosition(position);
+			node->transform.setRotation(rotation);
+			node->transform.setScale(scale);
+
+			if (parent < 0)
+				cell->nodes.push_back(node);
+			else
+				loaded[parent]->addChild(node);
+
+			loaded.push_back(node.get());
+
+			bool has_body = false;
+
+			for (uint32 m = 0; m < meshes_count; m++)
+			{
+				std::shared_ptr<StaticMesh> mesh = StaticMesh::create();
+				std::string material_name;
+				RzaMaterialParameters parameters = {};
+				AABB box;
+
+				serializer.readString(in, &mesh->getName());
+				serializer.readArray<float>(in, &mesh->getVertices());
+				serializer.readArray<float>(in, &mesh->getNormals());
+				serializer.readArray<float>(in, &mesh->getUvs());
+				serializer.readArray<float>(in, &mesh->getTangents());
+				serializer.readArray<unsigned int>(in, &mesh->getIndices());
+				serializer.readData<AABB>(in, &box);
+				serializer.readString(in, &material_name);
+				serializer.readData<RzaMaterialParameters>(in, &parameters);
+
+				std::shared_ptr<Material> material = Serializer::createMaterial(parameters);
+				material->setName(material_name);
+
+				for (Material::TextureType type : s_textureTypes)
+					serializer.readString(in, &material->getTexturePath(type));
+
+				Collider collider = Collider::None;
+				float mass = 0.0f;
+				glm::vec3 extents = glm::vec3(0.0f);
+
+				serializer.readData<Collider>(in, &collider);
+				serializer.readData<float>(in, &mass);
+				serializer.readData<glm::vec3>(in, &extents);
+
+				if (!in)
+				{
+					Log::error("World partition: %s is truncated", cell->filename.c_str());
+					return false;
+				}
+
+				mesh->setBoundingBox(box);
+				mesh->setMaterial(material);
+				// Fills the bounds cache before the graph asks for it on the update thread
+				mesh->getLocalBoundingBox();
+
+				if (collider != Collider::None)
+				{
+					PhysicsBody* body = collider == Collider::Box
+						? (PhysicsBody*)new CubePhysicsBody(node.get(), extents)
+						: (PhysicsBody*)new SpherePhysicsBody(node.get(), extents.x);
+
+					body->mass = mass;
+					mesh->setPhysicsBody(body);
+					mesh->getPhysicsEnabled() = true;
+					has_body = true;
+				}
+
+				node->meshes.push_back(mesh);
+				cell->meshes.push_back(mesh);
+			}
+
+			if (has_body)
+				cell->bodies.push_back(node);
+		}
+
+		decodeTextures(cell);
+
+		return true;
+	}
+
+	void WorldPartition::decodeTextures(Cell* cell)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		for (auto& mesh : cell->meshes)
+		{
+			Material* material = mesh->getMaterial().get();
+
+			for (Material::TextureType type : s_textureTypes)
+			{
+				const std::string& path = material->getTexturePath(type);
+
+				if (path.empty() || path == "Not set" || cell->images.find(path) != cell->images.end())
+					continue;
+
+				// Already resident, pinned so it isn't destroyed before the cell uploads
+				{
+					std::lock_guard<std::mutex> lock(texture_mutex);
+
+					auto it = textures.find(path);
+
+					if (it != textures.end())
+					{
+						it->second.references++;
+						cell->textures.push_back(path);
+						cell->images[path] = nullptr;
+						continue;
+					}
+				}
+
+				cell->images[path] = Texture::decode(path, true);
+			}
+		}
+	}
+
+	void WorldPartition::attach(Cell* cell, SceneGraph* graph, World* world)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		for (auto& node : cell->nodes)
+			cell->handles.push_back(graph->addNode(node));
+
+		for (auto& node : cell->bodies)
+			world->addNode(node);
+
+		cell->state.store(State::Active, std::memory_order_release);
+	}
+
+	void WorldPartition::detach(Cell* cell, SceneGraph* graph, World* world, uint64 frame)
+	{
+		RZ_PROFILE_FUNCTION();
+
+		for (auto& node : cell->bodies)
+			world->removeNode(node);
+
+		for (NodeHandle handle : cell->handles)
+			graph->removeNode(handle);
+
+		cell->handles.clear();
+		retire(cell, frame);
+	}
+
+	void WorldPartition::retire(Cell* cell, uint64 frame)
+	{
+		std::lock_guard<std::mutex> lock(upload_mutex);
+
+		cell->retired_frame = frame;
+		cell->state.store(State::Retired, std::memory_order_release);
+		retired.push_back(cell);
+	}
+
+	void WorldPartition::release(Cell* cell)
+	{
+		for (auto& path : cell->textures)
+			releaseTexture(path);
+
+		for (auto& image : cell->images)
+			delete image.second;
+
+		cell->textures.clear();
+		cell->images.clear();
+		cell->handles.clear();
+		cell->bodies.clear();
+		cell->meshes.clear();
+		cell->nodes.clear();
+		cell->uploaded = 0;
+	}
+
+	void WorldPartition::uploadMesh(Cell* cell, const std::shared_ptr<StaticMesh>& mesh)
+	{
+		mesh->setupBuffers();
+
+		Material* material = mesh->getMaterial().get();
+
+		for (Material::TextureType type : s_textureTypes)
+		{
+			const std::string& path = material->getTexturePath(type);
+
+			if (path.empty() || path == "Not set")
+				continue;
+
+			Texture* texture = acquireTexture(path);
+
+			// Unreadable, reported by the load job
+			if (texture == nullptr)
+				continue;
+
+			material->setTextureMap(type, texture->getId());
+			cell->textures.push_back(path);
+		}
+	}
+
+	size_t WorldPartition::uploadTexture(Cell* cell, const std::string& path, Texture* texture)
+	{
+		if (texture == nullptr)
+			return 0;
+
+		std::lock_guard<std::mutex> lock(texture_mutex);
+
+		// Pinned by the cell like in decodeTextures(), its meshes may only upload next frame
+		cell->textures.push_back(path);
+
+		auto it = textures.find(path);
+
+		// Another cell decoded and uploaded it first
+		if (it != textures.end())
+		{
+			it->second.references++;
+			delete texture;
+			return 0;
+		}
+
+		// The mip chain adds a third
+		size_t size = texture->getDataSize() * 4 / 3;
+
+		texture->upload();
+		textures.insert({ path, { texture, 1 } });
+
+		return size;
+	}
+
+	Texture* WorldPartition::acquireTexture(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(texture_mutex);
+
+		auto it = textures.find(path);
+
+		if (it == textures.end())
+			return nullptr;
+
+		it->second.references++;
+
+		return it->second.texture;
+	}
+
+	void WorldPartition::releaseTexture(const std::string& path)
+	{
+		Texture* texture = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(texture_mutex);
+
+			auto it = textures.find(path);
+
+			if (it == textures.end() || --it->second.references > 0)
+				return;
+
+			texture = it->second.texture;
+			textures.erase(it);
+		}
+
+		delete texture;
+	}
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "Razor/Scene/Node.h"
+
+#define WORLD_CELL_SIZE 64.0f
+// Cells closer than the radius to the camera are loaded, they are only
+// unloaded once further than radius + hysteresis so they don't flicker
+#define WORLD_STREAMING_RADIUS 192.0f
+#define WORLD_STREAMING_HYSTERESIS 32.0f
+// Vertex, index and texel bytes sent to GL per frame, one mesh or texture at least
+#define WORLD_UPLOAD_BUDGET (4 * 1024 * 1024)
+#define WORLD_MAX_PENDING_LOADS 4
+// Cells behind the camera wait up to (1 + weight) times longer than the ones in front
+#define WORLD_VIEW_WEIGHT 1.0f
+#define WORLD_INDEX_FILENAME "world.rzw"
+#define WORLD_INDEX_MAGIC 0x575a5a52
+#define WORLD_CELL_MAGIC 0x435a5a52
+#define WORLD_FORMAT_VERSION 2
+
+namespace Razor
+{
+
+	class Scene;
+	class SceneGraph;
+	class World;
+	class Texture;
+
+	// Splits a scene into a grid of cells cooked to their own file and streams
+	// them around the camera. Cells are read and their textures decoded on
+	// the job workers, buffers and pixels uploaded on the main thread within
+	// a per frame budget, and attached to the graph and the physics world by the update
+	// thread. Memory is bounded by the streaming radius, not the level size.
+	//
+	// A cell goes Unloaded -> Loading (worker) -> Loaded -> Uploading (main
+	// thread) -> Ready -> Active (update thread) and back to Unloaded through
+	// Retired, its GL objects are destroyed on the main thread once the
+	// frame snapshots that may still reference its nodes are gone.
+	class WorldPartition
+	{
+	public:
+		WorldPartition();
+		~WorldPartition();
+
+		WorldPartition(const WorldPartition&) = delete;
+		WorldPartition& operator=(const WorldPartition&) = delete;
+
+		// Writes every root subtree with meshes to the cell holding the center
+		// of its world bounds. Landscapes, lights and cameras aren't cooked,
+		// they stay in the persistent scene. Run it with the game loop stopped.
+		static bool cook(Scene* scene, const std::string& directory, float cell_size = WORLD_CELL_SIZE);
+
+		bool open(const std::string& directory);
+		// Detaches and releases every cell, on the main thread with the game loop
+		// stopped. Null graph or world when they are already gone.
+		void close(SceneGraph* graph, World* world);
+
+		// Update thread: attaches the uploaded cells, detaches the far ones and
+		// schedules the loads by priority (distance weighted by view direction)
+		void update(Camera* camera, SceneGraph* graph, World* world, uint64 frame);
+		// Main thread: GL uploads within the budget, releases retired cells
+		void upload(uint64 frame);
+
+		inline float& getRadius() { return radius; }
+		inline float& getHysteresis() { return hysteresis; }
+		inline size_t& getUploadBudget() { return upload_budget; }
+		inline float getCellSize() const { return cell_size; }
+		inline size_t getCellsCount() const { return cells.size(); }
+		inline size_t getResidentCellsCount() const { return resident.size(); }
+		inline bool isOpened() const { return !cells.empty(); }
+
+	private:
+		enum class State : uint8
+		{
+			Unloaded,
+			Loading,
+			Loaded,
+			Uploading,
+			Ready,
+			Active,
+			Retired,
+			// Unreadable file, never requested again
+			Failed
+		};
+
+		enum class Collider : uint8
+		{
+			None,
+			Box,
+			Sphere
+		};
+
+		struct Cell
+		{
+			int32 x = 0;
+			int32 z = 0;
+			AABB bounds;
+			std::string filename;
+			std::atomic<State> state{ State::Unloaded };
+			// Written by the update thread, read by the main thread under upload_mutex
+			float priority = 0.0f;
+			// Frame it was retired at, upload() waits for the snapshots to rotate
+			uint64 retired_frame = 0;
+			// In resident, update thread only
+			bool listed = false;
+
+			// Owned by the thread the state gives the cell to
+			Node::List nodes;
+			std::vector<std::shared_ptr<StaticMesh>> meshes;
+			std::vector<std::shared_ptr<Node>> bodies;
+			std::vector<NodeHandle> handles;
+			// One reference per entry
+			std::vector<std::string> textures;
+			// Decoded by the load job, null when already resident or unreadable
+			std::unordered_map<std::string, Texture*> images;
+			size_t uploaded = 0;
+		};
+
+		static int64 getKey(int32 x, int32 z) { return (int64)(((uint64)(uint32)x << 32) | (uint32)z); }
+		static float getDistance(const Cell* cell, const glm::vec3& position);
+		float getPriority(const Cell* cell, const glm::vec3& position, const glm::vec3& direction) const;
+
+		bool load(Cell* cell);
+		void attach(Cell* cell, SceneGraph* graph, World* world);
+		void detach(Cell* cell, SceneGraph* graph, World* world, uint64 frame);
+		void retire(Cell* cell, uint64 frame);
+		void release(Cell* cell);
+
+		void decodeTextures(Cell* cell);
+		size_t uploadTexture(Cell* cell, const std::string& path, Texture* texture);
+		void uploadMesh(Cell* cell, const std::shared_ptr<StaticMesh>& mesh);
+		Texture* acquireTexture(const std::string& path);
+		void releaseTexture(const std::string& path);
+
+		std::string directory;
+		float cell_size;
+		// How far the cooked bounds overflow their grid square at most
+		float margin;
+		float radius;
+		float hysteresis;
+		size_t upload_budget;
+
+		std::vector<Cell*> cells;
+		std::unordered_map<int64, Cell*> grid;
+		// Cells not Unloaded, only touched by the update thread
+		std::vector<Cell*> resident;
+		std::vector<Cell*> candidates;
+		std::atomic<int> pending_loads;
+
+		// Handed from the update thread to the main thread
+		std::vector<Cell*> uploads;
+		std::vector<Cell*> retired;
+		std::mutex upload_mutex;
+		// Main thread copies of the above
+		std::vector<Cell*> uploading;
+		std::vector<Cell*> releasing;
+
+		// Created and destroyed on the main thread, shared by the cells
+		// referencing them. The load jobs look them up under texture_mutex.
+		struct TextureEntry
+		{
+			Texture* texture;
+			uint32 references;
+		};
+
+		std::unordered_map<std::string, TextureEntry> textures;
+		std::mutex texture_mutex;
+	};
+
+}
@@ -12,6 +12,7 @@
 #include <queue>
 #include <condition_variable>
 #include <mutex>
+#include <atomic>
 #include <deque>
 #include <limits>
 #include <bitset>
@@ -40,9 +41,11 @@
 #include "Razor/Types/Variant.h"
 #include "Razor/Core/Log.h"
 #include "Razor/Core/Utils.h"
+#include "Razor/Core/TraceProfiler.h"
 
 #ifdef RZ_PLATFORM_WINDOWS
 	#pragma comment (lib, "ws2_32.lib")
+	#pragma comment (lib, "winmm.lib")
 	#include <WS2tcpip.h>
 	#include <winsock2.h>
 
@@ -0,0 +1,272 @@
+#include "Benchmark.h"
+
+namespace Razor
+{
+
+	std::atomic<uint64> Benchmark::s_allocations(0);
+	std::atomic<uint64> Benchmark::s_allocatedBytes(0);
+
+	Benchmark::State::State(uint64 parameter, double min_time, uint32 max_iterations) :
+		parameter(parameter),
+		processed_bytes(0),
+		min_time(min_time),
+		max_iterations(max_iterations),
+		warmup(0),
+		running(false),
+		start(0),
+		first(0),
+		start_allocations(0),
+		start_bytes(0),
+		samples({}),
+		allocations(0),
+		bytes(0)
+	{
+		samples.reserve(max_iterations);
+	}
+
+	bool Benchmark::State::run()
+	{
+		uint64 now = TraceProfiler::now();
+
+		if (running)
+		{
+			uint64 iteration_allocations = s_allocations.load(std::memory_order_relaxed) - start_allocations;
+			uint64 iteration_bytes = s_allocatedBytes.load(std::memory_order_relaxed) - start_bytes;
+
+			if (warmup < BENCHMARK_WARMUP_ITERATIONS)
+			{
+				warmup++;
+			}
+			else
+			{
+				samples.push_back(now - start);
+				allocations += iteration_allocations;
+				bytes += iteration_bytes;
+			}
+		}
+		else
+		{
+			running = true;
+			first = now;
+		}
+
+		uint32 count = (uint32)samples.size();
+		double elapsed = (double)(now - first) / 1e9;
+
+		if (count >= max_iterations || (count >= BENCHMARK_MIN_ITERATIONS && elapsed >= min_time))
+			return false;
+
+		start_allocations = s_allocations.load(std::memory_order_relaxed);
+		start_bytes = s_allocatedBytes.load(std::memory_order_relaxed);
+		start = TraceProfiler::now();
+
+		return true;
+	}
+
+	Benchmark::Result Benchmark::State::getResult(const std::string& name) const
+	{
+		std::vector<uint64> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		size_t count = sorted.size();
+		size_t p99 = std::min(count - 1, (size_t)std::ceil(count * 0.99) - 1);
+		double total = 0.0;
+
+		for (uint64 sample : sorted)
+			total += (double)sample;
+
+		Result result;
+		result.name = name;
+		result.iterations = (uint32)count;
+		result.min = sorted[0] / 1000.0;
+		result.median = sorted[count / 2] / 1000.0;
+		result.p99 = sorted[p99] / 1000.0;
+		result.mean = total / count / 1000.0;
+		result.allocations = (double)allocations / count;
+		result.bytes = (double)bytes / count;
+		result.throughput = processed_bytes > 0 ? (processed_bytes / (1024.0 * 1024.0)) / (result.median / 1e6) : 0.0;
+
+		return result;
+	}
+
+	std::vector<Benchmark::Scenario>& Benchmark::getScenarios()
+	{
+		static std::vector<Scenario> scenarios;
+
+		return scenarios;
+	}
+
+	bool Benchmark::add(const char* name, const std::vector<uint64>& parameters, Function function)
+	{
+		Scenario scenario;
+		scenario.name = name;
+		scenario.parameters = parameters.empty() ? std::vector<uint64>({ 0 }) : parameters;
+		scenario.function = function;
+
+		getScenarios().push_back(scenario);
+
+		return true;
+	}
+
+	std::vector<Benchmark::Result> Benchmark::run(const std::string& filter, double min_time, uint32 max_iterations)
+	{
+		std::vector<Result> results;
+
+		for (auto& scenario : getScenarios())
+		{
+			for (uint64 parameter : scenario.parameters)
+			{
+				std::string name = scenario.name + "/" + std::to_string(parameter);
+
+				if (!filter.empty() && name.find(filter) == std::string::npos)
+					continue;
+
+				State state(parameter, min_time, max_iterations);
+				scenario.function(state);
+
+				if (state.getIterations() == 0)
+				{
+					Log::warn("%s: no iterations ran", name.c_str());
+					continue;
+				}
+
+				Result result = state.getResult(name);
+				results.push_back(result);
+
+				Log::info(
+					"%-40s median %10.2f us  min %10.2f us  p99 %10.2f us  %8.1f allocs  %s",
+					name.c_str(),
+					result.median,
+					result.min,
+					result.p99,
+					result.allocations,
+					Utils::bytesToSize((size_t)result.bytes).c_str()
+				);
+			}
+		}
+
+		return results;
+	}
+
+	bool Benchmark::write(const std::string& path, const std::vector<Result>& results)
+	{
+		std::ofstream stream(path, std::ios::out | std::ios::trunc);
+
+		if (!stream.is_open())
+			return false;
+
+		// One benchmark per line, read() relies on it
+		stream << "{\n\"benchmarks\": [";
+		stream << std::fixed << std::setprecision(3);
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const Result& result = results[i];
+
+			stream << (i > 0 ? "," : "") << "\n{\"name\": \"" << result.name << "\""
+				<< ", \"iterations\": " << result.iterations
+				<< ", \"min\": " << result.min
+				<< ", \"median\": " << result.median
+				<< ", \"p99\": " << result.p99
+				<< ", \"mean\": " << result.mean
+				<< ", \"allocations\": " << result.allocations
+				<< ", \"bytes\": " << result.bytes
+				<< ", \"throughput\": " << result.throughput
+				<< "}";
+		}
+
+		stream << "\n]\n}\n";
+
+		return true;
+	}
+
+	static double readNumber(const std::string& line, const char* key)
+	{
+		std::string token = std::string("\"") + key + "\": ";
+		size_t position = line.find(token);
+
+		return position != std::string::npos ? std::strtod(line.c_str() + position + token.size(), nullptr) : 0.0;
+	}
+
+	bool Benchmark::read(const std::string& path, std::vector<Result>& results)
+	{
+		std::ifstream stream(path);
+
+		if (!stream.is_open())
+			return false;
+
+		std::string line;
+		const std::string name_token = "\"name\": \"";
+
+		while (std::getline(stream, line))
+		{
+			size_t position = line.find(name_token);
+
+			if (position == std::string::npos)
+				continue;
+
+			size_t begin = position + name_token.size();
+			size_t end = line.find('"', begin);
+
+			if (end == std::string::npos)
+				continue;
+
+			Result result;
+			result.name = line.substr(begin, end - begin);
+			result.iterations = (uint32)readNumber(line, "iterations");
+			result.min = readNumber(line, "min");
+			result.median = readNumber(line, "median");
+			result.p99 = readNumber(line, "p99");
+			result.mean = readNumber(line, "mean");
+			result.allocations = readNumber(line, "allocations");
+			result.bytes = readNumber(line, "bytes");
+			result.throughput = readNumber(line, "throughput");
+
+			results.push_back(result);
+		}
+
+		return true;
+	}
+
+	uint32 Benchmark::compare(const std::vector<Result>& baseline, const std::vector<Result>& results, double threshold)
+	{
+		uint32 regressions = 0;
+
+		for (auto& result : results)
+		{
+			auto it = std::find_if(baseline.begin(), baseline.end(), [&](const Result& r) { return r.name == result.name; });
+
+			if (it == baseline.end())
+			{
+				Log::info("%-40s not in baseline", result.name.c_str());
+				continue;
+			}
+
+			double time_change = it->median > 0.0 ? result.median / it->median - 1.0 : 0.0;
+			// Below one allocation per iteration is noise from warmup and lazy init
+			bool more_allocations = result.allocations - it->allocations >= 1.0 && result.allocations > it->allocations * (1.0 + threshold);
+			bool regression = time_change > threshold || more_allocations;
+
+			if (regression)
+			{
+				regressions++;
+
+				Log::warn(
+					"%-40s REGRESSION %+7.1f %%  (%.2f -> %.2f us, %.1f -> %.1f allocs)",
+					result.name.c_str(), time_change * 100.0, it->median, result.median, it->allocations, result.allocations
+				);
+			}
+			else
+			{
+				Log::info(
+					"%-40s %s %+7.1f %%  (%.2f -> %.2f us, %.1f -> %.1f allocs)",
+					result.name.c_str(), time_change < -threshold ? "improved  " : "ok        ",
+					time_change * 100.0, it->median, result.median, it->allocations, result.allocations
+				);
+			}
+		}
+
+		return regressions;
+	}
+
+}
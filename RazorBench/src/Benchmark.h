@@ -0,0 +1,101 @@
+#pragma once
+
+#include "rzpch.h"
+#include "Razor/Core/JobSystem.h"
+#include "Razor/Core/Parallel.h"
+
+#define BENCHMARK_WARMUP_ITERATIONS 2
+#define BENCHMARK_MIN_ITERATIONS 10
+#define BENCHMARK_MAX_ITERATIONS 1000
+#define BENCHMARK_MIN_TIME 0.5
+#define BENCHMARK_REGRESSION_THRESHOLD 0.1
+
+namespace Razor
+{
+
+	class Benchmark
+	{
+	public:
+		// Times are in microseconds, allocations and bytes are per iteration
+		struct Result
+		{
+			std::string name;
+			uint32 iterations;
+			double min;
+			double median;
+			double p99;
+			double mean;
+			double allocations;
+			double bytes;
+			double throughput;
+		};
+
+		class State
+		{
+		public:
+			State(uint64 parameter, double min_time, uint32 max_iterations);
+
+			// Loop condition of a scenario, everything before the first call is setup
+			bool run();
+
+			inline uint64 getParameter() const { return parameter; }
+			inline void setProcessedBytes(uint64 bytes) { processed_bytes = bytes; }
+			inline uint32 getIterations() const { return (uint32)samples.size(); }
+
+			Result getResult(const std::string& name) const;
+
+		private:
+			uint64 parameter;
+			uint64 processed_bytes;
+			double min_time;
+			uint32 max_iterations;
+			uint32 warmup;
+			bool running;
+			uint64 start;
+			uint64 first;
+			uint64 start_allocations;
+			uint64 start_bytes;
+			std::vector<uint64> samples;
+			uint64 allocations;
+			uint64 bytes;
+		};
+
+		typedef std::function<void(State&)> Function;
+
+		struct Scenario
+		{
+			std::string name;
+			std::vector<uint64> parameters;
+			Function function;
+		};
+
+		static bool add(const char* name, const std::vector<uint64>& parameters, Function function);
+		static std::vector<Result> run(const std::string& filter, double min_time, uint32 max_iterations);
+
+		static bool write(const std::string& path, const std::vector<Result>& results);
+		static bool read(const std::string& path, std::vector<Result>& results);
+
+		// Prints every scenario slower (median) or allocating more than the
+		// baseline by more than threshold, returns the number of regressions
+		static uint32 compare(const std::vector<Result>& baseline, const std::vector<Result>& results, double threshold);
+
+		// Fed by the global operator new of the benchmark executable
+		inline static void onAllocation(size_t size)
+		{
+			s_allocations.fetch_add(1, std::memory_order_relaxed);
+			s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		}
+
+	private:
+		static std::vector<Scenario>& getScenarios();
+
+		static std::atomic<uint64> s_allocations;
+		static std::atomic<uint64> s_allocatedBytes;
+	};
+
+}
+
+#define RZ_BENCHMARK(name, ...) \
+	static void Benchmark_##name(Razor::Benchmark::State& state); \
+	static bool s_benchmark_##name = Razor::Benchmark::add(#name, { __VA_ARGS__ }, Benchmark_##name); \
+	static void Benchmark_##name(Razor::Benchmark::State& state)
@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+
+#include "Razor/Animation/AnimationManager.h"
+#include "Razor/Animation/Animation.h"
+#include "Razor/Animation/Keyframe.h"
+#include "Razor/Animation/BoneTransform.h"
+#include "Razor/Animation/Bone.h"
+#include "Razor/Geometry/SkeletalMesh.h"
+
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#define BENCHMARK_BONES 64
+#define BENCHMARK_KEYFRAMES 30
+
+namespace Razor
+{
+
+	// Bone i is a child of bone (i - 1) / 2
+	static std::shared_ptr<Bone> createSkeleton()
+	{
+		std::vector<std::shared_ptr<Bone>> bones;
+
+		for (int i = 0; i < BENCHMARK_BONES; i++)
+		{
+			bones.push_back(std::make_shared<Bone>("Bone" + std::to_string(i), glm::translate(glm::vec3(0.0f, 1.0f, 0.0f))));
+
+			if (i > 0)
+				bones[(i - 1) / 2]->addChild(bones[i]);
+		}
+
+		bones[0]->calcInverseTransform(glm::mat4(1.0f));
+
+		return bones[0];
+	}
+
+	RZ_BENCHMARK(AnimationUpdate, 10, 100, 1000)
+	{
+		std::vector<std::unique_ptr<BoneTransform>> transforms;
+		std::vector<Keyframe> keyframes;
+
+		for (int k = 0; k < BENCHMARK_KEYFRAMES; k++)
+		{
+			std::map<std::string, BoneTransform*> pose;
+			float angle = (float)k / BENCHMARK_KEYFRAMES * glm::two_pi<float>();
+
+			for (int i = 0; i < BENCHMARK_BONES; i++)
+			{
+				transforms.push_back(std::make_unique<BoneTransform>(
+					glm::vec3(0.0f, 1.0f, 0.0f),
+					glm::angleAxis(angle + i * 0.1f, glm::vec3(0.0f, 0.0f, 1.0f))
+				));
+
+				pose["Bone" + std::to_string(i)] = transforms.back().get();
+			}
+
+			keyframes.push_back(Keyframe((float)k / (BENCHMARK_KEYFRAMES - 1), pose));
+		}
+
+		Animation animation;
+		animation.setLength(1.0f);
+		animation.setKeyframes(keyframes);
+
+		std::vector<std::unique_ptr<SkeletalMesh>> meshes;
+		std::vector<std::unique_ptr<AnimationManager>> managers;
+
+		for (uint64 i = 0; i < state.getParameter(); i++)
+		{
+			meshes.push_back(std::make_unique<SkeletalMesh>());
+			meshes.back()->setRootBone(createSkeleton());
+
+			managers.push_back(std::make_unique<AnimationManager>(meshes.back().get()));
+			managers.back()->playAnimation(&animation);
+		}
+
+		while (state.run())
+		{
+			for (auto& manager : managers)
+				manager->update(1.0f / 60.0f);
+		}
+	}
+
+}
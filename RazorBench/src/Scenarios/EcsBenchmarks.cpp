@@ -0,0 +1,136 @@
+#include "Benchmark.h"
+
+#include "Razor/Ecs/Manager.h"
+
+namespace Razor
+{
+
+	struct BenchmarkPosition
+	{
+		float x, y, z;
+	};
+
+	struct BenchmarkVelocity
+	{
+		float x, y, z;
+	};
+
+	// Same data through the virtual per component path
+	class BenchmarkMotionComponent : public ECS::Component
+	{
+	public:
+		void update(float delta) override
+		{
+			position.x += velocity.x * delta;
+			position.y += velocity.y * delta;
+			position.z += velocity.z * delta;
+		}
+
+		BenchmarkPosition position = { 0.0f, 0.0f, 0.0f };
+		BenchmarkVelocity velocity = { 1.0f, 2.0f, 3.0f };
+	};
+
+	RZ_BENCHMARK(EcsVirtualUpdate, 10000, 100000)
+	{
+		ECS::Manager manager;
+
+		for (uint64 i = 0; i < state.getParameter(); i++)
+			manager.createEntity().addComponent<BenchmarkMotionComponent>();
+
+		while (state.run())
+			manager.update(0.016f);
+	}
+
+	RZ_BENCHMARK(EcsArchetypeEach, 10000, 100000)
+	{
+		ECS::Manager manager;
+
+		for (uint64 i = 0; i < state.getParameter(); i++)
+			manager.spawn(BenchmarkPosition{ 0.0f, 0.0f, 0.0f }, BenchmarkVelocity{ 1.0f, 2.0f, 3.0f });
+
+		state.setProcessedBytes(state.getParameter() * (sizeof(BenchmarkPosition) + sizeof(BenchmarkVelocity)));
+
+		while (state.run())
+		{
+			manager.each<BenchmarkPosition, const BenchmarkVelocity>([](BenchmarkPosition& position, const BenchmarkVelocity& velocity)
+			{
+				position.x += velocity.x * 0.016f;
+				position.y += velocity.y * 0.016f;
+				position.z += velocity.z * 0.016f;
+			});
+		}
+	}
+
+	RZ_BENCHMARK(EcsParallelEach, 100000, 1000000)
+	{
+		ECS::Manager manager;
+
+		for (uint64 i = 0; i < state.getParameter(); i++)
+			manager.spawn(BenchmarkPosition{ 0.0f, 0.0f, 0.0f }, BenchmarkVelocity{ 1.0f, 2.0f, 3.0f });
+
+		state.setProcessedBytes(state.getParameter() * (sizeof(BenchmarkPosition) + sizeof(BenchmarkVelocity)));
+
+		while (state.run())
+		{
+			manager.eachParallel<BenchmarkPosition, const BenchmarkVelocity>([](BenchmarkPosition& position, const BenchmarkVelocity& velocity)
+			{
+				position.x += velocity.x * 0.016f;
+				position.y += velocity.y * 0.016f;
+				position.z += velocity.z * 0.016f;
+			});
+		}
+	}
+
+	RZ_BENCHMARK(EcsDeferredSpawn, 10000, 100000)
+	{
+		ECS::Manager manager;
+		ECS::CommandBuffer& commands = manager.getCommands();
+
+		while (state.run())
+		{
+			for (uint64 i = 0; i < state.getParameter(); i++)
+				commands.spawn(BenchmarkPosition{ (float)i, 0.0f, 0.0f }, BenchmarkVelocity{ 1.0f, 0.0f, 0.0f });
+
+			manager.flush();
+
+			manager.each<const BenchmarkPosition>([&](ECS::EntityId entity, const BenchmarkPosition&)
+			{
+				commands.despawn(entity);
+			});
+
+			manager.flush();
+		}
+	}
+
+	// Projectile style churn, a hundred entities die and spawn every frame
+	RZ_BENCHMARK(EcsRefreshChurn, 10000, 100000)
+	{
+		ECS::Manager manager;
+		std::vector<ECS::EntityId> handles;
+
+		for (uint64 i = 0; i < state.getParameter(); i++)
+		{
+			ECS::Entity& entity = manager.createEntity();
+			entity.addGroup(i % 4);
+			handles.push_back(entity.getId());
+		}
+
+		size_t next = 0;
+
+		while (state.run())
+		{
+			for (uint32 i = 0; i < 100; i++)
+			{
+				size_t slot = next++ % handles.size();
+				manager.getEntity(handles[slot])->destroy();
+
+				ECS::Entity& entity = manager.createEntity();
+				entity.addGroup(slot % 4);
+				handles[slot] = entity.getId();
+			}
+
+			manager.refresh();
+		}
+	}
+
+}
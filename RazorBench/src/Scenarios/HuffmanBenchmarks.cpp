@@ -0,0 +1,45 @@
+#include "Benchmark.h"
+
+#include "Razor/Filesystem/HuffmanEncoding.h"
+
+namespace Razor
+{
+
+	// Word soup from a fixed seed, same input on every run
+	static std::string generateText(size_t size)
+	{
+		static const char* words[] = {
+			"razor", "engine", "node", "mesh", "shader", "texture", "light", "camera",
+			"scene", "physics", "packet", "frame", "the", "a", "of", "and"
+		};
+
+		std::string text;
+		text.reserve(size + 16);
+		uint32 seed = 1337;
+
+		while (text.size() < size)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			text += words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+			text += (seed & 0x7) == 0 ? ". " : " ";
+		}
+
+		text.resize(size);
+
+		return text;
+	}
+
+	RZ_BENCHMARK(HuffmanEncode, 4096, 65536, 1048576)
+	{
+		std::string text = generateText((size_t)state.getParameter());
+		state.setProcessedBytes(text.size());
+
+		while (state.run())
+		{
+			HuffmanEncoding encoding;
+			encoding.setVerbose(false);
+			encoding.encode(text);
+		}
+	}
+
+}
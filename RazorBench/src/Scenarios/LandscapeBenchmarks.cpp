@@ -0,0 +1,20 @@
+#include "Benchmark.h"
+
+#include "Razor/Landscape/Landscape.h"
+
+#define BENCHMARK_HEIGHTMAP "../Sandbox/data/heightmap2.png"
+
+namespace Razor
+{
+
+	RZ_BENCHMARK(LandscapeGenerate, 64, 256, 1024)
+	{
+		Landscape landscape(BENCHMARK_HEIGHTMAP);
+		landscape.setSubdivisions(glm::vec2((float)state.getParameter()));
+
+		// Mesh data only, uploading needs a GL context
+		while (state.run())
+			landscape.build();
+	}
+
+}
@@ -0,0 +1,127 @@
+#include "Benchmark.h"
+
+#include "Razor/Network/Packet.h"
+
+#define BENCHMARK_CLIENTS 64
+
+namespace Razor
+{
+
+	template<typename T>
+	static void encode(std::vector<char>& stream, const T& packet)
+	{
+		size_t offset = stream.size();
+		stream.resize(offset + sizeof(T));
+		std::memcpy(stream.data() + offset, &packet, sizeof(T));
+	}
+
+	// Mirrors the TCPServer receive path without sockets: token lookup over the
+	// connected clients, then the dispatch on the packet type
+	static uint64 dispatch(const std::vector<char>& stream, const std::vector<std::string>& tokens)
+	{
+		uint64 checksum = 0;
+		size_t offset = 0;
+
+		while (offset + sizeof(Packet) <= stream.size())
+		{
+			Packet* packet = (Packet*)(stream.data() + offset);
+			bool authenticated = false;
+
+			for (auto& token : tokens)
+			{
+				if (std::strncmp(token.c_str(), packet->token, sizeof(Packet::token)) == 0)
+				{
+					authenticated = true;
+					break;
+				}
+			}
+
+			if (packet->id != PacketType::PING)
+				checksum += packet->to_string().size();
+
+			if (packet->id == PacketType::LOGIN)
+			{
+				LoginRequest* login = (LoginRequest*)packet;
+				checksum += std::strlen(login->username);
+			}
+			else if (packet->id == PacketType::CHAT_MESSAGE)
+			{
+				ChatMessage* message = (ChatMessage*)packet;
+				checksum += std::strlen(message->message);
+			}
+			else if (packet->id == PacketType::PLAYER_POSITION)
+			{
+				PlayerPosition* player = (PlayerPosition*)packet;
+				checksum += (uint64)(player->position[0] + player->position[1] + player->position[2]);
+			}
+
+			checksum += authenticated ? 1 : 0;
+			offset += packet->size;
+		}
+
+		return checksum;
+	}
+
+	RZ_BENCHMARK(PacketEncodeDispatch, 1000, 10000, 100000)
+	{
+		std::vector<std::string> tokens;
+
+		for (int i = 0; i < BENCHMARK_CLIENTS; i++)
+		{
+			std::string token = "token" + std::to_string(i);
+			token.resize(MAX_TOKEN_LENGTH - 1, 'x');
+			tokens.push_back(token);
+		}
+
+		std::vector<char> stream;
+		uint64 checksum = 0;
+
+		while (state.run())
+		{
+			stream.clear();
+
+			for (uint64 i = 0; i < state.getParameter(); i++)
+			{
+				const char* token = tokens[i % tokens.size()].c_str();
+
+				switch (i % 4)
+				{
+					case 0:
+					{
+						auto packet = Packet::create<PlayerPosition>(token);
+						packet.position[0] = (float)i;
+						encode(stream, packet);
+						break;
+					}
+					case 1:
+					{
+						auto packet = Packet::create<ChatMessage>(token);
+						std::strncpy(packet.message, "Hello from the benchmark", sizeof(ChatMessage::message));
+						encode(stream, packet);
+						break;
+					}
+					case 2:
+					{
+						auto packet = Packet::create<Ping>(token);
+						encode(stream, packet);
+						break;
+					}
+					default:
+					{
+						auto packet = Packet::create<LoginRequest>(token);
+						std::strncpy(packet.username, "benchmark", sizeof(LoginRequest::username));
+						encode(stream, packet);
+						break;
+					}
+				}
+			}
+
+			checksum += dispatch(stream, tokens);
+			state.setProcessedBytes(stream.size());
+		}
+
+		if (checksum == 0)
+			Log::warn("PacketEncodeDispatch: nothing dispatched");
+	}
+
+}
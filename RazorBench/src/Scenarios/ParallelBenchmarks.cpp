@@ -0,0 +1,57 @@
+#include "Benchmark.h"
+
+namespace Razor
+{
+
+	static std::vector<uint32> generateKeys(size_t count)
+	{
+		std::vector<uint32> keys(count);
+		uint32 seed = 1337;
+
+		for (auto& key : keys)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			key = seed;
+		}
+
+		return keys;
+	}
+
+	RZ_BENCHMARK(ParallelSort, 65536, 1048576)
+	{
+		std::vector<uint32> source = generateKeys((size_t)state.getParameter());
+		std::vector<uint32> keys;
+		keys.reserve(source.size());
+		state.setProcessedBytes(source.size() * sizeof(uint32));
+
+		while (state.run())
+		{
+			keys.assign(source.begin(), source.end());
+			parallel_sort(keys.begin(), keys.end(), 16384);
+		}
+	}
+
+	RZ_BENCHMARK(ParallelReduce, 1048576, 16777216)
+	{
+		size_t count = (size_t)state.getParameter();
+		state.setProcessedBytes(count * sizeof(double));
+
+		while (state.run())
+		{
+			double sum = parallel_reduce(0, count, 65536, 0.0,
+				[](size_t first, size_t last, double value)
+				{
+					for (size_t i = first; i < last; i++)
+						value += 1.0 / (double)(i + 1);
+
+					return value;
+				},
+				[](double a, double b) { return a + b; }
+			);
+
+			if (sum < 0.0)
+				Log::error("ParallelReduce: unexpected sum");
+		}
+	}
+
+}
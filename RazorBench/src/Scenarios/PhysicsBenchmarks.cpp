@@ -0,0 +1,50 @@
+#include "Benchmark.h"
+
+#include "Razor/Scene/Node.h"
+#include "Razor/Physics/World.h"
+#include "Razor/Physics/Bodies/CubePhysicsBody.h"
+
+#define BENCHMARK_PHYSICS_COLUMNS 32
+
+namespace Razor
+{
+
+	static std::shared_ptr<Node> createBody(const glm::vec3& position, const glm::vec3& extents, float mass)
+	{
+		std::shared_ptr<Node> node = Node::create();
+		node->transform.setPosition(position);
+
+		std::shared_ptr<StaticMesh> mesh = StaticMesh::create();
+		CubePhysicsBody* body = new CubePhysicsBody(node.get(), extents);
+		body->mass = mass;
+
+		mesh->setPhysicsBody(body);
+		mesh->setPhysicsEnabled(true);
+		node->meshes.push_back(mesh);
+
+		return node;
+	}
+
+	RZ_BENCHMARK(PhysicsWorldTick, 100, 1000, 4000)
+	{
+		World world;
+		world.addNode(createBody(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(500.0f, 1.0f, 500.0f), 0.0f));
+
+		// Stacks of cubes falling onto the ground, kept awake so every tick costs the same
+		for (uint64 i = 0; i < state.getParameter(); i++)
+		{
+			float x = (float)(i % BENCHMARK_PHYSICS_COLUMNS) * 3.0f;
+			float z = (float)(i / BENCHMARK_PHYSICS_COLUMNS % BENCHMARK_PHYSICS_COLUMNS) * 3.0f;
+			float y = 2.0f + (float)(i / (BENCHMARK_PHYSICS_COLUMNS * BENCHMARK_PHYSICS_COLUMNS)) * 2.5f;
+
+			std::shared_ptr<Node> node = createBody(glm::vec3(x, y, z), glm::vec3(1.0f), 1.0f);
+			world.addNode(node);
+
+			node->meshes[0]->getPhysicsBody()->getBody()->setActivationState(DISABLE_DEACTIVATION);
+		}
+
+		while (state.run())
+			world.tick(1.0f / 60.0f);
+	}
+
+}
@@ -0,0 +1,79 @@
+#include "Benchmark.h"
+
+#include "Razor/Scene/Scene.h"
+#include "Razor/Scene/FrameSnapshot.h"
+#include "Razor/Rendering/RenderQueue.h"
+#include "Razor/Memory/LinearArena.h"
+#include "Razor/Materials/Presets/ColorMaterial.h"
+
+#define BENCHMARK_RENDER_MESHES 64
+#define BENCHMARK_RENDER_MATERIALS 256
+
+namespace Razor
+{
+
+	RZ_BENCHMARK(RenderQueueBuild, 1000, 10000, 100000)
+	{
+		Scene scene("Benchmark");
+
+		std::vector<std::shared_ptr<StaticMesh>> meshes;
+
+		for (int i = 0; i < BENCHMARK_RENDER_MESHES; i++)
+			meshes.push_back(StaticMesh::create());
+
+		for (uint64 i = 0; i < state.getParameter(); i++)
+		{
+			std::shared_ptr<Node> node = Node::create();
+			node->id = (unsigned int)i;
+			node->meshes.push_back(meshes[i % meshes.size()]);
+			scene.getSceneGraph()->addNode(node);
+		}
+
+		FrameSnapshot snapshot;
+		snapshot.capture(&scene, 0, 1.0 / 60.0);
+
+		// Draws are built and sorted but never submitted, no shaders needed
+		RenderQueue queue;
+
+		LinearArena arena("Render");
+		FrameArenaScope scope(&arena);
+
+		while (state.run())
+		{
+			arena.reset();
+			queue.build(snapshot);
+		}
+	}
+
+	RZ_BENCHMARK(RenderQueueSort, 1000, 10000, 100000)
+	{
+		std::vector<std::shared_ptr<Material>> materials;
+
+		for (int i = 0; i < BENCHMARK_RENDER_MATERIALS; i++)
+		{
+			std::shared_ptr<Material> material = std::make_shared<ColorMaterial>();
+			material->setTextureMap(Material::TextureType::Diffuse, i % 32 + 1);
+			materials.push_back(material);
+		}
+
+		RenderQueue queue;
+
+		for (uint64 i = 0; i < state.getParameter(); i++)
+		{
+			// Scrambled but deterministic material, transparency and depth
+			uint32 hash = (uint32)(i * 2654435761u);
+
+			RenderQueue::DrawData data = {};
+			data.material = materials[hash % materials.size()].get();
+			data.category = RenderQueue::RenderCategory::OBJECT;
+			data.transparent = (hash >> 8) % 8 == 0;
+
+			queue.add(data, (float)((hash >> 12) % 1000));
+		}
+
+		// Radix passes don't depend on the input order, sorting sorted items costs the same
+		while (state.run())
+			queue.sort();
+	}
+
+}
@@ -0,0 +1,177 @@
+#include "Benchmark.h"
+
+#include "Razor/Scene/Scene.h"
+#include "Razor/Scene/FrameSnapshot.h"
+#include "Razor/Scene/BVH.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+#define BENCHMARK_SCENE_FANOUT 8
+
+namespace Razor
+{
+
+	// Fills the scene breadth first, every node gets up to BENCHMARK_SCENE_FANOUT children
+	static void buildScene(Scene& scene, uint64 count)
+	{
+		std::vector<std::shared_ptr<Node>> nodes;
+		nodes.reserve((size_t)count);
+
+		for (uint64 i = 0; i < count; i++)
+		{
+			std::shared_ptr<Node> node = Node::create();
+			node->id = (unsigned int)i;
+			node->transform.setPosition(glm::vec3((float)(i % 100), (float)(i % 7), (float)(i / 100 % 100)));
+			node->transform.setRotation(glm::vec3(0.0f, (float)(i % 360), 0.0f));
+
+			if (i < BENCHMARK_SCENE_FANOUT)
+			{
+				scene.getSceneGraph()->addNode(node);
+			}
+			else
+			{
+				std::shared_ptr<Node>& parent = nodes[(size_t)(i / BENCHMARK_SCENE_FANOUT - 1)];
+				parent->addChild(node);
+			}
+
+			nodes.push_back(node);
+		}
+	}
+
+	RZ_BENCHMARK(SceneGraphTraversal, 10000, 100000, 1000000)
+	{
+		Scene scene("Benchmark");
+		buildScene(scene, state.getParameter());
+
+		// Alternate like the pipelined loop, each capture interpolates from the other
+		std::array<FrameSnapshot, 2> snapshots;
+		uint64 frame = 0;
+
+		while (state.run())
+		{
+			snapshots[frame % 2].capture(&scene, frame, 1.0 / 60.0, &snapshots[(frame + 1) % 2]);
+			frame++;
+		}
+	}
+
+	// One root moves every frame, its subtree is recomputed and the rest is skipped
+	RZ_BENCHMARK(SceneGraphWorldUpdate, 10000, 100000, 1000000)
+	{
+		Scene scene("Benchmark");
+		buildScene(scene, state.getParameter());
+
+		SceneGraph* graph = scene.getSceneGraph();
+		std::shared_ptr<Node> root = graph->getNodes()[0];
+		graph->updateWorldMatrices();
+
+		while (state.run())
+		{
+			root->transform.setPositionX(root->transform.getPositionX() + 0.01f);
+			graph->updateWorldMatrices();
+		}
+	}
+
+	// Editor picking and physics callbacks resolve nodes by id
+	RZ_BENCHMARK(SceneGraphLookupById, 10000, 100000, 1000000)
+	{
+		Scene scene("Benchmark");
+		buildScene(scene, state.getParameter());
+
+		SceneGraph* graph = scene.getSceneGraph();
+		// Registers the children attached directly by buildScene()
+		graph->updateWorldMatrices();
+
+		unsigned int count = (unsigned int)state.getParameter();
+		unsigned int id = 0;
+		uint64 checksum = 0;
+
+		while (state.run())
+		{
+			for (int i = 0; i < 1000; i++)
+			{
+				id = (id * 1103515245u + 12345u) % count;
+				checksum += graph->getNodeById(id)->childIndex;
+			}
+		}
+
+		if (checksum == 0)
+			Log::trace("SceneGraphLookupById: empty checksum");
+	}
+
+	// Unit boxes scattered in a cube holding about 64 of them per 16^3 cell
+	static void buildBoxes(std::vector<AABB>& boxes, uint64 count)
+	{
+		float side = 16.0f * cbrtf((float)count / 64.0f);
+		uint32 seed = 1;
+
+		auto next = [&seed, side]()
+		{
+			seed = seed * 1103515245u + 12345u;
+			return (float)((seed >> 8) & 0xffff) / 65535.0f * side;
+		};
+
+		boxes.reserve((size_t)count);
+
+		for (uint64 i = 0; i < count; i++)
+		{
+			glm::vec3 center = glm::vec3(next(), next(), next());
+			boxes.push_back(AABB::fromMinMax(center - glm::vec3(0.5f), center + glm::vec3(0.5f)));
+		}
+	}
+
+	static Frustum benchmarkFrustum()
+	{
+		glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.25f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+		return Frustum::fromMatrix(projection * view);
+	}
+
+	// Frustum culling through the BVH, SceneLinearFrustumQuery tests every box
+	RZ_BENCHMARK(SceneBVHFrustumQuery, 10000, 100000, 1000000)
+	{
+		std::vector<AABB> boxes;
+		buildBoxes(boxes, state.getParameter());
+
+		BVH bvh;
+
+		for (uint32 i = 0; i < boxes.size(); i++)
+			bvh.insert({ i, 0 }, boxes[i]);
+
+		bvh.rebuild();
+		bvh.commit();
+
+		Frustum frustum = benchmarkFrustum();
+		std::vector<NodeHandle> results;
+
+		while (state.run())
+		{
+			results.clear();
+			bvh.queryFrustum(frustum, results);
+		}
+
+		if (results.empty())
+			Log::trace("SceneBVHFrustumQuery: nothing visible");
+	}
+
+	RZ_BENCHMARK(SceneLinearFrustumQuery, 10000, 100000, 1000000)
+	{
+		std::vector<AABB> boxes;
+		buildBoxes(boxes, state.getParameter());
+
+		Frustum frustum = benchmarkFrustum();
+		std::vector<NodeHandle> results;
+
+		while (state.run())
+		{
+			results.clear();
+
+			for (uint32 i = 0; i < boxes.size(); i++)
+				if (frustum.intersects(boxes[i]))
+					results.push_back({ i, 0 });
+		}
+
+		if (results.empty())
+			Log::trace("SceneLinearFrustumQuery: nothing visible");
+	}
+
+}
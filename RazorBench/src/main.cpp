@@ -0,0 +1,117 @@
+#include "Benchmark.h"
+#include "Razor/Memory/MemoryTracker.h"
+
+// Every heap allocation of the process goes through here, Razor included
+void* operator new(size_t size)
+{
+	Razor::Benchmark::onAllocation(size);
+
+#ifdef RZ_MEMORY_TRACKING
+	return Razor::MemoryTracker::allocate(size);
+#else
+	void* pointer = std::malloc(size > 0 ? size : 1);
+
+	if (pointer == nullptr)
+		throw std::bad_alloc();
+
+	return pointer;
+#endif
+}
+
+void operator delete(void* pointer) noexcept
+{
+#ifdef RZ_MEMORY_TRACKING
+	Razor::MemoryTracker::deallocate(pointer);
+#else
+	std::free(pointer);
+#endif
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	operator delete(pointer);
+}
+
+static void printUsage()
+{
+	std::cout << "Usage: RazorBench [options]\n"
+		<< "  --filter <text>       Only run scenarios whose name contains text\n"
+		<< "  --out <file>          Write the results as JSON (default: razor_bench.json)\n"
+		<< "  --compare <file>      Compare against a baseline written by --out\n"
+		<< "  --threshold <ratio>   Allowed slowdown before flagging a regression (default: 0.1)\n"
+		<< "  --min-time <seconds>  Minimum measuring time per scenario (default: 0.5)\n"
+		<< "  --iterations <count>  Maximum iterations per scenario (default: 1000)\n"
+		<< "  --threads <count>     Job system threads, 1 runs everything serially (default: all cores)\n"
+		<< "  --deterministic       Run parallel loops in order on the calling thread\n";
+}
+
+int main(int argc, char** argv)
+{
+	std::string filter;
+	std::string output = "razor_bench.json";
+	std::string baseline_path;
+	double threshold = BENCHMARK_REGRESSION_THRESHOLD;
+	double min_time = BENCHMARK_MIN_TIME;
+	uint32 max_iterations = BENCHMARK_MAX_ITERATIONS;
+	unsigned int threads = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+
+		if (arg == "--filter" && has_value)
+			filter = argv[++i];
+		else if (arg == "--out" && has_value)
+			output = argv[++i];
+		else if (arg == "--compare" && has_value)
+			baseline_path = argv[++i];
+		else if (arg == "--threshold" && has_value)
+			threshold = std::atof(argv[++i]);
+		else if (arg == "--min-time" && has_value)
+			min_time = std::atof(argv[++i]);
+		else if (arg == "--iterations" && has_value)
+			max_iterations = (uint32)std::max(1, std::atoi(argv[++i]));
+		else if (arg == "--threads" && has_value)
+			threads = (unsigned int)std::max(1, std::atoi(argv[++i]));
+		else if (arg == "--deterministic")
+			Razor::Parallel::setDeterministic(true);
+		else
+		{
+			printUsage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	Razor::Log::init();
+
+	std::vector<Razor::Benchmark::Result> results;
+
+	{
+		// About 1 MiB of inline job slots, too big for the main thread stack
+		std::unique_ptr<Razor::JobSystem> jobs = std::make_unique<Razor::JobSystem>(threads);
+		results = Razor::Benchmark::run(filter, min_time, max_iterations);
+	}
+
+	if (!Razor::Benchmark::write(output, results))
+		Razor::Log::error("Unable to write %s", output.c_str());
+
+	uint32 regressions = 0;
+
+	if (!baseline_path.empty())
+	{
+		std::vector<Razor::Benchmark::Result> baseline;
+
+		if (Razor::Benchmark::read(baseline_path, baseline))
+		{
+			regressions = Razor::Benchmark::compare(baseline, results, threshold);
+			Razor::Log::info("%d regression(s) against %s", (int)regressions, baseline_path.c_str());
+		}
+		else
+			Razor::Log::error("Unable to read baseline %s", baseline_path.c_str());
+	}
+
+	Razor::Log::shutdown();
+
+	return regressions > 0 ? 2 : 0;
+}
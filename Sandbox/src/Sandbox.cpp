@@ -185,7 +185,7 @@ void TestLayer::OnAttach()
 		std::shared_ptr<Razor::PhongMaterial> defaultMaterial = std::make_shared<Razor::PhongMaterial>();
 		defaultMaterial->setSpecularColor(glm::vec3(0.0f, 0.0f, 0.0f));
 
-		std::shared_ptr<Razor::Node> nodePlane = std::make_shared<Razor::Node>();
+		std::shared_ptr<Razor::Node> nodePlane = Razor::Node::create();
 		std::shared_ptr<Razor::Plane> plane = std::make_shared<Razor::Plane>();
 		plane->setMaterial(defaultMaterial);
 		nodePlane->name = "Plane";
@@ -309,8 +309,15 @@ glm::vec2 TestLayer::extractLatLng(const std::string& str)
 
 void TestLayer::serialize()
 {
+	std::string path = Utils::saveFileDialog("rza");
 
-	//auto f = engine->getThreadPool()->addTask([=]
+	if (!path.empty())
+	{
+		Serializer serializer;
+		serializer.exportScene(sm->getActiveScene().get(), path);
+	}
+
+	//auto f = engine->getJobSystem()->addTask([=]
 	//{
 	//	Node* j = nullptr;
 	//	AssetsManager::import(j, &TestLayer::importFinished, Variant("./data/Jeep.fbx"));
@@ -353,7 +360,13 @@ void TestLayer::serialize()
 
 void TestLayer::unserialize()
 {
+	std::string path = Utils::fileDialog();
 
+	if (!path.empty())
+	{
+		Serializer serializer;
+		serializer.importScene(sm->getActiveScene().get(), path, AssetsManager::texturesManager);
+	}
 }
 
 void TestLayer::OnEvent(Razor::Event& event)
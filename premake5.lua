@@ -348,3 +348,60 @@ project "Client"
 		defines "RZ_DIST"
 		optimize "On"	
 		entrypoint "mainCRTStartup" 
+
+project "RazorBench"
+	location "RazorBench"
+	kind "ConsoleApp"
+	language "C++"
+
+	linkoptions { 
+		"-IGNORE:4099"
+	}
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp"
+	}
+
+	includedirs
+	{
+		"%{prj.name}/src",
+		"Razor/vendor/spdlog/include",
+		"Razor/src",
+		"Razor/vendor",
+		"%{IncludeDir.glm}",
+		"%{IncludeDir.bullet}"
+	}
+
+	links
+	{
+		"Razor"
+	}
+
+	filter "system:windows"
+		cppdialect "C++17"
+		staticruntime "On"
+		systemversion "latest"
+
+		defines
+		{
+			"_CRT_SECURE_NO_WARNINGS",
+			"RZ_PLATFORM_WINDOWS"
+		}
+
+	filter "configurations:Debug"
+		defines "RZ_DEBUG"
+		symbols "On"
+		buildoptions {"/MTd"}
+		
+	filter "configurations:Release"
+		defines "RZ_RELEASE"
+		optimize "On"
+		
+	filter "configurations:Dist"
+		defines "RZ_DIST"
+		optimize "On"